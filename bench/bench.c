@@ -0,0 +1,455 @@
+/*
+MIT License
+
+Copyright (c) 2023 MetaReal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+*/
+
+/**
+ * @file bench.c
+ * This file contains definitions of the \a bench.h file.
+*/
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include <bench.h>
+#include <mem.h>
+#include <consts.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+/**
+ * Seed of the generator. Every input starts from it.
+*/
+#define MR_BENCH_SEED ((uint64_t)0x9e3779b97f4a7c15)
+
+/**
+ * Size of the longest line that the generator writes.
+*/
+#define MR_BENCH_LINE ((mr_long_t)4096)
+
+/**
+ * @struct __MR_BENCH_GEN_T
+ * State of the generator.
+ * @var mr_str_t __MR_BENCH_GEN_T::code
+ * The generated code.
+ * @var mr_long_t __MR_BENCH_GEN_T::size
+ * Size of the generated code.
+ * @var uint64_t __MR_BENCH_GEN_T::seed
+ * State of the random number generator (xorshift64).
+*/
+struct __MR_BENCH_GEN_T
+{
+    mr_str_t code;
+    mr_long_t size;
+    uint64_t seed;
+};
+typedef struct __MR_BENCH_GEN_T mr_bench_gen_t;
+
+mr_str_ct mr_bench_names[MR_BENCH_KINDS] = {"plain", "indent", "comment", "strs", "expr", "fstrs"};
+
+/**
+ * Words that the generated identifiers and comments are made of.
+*/
+mr_str_ct mr_bench_words[16] =
+{
+    "value", "count", "index", "node", "item", "total", "size", "data",
+    "left", "right", "buffer", "state", "result", "offset", "token", "level"
+};
+
+/**
+ * Operators of the generated expressions.
+*/
+mr_str_ct mr_bench_ops[8] = {" + ", " - ", " * ", " / ", " % ", " & ", " | ", " ^ "};
+
+/**
+ * It returns a random number between zero and \a range (exclusive).
+ * @param gen
+ * State of the generator.
+ * @param range
+ * The range.
+ * @return It returns the number.
+*/
+mr_long_t mr_bench_rand(
+    mr_bench_gen_t *gen, mr_long_t range);
+
+/**
+ * It appends the \a str to the generated code.
+ * @param gen
+ * State of the generator.
+ * @param str
+ * The string.
+*/
+void mr_bench_put(
+    mr_bench_gen_t *gen, mr_str_ct str);
+
+/**
+ * It appends \a count copies of the \a chr to the generated code.
+ * @param gen
+ * State of the generator.
+ * @param chr
+ * The character.
+ * @param count
+ * Number of the copies.
+*/
+void mr_bench_putc(
+    mr_bench_gen_t *gen, mr_chr_t chr, mr_long_t count);
+
+/**
+ * It appends a random identifier to the generated code.
+ * @param gen
+ * State of the generator.
+*/
+void mr_bench_ident(
+    mr_bench_gen_t *gen);
+
+/**
+ * It appends a random operand (identifier, number, attribute, or call) to the generated code.
+ * @param gen
+ * State of the generator.
+*/
+void mr_bench_operand(
+    mr_bench_gen_t *gen);
+
+/**
+ * It appends a random string literal to the generated code.
+ * @param gen
+ * State of the generator.
+*/
+void mr_bench_str(
+    mr_bench_gen_t *gen);
+
+/**
+ * It appends a random dense expression to the generated code.
+ * @param gen
+ * State of the generator.
+ * @param depth
+ * Maximum number of the nested parentheses.
+*/
+void mr_bench_expr(
+    mr_bench_gen_t *gen, mr_byte_t depth);
+
+/**
+ * It appends an assignment of a random expression to the generated code (without the newline).
+ * @param gen
+ * State of the generator.
+*/
+void mr_bench_assign(
+    mr_bench_gen_t *gen);
+
+/**
+ * It appends a line of the input to the generated code.
+ * @param gen
+ * State of the generator.
+ * @param kind
+ * Kind of the input (from __MR_BENCH_KIND_ENUM).
+*/
+void mr_bench_line(
+    mr_bench_gen_t *gen, mr_byte_t kind);
+
+void mr_bench_args(
+    mr_long_t *size, mr_long_t *runs, int argc, char *argv[])
+{
+    *size = argc > 1 ? (mr_long_t)strtoul(argv[1], NULL, 10) * 1024 : MR_BENCH_SIZE;
+    *runs = argc > 2 ? (mr_long_t)strtoul(argv[2], NULL, 10) : MR_BENCH_RUNS;
+
+    if (!*size)
+        *size = MR_BENCH_SIZE;
+    if (!*runs)
+        *runs = 1;
+}
+
+mr_str_t mr_bench_generate(
+    mr_long_t *res, mr_byte_t kind, mr_long_t size)
+{
+    mr_bench_gen_t gen;
+
+    gen.code = mr_mem_malloc(MR_MEM_SOURCE, (size + MR_BENCH_LINE + MR_LEXER_MARGIN) * sizeof(mr_chr_t));
+    if (!gen.code)
+        return NULL;
+
+    gen.size = 0;
+    gen.seed = MR_BENCH_SEED;
+    while (gen.size < size)
+        mr_bench_line(&gen, kind);
+
+    memset(gen.code + gen.size, '\0', MR_LEXER_MARGIN * sizeof(mr_chr_t));
+    *res = gen.size;
+    return gen.code;
+}
+
+mr_byte_t mr_bench_write(
+    mr_str_ct fname, mr_str_ct code, mr_long_t size)
+{
+    FILE *file;
+    size_t written;
+
+    file = fopen(fname, "wb");
+    if (!file)
+        return MR_ERROR_FILE_NOT_FOUND;
+
+    written = fwrite(code, sizeof(mr_chr_t), size, file);
+    if (fclose(file) || written != size)
+        return MR_ERROR_FILE_NOT_FOUND;
+    return MR_NOERROR;
+}
+
+double mr_bench_now(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER counter, freq;
+
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&freq);
+    return (double)counter.QuadPart * 1000 / (double)freq.QuadPart;
+#else
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1000 + (double)now.tv_nsec / 1000000;
+#endif
+}
+
+void mr_bench_add(
+    mr_bench_t *bench, double start)
+{
+    double time;
+
+    time = mr_bench_now() - start;
+    if (!bench->runs || time < bench->best)
+        bench->best = time;
+
+    bench->total += time;
+    bench->runs++;
+}
+
+void mr_bench_print(
+    mr_str_ct name, const mr_bench_t *bench, mr_long_t size)
+{
+    printf("  %-24s best %9.2f ms  mean %9.2f ms", name, bench->best, bench->total / bench->runs);
+    if (size)
+        printf("  %8.1f MB/s", size / (bench->best * 1000));
+    putchar('\n');
+}
+
+mr_long_t mr_bench_rand(
+    mr_bench_gen_t *gen, mr_long_t range)
+{
+    gen->seed ^= gen->seed << 13;
+    gen->seed ^= gen->seed >> 7;
+    gen->seed ^= gen->seed << 17;
+    return (mr_long_t)((gen->seed >> 32) % range);
+}
+
+void mr_bench_put(
+    mr_bench_gen_t *gen, mr_str_ct str)
+{
+    mr_long_t size;
+
+    size = (mr_long_t)strlen(str);
+    memcpy(gen->code + gen->size, str, size * sizeof(mr_chr_t));
+    gen->size += size;
+}
+
+void mr_bench_putc(
+    mr_bench_gen_t *gen, mr_chr_t chr, mr_long_t count)
+{
+    memset(gen->code + gen->size, chr, count * sizeof(mr_chr_t));
+    gen->size += count;
+}
+
+void mr_bench_ident(
+    mr_bench_gen_t *gen)
+{
+    mr_bench_put(gen, mr_bench_words[mr_bench_rand(gen, 16)]);
+    if (mr_bench_rand(gen, 2))
+    {
+        mr_bench_putc(gen, '_', 1);
+        mr_bench_put(gen, mr_bench_words[mr_bench_rand(gen, 16)]);
+    }
+}
+
+void mr_bench_operand(
+    mr_bench_gen_t *gen)
+{
+    mr_long_t args;
+
+    switch (mr_bench_rand(gen, 8))
+    {
+    case 0:
+    case 1:
+        gen->size += sprintf(gen->code + gen->size, "%" PRIu32, mr_bench_rand(gen, 100000));
+        return;
+    case 2:
+        gen->size += sprintf(gen->code + gen->size, "%" PRIu32 ".%" PRIu32,
+            mr_bench_rand(gen, 1000), mr_bench_rand(gen, 100));
+        return;
+    case 3:
+        mr_bench_ident(gen);
+        mr_bench_putc(gen, '.', 1);
+        mr_bench_ident(gen);
+        return;
+    case 4:
+        mr_bench_ident(gen);
+        mr_bench_putc(gen, '(', 1);
+        mr_bench_ident(gen);
+        for (args = mr_bench_rand(gen, 3); args; args--)
+        {
+            mr_bench_put(gen, ", ");
+            mr_bench_ident(gen);
+        }
+        mr_bench_putc(gen, ')', 1);
+        return;
+    default:
+        mr_bench_ident(gen);
+        return;
+    }
+}
+
+void mr_bench_str(
+    mr_bench_gen_t *gen)
+{
+    mr_long_t count;
+
+    mr_bench_putc(gen, '"', 1);
+    for (count = mr_bench_rand(gen, 4) + 1; count; count--)
+    {
+        mr_bench_put(gen, mr_bench_words[mr_bench_rand(gen, 16)]);
+        mr_bench_put(gen, mr_bench_rand(gen, 4) ? " " : "\\n");
+    }
+    mr_bench_putc(gen, '"', 1);
+}
+
+void mr_bench_expr(
+    mr_bench_gen_t *gen, mr_byte_t depth)
+{
+    mr_long_t ops;
+
+    for (ops = mr_bench_rand(gen, 6) + 2; ops; ops--)
+    {
+        switch (mr_bench_rand(gen, 4))
+        {
+        case 0:
+            mr_bench_putc(gen, (mr_chr_t)('0' + mr_bench_rand(gen, 10)), 1);
+            break;
+        case 1:
+            if (depth)
+            {
+                mr_bench_putc(gen, '(', 1);
+                mr_bench_expr(gen, depth - 1);
+                mr_bench_putc(gen, ')', 1);
+                break;
+            }
+            /* fall through */
+        default:
+            mr_bench_putc(gen, (mr_chr_t)('a' + mr_bench_rand(gen, 8)), 1);
+            break;
+        }
+
+        if (ops != 1)
+            mr_bench_put(gen, mr_bench_ops[mr_bench_rand(gen, 8)]);
+    }
+}
+
+void mr_bench_assign(
+    mr_bench_gen_t *gen)
+{
+    mr_long_t ops;
+
+    mr_bench_ident(gen);
+    mr_bench_put(gen, " = ");
+    mr_bench_operand(gen);
+    for (ops = mr_bench_rand(gen, 4); ops; ops--)
+    {
+        mr_bench_put(gen, mr_bench_ops[mr_bench_rand(gen, 8)]);
+        mr_bench_operand(gen);
+    }
+}
+
+void mr_bench_line(
+    mr_bench_gen_t *gen, mr_byte_t kind)
+{
+    mr_long_t count;
+
+    switch (kind)
+    {
+    case MR_BENCH_PLAIN:
+        mr_bench_assign(gen);
+        break;
+    case MR_BENCH_INDENT:
+        mr_bench_putc(gen, ' ', 4 * (mr_bench_rand(gen, 16) + 2));
+        if (!mr_bench_rand(gen, 4))
+            mr_bench_putc(gen, '\t', mr_bench_rand(gen, 8) + 1);
+
+        mr_bench_assign(gen);
+        break;
+    case MR_BENCH_COMMENT:
+        if (!mr_bench_rand(gen, 16))
+        {
+            mr_bench_put(gen, "#*");
+            for (count = mr_bench_rand(gen, 24) + 8; count; count--)
+            {
+                mr_bench_put(gen, "\n * ");
+                mr_bench_put(gen, mr_bench_words[mr_bench_rand(gen, 16)]);
+                mr_bench_put(gen, " of the software is provided \"as is\", without warranty of any kind.");
+            }
+            mr_bench_put(gen, "\n*#\n");
+        }
+
+        mr_bench_assign(gen);
+        if (mr_bench_rand(gen, 2))
+        {
+            mr_bench_put(gen, " # ");
+            mr_bench_put(gen, mr_bench_words[mr_bench_rand(gen, 16)]);
+            mr_bench_put(gen, " is updated before the next iteration of the loop");
+        }
+        break;
+    case MR_BENCH_STRS:
+        mr_bench_ident(gen);
+        mr_bench_put(gen, " = ");
+        mr_bench_str(gen);
+        for (count = mr_bench_rand(gen, 3); count; count--)
+        {
+            mr_bench_put(gen, " + ");
+            mr_bench_str(gen);
+        }
+        break;
+    case MR_BENCH_EXPR:
+        mr_bench_putc(gen, (mr_chr_t)('a' + mr_bench_rand(gen, 8)), 1);
+        mr_bench_put(gen, " = ");
+        mr_bench_expr(gen, 2);
+        break;
+    case MR_BENCH_FSTRS:
+        mr_bench_ident(gen);
+        mr_bench_put(gen, " = f\"");
+        for (count = 8; count; count--)
+        {
+            mr_bench_put(gen, mr_bench_words[mr_bench_rand(gen, 16)]);
+            mr_bench_put(gen, " {");
+            mr_bench_operand(gen);
+            mr_bench_put(gen, "} ");
+        }
+        mr_bench_putc(gen, '"', 1);
+        break;
+    }
+
+    mr_bench_putc(gen, '\n', 1);
+}
@@ -0,0 +1,166 @@
+/*
+MIT License
+
+Copyright (c) 2023 MetaReal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+*/
+
+/**
+ * @file bench.h
+ * This file contains the shared parts of the benchmarks (see the \a MR_BENCH build option). \n
+ * Inputs are generated from a fixed seed, So every run of a benchmark measures the same code. \n
+ * All things defined in \a bench.c and this file have the \a mr_bench prefix.
+*/
+
+#ifndef __MR_BENCH__
+#define __MR_BENCH__
+
+#include <defs.h>
+
+/**
+ * Default size of the generated inputs in characters.
+*/
+#define MR_BENCH_SIZE ((mr_long_t)0x800000)
+
+/**
+ * Default number of runs of each measurement.
+*/
+#define MR_BENCH_RUNS ((mr_long_t)10)
+
+/**
+ * @enum __MR_BENCH_KIND_ENUM
+ * List of the generated inputs.
+ * @var __MR_BENCH_KIND_ENUM::MR_BENCH_PLAIN
+ * Assignments of small expressions with calls, One per line.
+ * @var __MR_BENCH_KIND_ENUM::MR_BENCH_INDENT
+ * The plain code, Indented by long runs of spaces and tabs.
+ * @var __MR_BENCH_KIND_ENUM::MR_BENCH_COMMENT
+ * The plain code, Interleaved with singleline comments and long multiline comment headers.
+ * @var __MR_BENCH_KIND_ENUM::MR_BENCH_STRS
+ * Assignments of string literals, A quarter of them with escape sequences.
+ * @var __MR_BENCH_KIND_ENUM::MR_BENCH_EXPR
+ * Assignments of long expressions with single-character operands and parentheses (about one token per two characters).
+ * @var __MR_BENCH_KIND_ENUM::MR_BENCH_FSTRS
+ * Assignments of formatted strings with eight interpolations of small operands each.
+ * @var __MR_BENCH_KIND_ENUM::MR_BENCH_KINDS
+ * Number of the inputs.
+*/
+enum __MR_BENCH_KIND_ENUM
+{
+    MR_BENCH_PLAIN,
+    MR_BENCH_INDENT,
+    MR_BENCH_COMMENT,
+    MR_BENCH_STRS,
+    MR_BENCH_EXPR,
+    MR_BENCH_FSTRS,
+
+    MR_BENCH_KINDS
+};
+
+/**
+ * @struct __MR_BENCH_T
+ * Timings of a single measurement.
+ * @var double __MR_BENCH_T::best
+ * Time of the fastest run in milliseconds.
+ * @var double __MR_BENCH_T::total
+ * Time of all runs in milliseconds.
+ * @var mr_long_t __MR_BENCH_T::runs
+ * Number of the runs.
+*/
+struct __MR_BENCH_T
+{
+    double best;
+    double total;
+    mr_long_t runs;
+};
+typedef struct __MR_BENCH_T mr_bench_t;
+
+/**
+ * Names of the inputs (indexed by __MR_BENCH_KIND_ENUM).
+*/
+extern mr_str_ct mr_bench_names[MR_BENCH_KINDS];
+
+/**
+ * It reads the common arguments of the benchmarks:
+ * <pre>
+ *     [size in KB] [runs]
+ * </pre>
+ * @param size
+ * Size of the inputs in characters (<em>MR_BENCH_SIZE</em> if it's not specified).
+ * @param runs
+ * Number of runs of each measurement (<em>MR_BENCH_RUNS</em> if it's not specified).
+ * @param argc
+ * Number of the arguments (including the name of the benchmark).
+ * @param argv
+ * The arguments.
+*/
+void mr_bench_args(
+    mr_long_t *size, mr_long_t *runs, int argc, char *argv[]);
+
+/**
+ * It generates an input. \n
+ * The code is followed by <em>MR_LEXER_MARGIN</em> null characters,
+ * And it's allocated for the <em>MR_MEM_SOURCE</em> phase (so it can be edited by the \a mr_lexer_edit function).
+ * @param size
+ * Minimum size of the code in characters. Generation stops at the end of the first line that reaches it.
+ * @param kind
+ * Kind of the input (from __MR_BENCH_KIND_ENUM).
+ * @param res
+ * Size of the generated code in characters.
+ * @return It returns the code, Or NULL if there isn't enough memory.
+*/
+mr_str_t mr_bench_generate(
+    mr_long_t *res, mr_byte_t kind, mr_long_t size);
+
+/**
+ * It writes the \a code into the file.
+ * @param fname
+ * Name of the file.
+ * @param code
+ * The code.
+ * @param size
+ * Size of the code in characters.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_FILE_NOT_FOUND</em>.
+*/
+mr_byte_t mr_bench_write(
+    mr_str_ct fname, mr_str_ct code, mr_long_t size);
+
+/**
+ * It returns the time of a monotonic clock in milliseconds.
+*/
+double mr_bench_now(void);
+
+/**
+ * It adds a run to the timings.
+ * @param bench
+ * The timings (must be zero-initialized before the first run).
+ * @param start
+ * Time of the start of the run (returned by the \a mr_bench_now function).
+*/
+void mr_bench_add(
+    mr_bench_t *bench, double start);
+
+/**
+ * It prints the best and the mean time of the runs, And the throughput of the best run. \n
+ * The throughput is omitted if \a size is zero.
+ * @param name
+ * Name of the measurement.
+ * @param bench
+ * The timings.
+ * @param size
+ * Number of the characters processed by each run.
+*/
+void mr_bench_print(
+    mr_str_ct name, const mr_bench_t *bench, mr_long_t size);
+
+#endif
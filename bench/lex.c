@@ -0,0 +1,123 @@
+/*
+MIT License
+
+Copyright (c) 2023 MetaReal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+*/
+
+/**
+ * @file lex.c
+ * Benchmark of the lexer. \n
+ * Every input is lexed with the scalar scanning subroutines and with the ones selected by the \a mr_scan_init function.
+*/
+
+#include <bench.h>
+#include <lexer/lexer.h>
+#include <lexer/scan.h>
+#include <pool.h>
+#include <mem.h>
+#include <config.h>
+#include <stdio.h>
+
+/**
+ * It lexes <em>_mr_config.code</em> \a runs times.
+ * @param bench
+ * Timings of the runs.
+ * @param runs
+ * Number of the runs.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns the error code of the lexer.
+*/
+mr_byte_t mr_bench_lex(
+    mr_bench_t *bench, mr_long_t runs);
+
+int main(
+    int argc, char *argv[])
+{
+    mr_long_t size, length, runs;
+    mr_byte_t kind, retcode;
+    mr_str_t code;
+    mr_scan_t scalar, selected;
+    mr_bench_t bench;
+
+    mr_bench_args(&size, &runs, argc, argv);
+
+    scalar = _mr_scan;
+    mr_scan_init();
+    selected = _mr_scan;
+
+    printf("Lexer (best of %" PRIu32 "):\n", runs);
+    for (kind = 0; kind != MR_BENCH_KINDS; kind++)
+    {
+        code = mr_bench_generate(&length, kind, size);
+        if (!code)
+        {
+            fputs("Internal Error: Not enough memory\n", stderr);
+            return MR_ERROR_NOT_ENOUGH_MEMORY;
+        }
+
+        _mr_config = (mr_config_t){.outstream=stdout, .instream=stdin, .errstream=stderr,
+            .code=code, .fname=mr_bench_names[kind], .size=length, .source=MR_CONFIG_SOURCE_HEAP};
+        printf("%s (%" PRIu32 " KB):\n", mr_bench_names[kind], length / 1024);
+
+        _mr_scan = scalar;
+        bench = (mr_bench_t){.best=0, .total=0, .runs=0};
+        retcode = mr_bench_lex(&bench, runs);
+        if (retcode != MR_NOERROR)
+        {
+            mr_mem_free(code);
+            return retcode;
+        }
+        mr_bench_print("scalar scanning", &bench, length);
+
+        _mr_scan = selected;
+        bench = (mr_bench_t){.best=0, .total=0, .runs=0};
+        retcode = mr_bench_lex(&bench, runs);
+        if (retcode != MR_NOERROR)
+        {
+            mr_mem_free(code);
+            return retcode;
+        }
+        mr_bench_print("selected scanning", &bench, length);
+
+        mr_mem_free(code);
+    }
+
+    return MR_NOERROR;
+}
+
+mr_byte_t mr_bench_lex(
+    mr_bench_t *bench, mr_long_t runs)
+{
+    mr_byte_t retcode;
+    mr_lexer_t lexer;
+    double start;
+
+    for (; runs; runs--)
+    {
+        start = mr_bench_now();
+        retcode = mr_lexer(&lexer);
+        if (retcode != MR_NOERROR)
+        {
+            fprintf(stderr, "Internal Error: Lexing %s failed (%" PRIu8 ")\n", _mr_config.fname, retcode);
+            return retcode;
+        }
+
+        mr_mem_free(lexer.tokens);
+        mr_pool_consts_free(&_mr_pool_consts);
+        mr_pool_syms_free(&_mr_pool_syms);
+        mr_pool_strs_free(&_mr_pool_strs);
+        mr_bench_add(bench, start);
+    }
+
+    return MR_NOERROR;
+}
@@ -0,0 +1,193 @@
+/*
+MIT License
+
+Copyright (c) 2023 MetaReal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+*/
+
+/**
+ * @file load.c
+ * Benchmark of loading source files. \n
+ * Every input is written into a file, And the file is loaded the way the \a main function loads it (then lexed).
+ * It's read into memory, And it's also mapped into memory if memory mapping is enabled (see the \a MR_SOURCE_MMAP build option). \n
+ * The file is loaded once before the runs, So the runs measure a warm page cache.
+*/
+
+#include <bench.h>
+#include <source.h>
+#include <lexer/lexer.h>
+#include <lexer/scan.h>
+#include <pool.h>
+#include <mem.h>
+#include <config.h>
+#include <stdio.h>
+
+/**
+ * Name of the file that the inputs are written into (in the working directory).
+*/
+#define MR_BENCH_LOAD_FILE "bench_load.mr"
+
+/**
+ * It loads and lexes the file \a runs times.
+ * @param load
+ * Timings of loading the file.
+ * @param lex
+ * Timings of loading and lexing the file.
+ * @param map
+ * It indicates whether the file should be mapped (MR_TRUE) or read (MR_FALSE).
+ * @param runs
+ * Number of the runs (plus one that warms the page cache).
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>.
+ * If the file can't be mapped, it returns <em>MR_ERROR_BAD_FORMAT</em>. Otherwise, it returns the error code.
+*/
+mr_byte_t mr_bench_load(
+    mr_bench_t *load, mr_bench_t *lex, mr_bool_t map, mr_long_t runs);
+
+int main(
+    int argc, char *argv[])
+{
+    mr_long_t size, length, runs;
+    mr_byte_t kind, retcode;
+    mr_str_t code;
+    mr_bench_t load, lex;
+
+    mr_bench_args(&size, &runs, argc, argv);
+    mr_scan_init();
+
+    printf("Loading (best of %" PRIu32 "):\n", runs);
+    for (kind = 0; kind != MR_BENCH_KINDS; kind++)
+    {
+        code = mr_bench_generate(&length, kind, size);
+        if (!code)
+        {
+            fputs("Internal Error: Not enough memory\n", stderr);
+            return MR_ERROR_NOT_ENOUGH_MEMORY;
+        }
+
+        retcode = mr_bench_write(MR_BENCH_LOAD_FILE, code, length);
+        mr_mem_free(code);
+        if (retcode != MR_NOERROR)
+        {
+            fputs("Internal Error: Can not write the file \"" MR_BENCH_LOAD_FILE "\"\n", stderr);
+            return retcode;
+        }
+
+        printf("%s (%" PRIu32 " KB):\n", mr_bench_names[kind], length / 1024);
+
+        load = (mr_bench_t){.best=0, .total=0, .runs=0};
+        lex = (mr_bench_t){.best=0, .total=0, .runs=0};
+        retcode = mr_bench_load(&load, &lex, MR_FALSE, runs);
+        if (retcode != MR_NOERROR)
+            break;
+
+        mr_bench_print("read", &load, length);
+        mr_bench_print("read + lex", &lex, length);
+
+#ifdef __MR_SOURCE_MMAP__
+        load = (mr_bench_t){.best=0, .total=0, .runs=0};
+        lex = (mr_bench_t){.best=0, .total=0, .runs=0};
+        retcode = mr_bench_load(&load, &lex, MR_TRUE, runs);
+        if (retcode == MR_ERROR_BAD_FORMAT)
+        {
+            puts("  the file can't be mapped (its last page is too full)");
+            continue;
+        }
+        if (retcode != MR_NOERROR)
+            break;
+
+        mr_bench_print("mmap", &load, length);
+        mr_bench_print("mmap + lex", &lex, length);
+#endif
+    }
+
+    remove(MR_BENCH_LOAD_FILE);
+    return kind == MR_BENCH_KINDS ? MR_NOERROR : retcode;
+}
+
+mr_byte_t mr_bench_load(
+    mr_bench_t *load, mr_bench_t *lex, mr_bool_t map, mr_long_t runs)
+{
+    mr_byte_t retcode;
+    mr_lexer_t lexer;
+    mr_long_t size;
+    mr_str_t code;
+    mr_bool_t warm;
+    FILE *file;
+    double start;
+
+    /* The first run only warms the page cache. */
+    warm = MR_FALSE;
+    for (runs++; runs; runs--)
+    {
+        start = mr_bench_now();
+        file = fopen(MR_BENCH_LOAD_FILE, "rb");
+        if (!file)
+        {
+            fputs("Internal Error: Can not find the file \"" MR_BENCH_LOAD_FILE "\"\n", stderr);
+            return MR_ERROR_FILE_NOT_FOUND;
+        }
+
+        fseek(file, 0, SEEK_END);
+        size = ftell(file);
+        rewind(file);
+
+#ifdef __MR_SOURCE_MMAP__
+        code = map ? mr_source_map(MR_BENCH_LOAD_FILE, size) : mr_source_read(file, size);
+#else
+        code = mr_source_read(file, size);
+#endif
+        fclose(file);
+
+        if (!code)
+        {
+            if (map)
+                return MR_ERROR_BAD_FORMAT;
+
+            fputs("Internal Error: Not enough memory\n", stderr);
+            return MR_ERROR_NOT_ENOUGH_MEMORY;
+        }
+
+        if (warm)
+            mr_bench_add(load, start);
+
+        _mr_config = (mr_config_t){.outstream=stdout, .instream=stdin, .errstream=stderr,
+            .code=code, .fname=MR_BENCH_LOAD_FILE, .size=size,
+            .source=map ? MR_CONFIG_SOURCE_MAPPED : MR_CONFIG_SOURCE_HEAP};
+        retcode = mr_lexer(&lexer);
+        if (retcode == MR_NOERROR)
+        {
+            mr_mem_free(lexer.tokens);
+            mr_pool_consts_free(&_mr_pool_consts);
+            mr_pool_syms_free(&_mr_pool_syms);
+            mr_pool_strs_free(&_mr_pool_strs);
+            if (warm)
+                mr_bench_add(lex, start);
+        }
+
+#ifdef __MR_SOURCE_MMAP__
+        if (map)
+            mr_source_unmap(code, size);
+        else
+#endif
+        mr_mem_free(code);
+
+        if (retcode != MR_NOERROR)
+        {
+            fprintf(stderr, "Internal Error: Lexing %s failed (%" PRIu8 ")\n", MR_BENCH_LOAD_FILE, retcode);
+            return retcode;
+        }
+        warm = MR_TRUE;
+    }
+
+    return MR_NOERROR;
+}
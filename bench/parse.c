@@ -0,0 +1,375 @@
+/*
+MIT License
+
+Copyright (c) 2023 MetaReal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+*/
+
+/**
+ * @file parse.c
+ * Benchmark of the parser. \n
+ * Every input is lexed and parsed the way the \a mr_compile function does it, And both phases are timed.
+ * The memory that the parser reads (the tokens list) and writes (the stack) is reported too,
+ * So builds with different token layouts (e.g. the \a MR_WIDE_IDX build option) can be compared. \n
+ * With compact token streams enabled, The tokens are converted into the compact token stream before parsing (also timed),
+ * And the parser reads the stream instead of the tokens list. \n
+ * With pull-based lexing enabled, Every input is also lexed and parsed with the lexer fused into the parser
+ * (like in the \a mr_compile_pull function), So only the time of both phases together is reported for it.
+*/
+
+#include <bench.h>
+#include <lexer/lexer.h>
+#include <lexer/scan.h>
+#include <parser/parser.h>
+#include <stack.h>
+#include <pool.h>
+#include <mem.h>
+#include <config.h>
+#include <consts.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __MR_TOKEN_COMPACT__
+/**
+ * Name of the tokens that the parser reads.
+*/
+#define MR_BENCH_PARSE_LIST "token stream"
+#else
+/**
+ * Name of the tokens that the parser reads.
+*/
+#define MR_BENCH_PARSE_LIST "tokens list"
+#endif
+
+/**
+ * @struct __MR_BENCH_PARSE_T
+ * Results of the parser benchmark.
+ * @var mr_bench_t __MR_BENCH_PARSE_T::lex
+ * Timings of the lexer.
+ * @var mr_bench_t __MR_BENCH_PARSE_T::encode
+ * Timings of the conversion into the compact token stream (only available with compact token streams enabled).
+ * @var mr_bench_t __MR_BENCH_PARSE_T::parse
+ * Timings of the parser.
+ * @var mr_bench_t __MR_BENCH_PARSE_T::total
+ * Timings of the lexer and the parser together (including everything between them).
+ * @var mr_long_t __MR_BENCH_PARSE_T::tokens
+ * Number of the tokens.
+ * @var mr_long_t __MR_BENCH_PARSE_T::list
+ * Size of the tokens list (or the compact token stream) that the parser reads in bytes.
+ * @var mr_long_t __MR_BENCH_PARSE_T::stack
+ * Size of the stack data that the parser writes in bytes.
+ * @var size_t __MR_BENCH_PARSE_T::lexer
+ * Peak of the memory of the lexer phase in bytes (the tokens and the pools, see <em>MR_MEM_LEXER</em>).
+*/
+struct __MR_BENCH_PARSE_T
+{
+    mr_bench_t lex;
+#ifdef __MR_TOKEN_COMPACT__
+    mr_bench_t encode;
+#endif
+    mr_bench_t parse;
+    mr_bench_t total;
+
+    mr_long_t tokens;
+    mr_long_t list;
+    mr_long_t stack;
+    size_t lexer;
+};
+typedef struct __MR_BENCH_PARSE_T mr_bench_parse_t;
+
+/**
+ * It lexes and parses <em>_mr_config.code</em> \a runs times.
+ * @param bench
+ * Results of the runs.
+ * @param runs
+ * Number of the runs.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns the error code of the lexer or the parser.
+*/
+mr_byte_t mr_bench_parse(
+    mr_bench_parse_t *bench, mr_long_t runs);
+
+/**
+ * It prints a size that the parser benchmark measured, And the size per token.
+ * @param name
+ * Name of the size.
+ * @param size
+ * The size in bytes.
+ * @param tokens
+ * Number of the tokens.
+*/
+void mr_bench_parse_print(
+    mr_str_ct name, size_t size, mr_long_t tokens);
+
+#ifdef __MR_TOKEN_PULL__
+/**
+ * It lexes and parses <em>_mr_config.code</em> \a runs times with the lexer fused into the parser
+ * (only available with pull-based lexing enabled).
+ * @param bench
+ * Results of the runs.
+ * @param runs
+ * Number of the runs.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns the error code of the lexer or the parser.
+*/
+mr_byte_t mr_bench_parse_pull(
+    mr_bench_parse_t *bench, mr_long_t runs);
+#endif
+
+int main(
+    int argc, char *argv[])
+{
+    mr_long_t size, length, runs;
+    mr_byte_t kind, retcode;
+    mr_str_t code;
+    mr_bench_parse_t bench;
+
+#ifdef __MR_TOKEN_PULL__
+    mr_bench_parse_t fused;
+#endif
+
+    mr_bench_args(&size, &runs, argc, argv);
+    mr_scan_init();
+
+    printf("Parser (best of %" PRIu32 ", %u-byte tokens):\n", runs, (unsigned)sizeof(mr_token_t));
+    for (kind = 0; kind != MR_BENCH_KINDS; kind++)
+    {
+        code = mr_bench_generate(&length, kind, size);
+        if (!code)
+        {
+            fputs("Internal Error: Not enough memory\n", stderr);
+            return MR_ERROR_NOT_ENOUGH_MEMORY;
+        }
+
+        _mr_config = (mr_config_t){.outstream=stdout, .instream=stdin, .errstream=stderr,
+            .code=code, .fname=mr_bench_names[kind], .size=length, .source=MR_CONFIG_SOURCE_HEAP};
+
+        bench = (mr_bench_parse_t){.tokens=0};
+        retcode = mr_bench_parse(&bench, runs);
+#ifdef __MR_TOKEN_PULL__
+        fused = (mr_bench_parse_t){.tokens=0};
+        if (retcode == MR_NOERROR)
+            retcode = mr_bench_parse_pull(&fused, runs);
+#endif
+        mr_mem_free(code);
+        if (retcode != MR_NOERROR)
+            return retcode;
+
+        printf("%s (%" PRIu32 " KB, %" PRIu32 " tokens):\n", mr_bench_names[kind], length / 1024, bench.tokens);
+        mr_bench_print("lex", &bench.lex, length);
+#ifdef __MR_TOKEN_COMPACT__
+        mr_bench_print("encode", &bench.encode, length);
+#endif
+        mr_bench_print("parse", &bench.parse, length);
+        mr_bench_print("lex + parse", &bench.total, length);
+#ifdef __MR_TOKEN_PULL__
+        mr_bench_print("fused lex + parse", &fused.total, length);
+#endif
+
+        mr_bench_parse_print(MR_BENCH_PARSE_LIST, bench.list, bench.tokens);
+        mr_bench_parse_print("lexer memory", bench.lexer, bench.tokens);
+#ifdef __MR_TOKEN_PULL__
+        mr_bench_parse_print("fused lexer memory", fused.lexer, bench.tokens);
+#endif
+        mr_bench_parse_print("stack data", bench.stack, bench.tokens);
+    }
+
+    return MR_NOERROR;
+}
+
+mr_byte_t mr_bench_parse(
+    mr_bench_parse_t *bench, mr_long_t runs)
+{
+    mr_byte_t retcode;
+    mr_lexer_t lexer;
+    mr_parser_t parser;
+    mr_token_cursor_t tokens;
+    mr_long_t counts[MR_TOKEN_COUNT];
+    double start, total;
+
+#ifdef __MR_TOKEN_COMPACT__
+    mr_byte_t *compact;
+#endif
+
+    for (; runs; runs--)
+    {
+        _mr_mem.stats[MR_MEM_LEXER].peak = _mr_mem.stats[MR_MEM_LEXER].size;
+
+        total = mr_bench_now();
+        retcode = mr_lexer(&lexer);
+        if (retcode != MR_NOERROR)
+        {
+            fprintf(stderr, "Internal Error: Lexing %s failed (%" PRIu8 ")\n", _mr_config.fname, retcode);
+            return retcode;
+        }
+        mr_bench_add(&bench->lex, total);
+
+        memset(counts, 0, sizeof(counts));
+        mr_token_histogram(counts, lexer.tokens);
+        retcode = mr_stack_init(mr_parser_stack_size(counts), MR_STACK_SCRATCH_SIZE);
+        if (retcode != MR_NOERROR)
+        {
+            fputs("Internal Error: Not enough memory\n", stderr);
+
+            mr_mem_free(lexer.tokens);
+            mr_pool_consts_free(&_mr_pool_consts);
+            mr_pool_syms_free(&_mr_pool_syms);
+            mr_pool_strs_free(&_mr_pool_strs);
+            return retcode;
+        }
+
+#ifdef __MR_TOKEN_COMPACT__
+        start = mr_bench_now();
+        retcode = mr_token_compact(&compact, lexer.tokens, lexer.size);
+        mr_mem_free(lexer.tokens);
+        if (retcode != MR_NOERROR)
+        {
+            fputs("Internal Error: Not enough memory\n", stderr);
+
+            mr_pool_consts_free(&_mr_pool_consts);
+            mr_pool_syms_free(&_mr_pool_syms);
+            mr_pool_strs_free(&_mr_pool_strs);
+            mr_stack_free();
+            return retcode;
+        }
+        mr_bench_add(&bench->encode, start);
+
+        /* The stream doesn't hold its size, So it's measured by reading it to the end. */
+        mr_token_cursor_init(&tokens, compact);
+        while (mr_token_cursor_type(&tokens) != MR_TOKEN_EOF)
+            mr_token_cursor_next(&tokens);
+        bench->list = (mr_long_t)(tokens.data - compact);
+
+        mr_token_cursor_init(&tokens, compact);
+#else
+        bench->list = (lexer.size + 1) * sizeof(mr_token_t);
+        mr_token_cursor_init(&tokens, lexer.tokens);
+#endif
+
+        start = mr_bench_now();
+        retcode = mr_parser(&parser, tokens, mr_parser_nodes_size(counts));
+        if (retcode != MR_NOERROR)
+        {
+            fprintf(stderr, "Internal Error: Parsing %s failed (%" PRIu8 ")\n", _mr_config.fname, retcode);
+
+#ifdef __MR_TOKEN_COMPACT__
+            mr_mem_free(compact);
+#else
+            mr_mem_free(lexer.tokens);
+#endif
+            mr_pool_consts_free(&_mr_pool_consts);
+            mr_pool_syms_free(&_mr_pool_syms);
+            mr_pool_strs_free(&_mr_pool_strs);
+            mr_stack_free();
+            return retcode;
+        }
+        mr_bench_add(&bench->parse, start);
+        mr_bench_add(&bench->total, total);
+
+        bench->tokens = lexer.size;
+        bench->stack = _mr_stack.ptr;
+        bench->lexer = _mr_mem.stats[MR_MEM_LEXER].peak;
+
+        mr_mem_free(parser.nodes);
+#ifdef __MR_TOKEN_COMPACT__
+        mr_mem_free(compact);
+#else
+        mr_mem_free(lexer.tokens);
+#endif
+        mr_pool_consts_free(&_mr_pool_consts);
+        mr_pool_syms_free(&_mr_pool_syms);
+        mr_pool_strs_free(&_mr_pool_strs);
+        mr_stack_free();
+    }
+
+    return MR_NOERROR;
+}
+
+void mr_bench_parse_print(
+    mr_str_ct name, size_t size, mr_long_t tokens)
+{
+    printf("  %-24s %9.1f KB  (%.2f B/token)\n", name, size / 1024.0, (double)size / tokens);
+}
+
+#ifdef __MR_TOKEN_PULL__
+mr_byte_t mr_bench_parse_pull(
+    mr_bench_parse_t *bench, mr_long_t runs)
+{
+    mr_byte_t retcode, pretcode;
+    mr_lexer_t lexer;
+    mr_parser_t parser;
+    mr_token_cursor_t tokens;
+    double start;
+
+    for (; runs; runs--)
+    {
+        _mr_mem.stats[MR_MEM_LEXER].peak = _mr_mem.stats[MR_MEM_LEXER].size;
+
+        start = mr_bench_now();
+        retcode = mr_lexer_pull_init(&tokens);
+        if (retcode != MR_NOERROR)
+        {
+            fputs("Internal Error: Not enough memory\n", stderr);
+            return retcode;
+        }
+
+        retcode = mr_stack_init(_mr_config.size * MR_STACK_SIZE_FACTOR, MR_STACK_SCRATCH_SIZE);
+        if (retcode != MR_NOERROR)
+        {
+            fputs("Internal Error: Not enough memory\n", stderr);
+
+            if (mr_lexer_pull_finish(&lexer, &tokens) == MR_NOERROR)
+            {
+                mr_pool_consts_free(&_mr_pool_consts);
+                mr_pool_syms_free(&_mr_pool_syms);
+                mr_pool_strs_free(&_mr_pool_strs);
+            }
+            return retcode;
+        }
+
+        pretcode = mr_parser(&parser, tokens, _mr_config.size / MR_PARSER_NODES_CHUNK + 1);
+        retcode = mr_lexer_pull_finish(&lexer, &tokens);
+        if (retcode != MR_NOERROR)
+        {
+            fprintf(stderr, "Internal Error: Lexing %s failed (%" PRIu8 ")\n", _mr_config.fname, retcode);
+
+            if (pretcode == MR_NOERROR)
+                mr_mem_free(parser.nodes);
+            mr_stack_free();
+            return retcode;
+        }
+
+        if (pretcode != MR_NOERROR)
+        {
+            fprintf(stderr, "Internal Error: Parsing %s failed (%" PRIu8 ")\n", _mr_config.fname, pretcode);
+
+            mr_pool_consts_free(&_mr_pool_consts);
+            mr_pool_syms_free(&_mr_pool_syms);
+            mr_pool_strs_free(&_mr_pool_strs);
+            mr_stack_free();
+            return pretcode;
+        }
+        mr_bench_add(&bench->total, start);
+
+        bench->stack = _mr_stack.ptr;
+        bench->lexer = _mr_mem.stats[MR_MEM_LEXER].peak;
+
+        mr_mem_free(parser.nodes);
+        mr_pool_consts_free(&_mr_pool_consts);
+        mr_pool_syms_free(&_mr_pool_syms);
+        mr_pool_strs_free(&_mr_pool_strs);
+        mr_stack_free();
+    }
+
+    return MR_NOERROR;
+}
+#endif
@@ -0,0 +1,148 @@
+/*
+MIT License
+
+Copyright (c) 2023 MetaReal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+*/
+
+/**
+ * @file stack.c
+ * Benchmark of the stack growth. \n
+ * The stack is initialized with an allocation step, And small blocks are pushed (and written) until it holds
+ * <em>MR_STACK_SIZE_FACTOR</em> bytes per character of the input size (the largest stack of a source code of that size).
+ * Every run includes the initialization and the \a mr_stack_free call. \n
+ * The benchmark takes the allocation step in KB as an optional third argument. Without it, Every step of the
+ * \a mr_bench_stack_steps list is measured. \n
+ * The peak resident memory of the process is reported at the end (not on Windows),
+ * So it covers only one step if the step is specified. \n
+ * Builds with and without the \a MR_STACK_RESERVE build option can be compared.
+*/
+
+#include <bench.h>
+#include <stack.h>
+#include <mem.h>
+#include <consts.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+/**
+ * Size of the pushed blocks in bytes.
+*/
+#define MR_BENCH_STACK_BLOCK ((mr_byte_t)16)
+
+/**
+ * Allocation steps that are measured if the step isn't specified (in KB).
+*/
+const mr_long_t mr_bench_stack_steps[] = {64, 1024, 16384};
+
+/**
+ * It pushes \a size bytes into the stack \a runs times.
+ * @param bench
+ * Timings of the runs.
+ * @param step
+ * Allocation step of the stack in bytes.
+ * @param size
+ * Number of the pushed bytes.
+ * @param runs
+ * Number of the runs.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em>.
+*/
+mr_byte_t mr_bench_stack(
+    mr_bench_t *bench, mr_long_t step, mr_long_t size, mr_long_t runs);
+
+int main(
+    int argc, char *argv[])
+{
+    mr_long_t size, runs, step, i;
+    mr_byte_t retcode;
+    mr_bench_t bench;
+    char name[32];
+
+#ifndef _WIN32
+    struct rusage usage;
+#endif
+
+    mr_bench_args(&size, &runs, argc, argv);
+    size = size / MR_BENCH_STACK_BLOCK * MR_BENCH_STACK_BLOCK * MR_STACK_SIZE_FACTOR;
+
+    printf("Stack (best of %" PRIu32 ", %" PRIu32 " MB in %" PRIu8 "-byte blocks):\n",
+        runs, size / 0x100000, MR_BENCH_STACK_BLOCK);
+    for (i = 0; i != sizeof(mr_bench_stack_steps) / sizeof(*mr_bench_stack_steps); i++)
+    {
+        step = argc > 3 ? (mr_long_t)strtoul(argv[3], NULL, 10) : mr_bench_stack_steps[i];
+        if (!step)
+        {
+            fputs("Internal Error: The step must be at least 1 KB\n", stderr);
+            return MR_ERROR_BAD_COMMAND;
+        }
+
+        bench = (mr_bench_t){.best=0, .total=0, .runs=0};
+        retcode = mr_bench_stack(&bench, step * 1024, size, runs);
+        if (retcode != MR_NOERROR)
+        {
+            fputs("Internal Error: Not enough memory\n", stderr);
+            return retcode;
+        }
+
+        sprintf(name, "%" PRIu32 " KB step", step);
+        mr_bench_print(name, &bench, size);
+
+        if (argc > 3)
+            break;
+    }
+
+#ifndef _WIN32
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    usage.ru_maxrss /= 1024;
+#endif
+    printf("  %-24s %9.1f MB\n", "peak RSS", usage.ru_maxrss / 1024.0);
+#endif
+
+    return MR_NOERROR;
+}
+
+mr_byte_t mr_bench_stack(
+    mr_bench_t *bench, mr_long_t step, mr_long_t size, mr_long_t runs)
+{
+    mr_long_t ptr, i;
+    double start;
+
+    for (; runs; runs--)
+    {
+        start = mr_bench_now();
+        if (mr_stack_init(step, MR_STACK_SCRATCH_SIZE) != MR_NOERROR)
+            return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+        for (i = 0; i != size; i += MR_BENCH_STACK_BLOCK)
+        {
+            if (mr_stack_push(&ptr, MR_BENCH_STACK_BLOCK) != MR_NOERROR)
+            {
+                mr_stack_free();
+                return MR_ERROR_NOT_ENOUGH_MEMORY;
+            }
+
+            memset(_mr_stack.data + ptr, (mr_byte_t)i, MR_BENCH_STACK_BLOCK);
+        }
+
+        mr_stack_free();
+        mr_bench_add(bench, start);
+    }
+
+    return MR_NOERROR;
+}
@@ -83,6 +83,8 @@ copies or substantial portions of the Software.
  * Name of the source file.
  * @var mr_long_t __MR_CONFIG_T::size
  * Size of the source code.
+ * @var mr_byte_t __MR_CONFIG_T::source
+ * Owner of the source code (<em>__MR_CONFIG_SOURCE_ENUM</em>).
 */
 struct __MR_CONFIG_T
 {
@@ -93,9 +95,28 @@ struct __MR_CONFIG_T
     mr_str_ct code;
     mr_str_ct fname;
     mr_long_t size;
+    mr_byte_t source;
 };
 typedef struct __MR_CONFIG_T mr_config_t;
 
+/**
+ * @enum __MR_CONFIG_SOURCE_ENUM
+ * List of owners of the source code.
+ * @var __MR_CONFIG_SOURCE_ENUM::MR_CONFIG_SOURCE_BORROWED
+ * The code belongs to the caller (like a static block), So it's never reallocated or freed. \n
+ * It's the default owner, Since it's zero.
+ * @var __MR_CONFIG_SOURCE_ENUM::MR_CONFIG_SOURCE_HEAP
+ * The code is allocated by <em>mr_mem_malloc(MR_MEM_SOURCE, size + MR_LEXER_MARGIN)</em>, So it can be reallocated (edited).
+ * @var __MR_CONFIG_SOURCE_ENUM::MR_CONFIG_SOURCE_MAPPED
+ * The code is a read-only mapping of the source file (see the \a MR_SOURCE_MMAP build option).
+*/
+enum __MR_CONFIG_SOURCE_ENUM
+{
+    MR_CONFIG_SOURCE_BORROWED,
+    MR_CONFIG_SOURCE_HEAP,
+    MR_CONFIG_SOURCE_MAPPED
+};
+
 /**
  * The \a mr_config_t instant that holds all information about the code and its compilation process.
 */
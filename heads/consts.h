@@ -46,23 +46,46 @@ copies or substantial portions of the Software.
 #define MR_PORT_VERSION_PATCH 0 /**< Current version of MetaReal portal (Patch number) */
 #define MR_PORT "mr-port" /**< MetaReal portal display name*/
 
+#ifdef __MR_WIDE_IDX__
+/**
+ * Maximum supported size of a single source file in characters (wide index). \n
+ * It's limited so that the stack allocation step (see <em>MR_STACK_SIZE_FACTOR</em>) still fits in 32 bits.
+*/
+#define MR_FILE_MAXSIZE ((mr_long_t)0xfffffff)
+#else
 /**
  * Maximum supported size of a single source file in characters
 */
 #define MR_FILE_MAXSIZE ((mr_long_t)0xffffff)
+#endif
+
+/**
+ * Minimum size of a source file that is mapped into memory instead of being read (only with memory mapping enabled). \n
+ * Smaller files are cheaper to read than to map.
+*/
+#define MR_FILE_MAPSIZE ((mr_long_t)0x40000)
 
 /**
  * Factor for figuring out the stack size allocation step. \n
- * Formula: `AllocationStep = SourceCodeSize * MR_STACK_SIZE_FACTOR`
+ * Formula: `AllocationStep = SourceCodeSize * MR_STACK_SIZE_FACTOR` \n
+ * The estimate made from the token counts never passes this size (see the \a mr_parser_stack_size function),
+ * And the pull mode uses this size directly since its tokens aren't counted before parsing.
 */
 #define MR_STACK_SIZE_FACTOR ((mr_byte_t)8)
 
 /**
- * Default size of the stack pointers chunk. \n
- * This number is used to calculate allocation size of the \a ptrs list. \n
- * Formula: `AllocationSize = SourceCodeSize / MR_STACK_PSIZE_CHUNK`
+ * Default size of the stack scratch space in bytes (its size is doubled whenever it's full). \n
+ * The scratch space only holds the lists that are being built, So it doesn't depend on the size of the source code.
 */
-#define MR_STACK_PSIZE_CHUNK ((mr_short_t)256)
+#define MR_STACK_SCRATCH_SIZE ((mr_long_t)1024)
+
+#ifdef __MR_STACK_RESERVE__
+/**
+ * Size of the address range that is reserved for the stack data in bytes (only with stack reservation enabled). \n
+ * Stack data is addressed with 32 bit offsets, So the range covers all of them (aligned to 64 KB pages).
+*/
+#define MR_STACK_RESERVE_SIZE ((mr_long_t)0xffff0000)
+#endif
 
 /* Lexer */
 
@@ -73,69 +96,120 @@ copies or substantial portions of the Software.
 */
 #define MR_LEXER_TOKENS_CHUNK ((mr_byte_t)16)
 
-/* Parser */
+/**
+ * Number of characters that must follow a token before the lexer can complete it. \n
+ * The lexer looks at most 3 characters ahead, So a token that ends closer to the end of the window of the streaming lexer might be incomplete. \n
+ * The same number of null characters is kept after the window (and after a memory-mapped source file).
+*/
+#define MR_LEXER_MARGIN ((mr_long_t)4)
 
 /**
- * Default size of the nodes chunk. \n
- * This number is used to calculate allocation size of the \a nodes list. \n
- * Formula: `AllocationSize = SourceCodeSize / MR_PARSER_NODES_CHUNK`
+ * Default number of characters that the streaming lexer reads from its input at once.
 */
-#define MR_PARSER_NODES_CHUNK ((mr_byte_t)64)
+#define MR_LEXER_STREAM_CHUNK ((mr_long_t)0x10000)
 
 /**
- * Default size of a <em>fstr</em> in nodes.
+ * Minimum size of a chunk that is lexed by a worker thread in the parallel mode. \n
+ * Smaller source codes are lexed by a single thread.
 */
-#define MR_PARSER_FSTR_SIZE ((mr_byte_t)16)
+#define MR_LEXER_PARALLEL_CHUNK ((mr_long_t)0x80000)
 
 /**
- * Default size of a <em>list</em> in nodes.
+ * Maximum number of threads used by the lexer in the parallel mode.
 */
-#define MR_PARSER_LIST_SIZE ((mr_byte_t)16)
+#define MR_LEXER_PARALLEL_THREADS ((mr_byte_t)16)
 
 /**
- * Default size of a <em>tuple</em> in nodes.
+ * Default number of tokens allocated for re-lexing an edited region of the code. \n
+ * The list is doubled whenever it's full, So an edit that changes the rest of the code doesn't grow it linearly.
 */
-#define MR_PARSER_TUPLE_SIZE ((mr_byte_t)8)
+#define MR_LEXER_EDIT_TOKENS ((mr_long_t)64)
 
 /**
- * Default size of a <em>dict</em> in key-values.
+ * Default number of formatted strings that the lexer can keep open at once. \n
+ * The stack of open formatted strings is doubled whenever it's full, So nesting is only limited by memory.
 */
-#define MR_PARSER_DICT_SIZE ((mr_byte_t)8)
+#define MR_LEXER_FSTR_DEPTH ((mr_long_t)8)
 
 /**
- * Default size of a <em>set</em> in nodes.
+ * Number of tokens that the pull-based lexer generates each time its buffer is filled. \n
+ * The buffer only holds a batch (and the tokens of an open formatted string), So it stays in the cache while the parser reads it.
 */
-#define MR_PARSER_SET_SIZE ((mr_byte_t)8)
+#define MR_LEXER_PULL_TOKENS ((mr_long_t)256)
+
+/* Pool */
 
 /**
- * Default size of a <em>function call</em> argument list in call-args.
+ * Default number of slots allocated by a constant pool on its first addition. \n
+ * The hash table of the pool starts with twice as many buckets.
 */
-#define MR_PARSER_FUNC_CALL_SIZE ((mr_byte_t)4)
+#define MR_POOL_CONSTS_SIZE ((mr_long_t)16)
 
 /**
- * Maximum size of a <em>function call</em> argument list in call-args.
+ * Default number of symbols allocated by a symbol pool on its first addition. \n
+ * The hash table of the pool starts with twice as many buckets.
 */
-#define MR_PARSER_FUNC_CALL_MAX ((mr_byte_t)(MR_PARSER_FUNC_CALL_SIZE * 16))
+#define MR_POOL_SYMS_SIZE ((mr_long_t)64)
 
 /**
- * Default size of a <em>dollar method</em> parameter list in nodes.
+ * Default number of characters allocated for the names of a symbol pool on its first addition.
 */
-#define MR_PARSER_DOLLAR_METHOD_SIZE ((mr_byte_t)4)
+#define MR_POOL_NAMES_SIZE ((mr_long_t)512)
 
 /**
- * Maximum size of a <em>dollar method</em> parameter list in nodes.
+ * Default number of strings allocated by a string pool on its first addition. \n
+ * The hash table of the pool starts with twice as many buckets.
 */
-#define MR_PARSER_DOLLAR_METHOD_MAX ((mr_byte_t)(MR_PARSER_DOLLAR_METHOD_SIZE * 4))
+#define MR_POOL_STRS_SIZE ((mr_long_t)64)
 
 /**
- * Default size of an \a import libraries list in indexes.
+ * Default number of characters allocated for the arena of a string pool on its first use.
 */
-#define MR_PARSER_IMPORT_SIZE ((mr_byte_t)2)
+#define MR_POOL_ARENA_SIZE ((mr_long_t)1024)
+
+/**
+ * Default number of references allocated by a pool on its first addition.
+*/
+#define MR_POOL_REFS_SIZE ((mr_long_t)64)
+
+/* Parser */
+
+/**
+ * Default size of the nodes chunk. \n
+ * This number is used to calculate allocation size of the \a nodes list in the pull mode
+ * (otherwise, The size is counted from the tokens, See the \a mr_parser_nodes_size function). \n
+ * Formula: `AllocationSize = SourceCodeSize / MR_PARSER_NODES_CHUNK`
+*/
+#define MR_PARSER_NODES_CHUNK ((mr_byte_t)64)
+
+/**
+ * Maximum size of a <em>function call</em> argument list in call-args.
+*/
+#define MR_PARSER_FUNC_CALL_MAX ((mr_byte_t)64)
+
+/**
+ * Maximum size of a <em>dollar method</em> parameter list in nodes.
+*/
+#define MR_PARSER_DOLLAR_METHOD_MAX ((mr_byte_t)16)
 
 /**
  * Maximum size of an \a import libraries list in indexes.
 */
-#define MR_PARSER_IMPORT_MAX ((mr_byte_t)(MR_PARSER_IMPORT_SIZE * 8))
+#define MR_PARSER_IMPORT_MAX ((mr_byte_t)16)
+
+/**
+ * Default size of the frames stack of the explicit-stack parser (its size is doubled whenever it's full).
+*/
+#define MR_PARSER_STACK_SIZE ((mr_byte_t)32)
+
+/* Error */
+
+/**
+ * Default size of the lines chunk. \n
+ * This number is used to calculate allocation size of the line table. \n
+ * Formula: `AllocationSize = SourceCodeSize / MR_ERROR_LINES_CHUNK`
+*/
+#define MR_ERROR_LINES_CHUNK ((mr_byte_t)32)
 
 /* Generator */
 
@@ -39,6 +39,47 @@ typedef const mr_chr_t *mr_str_ct;
 #define MR_TRUE ((mr_bool_t)1)
 #define MR_FALSE ((mr_bool_t)0)
 
+#ifdef __MR_WIDE_IDX__
+/**
+ * Position of characters in the source code (wide index). \n
+ * An aligned 32 bit integer that lifts the size limit of source files (see <em>MR_FILE_MAXSIZE</em>),
+ * At the cost of one extra byte per index (and the padding of the structures that aren't packed).
+*/
+typedef mr_long_t mr_idx_t;
+
+/**
+ * Invalid index. \n
+ * Used for indicating missing data.
+*/
+#define MR_INVALID_IDX ((mr_idx_t)0xffffffff)
+
+/**
+ * Zero index. \n
+ * Used for lists that have no elements.
+*/
+#define MR_ZERO_IDX ((mr_idx_t)0)
+
+/**
+ * Invalid index converted to a long value.
+*/
+#define MR_INVALID_IDX_CODE ((mr_long_t)0xffffffff)
+
+/**
+ * @def MR_IDX_EXTRACT(idx)
+ * It extracts the index as 32 bit integer.
+ * @param idx
+ * An instance of the \a mr_idx_t data structure
+*/
+#define MR_IDX_EXTRACT(idx) ((mr_long_t)(idx))
+
+/**
+ * @def MR_IDX_DECOMPOSE(idx)
+ * Constructs an index based on the 32 bit <em>idx</em>.
+ * @param idx
+ * Index passed as a 32 bit integer.
+*/
+#define MR_IDX_DECOMPOSE(idx) ((mr_idx_t)(idx))
+#else
 /**
  * @struct __MR_IDX_T
  * A data structure that points to the position of characters in the source code.
@@ -89,6 +130,7 @@ typedef struct __MR_IDX_T mr_idx_t;
  * Index passed as a 32 bit integer.
 */
 #define MR_IDX_DECOMPOSE(idx) ((mr_idx_t){.lidx=(idx) & 0xffff, .hidx=(mr_byte_t)((idx) >> 16)})
+#endif
 
 /* error codes */
 
@@ -96,7 +138,9 @@ typedef struct __MR_IDX_T mr_idx_t;
 #define MR_ERROR_FILE_NOT_FOUND 2
 #define MR_ERROR_NOT_ENOUGH_MEMORY 8
 #define MR_ERROR_BAD_FORMAT 11
+#define MR_ERROR_WRITE_PROTECT 19
 #define MR_ERROR_BAD_COMMAND 22
+#define MR_ERROR_READ_FAULT 30
 #define MR_ERROR_FILE_TOO_LARGE 223
 
 #endif
@@ -23,13 +23,18 @@ copies or substantial portions of the Software.
 #define __MR_ERROR__
 
 #include <lexer/token.h>
+#include <lexer/unicode.h>
 
 /**
  * @struct __MR_ILLEGAL_CHR_T
  * The structure that holds information about illegal or missing characters. \n
  * This structure is used by the lexer.
  * @var mr_chr_t __MR_ILLEGAL_CHR_T::chr
- * The illegal or missing character.
+ * The illegal or missing character, Followed by a null character. \n
+ * A non-ASCII illegal character holds its whole UTF-8 sequence. If the sequence is invalid,
+ * It holds the first character and the continuation bytes after it.
+ * @var mr_byte_t __MR_ILLEGAL_CHR_T::size
+ * Number of characters in the \a chr field.
  * @var mr_bool_t __MR_ILLEGAL_CHR_T::expected
  * It indicates whether the character is illegal (MR_FALSE) or is it missing (MR_TRUE).
  * @var mr_long_t __MR_ILLEGAL_CHR_T::idx
@@ -37,7 +42,8 @@ copies or substantial portions of the Software.
 */
 struct __MR_ILLEGAL_CHR_T
 {
-    mr_chr_t chr;
+    mr_chr_t chr[MR_UNICODE_SEQ_MAX + 1];
+    mr_byte_t size;
     mr_bool_t expected;
 
     mr_long_t idx;
@@ -51,13 +57,13 @@ typedef struct __MR_ILLEGAL_CHR_T mr_illegal_chr_t;
  * @var mr_str_ct __MR_INVALID_SYNTAX_T::detail
  * Details of the error. \n
  * This field will be NULL if the thrown error is a general invalid syntax error.
- * @var mr_token_t* __MR_INVALID_SYNTAX_T::token
- * Pointer to the token that caused the error.
+ * @var mr_token_cursor_t __MR_INVALID_SYNTAX_T::token
+ * Cursor of the token that caused the error.
 */
 struct __MR_INVALID_SYNTAX_T
 {
     mr_str_ct detail;
-    mr_token_t *token;
+    mr_token_cursor_t token;
 };
 typedef struct __MR_INVALID_SYNTAX_T mr_invalid_syntax_t;
 
@@ -68,8 +74,8 @@ typedef struct __MR_INVALID_SYNTAX_T mr_invalid_syntax_t;
  * @var mr_str_t __MR_INVALID_SEMANTIC_T::detail
  * Details of the error. \n
  * This field can be static or dynamic string.
- * @var mr_token_t* __MR_INVALID_SEMANTIC_T::token
- * Pointer to the last token that caused the error.
+ * @var mr_token_cursor_t __MR_INVALID_SEMANTIC_T::token
+ * Cursor of the last token that caused the error.
  * @var mr_bool_t __MR_INVALID_SEMANTIC_T::is_static
  * It determines that the \a detail is dynamic and should be freed or not.
  * @var mr_byte_t __MR_INVALID_SEMANTIC_T::type
@@ -82,7 +88,7 @@ typedef struct __MR_INVALID_SYNTAX_T mr_invalid_syntax_t;
 struct __MR_INVALID_SEMANTIC_T
 {
     mr_str_t detail;
-    mr_token_t *token;
+    mr_token_cursor_t token;
     mr_bool_t is_static : 1;
     mr_byte_t type : 7;
 
@@ -109,6 +115,55 @@ enum __MR_INVALID_SEMANTIC_ENUM
     MR_INVALID_SEMANTIC_DOLLAR_METHOD
 };
 
+/**
+ * @struct __MR_ERROR_LINES_T
+ * Line table of the source code. \n
+ * It's built on the first line query and reused by the next ones, So every query is a binary search instead of a pass over the code.
+ * @var mr_long_t* __MR_ERROR_LINES_T::data
+ * Starting index of every line except the first one (in ascending order).
+ * @var mr_long_t __MR_ERROR_LINES_T::size
+ * Number of lines in the table (number of newlines in the code).
+ * @var mr_long_t __MR_ERROR_LINES_T::alloc
+ * Allocated size for the table.
+ * @var mr_str_ct __MR_ERROR_LINES_T::code
+ * The code that the table is built for (NULL if the table isn't built).
+ * @var mr_long_t __MR_ERROR_LINES_T::csize
+ * Size of the code that the table is built for.
+*/
+struct __MR_ERROR_LINES_T
+{
+    mr_long_t *data;
+    mr_long_t size;
+    mr_long_t alloc;
+
+    mr_str_ct code;
+    mr_long_t csize;
+};
+typedef struct __MR_ERROR_LINES_T mr_error_lines_t;
+
+/**
+ * Line table of <em>_mr_config.code</em>. \n
+ * It's rebuilt whenever the code pointer or size changes. Changes that keep both must call the \a mr_error_lines_free function.
+*/
+extern mr_error_lines_t _mr_error_lines;
+
+/**
+ * It finds the line of a character in <em>_mr_config.code</em> (builds the line table on the first call).
+ * @param idx
+ * Index of the character.
+ * @param start
+ * Pointer to store the starting index of the line (the first line starts after the byte order mark, If the code has one).
+ * @return It returns the line number (starting from 1).
+*/
+mr_long_t mr_error_line(
+    mr_long_t idx, mr_long_t *start);
+
+/**
+ * It frees the line table. \n
+ * The table is rebuilt on the next line query.
+*/
+void mr_error_lines_free(void);
+
 /**
  * It displays an illegal character error in <em>errstream</em>. \n
  * Example of an illegal character error:
@@ -118,6 +173,11 @@ enum __MR_INVALID_SEMANTIC_ENUM
  * a += 4 * 3 @
  *            ^
  * </pre>
+ * Non-ASCII characters are displayed with their code points, And characters that aren't valid UTF-8 are displayed by their values:
+ * <pre>
+ * Illegal Character Error: '€' (U+20AC)
+ * Illegal Character Error: Invalid UTF-8 sequence \\xE2\\x82
+ * </pre>
  * Example of an expected character error:
  * <pre>
  * Expected Character Error: '"'
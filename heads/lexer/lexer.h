@@ -24,6 +24,7 @@ copies or substantial portions of the Software.
 #define __MR_LEXER__
 
 #include <error/error.h>
+#include <stdio.h>
 
 /**
  * @struct __MR_LEXER_T
@@ -32,14 +33,104 @@ copies or substantial portions of the Software.
  * List of tokens generated by the lexer.
  * @var mr_illegal_chr_t __MR_LEXER_T::error
  * Illegal character error.
+ * @var mr_long_t __MR_LEXER_T::size
+ * Number of tokens in the \a tokens list (without the <em>MR_TOKEN_EOF</em> token).
+ * @var mr_long_t* __MR_LEXER_T::fstrs
+ * Indices of the first and the last token of every outermost formatted string, In pairs. \n
+ * It's built by the first \a mr_lexer_edit call and kept up to date by the next ones (NULL before that). It must be freed by the caller.
+ * @var mr_long_t __MR_LEXER_T::fsize
+ * Number of the formatted strings in the \a fstrs list.
+ * @var mr_idx_t* __MR_LEXER_T::ends
+ * Ending index of each token (only available with token spans enabled). \n
+ * It is stored right after the \a tokens list in the same memory block, So freeing the \a tokens list frees it too.
 */
 struct __MR_LEXER_T
 {
     mr_token_t *tokens;
     mr_illegal_chr_t error;
+    mr_long_t size;
+
+    mr_long_t *fstrs;
+    mr_long_t fsize;
+
+#ifdef __MR_TOKEN_SPANS__
+    mr_idx_t *ends;
+#endif
 };
 typedef struct __MR_LEXER_T mr_lexer_t;
 
+/**
+ * @struct __MR_LEXER_BATCH_T
+ * A batch of tokens that the \a mr_lexer_stream function hands over to its consumer. \n
+ * Indices of the tokens are relative to the \a code window. The last batch ends with a <em>MR_TOKEN_EOF</em> token. \n
+ * A batch is handed over whenever characters are dropped from the window, So it can be empty.
+ * @var mr_token_t* __MR_LEXER_BATCH_T::tokens
+ * List of tokens in the batch.
+ * @var mr_long_t __MR_LEXER_BATCH_T::size
+ * Number of tokens in the batch.
+ * @var mr_str_ct __MR_LEXER_BATCH_T::code
+ * The window of the source code that tokens are pointing to (also accessible through <em>_mr_config.code</em>). \n
+ * It's only valid during the consumer call.
+ * @var mr_long_t __MR_LEXER_BATCH_T::base
+ * Index of the first character of the window in the whole input.
+ * @var mr_long_t __MR_LEXER_BATCH_T::release
+ * Number of characters (from the beginning of the window) that are dropped after the batch. \n
+ * These characters never appear in the later batches.
+ * @var mr_idx_t* __MR_LEXER_BATCH_T::ends
+ * Ending index of each token (only available with token spans enabled).
+*/
+struct __MR_LEXER_BATCH_T
+{
+    mr_token_t *tokens;
+    mr_long_t size;
+
+    mr_str_ct code;
+    mr_long_t base;
+    mr_long_t release;
+
+#ifdef __MR_TOKEN_SPANS__
+    mr_idx_t *ends;
+#endif
+};
+typedef struct __MR_LEXER_BATCH_T mr_lexer_batch_t;
+
+/**
+ * @struct __MR_LEXER_STREAM_T
+ * Input and result of the \a mr_lexer_stream function.
+ * @var FILE* __MR_LEXER_STREAM_T::file
+ * The stream that code is read from (a file, a pipe, or the standard input).
+ * @var mr_long_t __MR_LEXER_STREAM_T::chunk
+ * Number of characters read from the \a file at once (must be nonzero).
+ * @var __MR_LEXER_STREAM_T::consumer
+ * The function that receives token batches. \n
+ * If it returns anything other than <em>MR_NOERROR</em>, the process stops and its code is returned. \n
+ * If the consumer is NULL, the whole code and tokens list are kept (like the \a mr_lexer function).
+ * @var mr_ptr_t __MR_LEXER_STREAM_T::arg
+ * Argument passed to the \a consumer function.
+ * @var mr_lexer_t __MR_LEXER_STREAM_T::lexer
+ * Result of the lexer process. The tokens list is only set if the \a consumer is NULL.
+ * @var mr_str_t __MR_LEXER_STREAM_T::code
+ * The whole code if the \a consumer is NULL, The unreleased window of the code (up to the end of the line of the error) if an illegal character is found, And NULL otherwise. \n
+ * It must be freed by the caller.
+ * @var mr_long_t __MR_LEXER_STREAM_T::size
+ * Size of the \a code.
+ * @var mr_long_t __MR_LEXER_STREAM_T::base
+ * Index of the first character of the \a code in the whole input.
+*/
+struct __MR_LEXER_STREAM_T
+{
+    FILE *file;
+    mr_long_t chunk;
+    mr_byte_t (*consumer)(mr_ptr_t arg, mr_lexer_batch_t *batch);
+    mr_ptr_t arg;
+
+    mr_lexer_t lexer;
+    mr_str_t code;
+    mr_long_t size;
+    mr_long_t base;
+};
+typedef struct __MR_LEXER_STREAM_T mr_lexer_stream_t;
+
 /**
  * It creates a list of tokens based on contents of the code. \n
  * If there is an illegal character in the source code or a character is missing, the function returns an error.
@@ -51,4 +142,111 @@ typedef struct __MR_LEXER_T mr_lexer_t;
 mr_byte_t mr_lexer(
     mr_lexer_t *res);
 
+/**
+ * It creates the tokens while reading the code from a stream chunk by chunk. \n
+ * Tokens are handed over to the consumer in batches, So only a window of the code and its tokens are kept in memory. \n
+ * A token that reaches the end of the window (including strings, formatted strings, and comments) is lexed again after the next chunk is read. \n
+ * The last token of each batch is held back until the next batch, Because the semicolons and newlines after it can still change it. \n
+ * During the process, <em>_mr_config.code</em> and <em>_mr_config.size</em> refer to the window.
+ * After it, they refer to the \a code field of <em>res</em>.
+ * @param res
+ * Input and result of the lexer process. Error index is relative to the whole input.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns the error code (defined in \a defs.h header file).
+*/
+mr_byte_t mr_lexer_stream(
+    mr_lexer_stream_t *res);
+
+/**
+ * It replaces a part of the code and updates the result of a previous lexer call without lexing the whole code again. \n
+ * Lexing restarts from the last token that the edit can't affect (outside of formatted strings),
+ * And stops as soon as a new token matches an old token after the edit. Tokens before the restart point are kept,
+ * And indices of the tokens after the matching token (and references of the pools) are moved by the size difference. \n
+ * <em>_mr_config.code</em> must be allocated by <em>mr_mem_malloc(MR_MEM_SOURCE, size + MR_LEXER_MARGIN)</em>
+ * (with the margin filled with null characters), Since it's reallocated by \a mr_mem_realloc if the code grows.
+ * So <em>_mr_config.source</em> must be <em>MR_CONFIG_SOURCE_HEAP</em>. Mapped source files and blocks that belong to the caller can't be edited.
+ * @param res
+ * Result of a successful \a mr_lexer call on the current code (or a previous \a mr_lexer_edit call).
+ * It's updated in place. If the new code has an illegal character, It contains the error and the \a tokens and \a fstrs lists are freed.
+ * @param start
+ * Index of the first replaced character.
+ * @param end
+ * Index of the first character after the replaced ones.
+ * @param text
+ * The new characters.
+ * @param size
+ * Number of the new characters.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns the error code (defined in \a defs.h header file). \n
+ * If the code can't be edited (<em>MR_ERROR_WRITE_PROTECT</em>), the new code is too large, or its memory can't be allocated, Nothing is changed.
+ * Otherwise, the code is edited and the \a tokens and \a fstrs lists and the pools are freed on failure (like a failed \a mr_lexer call).
+*/
+mr_byte_t mr_lexer_edit(
+    mr_lexer_t *res, mr_long_t start, mr_long_t end, mr_str_ct text, mr_long_t size);
+
+#ifdef __MR_LEXER_PARALLEL__
+/**
+ * It splits the code into chunks, lexes them on worker threads, and stitches their tokens together (only available with parallel lexing enabled). \n
+ * The \a mr_lexer function calls it for codes of at least two <em>MR_LEXER_PARALLEL_CHUNK</em> characters.
+ * Calling it directly splits smaller codes too (at newlines), Which is how the seams between chunks are tested.
+ * @param res
+ * Result of the lexer process (it contains both error details and tokens list).
+ * @param count
+ * Number of threads (at most <em>MR_LEXER_PARALLEL_THREADS</em>).
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns the error code (defined in \a defs.h header file).
+*/
+mr_byte_t mr_lexer_parallel(
+    mr_lexer_t *res, mr_byte_t count);
+#endif
+
+#ifdef __MR_TOKEN_PULL__
+/**
+ * It prepares the lexer for generating tokens on demand and points the cursor to the first token (only available with pull-based lexing enabled). \n
+ * Tokens are generated in batches of <em>MR_LEXER_PULL_TOKENS</em> while the cursor moves, So the tokens list is never created. \n
+ * If the lexer finds an illegal character, The cursor reaches a <em>MR_TOKEN_EOF</em> token there.
+ * The error is reported by the \a mr_lexer_pull_finish function.
+ * @param tokens
+ * The cursor.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em>.
+*/
+mr_byte_t mr_lexer_pull_init(
+    mr_token_cursor_t *tokens);
+
+/**
+ * It drops the tokens before the cursor and fills the buffer with the next batch of tokens. \n
+ * This function is called by the \a mr_token_cursor_next macro.
+ * @param tokens
+ * The cursor.
+*/
+void mr_lexer_pull(
+    mr_token_cursor_t *tokens);
+
+/**
+ * It returns size of the current token of a cursor in characters. \n
+ * The size is always computed from the source code (even with token spans enabled), Since the buffer of the lexer may be gone. \n
+ * A formatted string is lexed again to find its end, Since its tokens are not kept.
+ * @param cur
+ * Pointer to the cursor.
+ * @return Size of the token in characters.
+*/
+mr_long_t mr_lexer_pull_getsize(
+    const mr_token_cursor_t *cur);
+
+/**
+ * It lexes the rest of the code and frees the state of the lexer. \n
+ * If the process was successful, The pools are moved into <em>_mr_pool_consts</em>, <em>_mr_pool_syms</em>, and <em>_mr_pool_strs</em>.
+ * Errors of the lexer are reported here, So they take precedence over the errors that the parser found in the same code.
+ * @param res
+ * Result of the lexer process (only the error details are set).
+ * @param tokens
+ * The cursor (or any copy of it, Only the state of the lexer is used).
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns the error code (defined in \a defs.h header file).
+*/
+mr_byte_t mr_lexer_pull_finish(
+    mr_lexer_t *res, mr_token_cursor_t *tokens);
+#endif
+
 #endif
@@ -0,0 +1,66 @@
+/*
+MIT License
+
+Copyright (c) 2023 MetaReal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+*/
+
+/**
+ * @file scan.h
+ * This file contains the scanning subroutines that the lexer uses for skipping long runs of characters
+ * (indentations, singleline comments, and multiline comments) and for validating the code as UTF-8. \n
+ * Every subroutine has a scalar, an SSE2, and an AVX2 version. The fastest version supported by the CPU is selected at runtime. \n
+ * All things defined in \a scan.c and this file have the \a mr_scan prefix.
+*/
+
+#ifndef __MR_SCAN__
+#define __MR_SCAN__
+
+#include <defs.h>
+
+/**
+ * @struct __MR_SCAN_T
+ * The structure that holds the selected version of the scanning subroutines. \n
+ * All subroutines take the source code, the starting index, and the ending index of the code (index of the null terminator). \n
+ * The code must be terminated with a '\\0' character at the ending index
+ * (the \a utf8 subroutine also accepts a smaller ending index, But the code must still be null-terminated after it).
+ * @var __MR_SCAN_T::spaces
+ * It returns index of the first character (starting from <em>idx</em>) that is not ' ', '\\t', or '\\r'.
+ * @var __MR_SCAN_T::line
+ * It returns index of the first '\\n' or '\\0' character (starting from <em>idx</em>).
+ * @var __MR_SCAN_T::comment
+ * It returns index of the first "*#" sequence or '\\0' character (starting from <em>idx</em>).
+ * @var __MR_SCAN_T::utf8
+ * It returns index of the first character (starting from <em>idx</em>) that is not a part of a valid UTF-8 sequence, Or the ending index if there is none. \n
+ * A sequence that crosses the ending index is invalid.
+*/
+struct __MR_SCAN_T
+{
+    mr_long_t (*spaces)(mr_str_ct code, mr_long_t idx, mr_long_t end);
+    mr_long_t (*line)(mr_str_ct code, mr_long_t idx, mr_long_t end);
+    mr_long_t (*comment)(mr_str_ct code, mr_long_t idx, mr_long_t end);
+    mr_long_t (*utf8)(mr_str_ct code, mr_long_t idx, mr_long_t end);
+};
+typedef struct __MR_SCAN_T mr_scan_t;
+
+/**
+ * The \a mr_scan_t instance that holds the selected scanning subroutines. \n
+ * It holds the scalar versions until the \a mr_scan_init function is called.
+*/
+extern mr_scan_t _mr_scan;
+
+/**
+ * It detects the instruction sets supported by the CPU and selects the fastest scanning subroutines.
+*/
+void mr_scan_init(void);
+
+#endif
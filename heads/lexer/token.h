@@ -492,7 +492,65 @@ extern mr_byte_t mr_token_type_size[MR_TOKEN_TYPE_COUNT];
 extern mr_byte_t mr_token_symbol_size[MR_TOKEN_KEYWORD_PAD];
 
 /**
- * It returns size of the token in characters.
+ * Size of the keyword and type hash table. \n
+ * Used by the identifier classification subroutine.
+*/
+#define MR_TOKEN_IDENT_SIZE ((mr_byte_t)128)
+
+/**
+ * Minimum size of a keyword or a type (<em>is</em>, <em>in</em>, <em>or</em>, <em>if</em>, <em>to</em>, and <em>do</em>).
+*/
+#define MR_TOKEN_IDENT_MINSIZE ((mr_byte_t)2)
+
+/**
+ * @def mr_token_ident_hash(str, size)
+ * It hashes an identifier into the \a mr_token_ident table. \n
+ * The hash is built from the first two characters, the last character, and size of the identifier. \n
+ * It is perfect over keywords and types, So every keyword and type has its own slot.
+ * @param str
+ * Starting point of the identifier.
+ * @param size
+ * Size of the identifier (at least <em>MR_TOKEN_IDENT_MINSIZE</em>).
+ * @return It returns index of the identifier in the \a mr_token_ident table.
+*/
+#define mr_token_ident_hash(str, size)                                                   \
+    ((mr_byte_t)((((mr_long_t)(mr_byte_t)(str)[0] | (mr_long_t)(mr_byte_t)(str)[1] << 8 | \
+    (mr_long_t)(mr_byte_t)(str)[(size) - 1] << 16 | (mr_long_t)(size) << 24) * 0x4a7e688fu) >> 25))
+
+/**
+ * Keyword and type hash table (indexed by the \a mr_token_ident_hash macro). \n
+ * Every slot holds the token type of a keyword or a type, Or <em>MR_TOKEN_EOF</em> if the slot is empty.
+*/
+extern mr_byte_t mr_token_ident[MR_TOKEN_IDENT_SIZE];
+
+#ifdef __MR_TOKEN_SPANS__
+
+/**
+ * @struct __MR_TOKEN_SPANS_T
+ * Token spans recorded by the lexer (only available with token spans enabled).
+ * @var mr_token_t* __MR_TOKEN_SPANS_T::tokens
+ * List of tokens generated by the lexer.
+ * @var mr_idx_t* __MR_TOKEN_SPANS_T::ends
+ * Ending index of each token (index of the first character after the token).
+*/
+struct __MR_TOKEN_SPANS_T
+{
+    mr_token_t *tokens;
+    mr_idx_t *ends;
+};
+typedef struct __MR_TOKEN_SPANS_T mr_token_spans_t;
+
+/**
+ * Spans of the tokens generated by the last \a mr_lexer call. \n
+ * Used by the \a mr_token_getsize function to look up sizes without rescanning the code.
+*/
+extern mr_token_spans_t _mr_token_spans;
+
+#endif
+
+/**
+ * It returns size of the token in characters. \n
+ * With token spans enabled, the size is looked up from the \a _mr_token_spans (the token must be a member of its list).
  * @param token
  * Pointer to the token with the needed data.
  * @return Size of the token in characters.
@@ -511,13 +569,215 @@ mr_long_t mr_token_getsize(
 mr_long_t mr_token_getsize2(
     mr_byte_t type, mr_long_t idx);
 
-#ifdef __MR_DEBUG__
+/**
+ * It counts the tokens of each type. \n
+ * The counts are used for sizing the lists of the parser and the stack before parsing.
+ * @param counts
+ * Number of tokens of each type (<em>MR_TOKEN_COUNT</em> elements, all zero).
+ * @param tokens
+ * The tokens list (terminated by the <em>MR_TOKEN_EOF</em> token).
+*/
+void mr_token_histogram(
+    mr_long_t *counts, const mr_token_t *tokens);
+
+#if defined(__MR_TOKEN_PULL__)
+
+/**
+ * @struct __MR_TOKEN_CURSOR_T
+ * Position in the tokens that the lexer generates on demand (only available with pull-based lexing enabled). \n
+ * The lexer keeps a small buffer of tokens and fills it again whenever the cursor reaches its end,
+ * So the tokens are never stored all at once. \n
+ * The cursor holds the current token, So a copy of it can be read after the buffer has moved on.
+ * @var mr_token_t* __MR_TOKEN_CURSOR_T::next
+ * The next token in the buffer.
+ * @var mr_token_t* __MR_TOKEN_CURSOR_T::end
+ * The first token of the buffer that the lexer can still change.
+ * @var mr_ptr_t __MR_TOKEN_CURSOR_T::src
+ * State of the lexer (created by the \a mr_lexer_pull_init function).
+ * @var mr_idx_t __MR_TOKEN_CURSOR_T::idx
+ * Starting index of the current token.
+ * @var mr_byte_t __MR_TOKEN_CURSOR_T::type
+ * Type of the current token.
+ * @var mr_byte_t __MR_TOKEN_CURSOR_T::prev
+ * Type of the previous token (<em>MR_TOKEN_EOF</em> for the first token).
+*/
+struct __MR_TOKEN_CURSOR_T
+{
+    mr_token_t *next;
+    mr_token_t *end;
+    mr_ptr_t src;
+
+    mr_idx_t idx;
+    mr_byte_t type;
+    mr_byte_t prev;
+};
+typedef struct __MR_TOKEN_CURSOR_T mr_token_cursor_t;
+
+/**
+ * @def mr_token_cursor_init(cur, tokens)
+ * It points the cursor to the first token of a complete list of tokens (ended with a <em>MR_TOKEN_EOF</em> token). \n
+ * The buffer of the cursor never ends, So the lexer is not pulled.
+ * @param cur
+ * Pointer to the cursor.
+ * @param tokens
+ * The list of tokens.
+*/
+#define mr_token_cursor_init(cur, tokens)                                 \
+    (*(cur) = (mr_token_cursor_t){.next=(tokens) + 1, .end=NULL, .src=NULL, \
+        .idx=(tokens)->idx, .type=(tokens)->type, .prev=MR_TOKEN_EOF})
+
+#define mr_token_cursor_type(cur) ((cur)->type) /**< Type of the current token */
+#define mr_token_cursor_idx(cur) ((cur)->idx) /**< Starting index of the current token (as a <em>mr_idx_t</em>) */
+#define mr_token_cursor_peek(cur) ((cur)->next->type) /**< Type of the next token (the current token must not be <em>MR_TOKEN_EOF</em>) */
+#define mr_token_cursor_prev(cur) ((cur)->prev) /**< Type of the previous token */
+
+/**
+ * @def mr_token_cursor_next(cur)
+ * It moves the cursor to the next token (the current token must not be <em>MR_TOKEN_EOF</em>). \n
+ * The buffer is filled by the \a mr_lexer_pull function when the cursor reaches its end (declared in \a lexer.h header file).
+*/
+#define mr_token_cursor_next(cur)                                       \
+    ((cur)->prev = (cur)->type, (cur)->type = (cur)->next->type,        \
+    (cur)->idx = (cur)->next->idx,                                      \
+    ++(cur)->next == (cur)->end ? mr_lexer_pull(cur) : (void)0)
+
+/**
+ * @def mr_token_cursor_getsize(cur)
+ * Size of the current token in characters (computed from the code by the \a mr_lexer_pull_getsize function).
+*/
+#define mr_token_cursor_getsize(cur) mr_lexer_pull_getsize(cur)
+
+#elif defined(__MR_TOKEN_COMPACT__)
+
+/**
+ * @struct __MR_TOKEN_CURSOR_T
+ * Position in a compact token stream (only available with compact token streams enabled). \n
+ * Every token of the stream is encoded as its type followed by the distance from the starting index of the previous token
+ * (7 bits per character, the high bit is set on all characters except the last one). \n
+ * The cursor holds the decoded current token, So reading it doesn't decode anything.
+ * @var const mr_byte_t* __MR_TOKEN_CURSOR_T::data
+ * Encoding of the next token.
+ * @var mr_long_t __MR_TOKEN_CURSOR_T::idx
+ * Starting index of the current token.
+ * @var mr_byte_t __MR_TOKEN_CURSOR_T::type
+ * Type of the current token.
+ * @var mr_byte_t __MR_TOKEN_CURSOR_T::prev
+ * Type of the previous token (<em>MR_TOKEN_EOF</em> for the first token).
+*/
+struct __MR_TOKEN_CURSOR_T
+{
+    const mr_byte_t *data;
+    mr_long_t idx;
+    mr_byte_t type;
+    mr_byte_t prev;
+};
+typedef struct __MR_TOKEN_CURSOR_T mr_token_cursor_t;
+
+/**
+ * @def mr_token_cursor_init(cur, tokens)
+ * It points the cursor to the first token of a compact token stream.
+ * @param cur
+ * Pointer to the cursor.
+ * @param tokens
+ * The compact token stream (generated by the \a mr_token_compact function).
+*/
+#define mr_token_cursor_init(cur, tokens) \
+    ((cur)->data = (tokens), (cur)->idx = 0, (cur)->type = MR_TOKEN_EOF, mr_token_cursor_next(cur))
+
+/**
+ * @def mr_token_cursor_type(cur)
+ * Type of the current token.
+*/
+#define mr_token_cursor_type(cur) ((cur)->type)
+
+/**
+ * @def mr_token_cursor_idx(cur)
+ * Starting index of the current token (as a <em>mr_idx_t</em>).
+*/
+#define mr_token_cursor_idx(cur) MR_IDX_DECOMPOSE((cur)->idx)
+
+/**
+ * @def mr_token_cursor_peek(cur)
+ * Type of the next token (the current token must not be <em>MR_TOKEN_EOF</em>).
+*/
+#define mr_token_cursor_peek(cur) (*(cur)->data)
+
+/**
+ * @def mr_token_cursor_prev(cur)
+ * Type of the previous token.
+*/
+#define mr_token_cursor_prev(cur) ((cur)->prev)
+
+/**
+ * @def mr_token_cursor_next(cur)
+ * It moves the cursor to the next token (the current token must not be <em>MR_TOKEN_EOF</em>). \n
+ * Distances that fit in a single character are decoded inline and the rest are decoded by the \a mr_token_cursor_decode function.
+*/
+#define mr_token_cursor_next(cur)                                          \
+    ((cur)->prev = (cur)->type, (cur)->type = *(cur)->data,                \
+    (cur)->data[1] & 0x80 ? mr_token_cursor_decode(cur) :                  \
+    (void)((cur)->idx += (cur)->data[1], (cur)->data += 2))
+
+/**
+ * It converts a list of tokens into a compact token stream. \n
+ * Tokens are in ascending order of their indices, So most distances fit in a single character.
+ * @param res
+ * It receives the compact token stream (must be freed by the caller).
+ * @param tokens
+ * The list of tokens (ended with a <em>MR_TOKEN_EOF</em> token).
+ * @param size
+ * Number of tokens in the list (without the <em>MR_TOKEN_EOF</em> token).
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, It returns <em>MR_NOERROR</em>. \n
+ * If the function failed to allocate the stream, It returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em>.
+*/
+mr_byte_t mr_token_compact(
+    mr_byte_t **res, const mr_token_t *tokens, mr_long_t size);
+
+/**
+ * It decodes a distance that doesn't fit in a single character and moves the cursor to the next token. \n
+ * Used by the \a mr_token_cursor_next macro.
+ * @param cur
+ * Pointer to the cursor (its \a data must point to the distance).
+*/
+void mr_token_cursor_decode(
+    mr_token_cursor_t *cur);
+
+/**
+ * It returns size of the current token of a cursor in characters. \n
+ * Sizes are always computed from the code, So token spans are not used.
+ * @param cur
+ * Pointer to the cursor.
+ * @return Size of the token in characters.
+*/
+mr_long_t mr_token_cursor_getsize(
+    const mr_token_cursor_t *cur);
+
+#else
+
+/**
+ * Position in a list of tokens. \n
+ * The parser reads tokens through the cursor macros, So it works with both the flat tokens list and the compact token stream.
+*/
+typedef mr_token_t *mr_token_cursor_t;
+
+#define mr_token_cursor_init(cur, tokens) (*(cur) = (tokens)) /**< It points the cursor to the first token of a list */
+#define mr_token_cursor_type(cur) ((*(cur))->type) /**< Type of the current token */
+#define mr_token_cursor_idx(cur) ((*(cur))->idx) /**< Starting index of the current token (as a <em>mr_idx_t</em>) */
+#define mr_token_cursor_peek(cur) ((*(cur))[1].type) /**< Type of the next token */
+#define mr_token_cursor_prev(cur) ((*(cur))[-1].type) /**< Type of the previous token */
+#define mr_token_cursor_next(cur) ((void)++*(cur)) /**< It moves the cursor to the next token */
+#define mr_token_cursor_getsize(cur) mr_token_getsize(*(cur)) /**< Size of the current token in characters */
+
+#endif
 
 /**
  * Number of valid tokens.
 */
 #define MR_TOKEN_COUNT ((mr_byte_t)(MR_TOKEN_TYPE_T + 1))
 
+#ifdef __MR_DEBUG__
+
 /**
  * Labels for different token types.
 */
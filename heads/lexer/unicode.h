@@ -0,0 +1,98 @@
+/*
+MIT License
+
+Copyright (c) 2023 MetaReal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+*/
+
+/**
+ * @file unicode.h
+ * This file contains the UTF-8 decoder and the Unicode character properties that the lexer uses for identifiers. \n
+ * Identifiers follow the Unicode identifier syntax (UAX #31): They start with an XID_Start character or '_',
+ * And continue with XID_Continue characters. \n
+ * All things defined in \a unicode.c and this file have the \a mr_unicode prefix.
+*/
+
+#ifndef __MR_UNICODE__
+#define __MR_UNICODE__
+
+#include <defs.h>
+
+/**
+ * The value returned by the \a mr_unicode_decode function for an invalid UTF-8 sequence.
+*/
+#define MR_UNICODE_INVALID ((mr_long_t)0xffffffff)
+
+/**
+ * Maximum number of characters of a UTF-8 sequence.
+*/
+#define MR_UNICODE_SEQ_MAX 4
+
+/**
+ * Number of characters of the UTF-8 byte order mark (U+FEFF).
+*/
+#define MR_UNICODE_BOM_SIZE 3
+
+/**
+ * @def mr_unicode_bom(str)
+ * It checks whether the \a str starts with the UTF-8 byte order mark (U+FEFF). \n
+ * The check stops at the first character that doesn't match, So a null-terminated string is never overread.
+ * @param str
+ * The string.
+*/
+#define mr_unicode_bom(str) \
+    ((mr_byte_t)(str)[0] == 0xef && (mr_byte_t)(str)[1] == 0xbb && (mr_byte_t)(str)[2] == 0xbf)
+
+/**
+ * It decodes a single UTF-8 sequence. \n
+ * Overlong sequences, surrogates, and code points above U+10FFFF are invalid (RFC 3629). \n
+ * The sequence ends at the first character that is not a continuation byte, So a null-terminated string is never overread.
+ * @param str
+ * The first character of the sequence.
+ * @param size
+ * It receives the number of characters of the sequence (1 if the sequence is invalid).
+ * @return It returns the code point, Or <em>MR_UNICODE_INVALID</em> if the sequence is invalid.
+*/
+mr_long_t mr_unicode_decode(
+    mr_str_ct str, mr_byte_t *size);
+
+/**
+ * It checks whether a non-ASCII code point can start an identifier (XID_Start).
+ * @param chr
+ * The code point.
+ * @return It returns <em>MR_TRUE</em> if the code point can start an identifier, And <em>MR_FALSE</em> otherwise.
+*/
+mr_bool_t mr_unicode_xid_start(
+    mr_long_t chr);
+
+/**
+ * It checks whether a non-ASCII code point can continue an identifier (XID_Continue).
+ * @param chr
+ * The code point.
+ * @return It returns <em>MR_TRUE</em> if the code point can continue an identifier, And <em>MR_FALSE</em> otherwise.
+*/
+mr_bool_t mr_unicode_xid_continue(
+    mr_long_t chr);
+
+/**
+ * It finds the end of an identifier that may contain non-ASCII characters. \n
+ * All characters are matched against the XID_Continue property, So the first character must be checked by the caller.
+ * @param code
+ * The null-terminated code.
+ * @param idx
+ * Index of the first character of the identifier.
+ * @return It returns index of the first character after the identifier.
+*/
+mr_long_t mr_unicode_ident_end(
+    mr_str_ct code, mr_long_t idx);
+
+#endif
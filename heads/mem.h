@@ -0,0 +1,236 @@
+/*
+MIT License
+
+Copyright (c) 2023 MetaReal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+*/
+
+/**
+ * @file mem.h
+ * This file contains the memory accounting of the compiler. \n
+ * All heap allocations of the compiler go through the functions of this file,
+ * So the memory used by each phase of the compilation can be reported (see the \--mem-stats option). \n
+ * Memory that is mapped instead of allocated (mapped source files and the reserved stack) isn't counted. \n
+ * All things defined in \a mem.c and this file have the \a mr_mem prefix.
+*/
+
+#ifndef __MR_MEM__
+#define __MR_MEM__
+
+#include <defs.h>
+#include <stdio.h>
+
+/**
+ * @enum __MR_MEM_PHASE_ENUM
+ * List of the compilation phases that own the allocations.
+ * @var __MR_MEM_PHASE_ENUM::MR_MEM_SOURCE
+ * The source code buffer and its lines table.
+ * @var __MR_MEM_PHASE_ENUM::MR_MEM_LEXER
+ * The tokens list, The constant pools, And the temporary data of the lexer.
+ * @var __MR_MEM_PHASE_ENUM::MR_MEM_PARSER
+ * The nodes list and the frames of the parser.
+ * @var __MR_MEM_PHASE_ENUM::MR_MEM_STACK
+ * The stack data and its scratch space (see \a stack.h).
+ * @var __MR_MEM_PHASE_ENUM::MR_MEM_PHASES
+ * Number of the phases.
+*/
+enum __MR_MEM_PHASE_ENUM
+{
+    MR_MEM_SOURCE,
+    MR_MEM_LEXER,
+    MR_MEM_PARSER,
+    MR_MEM_STACK,
+
+    MR_MEM_PHASES
+};
+
+/**
+ * @enum __MR_MEM_REPORT_ENUM
+ * List of the memory report formats.
+ * @var __MR_MEM_REPORT_ENUM::MR_MEM_REPORT_NONE
+ * No report.
+ * @var __MR_MEM_REPORT_ENUM::MR_MEM_REPORT_TEXT
+ * Human-readable table.
+ * @var __MR_MEM_REPORT_ENUM::MR_MEM_REPORT_JSON
+ * Single JSON object.
+*/
+enum __MR_MEM_REPORT_ENUM
+{
+    MR_MEM_REPORT_NONE,
+    MR_MEM_REPORT_TEXT,
+    MR_MEM_REPORT_JSON
+};
+
+/**
+ * @struct __MR_MEM_STAT_T
+ * Memory statistics of a single phase.
+ * @var size_t __MR_MEM_STAT_T::size
+ * Number of bytes that are currently allocated.
+ * @var size_t __MR_MEM_STAT_T::peak
+ * Maximum of the \a size field.
+ * @var size_t __MR_MEM_STAT_T::unused
+ * Capacity that the phase allocated but didn't use, As reported by the phase when it finished (see <em>mr_mem_unused</em>).
+ * @var mr_long_t __MR_MEM_STAT_T::allocs
+ * Number of allocations.
+ * @var mr_long_t __MR_MEM_STAT_T::reallocs
+ * Number of reallocations.
+ * @var mr_long_t __MR_MEM_STAT_T::frees
+ * Number of deallocations.
+*/
+struct __MR_MEM_STAT_T
+{
+    size_t size;
+    size_t peak;
+    size_t unused;
+
+    mr_long_t allocs;
+    mr_long_t reallocs;
+    mr_long_t frees;
+};
+typedef struct __MR_MEM_STAT_T mr_mem_stat_t;
+
+/**
+ * @struct __MR_MEM_T
+ * The structure that holds memory statistics of the compiler.
+ * @var mr_mem_stat_t __MR_MEM_T::stats
+ * Statistics of each phase.
+ * @var size_t __MR_MEM_T::size
+ * Number of bytes that are currently allocated by all phases.
+ * @var size_t __MR_MEM_T::peak
+ * Maximum of the \a size field.
+ * @var size_t __MR_MEM_T::fsize
+ * Size of the last allocation that failed.
+ * @var mr_byte_t __MR_MEM_T::failed
+ * Phase of the last allocation that failed (<em>MR_MEM_PHASES</em> if nothing failed).
+ * @var mr_byte_t __MR_MEM_T::report
+ * Format of the report (from __MR_MEM_REPORT_ENUM).
+*/
+struct __MR_MEM_T
+{
+    mr_mem_stat_t stats[MR_MEM_PHASES];
+
+    size_t size;
+    size_t peak;
+
+    size_t fsize;
+    mr_byte_t failed;
+    mr_byte_t report;
+};
+typedef struct __MR_MEM_T mr_mem_t;
+
+/**
+ * @union __MR_MEM_HEAD_T
+ * Header that is stored before every allocated block. \n
+ * The \a align fields make sure the block itself stays aligned for any type.
+ * @var __MR_MEM_HEAD_T::info
+ * Size of the block in bytes and the phase that owns it.
+ * @var long double __MR_MEM_HEAD_T::align
+ * Alignment of floating point types.
+ * @var mr_ptr_t __MR_MEM_HEAD_T::palign
+ * Alignment of pointers.
+*/
+union __MR_MEM_HEAD_T
+{
+    struct
+    {
+        size_t size;
+        mr_byte_t phase;
+    } info;
+
+    long double align;
+    mr_ptr_t palign;
+};
+typedef union __MR_MEM_HEAD_T mr_mem_head_t;
+
+/**
+ * The \a mr_mem_t instant that holds memory statistics of the compiler.
+*/
+extern mr_mem_t _mr_mem;
+
+/**
+ * Names of the phases (indexed by __MR_MEM_PHASE_ENUM).
+*/
+extern mr_str_ct mr_mem_names[MR_MEM_PHASES];
+
+/**
+ * It allocates a block of memory and counts it for the \a phase.
+ * @param phase
+ * Phase that owns the block (from __MR_MEM_PHASE_ENUM).
+ * @param size
+ * Size of the block in bytes.
+ * @return It returns the block, Or NULL if there isn't enough memory.
+*/
+mr_ptr_t mr_mem_malloc(
+    mr_byte_t phase, size_t size);
+
+/**
+ * It allocates a zero-filled block of memory and counts it for the \a phase.
+ * @param phase
+ * Phase that owns the block (from __MR_MEM_PHASE_ENUM).
+ * @param count
+ * Number of the elements.
+ * @param size
+ * Size of each element in bytes.
+ * @return It returns the block, Or NULL if there isn't enough memory.
+*/
+mr_ptr_t mr_mem_calloc(
+    mr_byte_t phase, size_t count, size_t size);
+
+/**
+ * It resizes a block of memory. \n
+ * The block stays counted for the phase that allocated it.
+ * @param phase
+ * Phase that owns the block if \a block is NULL (from __MR_MEM_PHASE_ENUM).
+ * @param block
+ * The block (allocated by the \a mr_mem functions), Or NULL.
+ * @param size
+ * New size of the block in bytes.
+ * @return It returns the resized block, Or NULL if there isn't enough memory (the old block stays valid).
+*/
+mr_ptr_t mr_mem_realloc(
+    mr_byte_t phase, mr_ptr_t block, size_t size);
+
+/**
+ * It deallocates a block of memory.
+ * @param block
+ * The block (allocated by the \a mr_mem functions), Or NULL.
+*/
+void mr_mem_free(
+    mr_ptr_t block);
+
+/**
+ * It records the capacity that the \a phase allocated but didn't use when it finished.
+ * @param phase
+ * The phase (from __MR_MEM_PHASE_ENUM).
+ * @param size
+ * Unused capacity in bytes.
+*/
+void mr_mem_unused(
+    mr_byte_t phase, size_t size);
+
+/**
+ * It prints the memory statistics in the format selected by <em>_mr_mem.report</em>.
+ * @param stream
+ * The output stream.
+*/
+void mr_mem_print(
+    FILE *stream);
+
+/**
+ * It prints the "not enough memory" error, Along with the phase and the size of the allocation that failed (if known).
+ * @param stream
+ * The output stream.
+*/
+void mr_mem_fail_print(
+    FILE *stream);
+
+#endif
@@ -173,6 +173,43 @@ enum __MR_NODE_ENUM
 */
 #define MR_NODE_COUNT (MR_NODE_INCLUDE + 1)
 
+/**
+ * Number of low bits of a <em>bool</em> or <em>type</em> node value that hold the index of its keyword. \n
+ * The high bits hold the keyword type relative to a pad,
+ * So the index must be smaller than 2^28 (see <em>MR_FILE_MAXSIZE</em>) and the pad must be closer than 16 types.
+*/
+#define MR_NODE_KEYWORD_BITS 28
+
+/**
+ * @def MR_NODE_KEYWORD_MAKE(idx, type, pad)
+ * It packs a keyword into a node value.
+ * @param idx
+ * Starting index of the keyword (32 bit integer).
+ * @param type
+ * Token type of the keyword.
+ * @param pad
+ * First token type of the keyword group (<em>MR_TOKEN_TRUE_K</em> or <em>MR_TOKEN_TYPE_PAD</em>).
+*/
+#define MR_NODE_KEYWORD_MAKE(idx, type, pad) ((mr_long_t)(idx) | (mr_long_t)((type) - (pad)) << MR_NODE_KEYWORD_BITS)
+
+/**
+ * @def MR_NODE_KEYWORD_IDX(value)
+ * It extracts the starting index of a keyword from a node value.
+ * @param value
+ * Value of the node.
+*/
+#define MR_NODE_KEYWORD_IDX(value) ((value) & (((mr_long_t)1 << MR_NODE_KEYWORD_BITS) - 1))
+
+/**
+ * @def MR_NODE_KEYWORD_TYPE(value, pad)
+ * It extracts the token type of a keyword from a node value.
+ * @param value
+ * Value of the node.
+ * @param pad
+ * First token type of the keyword group that was used to pack the value.
+*/
+#define MR_NODE_KEYWORD_TYPE(value, pad) ((mr_byte_t)(((value) >> MR_NODE_KEYWORD_BITS) + (pad)))
+
 /**
  * @struct __MR_NODE_KEYVAL_T
  * Data structure that holds information about a single key-value. \n
@@ -194,8 +231,8 @@ typedef struct __MR_NODE_KEYVAL_T mr_node_keyval_t;
 /**
  * @struct __MR_NODE_LIST_T
  * Data structure that holds information about a fstr, list, dict, or a set.
- * @var mr_idx_t __MR_NODE_LIST_T::elems
- * The list of elements.
+ * @var mr_long_t __MR_NODE_LIST_T::elems
+ * The list of elements (pointer to the stack data).
  * @var mr_idx_t __MR_NODE_LIST_T::size
  * Size of the elements list.
  * @var mr_idx_t __MR_NODE_LIST_T::sidx
@@ -206,7 +243,7 @@ typedef struct __MR_NODE_KEYVAL_T mr_node_keyval_t;
 #pragma pack(push, 1)
 struct __MR_NODE_LIST_T
 {
-    mr_idx_t elems;
+    mr_long_t elems;
     mr_idx_t size;
     mr_idx_t sidx;
     mr_idx_t eidx;
@@ -217,15 +254,15 @@ typedef struct __MR_NODE_LIST_T mr_node_list_t;
 /**
  * @struct __MR_NODE_TUPLE_T
  * Data structure that holds information about a tuple.
- * @var mr_idx_t __MR_NODE_TUPLE_T::elems
- * The list of elements.
+ * @var mr_long_t __MR_NODE_TUPLE_T::elems
+ * The list of elements (pointer to the stack data).
  * @var mr_idx_t __MR_NODE_TUPLE_T::size
  * Size of the elements list.
 */
 #pragma pack(push, 1)
 struct __MR_NODE_TUPLE_T
 {
-    mr_idx_t elems;
+    mr_long_t elems;
     mr_idx_t size;
 };
 #pragma pack(pop)
@@ -415,18 +452,20 @@ typedef struct __MR_NODE_VAR_ASSIGN_T mr_node_var_assign_t;
  * Starting index of the name. \n
  * If the name is not specified in the code, the \a name would be equal to <em>MR_INVALID_IDX</em>.
 */
+#pragma pack(push, 1)
 struct __MR_NODE_CALL_ARG_T
 {
     mr_node_t value;
     mr_idx_t name;
 };
+#pragma pack(pop)
 typedef struct __MR_NODE_CALL_ARG_T mr_node_call_arg_t;
 
 /**
  * @struct __MR_NODE_FUNC_CALL_T
  * Data structure that holds information about a function call (with arguments).
  * @var mr_long_t __MR_NODE_FUNC_CALL_T::args
- * List of function call arguments.
+ * List of function call arguments (pointer to the stack data).
  * @var mr_byte_t __MR_NODE_FUNC_CALL_T::size
  * Size of the \a args list.
  * @var mr_node_t __MR_NODE_FUNC_CALL_T::func
@@ -437,7 +476,7 @@ typedef struct __MR_NODE_CALL_ARG_T mr_node_call_arg_t;
 #pragma pack(push, 1)
 struct __MR_NODE_FUNC_CALL_T
 {
-    mr_idx_t args;
+    mr_long_t args;
     mr_byte_t size;
     mr_node_t func;
     mr_idx_t eidx;
@@ -453,18 +492,20 @@ typedef struct __MR_NODE_FUNC_CALL_T mr_node_func_call_t;
  * @var mr_idx_t __MR_NODE_EX_FUNC_CALL_T::eidx
  * Ending index of the call.
 */
+#pragma pack(push, 1)
 struct __MR_NODE_EX_FUNC_CALL_T
 {
     mr_node_t func;
     mr_idx_t eidx;
 };
+#pragma pack(pop)
 typedef struct __MR_NODE_EX_FUNC_CALL_T mr_node_ex_func_call_t;
 
 /**
  * @struct __MR_NODE_DOLLAR_METHOD_T
  * Data structure that holds information about a dollar method call (with arguments).
  * @var mr_long_t __MR_NODE_DOLLAR_METHOD_T::params
- * List of parameters.
+ * List of parameters (pointer to the stack data).
  * @var mr_byte_t __MR_NODE_DOLLAR_METHOD_T::size
  * Size of the \a params list.
  * @var mr_idx_t __MR_NODE_DOLLAR_METHOD_T::name
@@ -475,7 +516,7 @@ typedef struct __MR_NODE_EX_FUNC_CALL_T mr_node_ex_func_call_t;
 #pragma pack(push, 1)
 struct __MR_NODE_DOLLAR_METHOD_T
 {
-    mr_idx_t params;
+    mr_long_t params;
     mr_byte_t size;
     mr_idx_t name;
     mr_idx_t sidx;
@@ -548,8 +589,8 @@ typedef struct __MR_NODE_IF_ELSE_T mr_node_if_else_t;
  * Data structure that holds information about an if statement (if, elif, and else).
  * @var mr_node_t __MR_NODE_IF_ELIF_T::ebody
  * Body of the else statement.
- * @var mr_idx_t __MR_NODE_IF_ELIF_T::cases
- * Cases of the if statement (if and elif).
+ * @var mr_long_t __MR_NODE_IF_ELIF_T::cases
+ * Cases of the if statement, if and elif (pointer to the stack data).
  * @var mr_idx_t __MR_NODE_IF_ELIF_T::size
  * Size of the cases list.
  * @var mr_idx_t __MR_NODE_IF_ELIF_T::sidx
@@ -559,7 +600,7 @@ typedef struct __MR_NODE_IF_ELSE_T mr_node_if_else_t;
 struct __MR_NODE_IF_ELIF_T
 {
     mr_node_t ebody;
-    mr_idx_t cases;
+    mr_long_t cases;
     mr_idx_t size;
     mr_idx_t sidx;
 };
@@ -571,8 +612,8 @@ typedef struct __MR_NODE_IF_ELIF_T mr_node_if_elif_t;
  * Data structure that holds information about a switch statement (case).
  * @var mr_node_t __MR_NODE_SWITCH_T::value
  * Value of the switch statement.
- * @var mr_idx_t __MR_NODE_SWITCH_T::cases
- * Cases of the switch statement.
+ * @var mr_long_t __MR_NODE_SWITCH_T::cases
+ * Cases of the switch statement (pointer to the stack data).
  * @var mr_idx_t __MR_NODE_SWITCH_T::size
  * Size of the cases list.
  * @var mr_idx_t __MR_NODE_SWITCH_T::sidx
@@ -584,7 +625,7 @@ typedef struct __MR_NODE_IF_ELIF_T mr_node_if_elif_t;
 struct __MR_NODE_SWITCH_T
 {
     mr_node_t value;
-    mr_idx_t cases;
+    mr_long_t cases;
     mr_idx_t size;
     mr_idx_t sidx;
     mr_idx_t eidx;
@@ -599,8 +640,8 @@ typedef struct __MR_NODE_SWITCH_T mr_node_switch_t;
  * Value of the switch statement.
  * @var mr_node_t __MR_NODE_SWITCH::dbody
  * Body of the default statement.
- * @var mr_idx_t __MR_NODE_SWITCH_DEF_T::cases
- * Cases of the switch statement.
+ * @var mr_long_t __MR_NODE_SWITCH_DEF_T::cases
+ * Cases of the switch statement (pointer to the stack data).
  * @var mr_idx_t __MR_NODE_SWITCH_DEF_T::size
  * Size of the cases list.
  * @var mr_idx_t __MR_NODE_SWITCH_DEF_T::sidx
@@ -613,7 +654,7 @@ struct __MR_NODE_SWITCH_DEF_T
 {
     mr_node_t value;
     mr_node_t dbody;
-    mr_idx_t cases;
+    mr_long_t cases;
     mr_idx_t size;
     mr_idx_t sidx;
     mr_idx_t eidx;
@@ -624,8 +665,9 @@ typedef struct __MR_NODE_SWITCH_DEF_T mr_node_switch_def_t;
 /**
  * @struct __MR_NODE_IMPORT_T
  * Data structure that holds information about an import or an include statement.
- * @var mr_idx_t __MR_NODE_IMPORT_T::libs
- * The list of libraries.
+ * @var mr_long_t __MR_NODE_IMPORT_T::libs
+ * The list of libraries (pointer to the stack data). \n
+ * Elements of the list are unaligned <em>mr_idx_t</em> values, So they must be read with \a memcpy.
  * @var mr_idx_t __MR_NODE_IMPORT_T::size
  * Size of the libraries list.
  * @var mr_idx_t __MR_NODE_IMPORT_T::sidx
@@ -634,15 +676,90 @@ typedef struct __MR_NODE_SWITCH_DEF_T mr_node_switch_def_t;
 #pragma pack(push, 1)
 struct __MR_NODE_IMPORT_T
 {
-    mr_idx_t libs;
+    mr_long_t libs;
     mr_byte_t size;
     mr_idx_t sidx;
 };
 #pragma pack(pop)
 typedef struct __MR_NODE_IMPORT_T mr_node_import_t;
 
+#ifdef __MR_NODE_SPANS__
+
+/**
+ * @struct __MR_NODE_SPAN_T
+ * Span of a node in the source code. \n
+ * The span is stored right before the data of the node in the stack (only with node spans enabled).
+ * @var mr_idx_t __MR_NODE_SPAN_T::sidx
+ * Starting index of the node.
+ * @var mr_idx_t __MR_NODE_SPAN_T::eidx
+ * Ending index of the node.
+*/
+#pragma pack(push, 1)
+struct __MR_NODE_SPAN_T
+{
+    mr_idx_t sidx;
+    mr_idx_t eidx;
+};
+#pragma pack(pop)
+typedef struct __MR_NODE_SPAN_T mr_node_span_t;
+
+/**
+ * Size of the span that is stored with the data of each node.
+*/
+#define MR_NODE_SPAN_SIZE sizeof(mr_node_span_t)
+
+/**
+ * It pushes the data of a node into the stack, With room for its span right before the data.
+ * @param ptr
+ * Pointer to the data of the node (in the stack data).
+ * @param size
+ * Size of the data in bytes.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns the error code (defined in \a defs.h header file).
+*/
+mr_byte_t mr_node_push(
+    mr_long_t *ptr, mr_byte_t size);
+
+/**
+ * It creates a node and records its span. \n
+ * The data of the node must be complete (its children already have their spans).
+ * @param type
+ * Type of the node.
+ * @param value
+ * Pointer to the data of the node (pushed by the \a mr_node_push function).
+ * @return It returns the node.
+*/
+mr_node_t mr_node_make(
+    mr_byte_t type, mr_long_t value);
+
+#else
+
+/**
+ * Size of the span that is stored with the data of each node (nothing is stored without node spans).
+*/
+#define MR_NODE_SPAN_SIZE 0
+
+/**
+ * @def mr_node_push(ptr, size)
+ * It pushes the data of a node into the stack (see the \a mr_stack_push function).
+*/
+#define mr_node_push(ptr, size) mr_stack_push(ptr, size)
+
+/**
+ * @def mr_node_make(typ, val)
+ * It creates a node.
+ * @param typ
+ * Type of the node.
+ * @param val
+ * Pointer to the data of the node.
+*/
+#define mr_node_make(typ, val) ((mr_node_t){.type=(typ), .value=(val)})
+
+#endif
+
 /**
- * It extracts the starting index of a node.
+ * It extracts the starting index of a node. \n
+ * With node spans enabled, The index is read from the span of the node (except for literals and names).
  * @param node
  * The specified node.
  * @return It returns the starting index of the <em>node</em>.
@@ -651,7 +768,8 @@ mr_long_t mr_node_sidx(
     mr_node_t node);
 
 /**
- * It extracts the ending index of a node.
+ * It extracts the ending index of a node. \n
+ * With node spans enabled, The index is read from the span of the node (except for literals and names).
  * @param node
  * The specified node.
  * @return It returns the ending index of the <em>node</em>.
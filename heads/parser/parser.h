@@ -26,6 +26,55 @@ copies or substantial portions of the Software.
 #include <parser/node.h>
 #include <error/error.h>
 
+#ifdef __MR_PARSER_STACK__
+/**
+ * @struct __MR_PARSER_FRAME_T
+ * A pending rule of the explicit-stack parser (only available with the explicit-stack parser enabled). \n
+ * It holds the local variables of the rule, So the rule can continue after its nested rules are handled. \n
+ * Each field is used by the rules that need it, And the others are left undefined.
+ * @var mr_node_t __MR_PARSER_FRAME_T::left
+ * Left operand of a binary operation, The node of a subscript, The function of a function call, The key of a dict element,
+ * Or the name of a dollar method (its value holds the index).
+ * @var mr_node_t __MR_PARSER_FRAME_T::start
+ * Start of a subscript.
+ * @var mr_node_t __MR_PARSER_FRAME_T::end
+ * End of a subscript.
+ * @var mr_node_t __MR_PARSER_FRAME_T::step
+ * Step of a subscript.
+ * @var mr_long_t __MR_PARSER_FRAME_T::ptr
+ * Pointer to the value of the generated node (in the stack).
+ * @var mr_long_t __MR_PARSER_FRAME_T::base
+ * End of the scratch space of the stack before the first element of the list (or the arguments) was pushed.
+ * @var mr_long_t __MR_PARSER_FRAME_T::size
+ * Size of the elements list.
+ * @var mr_idx_t __MR_PARSER_FRAME_T::sidx
+ * Starting index of a unary operation or a dollar method, Or name of a function call argument.
+ * @var mr_byte_t __MR_PARSER_FRAME_T::state
+ * The point that the rule continues from.
+ * @var mr_byte_t __MR_PARSER_FRAME_T::op
+ * Operator of the operation.
+ * @var mr_byte_t __MR_PARSER_FRAME_T::prec
+ * Minimum precedence of a binary operation.
+*/
+struct __MR_PARSER_FRAME_T
+{
+    mr_node_t left;
+    mr_node_t start;
+    mr_node_t end;
+    mr_node_t step;
+
+    mr_long_t ptr;
+    mr_long_t base;
+    mr_long_t size;
+
+    mr_idx_t sidx;
+    mr_byte_t state;
+    mr_byte_t op;
+    mr_byte_t prec;
+};
+typedef struct __MR_PARSER_FRAME_T mr_parser_frame_t;
+#endif
+
 /**
  * @struct __MR_PARSER_T
  * Result of the \a mr_parser function.
@@ -35,6 +84,12 @@ copies or substantial portions of the Software.
  * Size of the \a nodes list.
  * @var mr_invalid_syntax_t __MR_PARSER_T::error
  * Invalid syntax error.
+ * @var mr_parser_frame_t* __MR_PARSER_T::frames
+ * Stack of the pending rules (only available with the explicit-stack parser enabled).
+ * @var mr_long_t __MR_PARSER_T::fsize
+ * Size of the \a frames stack.
+ * @var mr_long_t __MR_PARSER_T::falloc
+ * Allocated size of the \a frames stack.
 */
 struct __MR_PARSER_T
 {
@@ -42,6 +97,12 @@ struct __MR_PARSER_T
     mr_long_t size;
 
     mr_invalid_syntax_t error;
+
+#ifdef __MR_PARSER_STACK__
+    mr_parser_frame_t *frames;
+    mr_long_t fsize;
+    mr_long_t falloc;
+#endif
 };
 typedef struct __MR_PARSER_T mr_parser_t;
 
@@ -51,11 +112,36 @@ typedef struct __MR_PARSER_T mr_parser_t;
  * @param res
  * Result of the parser process (it contains both error and nodes list).
  * @param tokens
- * List of tokens generated by the lexer.
+ * Cursor of the tokens generated by the lexer (pointing to the first token). \n
+ * With compact token streams enabled, the cursor reads the stream generated by the \a mr_token_compact function. \n
+ * With the explicit-stack parser enabled, Nested expressions are handled on the heap instead of the call stack. \n
+ * If the process failed, the stack is released back to where it was before the call (see <em>mr_stack_release</em>).
+ * @param alloc
+ * Initial size of the \a nodes list, And its allocation step (see the \a mr_parser_nodes_size function).
  * @return It returns a code which indicates if the process was successful or not. \n
  * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns the error code (defined in \a defs.h header file).
 */
 mr_byte_t mr_parser(
-    mr_parser_t *res, mr_token_t *tokens);
+    mr_parser_t *res, mr_token_cursor_t tokens, mr_long_t alloc);
+
+/**
+ * It computes the number of statements that the tokens can contain at most (the size of the \a nodes list).
+ * @param counts
+ * Number of tokens of each type (generated by the \a mr_token_histogram function).
+ * @return It returns the number of statements.
+*/
+mr_long_t mr_parser_nodes_size(
+    const mr_long_t *counts);
+
+/**
+ * It computes the size of the stack data that parsing the tokens can take at most. \n
+ * Each token is charged with the largest structure that it can make the parser allocate,
+ * And the result is limited to the size estimated from the source code (see <em>MR_STACK_SIZE_FACTOR</em>).
+ * @param counts
+ * Number of tokens of each type (generated by the \a mr_token_histogram function).
+ * @return It returns the size in bytes.
+*/
+mr_long_t mr_parser_stack_size(
+    const mr_long_t *counts);
 
 #endif
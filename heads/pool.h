@@ -0,0 +1,621 @@
+/*
+MIT License
+
+Copyright (c) 2023 MetaReal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+*/
+
+/**
+ * @file pool.h
+ * This file contains definitions of the pools that the lexer fills with decoded literals, string literals, and interned identifiers. \n
+ * Pool IDs are not stored in the tokens or the nodes, Since that would grow every token (and leaf nodes have no room for them).
+ * Each pool keeps a list of references instead, Which maps the starting index of every literal or identifier to its pool slot,
+ * So both tokens and nodes can reach their pool slots. \n
+ * References are sorted like the tokens, So a pass that walks the tokens pairs the nth token of a kind with the nth reference of its pool
+ * without searching. Only a lookup of a single index (the \a find functions) uses a binary search. \n
+ * All things defined in \a pool.c and this file have the \a mr_pool prefix.
+*/
+
+#ifndef __MR_POOL__
+#define __MR_POOL__
+
+#include <defs.h>
+
+/**
+ * @struct __MR_POOL_CONST_T
+ * A decoded numeric or character literal.
+ * @var __MR_POOL_CONST_T::value
+ * Value of the literal. \n
+ * The \a i field is used by <em>MR_POOL_CONST_INT</em> and <em>MR_POOL_CONST_CHR</em> constants.
+ * The \a f field is used by the other ones.
+ * @var mr_byte_t __MR_POOL_CONST_T::type
+ * Type of the constant (<em>__MR_POOL_CONST_ENUM</em>).
+*/
+struct __MR_POOL_CONST_T
+{
+    union
+    {
+        uint64_t i;
+        double f;
+    } value;
+    mr_byte_t type;
+};
+typedef struct __MR_POOL_CONST_T mr_pool_const_t;
+
+/**
+ * @enum __MR_POOL_CONST_ENUM
+ * List of constant types.
+ * @var __MR_POOL_CONST_ENUM::MR_POOL_CONST_INT
+ * An integer that fits in 64 bits.
+ * @var __MR_POOL_CONST_ENUM::MR_POOL_CONST_BIG_INT
+ * An integer that doesn't fit in 64 bits (its value is the nearest floating point number).
+ * @var __MR_POOL_CONST_ENUM::MR_POOL_CONST_FLOAT
+ * A floating point number.
+ * @var __MR_POOL_CONST_ENUM::MR_POOL_CONST_IMAGINARY
+ * An imaginary number (its value is the imaginary part).
+ * @var __MR_POOL_CONST_ENUM::MR_POOL_CONST_CHR
+ * A character (escape sequences are decoded).
+*/
+enum __MR_POOL_CONST_ENUM
+{
+    MR_POOL_CONST_INT,
+    MR_POOL_CONST_BIG_INT,
+    MR_POOL_CONST_FLOAT,
+    MR_POOL_CONST_IMAGINARY,
+    MR_POOL_CONST_CHR
+};
+
+/**
+ * @struct __MR_POOL_REF_T
+ * Reference from a literal in the source code to its pool slot.
+ * @var mr_long_t __MR_POOL_REF_T::idx
+ * Starting index of the literal in the source code.
+ * @var mr_long_t __MR_POOL_REF_T::id
+ * Index of the slot in the pool.
+*/
+struct __MR_POOL_REF_T
+{
+    mr_long_t idx;
+    mr_long_t id;
+};
+typedef struct __MR_POOL_REF_T mr_pool_ref_t;
+
+/**
+ * @struct __MR_POOL_REFS_T
+ * List of references of a pool sorted by their starting indices.
+ * @var mr_pool_ref_t* __MR_POOL_REFS_T::data
+ * The references.
+ * @var mr_long_t __MR_POOL_REFS_T::size
+ * Number of references.
+ * @var mr_long_t __MR_POOL_REFS_T::alloc
+ * Allocated size of the \a data list.
+*/
+struct __MR_POOL_REFS_T
+{
+    mr_pool_ref_t *data;
+    mr_long_t size;
+    mr_long_t alloc;
+};
+typedef struct __MR_POOL_REFS_T mr_pool_refs_t;
+
+/**
+ * An empty references list.
+*/
+#define MR_POOL_REFS_EMPTY ((mr_pool_refs_t){.data=NULL, .size=0, .alloc=0})
+
+/**
+ * @struct __MR_POOL_BUCKET_T
+ * A bucket of the hash table of a pool.
+ * @var mr_long_t __MR_POOL_BUCKET_T::id
+ * Index of the slot plus one, Or zero if the bucket is empty.
+ * @var mr_long_t __MR_POOL_BUCKET_T::hash
+ * Hash of the slot. It's compared before the slot itself, So probing rarely touches the slots.
+*/
+struct __MR_POOL_BUCKET_T
+{
+    mr_long_t id;
+    mr_long_t hash;
+};
+typedef struct __MR_POOL_BUCKET_T mr_pool_bucket_t;
+
+/**
+ * @struct __MR_POOL_CONSTS_T
+ * The constant pool. \n
+ * Every distinct constant has one slot, And every literal in the source code has one reference. \n
+ * The nth reference belongs to the nth <em>MR_TOKEN_INT</em>, <em>MR_TOKEN_FLOAT</em>, <em>MR_TOKEN_IMAGINARY</em>, or <em>MR_TOKEN_CHR</em> token.
+ * @var mr_pool_const_t* __MR_POOL_CONSTS_T::data
+ * List of constants (slots).
+ * @var mr_long_t __MR_POOL_CONSTS_T::size
+ * Number of constants.
+ * @var mr_long_t __MR_POOL_CONSTS_T::alloc
+ * Allocated size of the \a data list.
+ * @var mr_pool_bucket_t* __MR_POOL_CONSTS_T::table
+ * Hash table of the constants (open addressing with linear probing).
+ * @var mr_long_t __MR_POOL_CONSTS_T::mask
+ * Number of buckets in the \a table minus one.
+ * @var mr_pool_refs_t __MR_POOL_CONSTS_T::refs
+ * References of the literals.
+*/
+struct __MR_POOL_CONSTS_T
+{
+    mr_pool_const_t *data;
+    mr_long_t size;
+    mr_long_t alloc;
+
+    mr_pool_bucket_t *table;
+    mr_long_t mask;
+
+    mr_pool_refs_t refs;
+};
+typedef struct __MR_POOL_CONSTS_T mr_pool_consts_t;
+
+/**
+ * An empty constant pool. \n
+ * Pools allocate their lists on the first addition, So an empty pool doesn't need any initialization.
+*/
+#define MR_POOL_CONSTS_EMPTY ((mr_pool_consts_t){.data=NULL, .size=0, .alloc=0, \
+    .table=NULL, .mask=0, .refs=MR_POOL_REFS_EMPTY})
+
+/**
+ * @struct __MR_POOL_SYM_T
+ * An interned identifier (symbol).
+ * @var mr_long_t __MR_POOL_SYM_T::name
+ * Index of the first character of the symbol in the \a names list of its pool.
+ * @var mr_long_t __MR_POOL_SYM_T::size
+ * Size of the symbol in characters.
+*/
+struct __MR_POOL_SYM_T
+{
+    mr_long_t name;
+    mr_long_t size;
+};
+typedef struct __MR_POOL_SYM_T mr_pool_sym_t;
+
+/**
+ * @struct __MR_POOL_SYMS_T
+ * The symbol pool (identifier intern table). \n
+ * Every distinct identifier has one symbol ID, And every identifier in the source code has one reference. \n
+ * Symbol IDs are dense (numbered from zero in the order of first appearance), So they can index per-symbol lists directly,
+ * And two names are compared by comparing their IDs. \n
+ * The nth reference belongs to the nth <em>MR_TOKEN_IDENTIFIER</em> token (keywords and types are not interned).
+ * @var mr_pool_sym_t* __MR_POOL_SYMS_T::data
+ * List of symbols (indexed by the symbol ID).
+ * @var mr_long_t __MR_POOL_SYMS_T::size
+ * Number of symbols.
+ * @var mr_long_t __MR_POOL_SYMS_T::alloc
+ * Allocated size of the \a data list.
+ * @var mr_str_t __MR_POOL_SYMS_T::names
+ * Characters of the symbols (copied from the code, So they outlive the window of the streaming lexer).
+ * @var mr_long_t __MR_POOL_SYMS_T::nsize
+ * Number of characters in the \a names list.
+ * @var mr_long_t __MR_POOL_SYMS_T::nalloc
+ * Allocated size of the \a names list.
+ * @var mr_pool_bucket_t* __MR_POOL_SYMS_T::table
+ * Hash table of the symbols (open addressing with linear probing).
+ * @var mr_long_t __MR_POOL_SYMS_T::mask
+ * Number of buckets in the \a table minus one.
+ * @var mr_pool_refs_t __MR_POOL_SYMS_T::refs
+ * References of the identifiers.
+*/
+struct __MR_POOL_SYMS_T
+{
+    mr_pool_sym_t *data;
+    mr_long_t size;
+    mr_long_t alloc;
+
+    mr_str_t names;
+    mr_long_t nsize;
+    mr_long_t nalloc;
+
+    mr_pool_bucket_t *table;
+    mr_long_t mask;
+
+    mr_pool_refs_t refs;
+};
+typedef struct __MR_POOL_SYMS_T mr_pool_syms_t;
+
+/**
+ * An empty symbol pool.
+*/
+#define MR_POOL_SYMS_EMPTY ((mr_pool_syms_t){.data=NULL, .size=0, .alloc=0, \
+    .names=NULL, .nsize=0, .nalloc=0, .table=NULL, .mask=0, .refs=MR_POOL_REFS_EMPTY})
+
+/**
+ * @struct __MR_POOL_STR_T
+ * A string literal (or a piece of a formatted string). \n
+ * Strings are kept as they're written in the source code, And their escape sequences are decoded on the first \a mr_pool_strs_get call.
+ * @var mr_long_t __MR_POOL_STR_T::start
+ * Index of the first character of the literal in the source code (if \a slice is true) or in the \a arena list of its pool.
+ * @var mr_long_t __MR_POOL_STR_T::size
+ * Size of the literal in characters.
+ * @var mr_long_t __MR_POOL_STR_T::value
+ * Index of the first decoded character in the \a arena list of its pool,
+ * Or <em>MR_INVALID_IDX_CODE</em> if the string isn't decoded yet (only used if \a esc is true).
+ * @var mr_long_t __MR_POOL_STR_T::vsize
+ * Size of the decoded string in characters (only valid if \a value is).
+ * @var mr_bool_t __MR_POOL_STR_T::slice
+ * It indicates that the literal is a slice of the source code (zero-copy). \n
+ * Literals are slices unless the pool copies them.
+ * @var mr_bool_t __MR_POOL_STR_T::esc
+ * It indicates that the literal contains escape sequences.
+*/
+struct __MR_POOL_STR_T
+{
+    mr_long_t start;
+    mr_long_t size;
+    mr_long_t value;
+    mr_long_t vsize;
+    mr_bool_t slice;
+    mr_bool_t esc;
+};
+typedef struct __MR_POOL_STR_T mr_pool_str_t;
+
+/**
+ * @struct __MR_POOL_STRS_T
+ * The string pool. \n
+ * Every distinct literal has one string ID (numbered from zero in the order of first appearance), And every string literal has one reference. \n
+ * Literals are compared as they're written, So two literals that only differ in their escape sequences (like "\\q" and "q") have different IDs.
+ * @var mr_pool_str_t* __MR_POOL_STRS_T::data
+ * List of strings (indexed by the string ID).
+ * @var mr_long_t __MR_POOL_STRS_T::size
+ * Number of strings.
+ * @var mr_long_t __MR_POOL_STRS_T::alloc
+ * Allocated size of the \a data list.
+ * @var mr_str_t __MR_POOL_STRS_T::arena
+ * Characters of the literals that are not slices of the source code (copied), And the decoded strings.
+ * @var mr_long_t __MR_POOL_STRS_T::asize
+ * Number of characters in the \a arena list.
+ * @var mr_long_t __MR_POOL_STRS_T::aalloc
+ * Allocated size of the \a arena list.
+ * @var mr_pool_bucket_t* __MR_POOL_STRS_T::table
+ * Hash table of the strings (open addressing with linear probing).
+ * @var mr_long_t __MR_POOL_STRS_T::mask
+ * Number of buckets in the \a table minus one.
+ * @var mr_pool_refs_t __MR_POOL_STRS_T::refs
+ * References of the string literals.
+ * @var mr_bool_t __MR_POOL_STRS_T::copy
+ * It indicates that new literals must be copied into the \a arena (used when the source code doesn't outlive the lexer).
+*/
+struct __MR_POOL_STRS_T
+{
+    mr_pool_str_t *data;
+    mr_long_t size;
+    mr_long_t alloc;
+
+    mr_str_t arena;
+    mr_long_t asize;
+    mr_long_t aalloc;
+
+    mr_pool_bucket_t *table;
+    mr_long_t mask;
+
+    mr_pool_refs_t refs;
+    mr_bool_t copy;
+};
+typedef struct __MR_POOL_STRS_T mr_pool_strs_t;
+
+/**
+ * An empty string pool.
+*/
+#define MR_POOL_STRS_EMPTY ((mr_pool_strs_t){.data=NULL, .size=0, .alloc=0, \
+    .arena=NULL, .asize=0, .aalloc=0, .table=NULL, .mask=0, .refs=MR_POOL_REFS_EMPTY, .copy=MR_FALSE})
+
+/**
+ * Constants of the code generated by the last lexer call. \n
+ * The lexer only fills it if the \a MR_POOL_CONSTS build option is on (it stays empty otherwise). It must be freed by the \a mr_pool_consts_free function.
+*/
+extern mr_pool_consts_t _mr_pool_consts;
+
+/**
+ * Symbols of the code generated by the last lexer call. \n
+ * The lexer only fills it if the \a MR_POOL_SYMS build option is on (it stays empty otherwise). It must be freed by the \a mr_pool_syms_free function.
+*/
+extern mr_pool_syms_t _mr_pool_syms;
+
+/**
+ * String literals of the code generated by the last lexer call. \n
+ * The lexer only fills it if the \a MR_POOL_STRS build option is on (it stays empty otherwise). \n
+ * Its slices point into <em>_mr_config.code</em>, So the code must outlive the pool. It must be freed by the \a mr_pool_strs_free function.
+*/
+extern mr_pool_strs_t _mr_pool_strs;
+
+/**
+ * It adds a constant to the pool and references it from the <em>idx</em>. \n
+ * If the constant already exists in the pool, its slot is reused. \n
+ * References must be added in the order of their indices.
+ * @param pool
+ * The constant pool.
+ * @param idx
+ * Starting index of the literal in the source code.
+ * @param value
+ * The constant.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em>.
+*/
+mr_byte_t mr_pool_consts_add(
+    mr_pool_consts_t *pool, mr_long_t idx, mr_pool_const_t value);
+
+/**
+ * It moves the references of the <em>src</em> to the end of the <em>pool</em>, And adds their constants to the <em>pool</em>. \n
+ * References of the \a src must come after references of the <em>pool</em>. The \a src pool is freed.
+ * @param pool
+ * The constant pool.
+ * @param src
+ * The pool that is merged into the <em>pool</em>.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em>.
+*/
+mr_byte_t mr_pool_consts_merge(
+    mr_pool_consts_t *pool, mr_pool_consts_t *src);
+
+/**
+ * It removes the constants and references added after the pool had \a size constants and \a rsize references.
+ * @param pool
+ * The constant pool.
+ * @param size
+ * Number of constants that are kept.
+ * @param rsize
+ * Number of references that are kept.
+*/
+void mr_pool_consts_rollback(
+    mr_pool_consts_t *pool, mr_long_t size, mr_long_t rsize);
+
+/**
+ * It finds the pool slot of a literal with a binary search on the references. \n
+ * Passes that walk the tokens in order should walk the references with them instead.
+ * @param pool
+ * The constant pool.
+ * @param idx
+ * Starting index of the literal in the source code
+ * (index of the token or value of the node).
+ * @return It returns index of the slot, Or <em>MR_INVALID_IDX_CODE</em> if there is no literal at the <em>idx</em>.
+*/
+mr_long_t mr_pool_consts_find(
+    mr_pool_consts_t *pool, mr_long_t idx);
+
+/**
+ * It frees the lists of the pool and empties it.
+ * @param pool
+ * The constant pool.
+*/
+void mr_pool_consts_free(
+    mr_pool_consts_t *pool);
+
+/**
+ * It interns an identifier and references its symbol from the <em>idx</em>. \n
+ * References must be added in the order of their indices.
+ * @param pool
+ * The symbol pool.
+ * @param idx
+ * Starting index of the identifier in the source code.
+ * @param str
+ * Starting point of the identifier.
+ * @param size
+ * Size of the identifier in characters.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em>.
+*/
+mr_byte_t mr_pool_syms_add(
+    mr_pool_syms_t *pool, mr_long_t idx, mr_str_ct str, mr_long_t size);
+
+/**
+ * It moves the references of the <em>src</em> to the end of the <em>pool</em>, And interns its symbols in the <em>pool</em>. \n
+ * References of the \a src must come after references of the <em>pool</em>. The \a src pool is freed.
+ * @param pool
+ * The symbol pool.
+ * @param src
+ * The pool that is merged into the <em>pool</em>.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em>.
+*/
+mr_byte_t mr_pool_syms_merge(
+    mr_pool_syms_t *pool, mr_pool_syms_t *src);
+
+/**
+ * It removes the symbols and references added after the pool had \a size symbols and \a rsize references.
+ * @param pool
+ * The symbol pool.
+ * @param size
+ * Number of symbols that are kept.
+ * @param rsize
+ * Number of references that are kept.
+*/
+void mr_pool_syms_rollback(
+    mr_pool_syms_t *pool, mr_long_t size, mr_long_t rsize);
+
+/**
+ * It finds the symbol ID of an identifier with a binary search on the references. \n
+ * Passes that walk the tokens in order should walk the references with them instead.
+ * @param pool
+ * The symbol pool.
+ * @param idx
+ * Starting index of the identifier in the source code
+ * (index of the token or the index stored in a node).
+ * @return It returns the symbol ID, Or <em>MR_INVALID_IDX_CODE</em> if there is no identifier at the <em>idx</em>.
+*/
+mr_long_t mr_pool_syms_find(
+    mr_pool_syms_t *pool, mr_long_t idx);
+
+/**
+ * It frees the lists of the pool and empties it.
+ * @param pool
+ * The symbol pool.
+*/
+void mr_pool_syms_free(
+    mr_pool_syms_t *pool);
+
+/**
+ * It interns a string literal and references it from the <em>idx</em>. \n
+ * A new literal becomes a slice of <em>_mr_config.code</em> (unless the pool copies its strings), And it's not decoded until it's read. \n
+ * References must be added in the order of their indices.
+ * @param pool
+ * The string pool.
+ * @param idx
+ * Starting index of the literal in the source code.
+ * @param str
+ * First character of the literal after the opening quote (it must be a part of <em>_mr_config.code</em>).
+ * @param size
+ * Number of characters before the closing quote.
+ * @param esc
+ * If \a esc is equal to <em>MR_FALSE</em>, The '\\' characters don't start escape sequences.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em>.
+*/
+mr_byte_t mr_pool_strs_add(
+    mr_pool_strs_t *pool, mr_long_t idx, mr_str_ct str, mr_long_t size, mr_bool_t esc);
+
+/**
+ * It moves the references of the <em>src</em> to the end of the <em>pool</em>, And interns its strings in the <em>pool</em>. \n
+ * References of the \a src must come after references of the <em>pool</em>. The \a src pool is freed.
+ * @param pool
+ * The string pool.
+ * @param src
+ * The pool that is merged into the <em>pool</em>.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em>.
+*/
+mr_byte_t mr_pool_strs_merge(
+    mr_pool_strs_t *pool, mr_pool_strs_t *src);
+
+/**
+ * It removes the strings and references added after the pool had \a size strings and \a rsize references.
+ * @param pool
+ * The string pool.
+ * @param size
+ * Number of strings that are kept.
+ * @param rsize
+ * Number of references that are kept.
+*/
+void mr_pool_strs_rollback(
+    mr_pool_strs_t *pool, mr_long_t size, mr_long_t rsize);
+
+/**
+ * It finds the string ID of a string literal.
+ * @param pool
+ * The string pool.
+ * @param idx
+ * Starting index of the literal in the source code
+ * (index of the token or the index stored in a node).
+ * @return It returns the string ID, Or <em>MR_INVALID_IDX_CODE</em> if there is no string literal at the <em>idx</em>.
+*/
+mr_long_t mr_pool_strs_find(
+    mr_pool_strs_t *pool, mr_long_t idx);
+
+/**
+ * It returns the characters of a string. \n
+ * Escape sequences of the string are decoded into the \a arena on the first call. It can move the arena, So the returned pointer is only valid until the next call.
+ * @param size
+ * Size of the string in characters.
+ * @param pool
+ * The string pool.
+ * @param id
+ * The string ID.
+ * @return It returns the first character of the string (the string is not null-terminated), Or NULL if there isn't enough memory to decode it.
+*/
+mr_str_ct mr_pool_strs_get(
+    mr_long_t *size, mr_pool_strs_t *pool, mr_long_t id);
+
+/**
+ * It prepares the slices of the pool for an edit of the source code. \n
+ * Slices that overlap the replaced characters are copied into the <em>arena</em>, And slices after them are moved by <em>delta</em>. \n
+ * It must be called before the code is edited. Copied strings keep their IDs, So the pool can't be rolled back past them.
+ * @param pool
+ * The string pool.
+ * @param start
+ * Index of the first replaced character.
+ * @param end
+ * Index of the first character after the replaced ones.
+ * @param delta
+ * Size of the new characters minus number of the replaced characters (modulo 2^32).
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em>
+ * (the slices are not moved in that case).
+*/
+mr_byte_t mr_pool_strs_edit(
+    mr_pool_strs_t *pool, mr_long_t start, mr_long_t end, mr_long_t delta);
+
+/**
+ * It frees the lists of the pool and empties it.
+ * @param pool
+ * The string pool.
+*/
+void mr_pool_strs_free(
+    mr_pool_strs_t *pool);
+
+/**
+ * It computes the capacity of the pools of the last lexer call that is allocated but not used (see <em>mr_mem_unused</em>). \n
+ * Empty slots of the hash tables aren't counted, Since they're kept empty on purpose.
+ * @return It returns the unused capacity in bytes.
+*/
+size_t mr_pool_unused(void);
+
+/**
+ * It replaces the references between \a start and \a end with the references of the <em>src</em>,
+ * And moves the references after them by <em>delta</em>. The \a src list is freed. \n
+ * Slots of the replaced references are kept, So IDs of the other references stay valid.
+ * @param refs
+ * The references list.
+ * @param start
+ * Starting index of the first replaced reference (before the edit).
+ * @param end
+ * Starting index of the first kept reference after the replaced ones (before the edit).
+ * @param src
+ * The new references (their indices are already after the edit). They must fit between the kept references.
+ * @param delta
+ * Difference between indices of the kept references after and before the edit (modulo 2^32).
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em>.
+*/
+mr_byte_t mr_pool_refs_splice(
+    mr_pool_refs_t *refs, mr_long_t start, mr_long_t end, mr_pool_refs_t *src, mr_long_t delta);
+
+/**
+ * It decodes an integer literal (underscores are skipped). \n
+ * Runs of 8 digits are converted at once (SWAR) on little endian machines.
+ * @param res
+ * The decoded integer.
+ * @param str
+ * Starting point of the literal.
+ * @param size
+ * Size of the literal in characters.
+ * @return It returns \a MR_TRUE if the integer fits in 64 bits and \a MR_FALSE otherwise.
+*/
+mr_bool_t mr_pool_decode_int(
+    uint64_t *res, mr_str_ct str, mr_long_t size);
+
+/**
+ * It decodes a floating point literal (underscores are skipped). \n
+ * Literals with at most 53 bits of digits and an exponent between -22 and 22 are converted with a single multiplication or division,
+ * Which is exact since both operands are exact. Other literals are converted by the \a strtod function.
+ * @param res
+ * The decoded number.
+ * @param str
+ * Starting point of the literal (without the imaginary suffix).
+ * @param size
+ * Size of the literal in characters.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em>.
+*/
+mr_byte_t mr_pool_decode_float(
+    double *res, mr_str_ct str, mr_long_t size);
+
+/**
+ * It returns the character that an escape sequence stands for. \n
+ * Supported sequences: \\a, \\b, \\f, \\n, \\r, \\t, \\v, and \\0. Other characters stand for themselves (like \\\\ and \\').
+ * @param chr
+ * The character after '\\'.
+ * @return It returns the decoded character.
+*/
+mr_chr_t mr_pool_escape(
+    mr_chr_t chr);
+
+#endif
@@ -0,0 +1,72 @@
+/*
+MIT License
+
+Copyright (c) 2023 MetaReal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+*/
+
+/**
+ * @file source.h
+ * This file contains the functions that load source files into memory. \n
+ * Every loaded code is followed by <em>MR_LEXER_MARGIN</em> null characters, So it can be lexed in place. \n
+ * All things defined in \a source.c and this file have the \a mr_source prefix.
+*/
+
+#ifndef __MR_SOURCE__
+#define __MR_SOURCE__
+
+#include <defs.h>
+#include <stdio.h>
+
+/**
+ * It reads the code from the \a file into a block allocated for the <em>MR_MEM_SOURCE</em> phase
+ * (so its owner is <em>MR_CONFIG_SOURCE_HEAP</em>).
+ * @param file
+ * The file (positioned at its start).
+ * @param size
+ * Size of the file in characters.
+ * @return It returns the code, Or NULL if there isn't enough memory. \n
+ * The code must be freed by the \a mr_mem_free function.
+*/
+mr_str_t mr_source_read(
+    FILE *file, mr_long_t size);
+
+#ifdef __MR_SOURCE_MMAP__
+/**
+ * It maps the file into memory read-only (so its owner is <em>MR_CONFIG_SOURCE_MAPPED</em>). \n
+ * The lexer relies on <em>MR_LEXER_MARGIN</em> null characters after the code.
+ * The mapping supplies them from the zero-filled rest of its last page,
+ * So the file is only mapped if that part is large enough
+ * (files whose size is a multiple of the page size have no such part, So they are never mapped).
+ * @param fname
+ * Name of the file.
+ * @param size
+ * Size of the file in characters.
+ * @return It returns the mapped code. \n
+ * If the file can't be mapped (or its last page is too full), it returns NULL and the file should be read instead. \n
+ * The code must be unmapped by the \a mr_source_unmap function.
+*/
+mr_str_t mr_source_map(
+    mr_str_ct fname, mr_long_t size);
+
+/**
+ * It unmaps a code that is mapped by the \a mr_source_map function.
+ * @param code
+ * The code.
+ * @param size
+ * Size of the code in characters.
+*/
+void mr_source_unmap(
+    mr_str_t code, mr_long_t size);
+#endif
+
+#endif
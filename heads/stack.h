@@ -30,37 +30,51 @@ copies or substantial portions of the Software.
  * @struct __MR_STACK_T
  * The structure that organizes allocations in the parser and optimizer steps.
  * @var mr_byte_t* __MR_STACK_T::data
- * Data of the stack.
- * @var mr_ptr_t* __MR_STACK_T::ptrs
- * List of allocated pointers by the stack.
+ * Data of the stack. \n
+ * With stack reservation enabled, The data is a reserved address range whose pages are committed on demand, So it never moves.
+ * @var mr_byte_t* __MR_STACK_T::scratch
+ * Scratch space for building lists whose final size isn't known yet. \n
+ * Elements of a list are pushed into the scratch space and moved into the \a data with a single copy when the list is complete.
  * @var mr_long_t __MR_STACK_T::size
- * Allocated size of the data in bytes.
+ * Allocated (or committed) size of the data in bytes.
  * @var mr_long_t __MR_STACK_T::ptr
  * Pointer that points to the end of the stack data (stack pointer).
  * @var mr_long_t __MR_STACK_T::exalloc
- * Allocation step used for reallocating the stack data.
- * @var mr_long_t __MR_STACK_T::psize
- * Allocated size of the \a ptrs list.
- * @var mr_long_t __MR_STACK_T::pptr
- * Pointer that points to the end of the \a ptrs list.
- * @var mr_long_t __MR_STACK_T::pexalloc
- * Allocation step used for reallocating the \a ptrs list.
+ * Allocation step used for reallocating (or committing) the stack data.
+ * @var mr_long_t __MR_STACK_T::ssize
+ * Allocated size of the \a scratch space in bytes.
+ * @var mr_long_t __MR_STACK_T::sptr
+ * Pointer that points to the end of the \a scratch space.
 */
 struct __MR_STACK_T
 {
     mr_byte_t *data;
-    mr_ptr_t *ptrs;
+    mr_byte_t *scratch;
 
     mr_long_t size;
     mr_long_t ptr;
     mr_long_t exalloc;
 
-    mr_long_t psize;
-    mr_long_t pptr;
-    mr_long_t pexalloc;
+    mr_long_t ssize;
+    mr_long_t sptr;
 };
 typedef struct __MR_STACK_T mr_stack_t;
 
+/**
+ * @struct __MR_STACK_MARK_T
+ * A checkpoint of the stack that can be released to discard everything allocated after it.
+ * @var mr_long_t __MR_STACK_MARK_T::ptr
+ * Stack pointer of the data when the mark was taken.
+ * @var mr_long_t __MR_STACK_MARK_T::sptr
+ * Pointer to the end of the \a scratch space when the mark was taken.
+*/
+struct __MR_STACK_MARK_T
+{
+    mr_long_t ptr;
+    mr_long_t sptr;
+};
+typedef struct __MR_STACK_MARK_T mr_stack_mark_t;
+
 /**
  * The \a mr_stack_t instant that stores parser and optimizer allocations.
 */
@@ -71,13 +85,13 @@ extern mr_stack_t _mr_stack;
  * If the initialization failed, it returns an error.
  * @param size
  * Size of the \a data field.
- * @param psize
- * Size of the \a ptrs field.
+ * @param ssize
+ * Size of the \a scratch field.
  * @return It returns a code which indicates if the process was successful or not. \n
  * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns the error code (defined in \a defs.h header file).
 */
 mr_byte_t mr_stack_init(
-    mr_long_t size, mr_long_t psize);
+    mr_long_t size, mr_long_t ssize);
 
 /**
  * It pushes a new data into the stack. \n
@@ -93,30 +107,48 @@ mr_byte_t mr_stack_push(
     mr_long_t *ptr, mr_byte_t size);
 
 /**
- * It allocates a new dynamic pointer and stores it in the \a ptrs list. \n
- * The returned value will be the index of the pointer in \a ptrs list.
- * @param ptr
- * Pointer to the allocated data.
+ * It pushes an element of a list into the \a scratch space. \n
+ * The scratch space is doubled whenever it's full.
+ * @param elem
+ * Pointer to the element.
  * @param size
- * Requested size for the block.
+ * Size of the element in bytes.
  * @return It returns a code which indicates if the process was successful or not. \n
  * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns the error code (defined in \a defs.h header file).
 */
-mr_byte_t mr_stack_palloc(
-    mr_long_t *ptr, mr_long_t size);
+mr_byte_t mr_stack_scratch_push(
+    mr_ptr_t elem, mr_byte_t size);
 
 /**
- * It reallocates pointer that is stored in the specified index of the \a ptrs list. \n
- * The new pointer will be placed at the specified index.
+ * It moves the elements that were pushed into the \a scratch space after \a base to the stack data with a single copy. \n
+ * The list takes exactly the size of its elements, And the scratch space is released back to \a base. \n
+ * Lists can be nested, As long as the inner list is moved before the outer list pushes its next element.
  * @param ptr
  * Pointer to the allocated data.
- * @param size
- * Requested size for the block.
+ * @param base
+ * Pointer to the end of the \a scratch space before the first element of the list was pushed.
  * @return It returns a code which indicates if the process was successful or not. \n
  * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns the error code (defined in \a defs.h header file).
 */
-mr_byte_t mr_stack_prealloc(
-    mr_long_t ptr, mr_long_t size);
+mr_byte_t mr_stack_scratch_pop(
+    mr_long_t *ptr, mr_long_t base);
+
+/**
+ * It takes a checkpoint of the stack data and the \a scratch space.
+ * @return It returns the checkpoint.
+*/
+mr_stack_mark_t mr_stack_mark(void);
+
+/**
+ * It releases the stack back to the \a mark checkpoint in constant time. \n
+ * Data allocated after the mark is discarded (its memory is kept for the next allocations),
+ * So any offsets taken after the mark become invalid. \n
+ * Marks that were taken after \a mark must not be released after it.
+ * @param mark
+ * The checkpoint (returned by \a mr_stack_mark).
+*/
+void mr_stack_release(
+    mr_stack_mark_t mark);
 
 /**
  * It clears the stack and its data.
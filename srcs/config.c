@@ -22,7 +22,8 @@ copies or substantial portions of the Software.
 #include <config.h>
 #include <string.h>
 
-mr_config_t _mr_config = {.outstream=NULL, .instream=NULL, .errstream=NULL, .code=NULL, .fname=NULL, .size=0};
+mr_config_t _mr_config = {.outstream=NULL, .instream=NULL, .errstream=NULL, .code=NULL, .fname=NULL, .size=0,
+    .source=MR_CONFIG_SOURCE_BORROWED};
 
 void mr_config_opt(
     mr_byte_t olevel)
@@ -20,10 +20,17 @@ copies or substantial portions of the Software.
 */
 
 #include <error/error.h>
+#include <lexer/scan.h>
+#include <lexer/unicode.h>
 #include <config.h>
-#include <stdlib.h>
+#include <consts.h>
+#include <mem.h>
 #include <stdio.h>
 
+#ifdef __MR_TOKEN_PULL__
+#include <lexer/lexer.h>
+#endif
+
 /**
  * Number of invalid semantic types
 */
@@ -39,25 +46,88 @@ static mr_str_ct mr_invalid_semantic_label[MR_INVALID_SEMANTIC_COUNT] =
     "InvalidDollarMethod"
 };
 
+mr_error_lines_t _mr_error_lines = {.data=NULL, .size=0, .alloc=0, .code=NULL, .csize=0};
+
+/**
+ * It builds the line table of <em>_mr_config.code</em>. \n
+ * Newlines are found with the scanning subroutines (see <em>_mr_scan.line</em>).
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em>.
+*/
+mr_byte_t mr_error_lines_build(void);
+
+mr_long_t mr_error_line(
+    mr_long_t idx, mr_long_t *start)
+{
+    mr_long_t i, ln, low, high, mid;
+
+    if ((_mr_error_lines.code != _mr_config.code || _mr_error_lines.csize != _mr_config.size) &&
+        mr_error_lines_build() != MR_NOERROR)
+    {
+        ln = 1;
+        *start = 0;
+        for (i = 0; i != idx; i++)
+            if (_mr_config.code[i] == '\n')
+            {
+                *start = i + 1;
+                ln++;
+            }
+    }
+    else
+    {
+        low = 0;
+        high = _mr_error_lines.size;
+        while (low != high)
+        {
+            mid = low + (high - low) / 2;
+            if (_mr_error_lines.data[mid] <= idx)
+                low = mid + 1;
+            else
+                high = mid;
+        }
+
+        *start = low ? _mr_error_lines.data[low - 1] : 0;
+        ln = low + 1;
+    }
+
+    /* The lexer skips a leading byte order mark, So the first line starts after it. */
+    if (!*start && idx >= MR_UNICODE_BOM_SIZE && mr_unicode_bom(_mr_config.code))
+        *start = MR_UNICODE_BOM_SIZE;
+    return ln;
+}
+
+void mr_error_lines_free(void)
+{
+    mr_mem_free(_mr_error_lines.data);
+    _mr_error_lines = (mr_error_lines_t){.data=NULL, .size=0, .alloc=0, .code=NULL, .csize=0};
+}
+
 void mr_illegal_chr_print(
     mr_illegal_chr_t error)
 {
-    mr_long_t i, ln, start;
+    mr_long_t i, ln, start, value;
     mr_chr_t chr;
+    mr_byte_t size;
 
     if (error.expected)
-        fprintf(_mr_config.errstream, "\nExpected Character Error: '%c'\n", error.chr);
+        fprintf(_mr_config.errstream, "\nExpected Character Error: '%c'\n", *error.chr);
+    else if ((mr_byte_t)*error.chr < 0x80)
+        fprintf(_mr_config.errstream, "\nIllegal Character Error: '%c'\n", *error.chr);
     else
-        fprintf(_mr_config.errstream, "\nIllegal Character Error: '%c'\n", error.chr);
-
-    ln = 1;
-    start = 0;
-    for (i = 0; i != error.idx; i++)
-        if (_mr_config.code[i] == '\n')
+    {
+        value = mr_unicode_decode(error.chr, &size);
+        if (value != MR_UNICODE_INVALID)
+            fprintf(_mr_config.errstream, "\nIllegal Character Error: '%s' (U+%04" PRIX32 ")\n", error.chr, value);
+        else
         {
-            start = i + 1;
-            ln++;
+            fputs("\nIllegal Character Error: Invalid UTF-8 sequence ", _mr_config.errstream);
+            for (size = 0; size != error.size; size++)
+                fprintf(_mr_config.errstream, "\\x%02" PRIX8, (mr_byte_t)error.chr[size]);
+            fputc('\n', _mr_config.errstream);
         }
+    }
+
+    ln = mr_error_line(error.idx, &start);
 
     fprintf(_mr_config.errstream, "File \"%s\", line %" PRIu32 "\n\n", _mr_config.fname, ln);
 
@@ -87,21 +157,14 @@ void mr_invalid_syntax_print(
     else
         fputs("\nInvalid Syntax Error\n", _mr_config.errstream);
 
-    ln = 1;
-    start = 0;
-    idx = MR_IDX_EXTRACT(error->token->idx);
-    for (i = 0; i != idx; i++)
-        if (_mr_config.code[i] == '\n')
-        {
-            start = i + 1;
-            ln++;
-        }
+    idx = MR_IDX_EXTRACT(mr_token_cursor_idx(&error->token));
+    ln = mr_error_line(idx, &start);
 
     fprintf(_mr_config.errstream, "File \"%s\", line %" PRIu32 "\n\n", _mr_config.fname, ln);
 
-    if (error->token->type == MR_TOKEN_EOF)
+    if (mr_token_cursor_type(&error->token) == MR_TOKEN_EOF)
     {
-        fprintf(_mr_config.errstream, "%.*s\n", _mr_config.size - start, _mr_config.code);
+        fprintf(_mr_config.errstream, "%.*s\n", _mr_config.size - start, _mr_config.code + start);
 
         for (i = start; i != idx; i++)
             fputc(' ', _mr_config.errstream);
@@ -109,7 +172,7 @@ void mr_invalid_syntax_print(
         return;
     }
 
-    eidx = idx + mr_token_getsize(error->token);
+    eidx = idx + mr_token_cursor_getsize(&error->token);
     for (end = start; end != _mr_config.size; end++)
     {
         chr = _mr_config.code[end];
@@ -144,24 +207,17 @@ void mr_invalid_semantic_print(
 
     fprintf(_mr_config.errstream, "\nInvalid Semantic Error: %s\n", error->detail);
     if (error->is_static)
-        free(error->detail);
+        mr_mem_free(error->detail);
 
     fprintf(_mr_config.errstream, "Error Type: %s\n", mr_invalid_semantic_label[error->type]);
 
-    ln = 1;
-    start = 0;
-    for (i = 0; i != error->idx; i++)
-        if (_mr_config.code[i] == '\n')
-        {
-            start = i + 1;
-            ln++;
-        }
+    ln = mr_error_line(error->idx, &start);
 
     fprintf(_mr_config.errstream, "File \"%s\", line %" PRIu32 "\n\n", _mr_config.fname, ln);
 
     eidx = error->idx + error->size;
-    if (error->token->type != MR_TOKEN_EOF)
-        eidx += mr_token_getsize(error->token);
+    if (mr_token_cursor_type(&error->token) != MR_TOKEN_EOF)
+        eidx += mr_token_cursor_getsize(&error->token);
 
     for (end = start; end != _mr_config.size; end++)
     {
@@ -188,3 +244,44 @@ void mr_invalid_semantic_print(
 
     fputs("\n\n", _mr_config.errstream);
 }
+
+mr_byte_t mr_error_lines_build(void)
+{
+    mr_long_t i;
+    mr_long_t *block;
+
+    mr_error_lines_free();
+
+    _mr_error_lines.alloc = _mr_config.size / MR_ERROR_LINES_CHUNK + 1;
+    _mr_error_lines.data = mr_mem_malloc(MR_MEM_SOURCE, _mr_error_lines.alloc * sizeof(mr_long_t));
+    if (!_mr_error_lines.data)
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    for (i = 0;; i++)
+    {
+        i = _mr_scan.line(_mr_config.code, i, _mr_config.size);
+        if (i == _mr_config.size)
+            break;
+        if (_mr_config.code[i] != '\n')
+            continue;
+
+        if (_mr_error_lines.size == _mr_error_lines.alloc)
+        {
+            block = mr_mem_realloc(MR_MEM_SOURCE, _mr_error_lines.data, _mr_error_lines.alloc * 2 * sizeof(mr_long_t));
+            if (!block)
+            {
+                mr_error_lines_free();
+                return MR_ERROR_NOT_ENOUGH_MEMORY;
+            }
+
+            _mr_error_lines.data = block;
+            _mr_error_lines.alloc *= 2;
+        }
+
+        _mr_error_lines.data[_mr_error_lines.size++] = i + 1;
+    }
+
+    _mr_error_lines.code = _mr_config.code;
+    _mr_error_lines.csize = _mr_config.size;
+    return MR_NOERROR;
+}
@@ -0,0 +1,88 @@
+# MetaReal token specification.
+# This file is read by the tools/dfagen.c generator to build the table-driven lexer engine (MR_LEXER_DFA build option).
+#
+# Syntax:
+#   class <name> "<characters>"    Defines a named character set. Ranges like a-z are allowed.
+#   <pattern> <result>             Defines a token rule.
+#
+# A pattern is a sequence of "quoted literals" and {class} references.
+# A result is either an MR_TOKEN_* type or an @action which is handed over to a hand-written subroutine
+# (the action always starts from the first character of the pattern).
+# When more than one rule matches, the longest match wins.
+# Escape sequences: \\ \" \' \n \t \r
+# Lines starting with '#' are comments.
+
+class digit "0-9"
+class ident "A-Za-eg-z_"
+
+# Dispatched subroutines.
+"\n"          @newline
+"#"           @comment
+";"           @semicolon
+"\\"          @backslash
+"'"           @chr
+"\""          @str
+"f"           @fprefix
+{ident}       @identifier
+{digit}       @number
+"."{digit}    @number
+"{"           @lcurly
+"}"           @rcurly
+
+# Arithmetic operators.
+"+"           MR_TOKEN_PLUS
+"++"          MR_TOKEN_INCREMENT
+"+="          MR_TOKEN_PLUS_ASSIGN
+"-"           MR_TOKEN_MINUS
+"--"          MR_TOKEN_DECREMENT
+"-="          MR_TOKEN_MINUS_ASSIGN
+"->"          MR_TOKEN_LINK
+"*"           MR_TOKEN_MULTIPLY
+"*="          MR_TOKEN_MULTIPLY_ASSIGN
+"**"          MR_TOKEN_POWER
+"**="         MR_TOKEN_POWER_ASSIGN
+"/"           MR_TOKEN_DIVIDE
+"/="          MR_TOKEN_DIVIDE_ASSIGN
+"//"          MR_TOKEN_QUOTIENT
+"//="         MR_TOKEN_QUOTIENT_ASSIGN
+"%"           MR_TOKEN_MODULO
+"%="          MR_TOKEN_MODULO_ASSIGN
+
+# Bitwise and logical operators.
+"&"           MR_TOKEN_B_AND
+"&="          MR_TOKEN_B_AND_ASSIGN
+"&&"          MR_TOKEN_AND_K
+"|"           MR_TOKEN_B_OR
+"|="          MR_TOKEN_B_OR_ASSIGN
+"||"          MR_TOKEN_OR_K
+"^"           MR_TOKEN_B_XOR
+"^="          MR_TOKEN_B_XOR_ASSIGN
+"~"           MR_TOKEN_B_NOT
+"!"           MR_TOKEN_NOT_K
+
+# Comparison and assignment operators.
+"="           MR_TOKEN_ASSIGN
+"=="          MR_TOKEN_EQUAL
+"==="         MR_TOKEN_EX_EQUAL
+"!="          MR_TOKEN_NEQUAL
+"!=="         MR_TOKEN_EX_NEQUAL
+"<"           MR_TOKEN_LESS
+"<="          MR_TOKEN_LESS_EQUAL
+"<<"          MR_TOKEN_L_SHIFT
+"<<="         MR_TOKEN_L_SHIFT_ASSIGN
+">"           MR_TOKEN_GREATER
+">="          MR_TOKEN_GREATER_EQUAL
+">>"          MR_TOKEN_R_SHIFT
+">>="         MR_TOKEN_R_SHIFT_ASSIGN
+
+# Punctuation.
+"("           MR_TOKEN_L_PAREN
+")"           MR_TOKEN_R_PAREN
+"["           MR_TOKEN_L_SQUARE
+"]"           MR_TOKEN_R_SQUARE
+","           MR_TOKEN_COMMA
+"."           MR_TOKEN_DOT
+"..."         MR_TOKEN_ELLIPSIS
+":"           MR_TOKEN_COLON
+"?"           MR_TOKEN_QUESTION
+"$"           MR_TOKEN_DOLLAR
@@ -20,31 +20,54 @@ copies or substantial portions of the Software.
 */
 
 #include <lexer/lexer.h>
+#include <lexer/scan.h>
+#include <lexer/unicode.h>
 #include <config.h>
-#include <stdlib.h>
+#include <pool.h>
+#include <mem.h>
 #include <string.h>
 #include <consts.h>
 
+#ifdef __MR_LEXER_DFA__
+#include <lexer/dfa.h>
+#endif
+
+#ifdef __MR_LEXER_PARALLEL__
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
 /**
- * @def mr_lexer_tokens_realloc
- * It reallocates the \a tokens list. \n
- * This macro is used by the \a mr_lexer_generate_fstr function.
-*/
-#define mr_lexer_tokens_realloc                                                                 \
-    do                                                                                          \
-        if (data->size == data->alloc)                                                          \
-        {                                                                                       \
-            block = realloc(data->tokens, (data->alloc += data->exalloc) * sizeof(mr_token_t)); \
-            if (!block)                                                                         \
-            {                                                                                   \
-                data->flag = MR_LEXER_MATCH_FLAG_MEMORY;                                        \
-                return;                                                                         \
-            }                                                                                   \
-                                                                                                \
-            data->tokens = block;                                                               \
-        }                                                                                       \
+ * @def mr_lexer_tokens_reserve(count)
+ * It extends the \a tokens list until it has room for \a count more tokens. \n
+ * This macro is used by the functions that generate more than one token at once (pieces of formatted strings).
+ * @param count
+ * Number of the tokens.
+*/
+#define mr_lexer_tokens_reserve(count)                   \
+    do                                                   \
+        while (data->alloc - data->size < count)         \
+            if (mr_lexer_tokens_grow(data))              \
+            {                                            \
+                data->flag = MR_LEXER_MATCH_FLAG_MEMORY; \
+                return;                                  \
+            }                                            \
     while (0)
 
+#ifdef __MR_TOKEN_SPANS__
+/**
+ * @def mr_lexer_token_end(tok, end)
+ * It records the ending index of a token in the \a ends list.
+ * @param tok
+ * Pointer to the token.
+ * @param end
+ * Index of the first character after the token.
+*/
+#define mr_lexer_token_end(tok, end) (data->ends[(tok) - data->tokens] = MR_IDX_DECOMPOSE(end))
+#else
+#define mr_lexer_token_end(tok, end) ((void)0)
+#endif
+
 /**
  * @def mr_lexer_token_set(typ, inc)
  * It creates a new token with a given type. \n
@@ -60,6 +83,7 @@ copies or substantial portions of the Software.
         *token = (mr_token_t){.type=typ, .idx=MR_IDX_DECOMPOSE(data->idx)}; \
                                                                             \
         data->idx += inc;                                                   \
+        mr_lexer_token_end(token, data->idx);                               \
         data->size++;                                                       \
     } while (0)
 
@@ -75,7 +99,7 @@ copies or substantial portions of the Software.
 #define mr_lexer_token_set2(typ, inc)                                       \
     do                                                                      \
     {                                                                       \
-        token = data->tokens + data->size ## inc;                           \
+        token = data->tokens + data->size inc;                              \
         *token = (mr_token_t){.type=typ, .idx=MR_IDX_DECOMPOSE(data->idx)}; \
     } while (0)
 
@@ -213,7 +237,8 @@ copies or substantial portions of the Software.
 
 /**
  * @def mr_lexer_skip_spaces(code, idx)
- * It skips space characters (' ', '\t', and '\r') from the \a code and advances <em>idx</em>.
+ * It skips space characters (' ', '\t', and '\r') from the \a code and advances <em>idx</em>. \n
+ * A single space is skipped inline. Longer runs (indentations) are skipped by the \a spaces scanning subroutine.
  * @param chr
  * Current character of the code.
  * @param code
@@ -221,9 +246,19 @@ copies or substantial portions of the Software.
  * @param idx
  * Index of the current character ( \a idx field of \a pos structure).
 */
-#define mr_lexer_skip_spaces(chr, code, idx)         \
-    while (chr == ' ' || chr == '\t' || chr == '\r') \
-        chr = code[++idx]
+#define mr_lexer_skip_spaces(chr, code, idx)                   \
+    do                                                         \
+    {                                                          \
+        if (chr != ' ' && chr != '\t' && chr != '\r')          \
+            break;                                             \
+                                                               \
+        chr = code[++idx];                                     \
+        if (chr != ' ' && chr != '\t' && chr != '\r')          \
+            break;                                             \
+                                                               \
+        idx = _mr_scan.spaces(code, idx + 1, _mr_config.size); \
+        chr = code[idx];                                       \
+    } while (0)
 
 /**
  * @def mr_lexer_add_newline(prev)
@@ -240,7 +275,7 @@ copies or substantial portions of the Software.
 
 /**
  * @def mr_lexer_str_sub
- * The subroutine for \a mr_lexer_generate_str and <em>mr_lexer_generate_fstr</em> functions.
+ * The subroutine for the \a mr_lexer_generate_str function.
 */
 #define mr_lexer_str_sub                              \
     do                                                \
@@ -257,6 +292,31 @@ copies or substantial portions of the Software.
         chr = _mr_config.code[++data->idx];           \
     } while (0)
 
+/**
+ * @struct __MR_LEXER_FSTR_T
+ * A formatted string that is open during the matching process. \n
+ * Formatted strings are lexed by the main loop of the lexer, So an interpolation (<em>{...}</em>) is matched like the rest of the code,
+ * And the formatted string continues when its closing curly bracket is reached.
+ * @var mr_long_t __MR_LEXER_FSTR_T::start
+ * Index of the <em>MR_TOKEN_FSTR_START</em> token (only available with token spans enabled).
+ * @var mr_long_t __MR_LEXER_FSTR_T::lcurly
+ * Number of the curly brackets that are open inside the current interpolation.
+ * @var mr_chr_t __MR_LEXER_FSTR_T::quot
+ * The quotation mark that closes the formatted string.
+ * @var mr_bool_t __MR_LEXER_FSTR_T::esc
+ * If \a esc is equal to \a MR_FALSE (by using '\\' prefix), All escape sequences will be avoided.
+*/
+struct __MR_LEXER_FSTR_T
+{
+#ifdef __MR_TOKEN_SPANS__
+    mr_long_t start;
+#endif
+    mr_long_t lcurly;
+    mr_chr_t quot;
+    mr_bool_t esc;
+};
+typedef struct __MR_LEXER_FSTR_T mr_lexer_fstr_t;
+
 /**
  * @struct __MR_LEXER_MATCH_T
  * Input of the \a mr_lexer_match function.
@@ -275,6 +335,25 @@ copies or substantial portions of the Software.
  * If \a size reaches the \a alloc limit, the \a exalloc is used for allocating extra memory.
  * @var mr_long_t __MR_LEXER_MATCH_T::idx
  * An index for the current character of the code.
+ * @var mr_long_t __MR_LEXER_MATCH_T::base
+ * Index of the first character of the code in the whole input (nonzero in the streaming lexer). \n
+ * References of the pools are relative to the whole input.
+ * @var mr_pool_consts_t __MR_LEXER_MATCH_T::consts
+ * Pool of the numeric and character literals decoded during the matching process.
+ * @var mr_pool_syms_t __MR_LEXER_MATCH_T::syms
+ * Pool of the identifiers interned during the matching process.
+ * @var mr_pool_strs_t __MR_LEXER_MATCH_T::strs
+ * Pool of the string literals decoded during the matching process.
+ * @var mr_long_t __MR_LEXER_MATCH_T::utf8
+ * Index of the first character that is not a part of a valid UTF-8 sequence (<em>MR_INVALID_IDX_CODE</em> if the code is valid).
+ * @var mr_lexer_fstr_t* __MR_LEXER_MATCH_T::fstrs
+ * Stack of the open formatted strings (the innermost one is at the top).
+ * @var mr_long_t __MR_LEXER_MATCH_T::fsize
+ * Size of the \a fstrs stack.
+ * @var mr_long_t __MR_LEXER_MATCH_T::falloc
+ * Allocated size of the \a fstrs stack.
+ * @var mr_idx_t* __MR_LEXER_MATCH_T::ends
+ * Ending indices of the tokens (parallel to the \a tokens list, only available with token spans enabled).
 */
 struct __MR_LEXER_MATCH_T
 {
@@ -286,6 +365,21 @@ struct __MR_LEXER_MATCH_T
     mr_long_t exalloc;
 
     mr_long_t idx;
+    mr_long_t base;
+
+    mr_pool_consts_t consts;
+    mr_pool_syms_t syms;
+    mr_pool_strs_t strs;
+
+    mr_long_t utf8;
+
+    mr_lexer_fstr_t *fstrs;
+    mr_long_t fsize;
+    mr_long_t falloc;
+
+#ifdef __MR_TOKEN_SPANS__
+    mr_idx_t *ends;
+#endif
 };
 typedef struct __MR_LEXER_MATCH_T mr_lexer_match_t;
 
@@ -309,6 +403,338 @@ enum __MR_LEXER_MATCH_FLAG_ENUM
     MR_LEXER_MATCH_FLAG_MEMORY
 };
 
+/**
+ * @struct __MR_LEXER_WINDOW_T
+ * The window of the code that the streaming lexer keeps in memory.
+ * @var mr_str_t __MR_LEXER_WINDOW_T::code
+ * Characters of the window followed by <em>MR_LEXER_MARGIN</em> null characters.
+ * @var mr_long_t __MR_LEXER_WINDOW_T::size
+ * Number of characters in the window.
+ * @var mr_long_t __MR_LEXER_WINDOW_T::alloc
+ * Maximum number of characters that can be stored in the window.
+ * @var mr_long_t __MR_LEXER_WINDOW_T::base
+ * Index of the first character of the window in the whole input.
+ * @var mr_bool_t __MR_LEXER_WINDOW_T::eof
+ * It indicates that the whole input is read.
+ * @var mr_long_t __MR_LEXER_WINDOW_T::valid
+ * Number of characters (from the beginning of the window) that are validated as UTF-8. \n
+ * A sequence that is cut off by the end of the window is validated after the next chunk is read.
+ * @var mr_long_t __MR_LEXER_WINDOW_T::utf8
+ * Index of the first character of the window that is not a part of a valid UTF-8 sequence (<em>MR_INVALID_IDX_CODE</em> if there is none). \n
+ * Characters after it are not validated.
+*/
+struct __MR_LEXER_WINDOW_T
+{
+    mr_str_t code;
+    mr_long_t size;
+    mr_long_t alloc;
+    mr_long_t base;
+    mr_bool_t eof;
+
+    mr_long_t valid;
+    mr_long_t utf8;
+};
+typedef struct __MR_LEXER_WINDOW_T mr_lexer_window_t;
+
+#ifdef __MR_LEXER_PARALLEL__
+/**
+ * @struct __MR_LEXER_CHUNK_T
+ * A chunk of the code that is lexed by a worker thread in the parallel mode. \n
+ * Chunks start at newlines. A newline inside a string or a comment is only detected after lexing the previous chunk.
+ * @var mr_lexer_match_t __MR_LEXER_CHUNK_T::data
+ * Matching data of the chunk. Its \a idx field holds the index that the worker stopped at.
+ * @var mr_long_t __MR_LEXER_CHUNK_T::start
+ * Index of the first character of the chunk.
+ * @var mr_long_t __MR_LEXER_CHUNK_T::end
+ * Index of the first character after the chunk.
+ * @var mr_long_t __MR_LEXER_CHUNK_T::lead
+ * Index of the first token of the chunk (spaces, newlines, semicolons, and comments before it are skipped).
+*/
+struct __MR_LEXER_CHUNK_T
+{
+    mr_lexer_match_t data;
+    mr_long_t start;
+    mr_long_t end;
+    mr_long_t lead;
+};
+typedef struct __MR_LEXER_CHUNK_T mr_lexer_chunk_t;
+
+/**
+ * It determines the number of threads that the lexer should use based on the code size and number of processors.
+ * @return It returns number of threads.
+*/
+mr_byte_t mr_lexer_parallel_count(void);
+
+/**
+ * The worker thread subroutine that lexes a single chunk of the code. \n
+ * It stops at the first token that ends at or after the end of the chunk.
+ * @param chunk
+ * The chunk (<em>mr_lexer_chunk_t</em>).
+ * @return It returns NULL.
+*/
+mr_ptr_t mr_lexer_parallel_worker(
+    mr_ptr_t chunk);
+
+/**
+ * It stitches tokens of the chunks into a single list. \n
+ * Tokens of a chunk (and its constants) are only used if the previous chunk stopped exactly at its start (outside of formatted strings). Otherwise, the chunk is lexed again. \n
+ * Spaces, newlines, semicolons, and comments at the start of each chunk are lexed again after the previous tokens,
+ * So the newline and semicolon rules are applied across chunks.
+ * @param data
+ * Data structure that receives the tokens.
+ * @param chunks
+ * List of chunks.
+ * @param count
+ * Number of chunks.
+*/
+void mr_lexer_parallel_stitch(
+    mr_lexer_match_t *data, mr_lexer_chunk_t *chunks, mr_byte_t count);
+#endif
+
+/**
+ * It initializes the matching data and allocates the \a tokens list (and the \a ends list if token spans are enabled). \n
+ * The \a consts, \a syms, and \a strs pools start empty.
+ * @param data
+ * Data structure containing all necessary information about the code.
+ * @param alloc
+ * Number of tokens that should be allocated.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em>.
+*/
+mr_byte_t mr_lexer_match_init(
+    mr_lexer_match_t *data, mr_long_t alloc);
+
+/**
+ * It frees the \a tokens list (and the \a ends list if token spans are enabled) and the pools of the matching data.
+ * @param data
+ * Data structure containing all necessary information about the code.
+*/
+void mr_lexer_match_free(
+    mr_lexer_match_t *data);
+
+/**
+ * It validates the code between \a start and \a end as UTF-8 and stores index of the first invalid character in the \a utf8 field of the data.
+ * @param data
+ * Data structure containing all necessary information about the code.
+ * @param start
+ * Index of the first validated character.
+ * @param end
+ * Index of the first character after the validated ones.
+*/
+void mr_lexer_match_validate(
+    mr_lexer_match_t *data, mr_long_t start, mr_long_t end);
+
+/**
+ * It reports the invalid UTF-8 character of the code as an illegal character, Unless the matching process failed before it. \n
+ * The validation runs separately from the matching process, So the earliest of the two errors is reported.
+ * @param data
+ * Data structure containing all necessary information about the code.
+*/
+void mr_lexer_match_utf8(
+    mr_lexer_match_t *data);
+
+/**
+ * It reports a formatted string that is still open at the end of the code as a missing closing curly bracket (the code ends inside its interpolation),
+ * Unless the matching process failed before.
+ * @param data
+ * Data structure containing all necessary information about the code.
+*/
+void mr_lexer_match_fstr(
+    mr_lexer_match_t *data);
+
+/**
+ * It finishes the lexer process. \n
+ * If the matching process failed, it frees the lists and sets the error. Otherwise, it appends the <em>MR_TOKEN_EOF</em> token and shrinks the \a tokens list. \n
+ * The \a consts, \a syms, and \a strs pools are moved into <em>_mr_pool_consts</em>, <em>_mr_pool_syms</em>, and <em>_mr_pool_strs</em> (which are emptied if the process failed).
+ * @param data
+ * Data structure containing all necessary information about the code.
+ * @param res
+ * Result of the lexer process.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns the error code (defined in \a defs.h header file).
+*/
+mr_byte_t mr_lexer_finish(
+    mr_lexer_match_t *data, mr_lexer_t *res);
+
+/**
+ * It reads the next chunk of the code into the window and validates it as UTF-8. \n
+ * The window is extended if less than half a chunk of space is left in it. \n
+ * A null character in the input is considered as the end of the code.
+ * @param window
+ * The window of the code.
+ * @param res
+ * Input of the streaming lexer.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns the error code (defined in \a defs.h header file).
+*/
+mr_byte_t mr_lexer_window_read(
+    mr_lexer_window_t *window, mr_lexer_stream_t *res);
+
+/**
+ * It hands over all tokens except the last one to the consumer and drops the characters before the last token from the window. \n
+ * A batch is handed over whenever characters are dropped, So it can be empty. Nothing is handed over while a formatted string is open. \n
+ * Then, it reads the next chunk of the code.
+ * @param data
+ * Data structure containing all necessary information about the code.
+ * @param window
+ * The window of the code.
+ * @param res
+ * Input of the streaming lexer.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns the error code (defined in \a defs.h header file).
+*/
+mr_byte_t mr_lexer_stream_flush(
+    mr_lexer_match_t *data, mr_lexer_window_t *window, mr_lexer_stream_t *res);
+
+/**
+ * It finds the token that re-lexing an edited code starts from. \n
+ * It's the last token that starts at least <em>MR_LEXER_MARGIN</em> characters before the edit (so the lookahead of the tokens before it can't reach the edit),
+ * Moved back to the start of the outermost formatted string that contains it.
+ * @param res
+ * Result of the previous lexer call (with the \a fstrs list).
+ * @param start
+ * Index of the first replaced character.
+ * @return It returns index of the token, Or zero if the code must be lexed from the beginning.
+*/
+mr_long_t mr_lexer_edit_restart(
+    mr_lexer_t *res, mr_long_t start);
+
+/**
+ * It builds the \a fstrs list of the <em>res</em>.
+ * @param res
+ * Result of the previous lexer call.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em>.
+*/
+mr_byte_t mr_lexer_edit_index(
+    mr_lexer_t *res);
+
+/**
+ * It finds the outermost formatted strings between two tokens.
+ * The token at \a start must be outside of formatted strings.
+ * @param fstrs
+ * The list that indices of the first and the last token of the formatted strings are written into (in pairs), Or NULL if they're only counted.
+ * @param res
+ * Result of the lexer call.
+ * @param start
+ * Index of the first token.
+ * @param end
+ * Index of the token after the last one.
+ * @return It returns number of the formatted strings.
+*/
+mr_long_t mr_lexer_edit_collect(
+    mr_long_t *fstrs, mr_lexer_t *res, mr_long_t start, mr_long_t end);
+
+/**
+ * It finds the first formatted string of the \a fstrs list that starts at or after a token.
+ * @param res
+ * Result of the lexer call.
+ * @param idx
+ * Index of the token.
+ * @return It returns index of the formatted string in the \a fstrs list (in pairs), Or \a fsize if there is no such formatted string.
+*/
+mr_long_t mr_lexer_edit_bound(
+    mr_lexer_t *res, mr_long_t idx);
+
+/**
+ * It updates the \a fstrs list after the tokens between \a first and \a last were replaced with \a count new tokens. \n
+ * Tokens at \a first and \a last (before the edit) must be outside of formatted strings.
+ * @param res
+ * Result of the lexer call (with the new tokens).
+ * @param first
+ * Index of the first replaced token.
+ * @param last
+ * Index of the first kept token after the replaced ones (before the edit).
+ * @param count
+ * Number of the new tokens.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em>.
+*/
+mr_byte_t mr_lexer_edit_fstrs(
+    mr_lexer_t *res, mr_long_t first, mr_long_t last, mr_long_t count);
+
+/**
+ * It replaces characters of the code between \a start and \a end with the <em>text</em>. \n
+ * Slices of <em>_mr_pool_strs</em> are prepared for the edit before the code changes. \n
+ * The <em>MR_LEXER_MARGIN</em> null characters after the code are written again,
+ * So nothing of the old code stays in the lookahead of the lexer when the code shrinks.
+ * @param start
+ * Index of the first replaced character.
+ * @param end
+ * Index of the first character after the replaced ones.
+ * @param text
+ * The new characters.
+ * @param size
+ * Number of the new characters.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em> (the code is not changed).
+*/
+mr_byte_t mr_lexer_edit_code(
+    mr_long_t start, mr_long_t end, mr_str_ct text, mr_long_t size);
+
+/**
+ * It replaces the old tokens between \a first and \a last with the tokens of the matching data,
+ * And moves the tokens after them (including the <em>MR_TOKEN_EOF</em> token) by <em>delta</em>. \n
+ * If \a first is nonzero, The first token of the matching data is the context token (a copy of the token before <em>first</em>), And its type is copied back.
+ * @param res
+ * Result of the previous lexer call.
+ * @param data
+ * Data structure containing the new tokens.
+ * @param first
+ * Index of the first replaced token.
+ * @param last
+ * Index of the first kept token after the replaced ones.
+ * @param delta
+ * Size difference of the code (modulo 2^32).
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em>.
+*/
+mr_byte_t mr_lexer_edit_splice(
+    mr_lexer_t *res, mr_lexer_match_t *data, mr_long_t first, mr_long_t last, mr_long_t delta);
+
+#ifdef __MR_TOKEN_PULL__
+/**
+ * @def mr_lexer_pull_done(data)
+ * It checks that the pull-based lexer reached the end of the code (its last token is the <em>MR_TOKEN_EOF</em> token).
+ * @param data
+ * Pointer to the matching data.
+*/
+#define mr_lexer_pull_done(data) ((data)->size && (data)->tokens[(data)->size - 1].type == MR_TOKEN_EOF)
+
+/**
+ * It drops the tokens before a position of the buffer and generates the next batch of tokens. \n
+ * Tokens are not dropped while a formatted string is open, Since its start is still needed. \n
+ * At the end of the code (or if an error occurs), A <em>MR_TOKEN_EOF</em> token is added.
+ * @param data
+ * Data structure containing all necessary information about the code.
+ * @param pos
+ * Index of the first token that must be kept.
+ * @return It returns the new index of the token at <em>pos</em>.
+*/
+mr_long_t mr_lexer_pull_fill(
+    mr_lexer_match_t *data, mr_long_t pos);
+#endif
+
+/**
+ * It extends the \a tokens list (and the \a ends list if token spans are enabled) by \a exalloc tokens.
+ * @param data
+ * Data structure containing all necessary information about the code.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em>.
+*/
+mr_byte_t mr_lexer_tokens_grow(
+    mr_lexer_match_t *data);
+
+/**
+ * It extends the \a fstrs stack (its size is doubled, Starting from <em>MR_LEXER_FSTR_DEPTH</em>).
+ * @param data
+ * Data structure containing all necessary information about the code.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em>.
+*/
+mr_byte_t mr_lexer_fstrs_grow(
+    mr_lexer_match_t *data);
+
 /**
  * It matches characters against lexer patterns and generates tokens one by one.
  * @param data
@@ -317,6 +743,15 @@ enum __MR_LEXER_MATCH_FLAG_ENUM
 void mr_lexer_match(
     mr_lexer_match_t *data);
 
+/**
+ * It skips spaces, newlines, semicolons, and comments that come before the first token of the code. \n
+ * A byte order mark at the start of the code is skipped too.
+ * @param data
+ * Data structure containing all necessary information about the code.
+*/
+void mr_lexer_skip_lead(
+    mr_lexer_match_t *data);
+
 /**
  * It skips comments (both singleline and multiline ones). \n
  * Singleline comment regex pattern: `\#.*` \n
@@ -329,13 +764,23 @@ void mr_lexer_skip_comment(
 
 /**
  * It generates an identifier, a keyword, or a type based on the code. \n
- * Identifier regex pattern: `[a-zA-Z_]\w*`
+ * Identifiers are interned into the \a syms pool. If the pool can not grow, the flag is set to <em>MR_LEXER_MATCH_FLAG_MEMORY</em>. \n
+ * Identifier regex pattern: `[a-zA-Z_\p{XID_Start}][\w\p{XID_Continue}]*`
  * @param data
  * Data structure containing all necessary information about the code.
 */
 void mr_lexer_generate_identifier(
     mr_lexer_match_t *data);
 
+/**
+ * It generates an identifier that starts with a non-ASCII character. \n
+ * If the character can't start an identifier (or it's not a valid UTF-8 sequence), the flag is set to <em>MR_LEXER_MATCH_FLAG_ILLEGAL</em>.
+ * @param data
+ * Data structure containing all necessary information about the code.
+*/
+void mr_lexer_generate_unicode(
+    mr_lexer_match_t *data);
+
 /**
  * It generates a number (int, float, or imaginary) based on the code. \n
  * Int regex pattern: `\d[0-9_]*` \n
@@ -347,6 +792,19 @@ void mr_lexer_generate_identifier(
 void mr_lexer_generate_number(
     mr_lexer_match_t *data);
 
+#ifdef __MR_POOL_CONSTS__
+/**
+ * It decodes a numeric or character literal that ends at the current index and adds it to the \a consts pool. \n
+ * If the pool can not grow, the flag is set to <em>MR_LEXER_MATCH_FLAG_MEMORY</em>.
+ * @param data
+ * Data structure containing all necessary information about the code.
+ * @param token
+ * The literal token (<em>MR_TOKEN_INT</em>, <em>MR_TOKEN_FLOAT</em>, <em>MR_TOKEN_IMAGINARY</em>, or <em>MR_TOKEN_CHR</em>).
+*/
+void mr_lexer_generate_const(
+    mr_lexer_match_t *data, mr_token_t *token);
+#endif
+
 /**
  * It generates a character or a string based on the code.
  * @param data
@@ -366,7 +824,7 @@ void mr_lexer_generate_str(
     mr_lexer_match_t *data, mr_bool_t esc);
 
 /**
- * It generates a formatted string based on the code. \n
+ * It generates the start of a formatted string and pushes it onto the \a fstrs stack. \n
  * This function will be called by using 'f' prefix.
  * @param data
  * Data structure containing all necessary information about the code.
@@ -376,6 +834,43 @@ void mr_lexer_generate_str(
 void mr_lexer_generate_fstr(
     mr_lexer_match_t *data, mr_bool_t esc);
 
+/**
+ * It generates the text of the formatted string at the top of the \a fstrs stack,
+ * Until the start of an interpolation (which is left to the main loop of the lexer) or the end of the formatted string. \n
+ * At the end, It generates a <em>MR_TOKEN_FSTR_END</em> token and pops the formatted string.
+ * @param data
+ * Data structure containing all necessary information about the code.
+*/
+void mr_lexer_generate_fstr_text(
+    mr_lexer_match_t *data);
+
+/**
+ * It handles a closing curly bracket inside the interpolation of a formatted string. \n
+ * If the bracket closes the interpolation, the formatted string continues. Otherwise, it generates a <em>MR_TOKEN_R_CURLY</em> token. \n
+ * Outside of formatted strings, the caller generates the token itself, So a plain closing curly bracket costs a single check.
+ * @param data
+ * Data structure containing all necessary information about the code.
+*/
+void mr_lexer_generate_rcurly(
+    mr_lexer_match_t *data);
+
+#ifdef __MR_POOL_STRS__
+/**
+ * It adds a string literal (or a piece of a formatted string) that ends at the current index to the \a strs pool. \n
+ * If the pool can not grow, the flag is set to <em>MR_LEXER_MATCH_FLAG_MEMORY</em>.
+ * @param data
+ * Data structure containing all necessary information about the code.
+ * @param idx
+ * Index of the token.
+ * @param skip
+ * Number of characters between the token and the first character of the string (the prefix and the opening quote).
+ * @param esc
+ * If \a esc is equal to \a MR_FALSE (by using '\\' prefix), All escape sequences will be avoided.
+*/
+void mr_lexer_generate_strlit(
+    mr_lexer_match_t *data, mr_long_t idx, mr_long_t skip, mr_bool_t esc);
+#endif
+
 /**
  * Generates a <em>MR_TOKEN_DOT</em>, <em>MR_TOKEN_ELLIPSIS</em>, or a floating point number based on the code.
  * @param data
@@ -384,245 +879,1521 @@ void mr_lexer_generate_fstr(
 void mr_lexer_generate_dot(
     mr_lexer_match_t *data);
 
+/**
+ * It generates a <em>MR_TOKEN_NEWLINE</em> token if the previous token can end a statement. Otherwise, It skips the newline.
+ * @param data
+ * Data structure containing all necessary information about the code.
+*/
+void mr_lexer_generate_newline(
+    mr_lexer_match_t *data);
+
+/**
+ * It generates a <em>MR_TOKEN_SEMICOLON</em> token. \n
+ * Repeated semicolons are skipped, And a newline followed by a semicolon is merged into the semicolon.
+ * @param data
+ * Data structure containing all necessary information about the code.
+*/
+void mr_lexer_generate_semicolon(
+    mr_lexer_match_t *data);
+
+/**
+ * It generates a string or a formatted string with the '\\' prefix (escape sequences are avoided).
+ * @param data
+ * Data structure containing all necessary information about the code.
+*/
+void mr_lexer_generate_backslash(
+    mr_lexer_match_t *data);
+
+/**
+ * It generates a formatted string (with 'f' or 'f\\' prefix) or an identifier that starts with 'f'.
+ * @param data
+ * Data structure containing all necessary information about the code.
+*/
+void mr_lexer_generate_fprefix(
+    mr_lexer_match_t *data);
+
 mr_byte_t mr_lexer(
     mr_lexer_t *res)
 {
     mr_chr_t chr;
-    mr_token_t *block;
     mr_lexer_match_t data;
+#ifdef __MR_LEXER_PARALLEL__
+    mr_byte_t count;
+#endif
 
-    data = (mr_lexer_match_t){.flag=MR_LEXER_MATCH_FLAG_OK, .alloc=_mr_config.size / MR_LEXER_TOKENS_CHUNK + 1};
-    data.tokens = malloc(data.alloc * sizeof(mr_token_t));
-    if (!data.tokens)
-        return MR_ERROR_NOT_ENOUGH_MEMORY;
+#ifdef __MR_LEXER_PARALLEL__
+    count = mr_lexer_parallel_count();
+    if (count > 1)
+        return mr_lexer_parallel(res, count);
+#endif
 
-    data.size = 0;
-    data.exalloc = data.alloc;
-    data.idx = 0;
+    if (mr_lexer_match_init(&data, _mr_config.size / MR_LEXER_TOKENS_CHUNK + 1))
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
 
+    mr_lexer_match_validate(&data, 0, _mr_config.size);
+    mr_lexer_skip_lead(&data);
     chr = _mr_config.code[data.idx];
-    while (1)
-    {
-        mr_lexer_skip_spaces(chr, _mr_config.code, data.idx);
-        if (chr == '\n')
-        {
-            chr = _mr_config.code[++data.idx];
-            continue;
-        }
-        if (chr == ';')
-        {
-            chr = _mr_config.code[++data.idx];
-            continue;
-        }
-
-        if (chr == '#')
-        {
-            mr_lexer_skip_comment(&data);
-            chr = _mr_config.code[data.idx];
-            continue;
-        }
-
-        break;
-    }
 
     while (chr != '\0')
     {
-        if (data.size == data.alloc)
+        if (data.size == data.alloc && mr_lexer_tokens_grow(&data))
         {
-            block = realloc(data.tokens, (data.alloc += data.exalloc) * sizeof(mr_token_t));
-            if (!block)
-            {
-                free(data.tokens);
-                return MR_ERROR_NOT_ENOUGH_MEMORY;
-            }
-
-            data.tokens = block;
+            data.flag = MR_LEXER_MATCH_FLAG_MEMORY;
+            break;
         }
 
         mr_lexer_match(&data);
         chr = _mr_config.code[data.idx];
 
         if (data.flag)
-        {
-            free(data.tokens);
-            if (data.flag == MR_LEXER_MATCH_FLAG_MEMORY)
-                return MR_ERROR_NOT_ENOUGH_MEMORY;
-
-            if (data.flag == MR_LEXER_MATCH_FLAG_ILLEGAL)
-                res->error = (mr_illegal_chr_t){.chr=_mr_config.code[data.idx], .expected=MR_FALSE};
-            else
-                res->error = (mr_illegal_chr_t){.chr=(mr_chr_t)data.alloc, .expected=MR_TRUE};
-
-            res->error.idx = data.idx;
-            return MR_ERROR_BAD_FORMAT;
-        }
-    }
-
-    if (data.size + 1 != data.alloc)
-    {
-        block = realloc(data.tokens, (data.size + 1) * sizeof(mr_token_t));
-        if (!block)
-        {
-            free(data.tokens);
-            return MR_ERROR_NOT_ENOUGH_MEMORY;
-        }
-
-        data.tokens = block;
+            break;
     }
 
-    block = data.tokens + data.size;
-    *block = (mr_token_t){.type=MR_TOKEN_EOF, .idx=MR_IDX_DECOMPOSE(data.idx)};
-
-    res->tokens = data.tokens;
-    return MR_NOERROR;
+    mr_lexer_match_fstr(&data);
+    mr_lexer_match_utf8(&data);
+    return mr_lexer_finish(&data, res);
 }
 
-void mr_lexer_match(
-    mr_lexer_match_t *data)
+mr_byte_t mr_lexer_stream(
+    mr_lexer_stream_t *res)
 {
+    mr_long_t idx, size, alloc, fsize, csize, crsize, ssize, srsize, tsize, trsize;
+    mr_byte_t retcode;
     mr_chr_t chr;
-    mr_token_t *token;
+    mr_lexer_match_t data;
+    mr_lexer_window_t window;
+    mr_lexer_fstr_t fstr;
+    mr_lexer_batch_t batch;
 
-    token = data->tokens + data->size;
-    chr = _mr_config.code[data->idx];
+    window = (mr_lexer_window_t){.size=0, .alloc=res->chunk, .base=0, .eof=MR_FALSE, .valid=0, .utf8=MR_INVALID_IDX_CODE};
+    window.code = mr_mem_malloc(MR_MEM_SOURCE, (window.alloc + MR_LEXER_MARGIN) * sizeof(mr_chr_t));
+    if (!window.code)
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
 
-    if (chr == '#')
+    if (mr_lexer_match_init(&data, res->chunk / MR_LEXER_TOKENS_CHUNK + 1))
     {
-        mr_lexer_skip_comment(data);
-        chr = _mr_config.code[data->idx];
-        mr_lexer_skip_spaces(chr, _mr_config.code, data->idx);
-        return;
+        mr_mem_free(window.code);
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
     }
 
-    if (chr == '\n')
+    /* The window is released while lexing, So the strings can't be slices of it. */
+    data.strs.copy = MR_TRUE;
+
+    retcode = mr_lexer_window_read(&window, res);
+    while (retcode == MR_NOERROR)
     {
-        mr_token_t *prev;
+        if (!window.eof && data.idx + MR_LEXER_MARGIN > window.size)
+        {
+            retcode = mr_lexer_stream_flush(&data, &window, res);
+            continue;
+        }
 
-        prev = token - 1;
-        if (mr_lexer_add_newline(prev->type))
+        chr = window.code[data.idx];
+        if (chr == '\0')
+            break;
+
+        if (data.size == data.alloc && mr_lexer_tokens_grow(&data))
         {
-            mr_lexer_token_set(MR_TOKEN_NEWLINE, 1);
-            chr = _mr_config.code[data->idx];
+            retcode = MR_ERROR_NOT_ENOUGH_MEMORY;
+            break;
         }
+
+        idx = data.idx;
+        size = data.size;
+        alloc = data.alloc;
+        fsize = data.fsize;
+        if (fsize)
+            fstr = data.fstrs[fsize - 1];
+        csize = data.consts.size;
+        crsize = data.consts.refs.size;
+        ssize = data.syms.size;
+        srsize = data.syms.refs.size;
+        tsize = data.strs.size;
+        trsize = data.strs.refs.size;
+
+        if (data.size)
+            mr_lexer_match(&data);
+        else if (!window.base && !data.idx && mr_unicode_bom(window.code))
+            data.idx = MR_UNICODE_BOM_SIZE;
+        else if (chr == '#')
+            mr_lexer_skip_comment(&data);
+        else if (chr == '\n' || chr == ';')
+            data.idx++;
+        else if (chr == ' ' || chr == '\t' || chr == '\r')
+            mr_lexer_skip_spaces(chr, window.code, data.idx);
         else
-            chr = _mr_config.code[++data->idx];
+            mr_lexer_match(&data);
 
-        mr_lexer_skip_spaces(chr, _mr_config.code, data->idx);
+        if (data.flag == MR_LEXER_MATCH_FLAG_MEMORY)
+        {
+            retcode = MR_ERROR_NOT_ENOUGH_MEMORY;
+            break;
+        }
+
+        if (!window.eof && data.idx + MR_LEXER_MARGIN > window.size)
+        {
+            data.flag = MR_LEXER_MATCH_FLAG_OK;
+            data.idx = idx;
+            data.size = size;
+            data.alloc = alloc;
+            data.fsize = fsize;
+            if (fsize)
+                data.fstrs[fsize - 1] = fstr;
+            mr_pool_consts_rollback(&data.consts, csize, crsize);
+            mr_pool_syms_rollback(&data.syms, ssize, srsize);
+            mr_pool_strs_rollback(&data.strs, tsize, trsize);
+
+            retcode = mr_lexer_stream_flush(&data, &window, res);
+            continue;
+        }
+
+        /* Tokens after an invalid UTF-8 character are never handed over. */
+        if (data.flag || data.idx > window.utf8)
+            break;
+    }
+
+    if (retcode == MR_NOERROR)
+    {
+        data.utf8 = window.utf8;
+        mr_lexer_match_fstr(&data);
+        mr_lexer_match_utf8(&data);
+    }
+
+    res->code = NULL;
+    if (retcode == MR_NOERROR && (data.flag || !res->consumer))
+    {
+        retcode = mr_lexer_finish(&data, &res->lexer);
+        if (retcode != MR_ERROR_NOT_ENOUGH_MEMORY)
+        {
+            if (retcode == MR_ERROR_BAD_FORMAT)
+            {
+                /* The rest of the line is read, So the error prints the whole line. */
+                idx = res->lexer.error.idx;
+                while (!window.eof && !memchr(window.code + idx, '\n', window.size - idx))
+                {
+                    idx = window.size;
+                    if (mr_lexer_window_read(&window, res) != MR_NOERROR)
+                        break;
+                }
+
+                res->lexer.error.idx += window.base;
+            }
+
+            res->code = window.code;
+            res->size = window.size;
+            res->base = window.base;
+            return retcode;
+        }
+
+        mr_mem_free(window.code);
+        _mr_config.code = NULL;
+        _mr_config.size = 0;
+        return retcode;
+    }
+
+    if (retcode == MR_NOERROR && data.size == data.alloc && mr_lexer_tokens_grow(&data))
+        retcode = MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    if (retcode == MR_NOERROR)
+    {
+        data.tokens[data.size] = (mr_token_t){.type=MR_TOKEN_EOF, .idx=MR_IDX_DECOMPOSE(data.idx)};
+        batch = (mr_lexer_batch_t){.tokens=data.tokens, .size=data.size + 1,
+            .code=window.code, .base=window.base, .release=window.size};
+
+#ifdef __MR_TOKEN_SPANS__
+        data.ends[data.size] = MR_IDX_DECOMPOSE(data.idx);
+        batch.ends = data.ends;
+        _mr_token_spans = (mr_token_spans_t){.tokens=data.tokens, .ends=data.ends};
+#endif
+
+        _mr_pool_consts = data.consts;
+        _mr_pool_syms = data.syms;
+        _mr_pool_strs = data.strs;
+        retcode = res->consumer(res->arg, &batch);
+
+        /* Reading the strings decodes them into the arena of the published pool. */
+        data.strs = _mr_pool_strs;
+    }
+
+    if (retcode == MR_NOERROR)
+    {
+        _mr_pool_consts = data.consts;
+        _mr_pool_syms = data.syms;
+        _mr_pool_strs = data.strs;
+        data.consts = MR_POOL_CONSTS_EMPTY;
+        data.syms = MR_POOL_SYMS_EMPTY;
+        data.strs = MR_POOL_STRS_EMPTY;
+    }
+    else
+    {
+        _mr_pool_consts = MR_POOL_CONSTS_EMPTY;
+        _mr_pool_syms = MR_POOL_SYMS_EMPTY;
+        _mr_pool_strs = MR_POOL_STRS_EMPTY;
+    }
+
+    mr_lexer_match_free(&data);
+    mr_mem_free(window.code);
+
+    _mr_config.code = NULL;
+    _mr_config.size = 0;
+    return retcode;
+}
+
+mr_byte_t mr_lexer_edit(
+    mr_lexer_t *res, mr_long_t start, mr_long_t end, mr_str_ct text, mr_long_t size)
+{
+    mr_long_t delta, first, last, depth, ctx, idx, from, to;
+    mr_chr_t chr;
+    mr_lexer_match_t data;
+    mr_token_t *token;
+    mr_pool_refs_t crefs, srefs, trefs;
+
+    if (_mr_config.source != MR_CONFIG_SOURCE_HEAP)
+        return MR_ERROR_WRITE_PROTECT;
+
+    delta = size - (end - start);
+    if (_mr_config.size + delta > MR_FILE_MAXSIZE)
+        return MR_ERROR_FILE_TOO_LARGE;
+
+    if (!res->fstrs && mr_lexer_edit_index(res))
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    if (mr_lexer_match_init(&data, MR_LEXER_EDIT_TOKENS))
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    if (mr_lexer_edit_code(start, end, text, size))
+    {
+        mr_lexer_match_free(&data);
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+    }
+
+    /*
+     * The rest of the code was valid before the edit, So only the new characters are validated,
+     * Along with the sequences that they cut into (continuation characters are never more than 3 in a row).
+    */
+    from = start;
+    while (from && ((mr_byte_t)_mr_config.code[from - 1] & 0xc0) == 0x80)
+        from--;
+    if (from)
+        from--;
+
+    to = start + size;
+    while (((mr_byte_t)_mr_config.code[to] & 0xc0) == 0x80)
+        to++;
+
+    mr_lexer_match_validate(&data, from, to);
+
+    /* New tokens are interned into the current pools, But their references are collected separately and spliced in at the end. */
+    data.consts = _mr_pool_consts;
+    data.syms = _mr_pool_syms;
+    data.strs = _mr_pool_strs;
+    data.consts.refs = MR_POOL_REFS_EMPTY;
+    data.syms.refs = MR_POOL_REFS_EMPTY;
+    data.strs.refs = MR_POOL_REFS_EMPTY;
+
+    first = mr_lexer_edit_restart(res, start);
+    ctx = first != 0;
+    if (ctx)
+    {
+        data.tokens[0] = res->tokens[first - 1];
+#ifdef __MR_TOKEN_SPANS__
+        data.ends[0] = res->ends[first - 1];
+#endif
+
+        data.size = 1;
+        data.idx = MR_IDX_EXTRACT(res->tokens[first].idx);
+    }
+    else
+        mr_lexer_skip_lead(&data);
+
+    last = first;
+    depth = 0;
+    chr = _mr_config.code[data.idx];
+
+    while (chr != '\0')
+    {
+        if (data.size == data.alloc)
+        {
+            data.exalloc = data.alloc;
+            if (mr_lexer_tokens_grow(&data))
+            {
+                data.flag = MR_LEXER_MATCH_FLAG_MEMORY;
+                break;
+            }
+        }
+
+        mr_lexer_match(&data);
+        chr = _mr_config.code[data.idx];
+
+        if (data.flag)
+            break;
+
+        if (data.size == ctx)
+            continue;
+
+        idx = MR_IDX_EXTRACT(data.tokens[data.size - 1].idx);
+        if (idx < start + size)
+            continue;
+
+        /*
+         * The code after a new token that starts after the edit is unchanged.
+         * If an old token of the same type started at the same place (both outside of formatted strings), The rest of the old tokens are still valid.
+        */
+        idx -= delta;
+        for (; last != res->size && MR_IDX_EXTRACT(res->tokens[last].idx) <= idx; last++)
+        {
+            if (res->tokens[last].type == MR_TOKEN_FSTR_START)
+                depth++;
+            else if (res->tokens[last].type == MR_TOKEN_FSTR_END)
+                depth--;
+        }
+
+        token = res->tokens + last - 1;
+        if (last != first && !depth && !data.fsize && MR_IDX_EXTRACT(token->idx) == idx && token->type == data.tokens[data.size - 1].type)
+            break;
+    }
+
+    crefs = data.consts.refs;
+    srefs = data.syms.refs;
+    trefs = data.strs.refs;
+    data.consts.refs = _mr_pool_consts.refs;
+    data.syms.refs = _mr_pool_syms.refs;
+    data.strs.refs = _mr_pool_strs.refs;
+    _mr_pool_consts = data.consts;
+    _mr_pool_syms = data.syms;
+    _mr_pool_strs = data.strs;
+
+    mr_lexer_match_fstr(&data);
+    mr_lexer_match_utf8(&data);
+    if (data.flag)
+    {
+        mr_mem_free(res->tokens);
+        mr_mem_free(res->fstrs);
+        res->fstrs = NULL;
+
+        mr_mem_free(crefs.data);
+        mr_mem_free(srefs.data);
+        mr_mem_free(trefs.data);
+        return mr_lexer_finish(&data, res);
+    }
+
+    data.consts = MR_POOL_CONSTS_EMPTY;
+    data.syms = MR_POOL_SYMS_EMPTY;
+    data.strs = MR_POOL_STRS_EMPTY;
+
+    if (chr == '\0')
+        last = res->size;
+
+    from = first ? MR_IDX_EXTRACT(res->tokens[first].idx) : 0;
+    to = MR_IDX_EXTRACT(res->tokens[last].idx) + (last == res->size);
+
+    if (mr_lexer_edit_splice(res, &data, first, last, delta) ||
+        mr_lexer_edit_fstrs(res, first, last, data.size - ctx) ||
+        mr_pool_refs_splice(&_mr_pool_consts.refs, from, to, &crefs, delta) ||
+        mr_pool_refs_splice(&_mr_pool_syms.refs, from, to, &srefs, delta) ||
+        mr_pool_refs_splice(&_mr_pool_strs.refs, from, to, &trefs, delta))
+    {
+        mr_mem_free(res->tokens);
+        mr_mem_free(res->fstrs);
+        res->fstrs = NULL;
+
+        mr_mem_free(crefs.data);
+        mr_mem_free(srefs.data);
+        mr_mem_free(trefs.data);
+        mr_lexer_match_free(&data);
+
+        mr_pool_consts_free(&_mr_pool_consts);
+        mr_pool_syms_free(&_mr_pool_syms);
+        mr_pool_strs_free(&_mr_pool_strs);
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+    }
+
+    if (chr == '\0')
+    {
+        res->tokens[res->size].idx = MR_IDX_DECOMPOSE(data.idx);
+#ifdef __MR_TOKEN_SPANS__
+        res->ends[res->size] = MR_IDX_DECOMPOSE(data.idx);
+#endif
+    }
+
+    mr_lexer_match_free(&data);
+    return MR_NOERROR;
+}
+
+mr_byte_t mr_lexer_match_init(
+    mr_lexer_match_t *data, mr_long_t alloc)
+{
+    *data = (mr_lexer_match_t){.flag=MR_LEXER_MATCH_FLAG_OK, .alloc=alloc, .exalloc=alloc, .size=0, .idx=0, .base=0,
+        .consts=MR_POOL_CONSTS_EMPTY, .syms=MR_POOL_SYMS_EMPTY, .strs=MR_POOL_STRS_EMPTY, .utf8=MR_INVALID_IDX_CODE,
+        .fstrs=NULL, .fsize=0, .falloc=0};
+
+    data->tokens = mr_mem_malloc(MR_MEM_LEXER, alloc * sizeof(mr_token_t));
+    if (!data->tokens)
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+#ifdef __MR_TOKEN_SPANS__
+    data->ends = mr_mem_malloc(MR_MEM_LEXER, alloc * sizeof(mr_idx_t));
+    if (!data->ends)
+    {
+        mr_mem_free(data->tokens);
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+    }
+#endif
+
+    return MR_NOERROR;
+}
+
+void mr_lexer_match_free(
+    mr_lexer_match_t *data)
+{
+    mr_mem_free(data->tokens);
+#ifdef __MR_TOKEN_SPANS__
+    mr_mem_free(data->ends);
+#endif
+    mr_mem_free(data->fstrs);
+
+    mr_pool_consts_free(&data->consts);
+    mr_pool_syms_free(&data->syms);
+    mr_pool_strs_free(&data->strs);
+}
+
+void mr_lexer_match_validate(
+    mr_lexer_match_t *data, mr_long_t start, mr_long_t end)
+{
+    start = _mr_scan.utf8(_mr_config.code, start, end);
+    if (start != end)
+        data->utf8 = start;
+}
+
+void mr_lexer_match_utf8(
+    mr_lexer_match_t *data)
+{
+    if (data->utf8 == MR_INVALID_IDX_CODE || data->flag == MR_LEXER_MATCH_FLAG_MEMORY)
         return;
+    if (data->flag && data->idx < data->utf8)
+        return;
+
+    data->flag = MR_LEXER_MATCH_FLAG_ILLEGAL;
+    data->idx = data->utf8;
+}
+
+void mr_lexer_match_fstr(
+    mr_lexer_match_t *data)
+{
+    if (!data->fsize || data->flag)
+        return;
+
+    data->flag = MR_LEXER_MATCH_FLAG_MISSING;
+    data->alloc = '}';
+}
+
+mr_byte_t mr_lexer_finish(
+    mr_lexer_match_t *data, mr_lexer_t *res)
+{
+    mr_token_t *block;
+    mr_str_ct code;
+
+    _mr_pool_consts = MR_POOL_CONSTS_EMPTY;
+    _mr_pool_syms = MR_POOL_SYMS_EMPTY;
+    _mr_pool_strs = MR_POOL_STRS_EMPTY;
+    if (data->flag)
+    {
+        mr_lexer_match_free(data);
+
+        if (data->flag == MR_LEXER_MATCH_FLAG_MEMORY)
+            return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+        if (data->flag == MR_LEXER_MATCH_FLAG_ILLEGAL)
+        {
+            code = _mr_config.code + data->idx;
+            res->error = (mr_illegal_chr_t){.expected=MR_FALSE};
+
+            /* An invalid sequence is reported with the continuation bytes after its first character. */
+            if (mr_unicode_decode(code, &res->error.size) == MR_UNICODE_INVALID && (mr_byte_t)*code >= 0xc0)
+                while (res->error.size != MR_UNICODE_SEQ_MAX && ((mr_byte_t)code[res->error.size] & 0xc0) == 0x80)
+                    res->error.size++;
+
+            memcpy(res->error.chr, code, res->error.size * sizeof(mr_chr_t));
+        }
+        else
+            res->error = (mr_illegal_chr_t){.chr={(mr_chr_t)data->alloc}, .size=1, .expected=MR_TRUE};
+
+        res->error.idx = data->idx;
+        return MR_ERROR_BAD_FORMAT;
+    }
+
+    mr_mem_free(data->fstrs);
+
+#ifdef __MR_TOKEN_SPANS__
+    block = mr_mem_realloc(MR_MEM_LEXER, data->tokens, (data->size + 1) * (sizeof(mr_token_t) + sizeof(mr_idx_t)));
+    if (!block)
+    {
+        mr_lexer_match_free(data);
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+    }
+
+    data->tokens = block;
+    res->ends = (mr_idx_t*)(data->tokens + data->size + 1);
+
+    memcpy(res->ends, data->ends, data->size * sizeof(mr_idx_t));
+    res->ends[data->size] = MR_IDX_DECOMPOSE(data->idx);
+    mr_mem_free(data->ends);
+
+    _mr_token_spans = (mr_token_spans_t){.tokens=data->tokens, .ends=res->ends};
+#else
+    if (data->size + 1 != data->alloc)
+    {
+        block = mr_mem_realloc(MR_MEM_LEXER, data->tokens, (data->size + 1) * sizeof(mr_token_t));
+        if (!block)
+        {
+            mr_lexer_match_free(data);
+            return MR_ERROR_NOT_ENOUGH_MEMORY;
+        }
+
+        data->tokens = block;
+    }
+#endif
+
+    block = data->tokens + data->size;
+    *block = (mr_token_t){.type=MR_TOKEN_EOF, .idx=MR_IDX_DECOMPOSE(data->idx)};
+
+    res->tokens = data->tokens;
+    res->size = data->size;
+    res->fstrs = NULL;
+    res->fsize = 0;
+    _mr_pool_consts = data->consts;
+    _mr_pool_syms = data->syms;
+    _mr_pool_strs = data->strs;
+    return MR_NOERROR;
+}
+
+mr_byte_t mr_lexer_tokens_grow(
+    mr_lexer_match_t *data)
+{
+    mr_ptr_t block;
+
+    block = mr_mem_realloc(MR_MEM_LEXER, data->tokens, (data->alloc + data->exalloc) * sizeof(mr_token_t));
+    if (!block)
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+    data->tokens = block;
+
+#ifdef __MR_TOKEN_SPANS__
+    block = mr_mem_realloc(MR_MEM_LEXER, data->ends, (data->alloc + data->exalloc) * sizeof(mr_idx_t));
+    if (!block)
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+    data->ends = block;
+#endif
+
+    data->alloc += data->exalloc;
+    return MR_NOERROR;
+}
+
+mr_byte_t mr_lexer_fstrs_grow(
+    mr_lexer_match_t *data)
+{
+    mr_long_t alloc;
+    mr_ptr_t block;
+
+    alloc = data->falloc ? data->falloc * 2 : MR_LEXER_FSTR_DEPTH;
+    block = mr_mem_realloc(MR_MEM_LEXER, data->fstrs, alloc * sizeof(mr_lexer_fstr_t));
+    if (!block)
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    data->fstrs = block;
+    data->falloc = alloc;
+    return MR_NOERROR;
+}
+
+mr_byte_t mr_lexer_window_read(
+    mr_lexer_window_t *window, mr_lexer_stream_t *res)
+{
+    mr_long_t size;
+    mr_str_t block;
+
+    if (window->alloc - window->size <= res->chunk / 2)
+    {
+        if (window->alloc == MR_FILE_MAXSIZE)
+        {
+            if (window->alloc == window->size)
+                return MR_ERROR_FILE_TOO_LARGE;
+        }
+        else
+        {
+            size = window->alloc + res->chunk;
+            if (size > MR_FILE_MAXSIZE || size < window->alloc)
+                size = MR_FILE_MAXSIZE;
+
+            block = mr_mem_realloc(MR_MEM_SOURCE, window->code, (size + MR_LEXER_MARGIN) * sizeof(mr_chr_t));
+            if (!block)
+                return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+            window->code = block;
+            window->alloc = size;
+        }
+    }
+
+    size = (mr_long_t)fread(window->code + window->size, sizeof(mr_chr_t), window->alloc - window->size, res->file);
+    if (size != window->alloc - window->size)
+    {
+        if (ferror(res->file))
+            return MR_ERROR_READ_FAULT;
+
+        window->eof = MR_TRUE;
+    }
+
+    block = memchr(window->code + window->size, '\0', size);
+    if (block)
+    {
+        size = (mr_long_t)(block - (window->code + window->size));
+        window->eof = MR_TRUE;
+    }
+
+    window->size += size;
+    memset(window->code + window->size, '\0', MR_LEXER_MARGIN);
+
+    if (window->utf8 == MR_INVALID_IDX_CODE)
+    {
+        size = _mr_scan.utf8(window->code, window->valid, window->size);
+        if (size == window->size || (!window->eof && size + MR_LEXER_MARGIN > window->size))
+            window->valid = size;
+        else
+            window->utf8 = size;
+    }
+
+    _mr_config.code = window->code;
+    _mr_config.size = window->size;
+    _mr_config.source = MR_CONFIG_SOURCE_HEAP;
+    return MR_NOERROR;
+}
+
+mr_byte_t mr_lexer_stream_flush(
+    mr_lexer_match_t *data, mr_lexer_window_t *window, mr_lexer_stream_t *res)
+{
+    mr_long_t shift;
+    mr_byte_t retcode;
+    mr_token_t *token;
+    mr_lexer_batch_t batch;
+
+    /* Tokens of an open formatted string are kept until it's closed, So the window grows instead. */
+    shift = 0;
+    if (res->consumer && !data->fsize)
+    {
+        token = data->size ? data->tokens + data->size - 1 : NULL;
+        shift = token ? MR_IDX_EXTRACT(token->idx) : data->idx;
+
+        if (shift)
+        {
+            batch = (mr_lexer_batch_t){.tokens=data->tokens, .size=token ? data->size - 1 : 0,
+                .code=window->code, .base=window->base, .release=shift};
+
+#ifdef __MR_TOKEN_SPANS__
+            batch.ends = data->ends;
+            _mr_token_spans = (mr_token_spans_t){.tokens=data->tokens, .ends=data->ends};
+#endif
+
+            _mr_pool_consts = data->consts;
+            _mr_pool_syms = data->syms;
+            _mr_pool_strs = data->strs;
+            retcode = res->consumer(res->arg, &batch);
+            data->strs = _mr_pool_strs;
+            if (retcode != MR_NOERROR)
+                return retcode;
+        }
+
+        if (token)
+        {
+            *data->tokens = (mr_token_t){.type=token->type, .idx=MR_IDX_DECOMPOSE(0)};
+#ifdef __MR_TOKEN_SPANS__
+            *data->ends = MR_IDX_DECOMPOSE(MR_IDX_EXTRACT(data->ends[data->size - 1]) - shift);
+#endif
+            data->size = 1;
+        }
+    }
+
+    if (shift)
+    {
+        memmove(window->code, window->code + shift, (window->size - shift) * sizeof(mr_chr_t));
+        window->size -= shift;
+        window->base += shift;
+        window->valid -= shift;
+        if (window->utf8 != MR_INVALID_IDX_CODE)
+            window->utf8 -= shift;
+        data->base = window->base;
+        data->idx -= shift;
+    }
+
+    retcode = mr_lexer_window_read(window, res);
+    data->exalloc = window->size / MR_LEXER_TOKENS_CHUNK + 1;
+    return retcode;
+}
+
+mr_long_t mr_lexer_edit_restart(
+    mr_lexer_t *res, mr_long_t start)
+{
+    mr_long_t low, high, mid;
+
+    low = 0;
+    high = res->size;
+    while (low != high)
+    {
+        mid = low + (high - low) / 2;
+        if (MR_IDX_EXTRACT(res->tokens[mid].idx) + MR_LEXER_MARGIN <= start)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    if (!low)
+        return 0;
+    low--;
+
+    /* Tokens inside a formatted string depend on its opening, So the whole outermost formatted string is lexed again. */
+    mid = mr_lexer_edit_bound(res, low + 1);
+    if (mid && res->fstrs[mid * 2 - 1] >= low)
+        return res->fstrs[mid * 2 - 2];
+    return low;
+}
+
+mr_byte_t mr_lexer_edit_index(
+    mr_lexer_t *res)
+{
+    mr_long_t size;
+
+    /* The list is allocated even if there are no formatted strings, So it's only built once. */
+    size = mr_lexer_edit_collect(NULL, res, 0, res->size);
+    res->fstrs = mr_mem_malloc(MR_MEM_LEXER, (size ? size * 2 : 1) * sizeof(mr_long_t));
+    if (!res->fstrs)
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    res->fsize = mr_lexer_edit_collect(res->fstrs, res, 0, res->size);
+    return MR_NOERROR;
+}
+
+mr_long_t mr_lexer_edit_collect(
+    mr_long_t *fstrs, mr_lexer_t *res, mr_long_t start, mr_long_t end)
+{
+    mr_long_t depth, count;
+
+    depth = 0;
+    count = 0;
+    for (; start != end; start++)
+    {
+        if (res->tokens[start].type == MR_TOKEN_FSTR_START)
+        {
+            if (!depth++ && fstrs)
+                fstrs[count * 2] = start;
+        }
+        else if (res->tokens[start].type == MR_TOKEN_FSTR_END && !--depth)
+        {
+            if (fstrs)
+                fstrs[count * 2 + 1] = start;
+            count++;
+        }
+    }
+
+    return count;
+}
+
+mr_long_t mr_lexer_edit_bound(
+    mr_lexer_t *res, mr_long_t idx)
+{
+    mr_long_t low, high, mid;
+
+    low = 0;
+    high = res->fsize;
+    while (low != high)
+    {
+        mid = low + (high - low) / 2;
+        if (res->fstrs[mid * 2] < idx)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    return low;
+}
+
+mr_byte_t mr_lexer_edit_fstrs(
+    mr_lexer_t *res, mr_long_t first, mr_long_t last, mr_long_t count)
+{
+    mr_long_t low, high, added, size, i;
+    mr_long_t *block;
+
+    low = mr_lexer_edit_bound(res, first);
+    high = mr_lexer_edit_bound(res, last);
+    added = mr_lexer_edit_collect(NULL, res, first, first + count);
+
+    size = res->fsize - (high - low) + added;
+    if (size > res->fsize)
+    {
+        block = mr_mem_realloc(MR_MEM_LEXER, res->fstrs, size * 2 * sizeof(mr_long_t));
+        if (!block)
+            return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+        res->fstrs = block;
+    }
+
+    if (size != res->fsize)
+        memmove(res->fstrs + (low + added) * 2, res->fstrs + high * 2, (res->fsize - high) * 2 * sizeof(mr_long_t));
+    mr_lexer_edit_collect(res->fstrs + low * 2, res, first, first + count);
+    res->fsize = size;
+
+    if (count != last - first)
+        for (i = (low + added) * 2; i != size * 2; i++)
+            res->fstrs[i] += count - (last - first);
+
+    return MR_NOERROR;
+}
+
+mr_byte_t mr_lexer_edit_code(
+    mr_long_t start, mr_long_t end, mr_str_ct text, mr_long_t size)
+{
+    mr_long_t delta;
+    mr_str_t code;
+
+    delta = size - (end - start);
+    code = (mr_str_t)_mr_config.code;
+    if (size > end - start)
+    {
+        code = mr_mem_realloc(MR_MEM_SOURCE, code, (_mr_config.size + delta + MR_LEXER_MARGIN) * sizeof(mr_chr_t));
+        if (!code)
+            return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+        _mr_config.code = code;
+    }
+
+    if (mr_pool_strs_edit(&_mr_pool_strs, start, end, delta))
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    if (delta)
+        memmove(code + start + size, code + end, (_mr_config.size - end) * sizeof(mr_chr_t));
+    memcpy(code + start, text, size * sizeof(mr_chr_t));
+
+    _mr_config.size += delta;
+    memset(code + _mr_config.size, '\0', MR_LEXER_MARGIN * sizeof(mr_chr_t));
+    mr_error_lines_free();
+    return MR_NOERROR;
+}
+
+mr_byte_t mr_lexer_edit_splice(
+    mr_lexer_t *res, mr_lexer_match_t *data, mr_long_t first, mr_long_t last, mr_long_t delta)
+{
+    mr_long_t ctx, count, size, i;
+    mr_token_t *block;
+#ifdef __MR_TOKEN_SPANS__
+    mr_idx_t *ends;
+#endif
+
+    ctx = first != 0;
+    count = data->size - ctx;
+    size = res->size - (last - first) + count;
+
+    if (ctx)
+        res->tokens[first - 1].type = data->tokens->type;
+
+#ifdef __MR_TOKEN_SPANS__
+    if (size != res->size)
+    {
+        block = mr_mem_malloc(MR_MEM_LEXER, (size + 1) * (sizeof(mr_token_t) + sizeof(mr_idx_t)));
+        if (!block)
+            return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+        ends = (mr_idx_t*)(block + size + 1);
+        memcpy(block, res->tokens, first * sizeof(mr_token_t));
+        memcpy(block + first + count, res->tokens + last, (res->size + 1 - last) * sizeof(mr_token_t));
+        memcpy(ends, res->ends, first * sizeof(mr_idx_t));
+        memcpy(ends + first + count, res->ends + last, (res->size + 1 - last) * sizeof(mr_idx_t));
+
+        mr_mem_free(res->tokens);
+        res->tokens = block;
+        res->ends = ends;
+        _mr_token_spans = (mr_token_spans_t){.tokens=block, .ends=ends};
+    }
+
+    memcpy(res->ends + first, data->ends + ctx, count * sizeof(mr_idx_t));
+#else
+    if (size > res->size)
+    {
+        block = mr_mem_realloc(MR_MEM_LEXER, res->tokens, (size + 1) * sizeof(mr_token_t));
+        if (!block)
+            return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+        res->tokens = block;
+    }
+
+    if (size != res->size)
+        memmove(res->tokens + first + count, res->tokens + last, (res->size + 1 - last) * sizeof(mr_token_t));
+
+    if (size < res->size)
+    {
+        block = mr_mem_realloc(MR_MEM_LEXER, res->tokens, (size + 1) * sizeof(mr_token_t));
+        if (block)
+            res->tokens = block;
+    }
+#endif
+
+    memcpy(res->tokens + first, data->tokens + ctx, count * sizeof(mr_token_t));
+    res->size = size;
+
+    if (delta)
+        for (i = first + count; i <= size; i++)
+        {
+            res->tokens[i].idx = MR_IDX_DECOMPOSE(MR_IDX_EXTRACT(res->tokens[i].idx) + delta);
+#ifdef __MR_TOKEN_SPANS__
+            res->ends[i] = MR_IDX_DECOMPOSE(MR_IDX_EXTRACT(res->ends[i]) + delta);
+#endif
+        }
+
+    return MR_NOERROR;
+}
+
+#ifdef __MR_TOKEN_PULL__
+mr_byte_t mr_lexer_pull_init(
+    mr_token_cursor_t *tokens)
+{
+    mr_lexer_match_t *data;
+
+    data = mr_mem_malloc(MR_MEM_LEXER, sizeof(mr_lexer_match_t));
+    if (!data)
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    if (mr_lexer_match_init(data, MR_LEXER_PULL_TOKENS))
+    {
+        mr_mem_free(data);
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
     }
 
-    if (chr >= '0' && chr <= '9')
-    {
-        mr_lexer_generate_number(data);
-        if (data->flag)
-            return;
+    mr_lexer_match_validate(data, 0, _mr_config.size);
+    mr_lexer_skip_lead(data);
 
-        chr = _mr_config.code[data->idx];
-        mr_lexer_skip_spaces(chr, _mr_config.code, data->idx);
+    *tokens = (mr_token_cursor_t){.next=data->tokens, .end=data->tokens, .src=data, .type=MR_TOKEN_EOF};
+    mr_lexer_pull(tokens);
+    mr_token_cursor_next(tokens);
+    return MR_NOERROR;
+}
+
+void mr_lexer_pull(
+    mr_token_cursor_t *tokens)
+{
+    mr_long_t pos;
+    mr_lexer_match_t *data;
+
+    data = tokens->src;
+    pos = (mr_long_t)(tokens->next - data->tokens);
+    if (mr_lexer_pull_done(data))
         return;
-    }
 
-    if (chr == 'f')
-    {
-        mr_bool_t esc;
+    pos = mr_lexer_pull_fill(data, pos);
+
+    /* The last token can still change (a newline followed by a semicolon), So it's only read after the next batch. */
+    tokens->next = data->tokens + pos;
+    tokens->end = data->tokens + data->size - !mr_lexer_pull_done(data);
+}
+
+mr_long_t mr_lexer_pull_getsize(
+    const mr_token_cursor_t *cur)
+{
+    mr_long_t idx, size;
+    mr_lexer_match_t data;
 
-        esc = MR_TRUE;
-        chr = _mr_config.code[data->idx + 1];
-        if (chr == '\\')
+    idx = MR_IDX_EXTRACT(cur->idx);
+    if (cur->type != MR_TOKEN_FSTR_START)
+        return mr_token_getsize2(cur->type, idx);
+
+    if (mr_lexer_match_init(&data, MR_LEXER_PULL_TOKENS))
+        return 1;
+
+    data.idx = idx;
+    do
+    {
+        if (data.size == data.alloc && mr_lexer_tokens_grow(&data))
         {
-            esc = MR_FALSE;
-            chr = _mr_config.code[data->idx + 2];
+            data.flag = MR_LEXER_MATCH_FLAG_MEMORY;
+            break;
         }
 
-        if (chr == '\'' || chr == '"')
-        {
-            mr_lexer_generate_fstr(data, esc);
-            if (data->flag)
-                return;
+        mr_lexer_match(&data);
+    } while (data.fsize && !data.flag);
 
-            chr = _mr_config.code[++data->idx];
-            mr_lexer_skip_spaces(chr, _mr_config.code, data->idx);
-            return;
-        }
-        else if (!esc)
+    size = data.flag ? 1 : MR_IDX_EXTRACT(data.tokens[data.size - 1].idx) - idx + 1;
+    mr_lexer_match_free(&data);
+    return size;
+}
+
+mr_byte_t mr_lexer_pull_finish(
+    mr_lexer_t *res, mr_token_cursor_t *tokens)
+{
+    mr_byte_t retcode;
+    mr_lexer_match_t *data;
+
+    data = tokens->src;
+    while (!mr_lexer_pull_done(data))
+        mr_lexer_pull_fill(data, data->size - 1);
+
+    data->size--;
+    mr_lexer_match_fstr(data);
+    mr_lexer_match_utf8(data);
+    if (data->flag)
+    {
+        retcode = mr_lexer_finish(data, res);
+        mr_mem_free(data);
+        return retcode;
+    }
+
+    _mr_pool_consts = data->consts;
+    _mr_pool_syms = data->syms;
+    _mr_pool_strs = data->strs;
+    data->consts = MR_POOL_CONSTS_EMPTY;
+    data->syms = MR_POOL_SYMS_EMPTY;
+    data->strs = MR_POOL_STRS_EMPTY;
+
+    mr_lexer_match_free(data);
+    mr_mem_free(data);
+    return MR_NOERROR;
+}
+
+mr_long_t mr_lexer_pull_fill(
+    mr_lexer_match_t *data, mr_long_t pos)
+{
+    mr_long_t count;
+    mr_chr_t chr;
+
+    if (pos && !data->fsize)
+    {
+        data->size -= pos;
+        memmove(data->tokens, data->tokens + pos, data->size * sizeof(mr_token_t));
+#ifdef __MR_TOKEN_SPANS__
+        memmove(data->ends, data->ends + pos, data->size * sizeof(mr_idx_t));
+#endif
+        pos = 0;
+    }
+
+    count = data->size + MR_LEXER_PULL_TOKENS;
+    chr = _mr_config.code[data->idx];
+
+    while (chr != '\0' && data->size < count)
+    {
+        if (data->size == data->alloc && mr_lexer_tokens_grow(data))
         {
-            data->idx++;
-            data->flag = MR_LEXER_MATCH_FLAG_ILLEGAL;
-            return;
+            data->flag = MR_LEXER_MATCH_FLAG_MEMORY;
+            break;
         }
 
-        mr_lexer_generate_identifier(data);
+        mr_lexer_match(data);
+        chr = _mr_config.code[data->idx];
+
         if (data->flag)
-            return;
+            break;
+    }
 
-        chr = _mr_config.code[data->idx];
-        mr_lexer_skip_spaces(chr, _mr_config.code, data->idx);
-        return;
+    if (chr != '\0' && !data->flag)
+        return pos;
+
+    /* If the list can't grow, The last token is replaced (the error is reported anyway). */
+    if (data->size == data->alloc && mr_lexer_tokens_grow(data))
+    {
+        data->flag = MR_LEXER_MATCH_FLAG_MEMORY;
+        data->size--;
     }
 
-    if ((chr >= 'A' && chr <= 'Z') || (chr >= 'a' && chr <= 'z') || chr == '_')
+    data->tokens[data->size] = (mr_token_t){.type=MR_TOKEN_EOF, .idx=MR_IDX_DECOMPOSE(data->idx)};
+#ifdef __MR_TOKEN_SPANS__
+    data->ends[data->size] = MR_IDX_DECOMPOSE(data->idx);
+#endif
+    data->size++;
+    return pos;
+}
+#endif
+
+#ifdef __MR_LEXER_PARALLEL__
+mr_byte_t mr_lexer_parallel_count(void)
+{
+    mr_long_t count;
+#ifdef _SC_NPROCESSORS_ONLN
+    long cpus;
+
+    cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    count = cpus > 0 ? (mr_long_t)cpus : 1;
+#else
+    count = MR_LEXER_PARALLEL_THREADS;
+#endif
+
+    if (count > MR_LEXER_PARALLEL_THREADS)
+        count = MR_LEXER_PARALLEL_THREADS;
+    if (count > _mr_config.size / MR_LEXER_PARALLEL_CHUNK)
+        count = _mr_config.size / MR_LEXER_PARALLEL_CHUNK;
+
+    return (mr_byte_t)count;
+}
+
+mr_byte_t mr_lexer_parallel(
+    mr_lexer_t *res, mr_byte_t count)
+{
+    mr_long_t idx, alloc;
+    mr_byte_t i, size;
+    mr_str_ct newline;
+    mr_lexer_match_t data;
+    mr_lexer_chunk_t chunks[MR_LEXER_PARALLEL_THREADS];
+    pthread_t threads[MR_LEXER_PARALLEL_THREADS];
+    mr_bool_t started[MR_LEXER_PARALLEL_THREADS];
+
+    chunks->start = 0;
+    size = 1;
+    for (i = 1; i != count; i++)
     {
-        mr_lexer_generate_identifier(data);
-        if (data->flag)
-            return;
+        idx = (mr_long_t)((uint64_t)_mr_config.size * i / count);
+        if (idx <= chunks[size - 1].start)
+            idx = chunks[size - 1].start + 1;
+        if (idx >= _mr_config.size)
+            break;
 
-        chr = _mr_config.code[data->idx];
-        mr_lexer_skip_spaces(chr, _mr_config.code, data->idx);
-        return;
+        newline = memchr(_mr_config.code + idx, '\n', _mr_config.size - idx);
+        if (!newline)
+            break;
+
+        chunks[size - 1].end = chunks[size].start = (mr_long_t)(newline - _mr_config.code);
+        size++;
     }
+    chunks[size - 1].end = _mr_config.size;
 
-    switch (chr)
+    alloc = size + 1;
+    for (i = 0; i != size; i++)
     {
-    case ';':
+        if (mr_lexer_match_init(&chunks[i].data, (chunks[i].end - chunks[i].start) / MR_LEXER_TOKENS_CHUNK + 1))
+        {
+            while (i)
+                mr_lexer_match_free(&chunks[--i].data);
+            return MR_ERROR_NOT_ENOUGH_MEMORY;
+        }
+
+        alloc += chunks[i].data.alloc;
+    }
+
+    for (i = 1; i != size; i++)
+        started[i] = !pthread_create(threads + i, NULL, mr_lexer_parallel_worker, chunks + i);
+
+    mr_lexer_parallel_worker(chunks);
+    for (i = 1; i != size; i++)
+    {
+        if (started[i])
+            pthread_join(threads[i], NULL);
+        else
+            mr_lexer_parallel_worker(chunks + i);
+    }
+
+    if (mr_lexer_match_init(&data, alloc))
     {
-        mr_token_t *ptr;
+        for (i = 0; i != size; i++)
+            mr_lexer_match_free(&chunks[i].data);
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+    }
+
+    data.exalloc = alloc / MR_LEXER_TOKENS_CHUNK + 1;
+    mr_lexer_parallel_stitch(&data, chunks, size);
 
-        ptr = token - 1;
-        if (ptr->type == MR_TOKEN_SEMICOLON)
+    for (i = 0; i != size; i++)
+        if (chunks[i].data.utf8 != MR_INVALID_IDX_CODE)
         {
-            data->idx++;
+            data.utf8 = chunks[i].data.utf8;
             break;
         }
-        else if (ptr->type == MR_TOKEN_NEWLINE)
+
+    for (i = 0; i != size; i++)
+        mr_lexer_match_free(&chunks[i].data);
+
+    mr_lexer_match_fstr(&data);
+    mr_lexer_match_utf8(&data);
+    return mr_lexer_finish(&data, res);
+}
+
+mr_ptr_t mr_lexer_parallel_worker(
+    mr_ptr_t chunk)
+{
+    mr_chr_t chr;
+    mr_lexer_chunk_t *data;
+
+    data = chunk;
+    data->data.idx = data->start;
+
+    /* Chunks start at newlines, So no UTF-8 sequence crosses their borders. */
+    mr_lexer_match_validate(&data->data, data->start, data->end);
+    mr_lexer_skip_lead(&data->data);
+    data->lead = data->data.idx;
+
+    chr = _mr_config.code[data->data.idx];
+    while (chr != '\0' && data->data.idx < data->end)
+    {
+        if (data->data.size == data->data.alloc && mr_lexer_tokens_grow(&data->data))
         {
-            ptr->type = MR_TOKEN_SEMICOLON;
-            data->idx++;
+            data->data.flag = MR_LEXER_MATCH_FLAG_MEMORY;
             break;
         }
 
-        mr_lexer_token_set(MR_TOKEN_SEMICOLON, 1);
-        break;
+        mr_lexer_match(&data->data);
+        chr = _mr_config.code[data->data.idx];
+
+        if (data->data.flag)
+            break;
     }
-    case '\\':
-        switch (_mr_config.code[data->idx + 1])
+
+    return NULL;
+}
+
+void mr_lexer_parallel_stitch(
+    mr_lexer_match_t *data, mr_lexer_chunk_t *chunks, mr_byte_t count)
+{
+    mr_long_t falloc;
+#ifdef __MR_TOKEN_SPANS__
+    mr_long_t i;
+#endif
+    mr_lexer_chunk_t *chunk;
+    mr_lexer_fstr_t *fstrs;
+
+    for (chunk = chunks; chunk != chunks + count; chunk++)
+    {
+        if (data->idx == chunk->start && !data->fsize)
         {
-        case 'f':
-            chr = _mr_config.code[data->idx + 2];
-            if (chr == '\'' || chr == '"')
+            if (!data->size)
+                data->idx = chunk->lead;
+
+            while (data->idx < chunk->lead)
+            {
+                if (data->size == data->alloc && mr_lexer_tokens_grow(data))
+                {
+                    data->flag = MR_LEXER_MATCH_FLAG_MEMORY;
+                    return;
+                }
+
+                mr_lexer_match(data);
+            }
+
+            if (chunk->data.flag)
             {
-                mr_lexer_generate_fstr(data, MR_FALSE);
-                if (data->flag)
+                data->flag = chunk->data.flag;
+                data->idx = chunk->data.idx;
+                data->alloc = chunk->data.alloc;
+                return;
+            }
+
+            while (data->alloc - data->size < chunk->data.size)
+                if (mr_lexer_tokens_grow(data))
+                {
+                    data->flag = MR_LEXER_MATCH_FLAG_MEMORY;
                     return;
+                }
 
-                data->idx++;
-                break;
+            memcpy(data->tokens + data->size, chunk->data.tokens, chunk->data.size * sizeof(mr_token_t));
+#ifdef __MR_TOKEN_SPANS__
+            memcpy(data->ends + data->size, chunk->data.ends, chunk->data.size * sizeof(mr_idx_t));
+#endif
+
+            /* The chunk can end inside formatted strings, So its stack is swapped with the empty stack of the data. */
+            fstrs = data->fstrs;
+            falloc = data->falloc;
+            data->fstrs = chunk->data.fstrs;
+            data->fsize = chunk->data.fsize;
+            data->falloc = chunk->data.falloc;
+            chunk->data.fstrs = fstrs;
+            chunk->data.fsize = 0;
+            chunk->data.falloc = falloc;
+
+#ifdef __MR_TOKEN_SPANS__
+            for (i = 0; i != data->fsize; i++)
+                data->fstrs[i].start += data->size;
+#endif
+
+            data->size += chunk->data.size;
+            data->idx = chunk->data.idx;
+
+            if (mr_pool_consts_merge(&data->consts, &chunk->data.consts) ||
+                mr_pool_syms_merge(&data->syms, &chunk->data.syms) ||
+                mr_pool_strs_merge(&data->strs, &chunk->data.strs))
+            {
+                data->flag = MR_LEXER_MATCH_FLAG_MEMORY;
+                return;
+            }
+            continue;
+        }
+
+        if (!data->size)
+            mr_lexer_skip_lead(data);
+
+        while (data->idx < chunk->end && _mr_config.code[data->idx] != '\0')
+        {
+            if (data->size == data->alloc && mr_lexer_tokens_grow(data))
+            {
+                data->flag = MR_LEXER_MATCH_FLAG_MEMORY;
+                return;
             }
 
-            data->flag = MR_LEXER_MATCH_FLAG_ILLEGAL;
-            break;
-        case '\'':
-        case '"':
-            mr_lexer_generate_str(data, MR_FALSE);
+            mr_lexer_match(data);
             if (data->flag)
                 return;
+        }
+    }
+}
+#endif
 
-            data->idx++;
+#ifdef __MR_LEXER_DFA__
+void mr_lexer_match(
+    mr_lexer_match_t *data)
+{
+    mr_long_t idx, last;
+    mr_byte_t state, accept;
+    mr_chr_t chr;
+    mr_token_t *token;
+
+    token = data->tokens + data->size;
+    idx = last = data->idx;
+
+    state = accept = MR_LEXER_DFA_START;
+    while ((state = mr_lexer_dfa_next[state][mr_lexer_dfa_class[(mr_byte_t)_mr_config.code[idx]]]))
+    {
+        idx++;
+        if (mr_lexer_dfa_action[state] != MR_LEXER_DFA_NONE)
+        {
+            accept = state;
+            last = idx;
+        }
+    }
+
+    switch (mr_lexer_dfa_action[accept])
+    {
+    case MR_LEXER_DFA_TOKEN:
+        mr_lexer_token_set(mr_lexer_dfa_token[accept], last - data->idx);
+        break;
+    case MR_LEXER_DFA_NEWLINE:
+        mr_lexer_generate_newline(data);
+        break;
+    case MR_LEXER_DFA_COMMENT:
+        mr_lexer_skip_comment(data);
+        break;
+    case MR_LEXER_DFA_SEMICOLON:
+        mr_lexer_generate_semicolon(data);
+        break;
+    case MR_LEXER_DFA_BACKSLASH:
+        mr_lexer_generate_backslash(data);
+        break;
+    case MR_LEXER_DFA_CHR:
+        mr_lexer_generate_chr(data);
+        break;
+    case MR_LEXER_DFA_STR:
+        mr_lexer_generate_str(data, MR_TRUE);
+        if (data->flag)
+            return;
+
+        data->idx++;
+        break;
+    case MR_LEXER_DFA_FPREFIX:
+        mr_lexer_generate_fprefix(data);
+        break;
+    case MR_LEXER_DFA_IDENTIFIER:
+        mr_lexer_generate_identifier(data);
+        break;
+    case MR_LEXER_DFA_NUMBER:
+        mr_lexer_generate_number(data);
+        break;
+    case MR_LEXER_DFA_LCURLY:
+        if (data->fsize)
+            data->fstrs[data->fsize - 1].lcurly++;
+
+        mr_lexer_token_set(MR_TOKEN_L_CURLY, 1);
+        break;
+    case MR_LEXER_DFA_RCURLY:
+        if (data->fsize)
+        {
+            mr_lexer_generate_rcurly(data);
             break;
-        default:
+        }
+
+        mr_lexer_token_set(MR_TOKEN_R_CURLY, 1);
+        break;
+    default:
+        if ((mr_byte_t)_mr_config.code[data->idx] < 0x80)
+        {
             data->flag = MR_LEXER_MATCH_FLAG_ILLEGAL;
             return;
-        }
+        }
+
+        mr_lexer_generate_unicode(data);
+        break;
+    }
+
+    if (data->flag)
+        return;
+
+    chr = _mr_config.code[data->idx];
+    mr_lexer_skip_spaces(chr, _mr_config.code, data->idx);
+}
+#else
+void mr_lexer_match(
+    mr_lexer_match_t *data)
+{
+    mr_chr_t chr;
+    mr_token_t *token;
+
+    token = data->tokens + data->size;
+    chr = _mr_config.code[data->idx];
+
+    if (chr == '#')
+    {
+        mr_lexer_skip_comment(data);
+        chr = _mr_config.code[data->idx];
+        mr_lexer_skip_spaces(chr, _mr_config.code, data->idx);
+        return;
+    }
+
+    if (chr == '\n')
+    {
+        mr_lexer_generate_newline(data);
+
+        chr = _mr_config.code[data->idx];
+        mr_lexer_skip_spaces(chr, _mr_config.code, data->idx);
+        return;
+    }
+
+    if (chr >= '0' && chr <= '9')
+    {
+        mr_lexer_generate_number(data);
+        if (data->flag)
+            return;
+
+        chr = _mr_config.code[data->idx];
+        mr_lexer_skip_spaces(chr, _mr_config.code, data->idx);
+        return;
+    }
+
+    if (chr == 'f')
+    {
+        mr_lexer_generate_fprefix(data);
+        if (data->flag)
+            return;
+
+        chr = _mr_config.code[data->idx];
+        mr_lexer_skip_spaces(chr, _mr_config.code, data->idx);
+        return;
+    }
+
+    if ((chr >= 'A' && chr <= 'Z') || (chr >= 'a' && chr <= 'z') || chr == '_')
+    {
+        mr_lexer_generate_identifier(data);
+        if (data->flag)
+            return;
+
+        chr = _mr_config.code[data->idx];
+        mr_lexer_skip_spaces(chr, _mr_config.code, data->idx);
+        return;
+    }
 
+    switch (chr)
+    {
+    case ';':
+        mr_lexer_generate_semicolon(data);
+        break;
+    case '\\':
+        mr_lexer_generate_backslash(data);
+        if (data->flag)
+            return;
         break;
     case '\'':
         mr_lexer_generate_chr(data);
@@ -702,9 +2473,20 @@ void mr_lexer_match(
         mr_lexer_token_set(MR_TOKEN_R_SQUARE, 1);
         break;
     case '{':
+        if (data->fsize)
+            data->fstrs[data->fsize - 1].lcurly++;
+
         mr_lexer_token_set(MR_TOKEN_L_CURLY, 1);
         break;
     case '}':
+        if (data->fsize)
+        {
+            mr_lexer_generate_rcurly(data);
+            if (data->flag)
+                return;
+            break;
+        }
+
         mr_lexer_token_set(MR_TOKEN_R_CURLY, 1);
         break;
     case ',':
@@ -726,43 +2508,68 @@ void mr_lexer_match(
         mr_lexer_token_set(MR_TOKEN_DOLLAR, 1);
         break;
     default:
-        data->flag = MR_LEXER_MATCH_FLAG_ILLEGAL;
-        return;
+        if ((mr_byte_t)chr < 0x80)
+        {
+            data->flag = MR_LEXER_MATCH_FLAG_ILLEGAL;
+            return;
+        }
+
+        mr_lexer_generate_unicode(data);
+        if (data->flag)
+            return;
+        break;
     }
 
     chr = _mr_config.code[data->idx];
     mr_lexer_skip_spaces(chr, _mr_config.code, data->idx);
 }
 
-void mr_lexer_skip_comment(
+#endif
+
+void mr_lexer_skip_lead(
     mr_lexer_match_t *data)
 {
     mr_chr_t chr;
 
-    chr = _mr_config.code[++data->idx];
-    if (chr != '*')
+    if (!data->base && !data->idx && mr_unicode_bom(_mr_config.code))
+        data->idx = MR_UNICODE_BOM_SIZE;
+
+    chr = _mr_config.code[data->idx];
+    while (1)
     {
-        while (chr != '\0' && chr != '\n')
+        mr_lexer_skip_spaces(chr, _mr_config.code, data->idx);
+        if (chr == '\n' || chr == ';')
+        {
             chr = _mr_config.code[++data->idx];
+            continue;
+        }
 
-        return;
+        if (chr == '#')
+        {
+            mr_lexer_skip_comment(data);
+            chr = _mr_config.code[data->idx];
+            continue;
+        }
+
+        break;
     }
+}
+
+void mr_lexer_skip_comment(
+    mr_lexer_match_t *data)
+{
+    mr_chr_t chr;
 
     chr = _mr_config.code[++data->idx];
-    while (chr != '\0')
+    if (chr != '*')
     {
-        if (chr == '*')
-        {
-            chr = _mr_config.code[++data->idx];
-            if (chr == '#')
-            {
-                data->idx++;
-                return;
-            }
-        }
-
-        chr = _mr_config.code[++data->idx];
+        data->idx = _mr_scan.line(_mr_config.code, data->idx, _mr_config.size);
+        return;
     }
+
+    data->idx = _mr_scan.comment(_mr_config.code, data->idx + 1, _mr_config.size);
+    if (_mr_config.code[data->idx] != '\0')
+        data->idx += 2;
 }
 
 void mr_lexer_generate_identifier(
@@ -770,9 +2577,10 @@ void mr_lexer_generate_identifier(
 {
     mr_long_t idx;
     mr_short_t size;
-    mr_byte_t i;
+    mr_byte_t type;
     mr_chr_t chr;
     mr_token_t *token;
+    mr_str_ct str;
 
     token = data->tokens + data->size;
     idx = data->idx;
@@ -782,29 +2590,60 @@ void mr_lexer_generate_identifier(
         chr = _mr_config.code[++data->idx];
     while ((chr >= 'A' && chr <= 'Z') || (chr >= 'a' && chr <= 'z') || (chr >= '0' && chr <= '9') || chr == '_');
 
+    if ((mr_byte_t)chr >= 0x80)
+        data->idx = mr_unicode_ident_end(_mr_config.code, idx);
+
     size = (mr_short_t)(data->idx - idx);
-    if (size <= MR_TOKEN_KEYWORD_MAXSIZE)
+    if (size >= MR_TOKEN_IDENT_MINSIZE && size <= MR_TOKEN_KEYWORD_MAXSIZE)
     {
-        for (i = 0; i != MR_TOKEN_KEYWORD_COUNT; i++)
-            if (size == mr_token_keyword_size[i] && !memcmp(_mr_config.code + idx, mr_token_keyword[i], size))
+        str = _mr_config.code + idx;
+        type = mr_token_ident[mr_token_ident_hash(str, size)];
+        if (type != MR_TOKEN_EOF)
+        {
+            if (type >= MR_TOKEN_TYPE_PAD)
             {
-                token->type = i + MR_TOKEN_KEYWORD_PAD;
-                data->size++;
-                return;
-            }
-
-        if (size <= MR_TOKEN_TYPE_MAXSIZE)
-            for (i = 0; i != MR_TOKEN_TYPE_COUNT; i++)
-                if (size == mr_token_type_size[i] && !memcmp(_mr_config.code + idx, mr_token_type[i], size))
+                if (size == mr_token_type_size[type - MR_TOKEN_TYPE_PAD] &&
+                    !memcmp(str, mr_token_type[type - MR_TOKEN_TYPE_PAD], size))
                 {
-                    token->type = i + MR_TOKEN_TYPE_PAD;
+                    token->type = type;
+                    mr_lexer_token_end(token, data->idx);
                     data->size++;
                     return;
                 }
+            }
+            else if (size == mr_token_keyword_size[type - MR_TOKEN_KEYWORD_PAD] &&
+                !memcmp(str, mr_token_keyword[type - MR_TOKEN_KEYWORD_PAD], size))
+            {
+                token->type = type;
+                mr_lexer_token_end(token, data->idx);
+                data->size++;
+                return;
+            }
+        }
     }
 
     token->type = MR_TOKEN_IDENTIFIER;
+    mr_lexer_token_end(token, data->idx);
     data->size++;
+
+#ifdef __MR_POOL_SYMS__
+    if (mr_pool_syms_add(&data->syms, data->base + idx, _mr_config.code + idx, data->idx - idx))
+        data->flag = MR_LEXER_MATCH_FLAG_MEMORY;
+#endif
+}
+
+void mr_lexer_generate_unicode(
+    mr_lexer_match_t *data)
+{
+    mr_byte_t size;
+
+    if (!mr_unicode_xid_start(mr_unicode_decode(_mr_config.code + data->idx, &size)))
+    {
+        data->flag = MR_LEXER_MATCH_FLAG_ILLEGAL;
+        return;
+    }
+
+    mr_lexer_generate_identifier(data);
 }
 
 void mr_lexer_generate_number(
@@ -858,8 +2697,54 @@ void mr_lexer_generate_number(
         data->idx++;
     }
 
+    mr_lexer_token_end(token, data->idx);
     data->size++;
+
+#ifdef __MR_POOL_CONSTS__
+    mr_lexer_generate_const(data, token);
+#endif
+}
+
+#ifdef __MR_POOL_CONSTS__
+void mr_lexer_generate_const(
+    mr_lexer_match_t *data, mr_token_t *token)
+{
+    mr_long_t idx, size;
+    mr_str_ct str;
+    mr_pool_const_t value;
+
+    idx = MR_IDX_EXTRACT(token->idx);
+    str = _mr_config.code + idx;
+    size = data->idx - idx;
+
+    if (token->type == MR_TOKEN_CHR)
+        value = (mr_pool_const_t){.value.i=(mr_byte_t)(size == 3 ? str[1] : mr_pool_escape(str[2])),
+            .type=MR_POOL_CONST_CHR};
+    else if (token->type == MR_TOKEN_INT && mr_pool_decode_int(&value.value.i, str, size))
+        value.type = MR_POOL_CONST_INT;
+    else
+    {
+        if (token->type == MR_TOKEN_INT)
+            value.type = MR_POOL_CONST_BIG_INT;
+        else if (token->type == MR_TOKEN_FLOAT)
+            value.type = MR_POOL_CONST_FLOAT;
+        else
+        {
+            value.type = MR_POOL_CONST_IMAGINARY;
+            size--;
+        }
+
+        if (mr_pool_decode_float(&value.value.f, str, size))
+        {
+            data->flag = MR_LEXER_MATCH_FLAG_MEMORY;
+            return;
+        }
+    }
+
+    if (mr_pool_consts_add(&data->consts, data->base + idx, value))
+        data->flag = MR_LEXER_MATCH_FLAG_MEMORY;
 }
+#endif
 
 void mr_lexer_generate_chr(
     mr_lexer_match_t *data)
@@ -873,24 +2758,38 @@ void mr_lexer_generate_chr(
         if (_mr_config.code[data->idx + 2] != '\'')
         {
             mr_lexer_generate_str(data, MR_TRUE);
+            if (data->flag)
+                return;
+
             data->idx++;
             return;
         }
 
         token = data->tokens + data->size;
         mr_lexer_token_set(MR_TOKEN_CHR, 3);
+
+#ifdef __MR_POOL_CONSTS__
+        mr_lexer_generate_const(data, token);
+#endif
         return;
     }
 
     if (_mr_config.code[data->idx + 3] != '\'')
     {
         mr_lexer_generate_str(data, MR_TRUE);
+        if (data->flag)
+            return;
+
         data->idx++;
         return;
     }
 
     token = data->tokens + data->size;
     mr_lexer_token_set(MR_TOKEN_CHR, 4);
+
+#ifdef __MR_POOL_CONSTS__
+    mr_lexer_generate_const(data, token);
+#endif
 }
 
 void mr_lexer_generate_str(
@@ -906,93 +2805,228 @@ void mr_lexer_generate_str(
 
     quot = _mr_config.code[data->idx++];
     chr = _mr_config.code[data->idx];
-    if (chr == quot)
-    {
-        data->size++;
-        return;
-    }
-
-    do
-        mr_lexer_str_sub;
-    while (chr != quot);
+    if (chr != quot)
+        do
+            mr_lexer_str_sub;
+        while (chr != quot);
 
+    mr_lexer_token_end(token, data->idx + 1);
     data->size++;
+
+#ifdef __MR_POOL_STRS__
+    mr_lexer_generate_strlit(data, MR_IDX_EXTRACT(token->idx), esc ? 1 : 2, esc);
+#endif
 }
 
+#ifdef __MR_POOL_STRS__
+void mr_lexer_generate_strlit(
+    mr_lexer_match_t *data, mr_long_t idx, mr_long_t skip, mr_bool_t esc)
+{
+    if (mr_pool_strs_add(&data->strs, data->base + idx, _mr_config.code + idx + skip, data->idx - idx - skip, esc))
+        data->flag = MR_LEXER_MATCH_FLAG_MEMORY;
+}
+#endif
+
 void mr_lexer_generate_fstr(
     mr_lexer_match_t *data, mr_bool_t esc)
 {
-    mr_long_t lcurly_count;
-    mr_chr_t quot, chr;
-    mr_ptr_t block;
     mr_token_t *token;
 
+    if (data->fsize == data->falloc && mr_lexer_fstrs_grow(data))
+    {
+        data->flag = MR_LEXER_MATCH_FLAG_MEMORY;
+        return;
+    }
+
+#ifdef __MR_TOKEN_SPANS__
+    data->fstrs[data->fsize].start = data->size;
+#endif
+
     mr_lexer_token_set2(MR_TOKEN_FSTR_START, ++);
     data->idx += esc ? 1 : 2;
 
-    quot = _mr_config.code[data->idx++];
-    chr = _mr_config.code[data->idx];
+    data->fstrs[data->fsize].lcurly = 0;
+    data->fstrs[data->fsize].quot = _mr_config.code[data->idx++];
+    data->fstrs[data->fsize++].esc = esc;
 
-    if (chr == quot)
-    {
-        mr_lexer_tokens_realloc;
-        mr_lexer_token_set2(MR_TOKEN_FSTR_END, ++);
-        return;
-    }
+    mr_lexer_generate_fstr_text(data);
+}
 
-    lcurly_count = 0;
-    do
+void mr_lexer_generate_fstr_text(
+    mr_lexer_match_t *data)
+{
+    mr_long_t idx, piece;
+    mr_bool_t esc;
+    mr_chr_t quot, chr;
+    mr_token_t *token;
+    mr_lexer_fstr_t *fstr;
+    mr_str_ct code;
+
+    /* A piece of text and the end of the formatted string are the most that can be generated at once. */
+    mr_lexer_tokens_reserve(2);
+
+    fstr = data->fstrs + data->fsize - 1;
+    quot = fstr->quot;
+    esc = fstr->esc;
+
+    code = _mr_config.code;
+    idx = data->idx;
+    chr = code[idx];
+    while (chr != quot)
     {
-        if (chr == '\0')
+        if (chr == '{')
         {
-            data->flag = MR_LEXER_MATCH_FLAG_MISSING;
-            data->alloc = quot;
+            data->idx = idx + 1;
             return;
         }
 
-        if (chr == '{')
+        piece = idx;
+        do
         {
-            chr = _mr_config.code[++data->idx];
-            while (chr != '}' || lcurly_count)
+            if (chr == '\\' && esc)
+                chr = code[++idx];
+            if (chr == '\0')
             {
-                if (_mr_config.code[data->idx] == '\0')
-                {
-                    data->flag = MR_LEXER_MATCH_FLAG_MISSING;
-                    data->alloc = '}';
-                    return;
-                }
+                data->flag = MR_LEXER_MATCH_FLAG_MISSING;
+                data->alloc = quot;
+                data->idx = idx;
+                return;
+            }
 
-                mr_lexer_tokens_realloc;
-                mr_lexer_match(data);
-                if (data->flag)
-                    return;
+            chr = code[++idx];
+        } while (chr != quot && chr != '{');
 
-                token = data->tokens + data->size - 1;
-                if (token->type == MR_TOKEN_L_CURLY)
-                    lcurly_count++;
-                else if (token->type == MR_TOKEN_R_CURLY)
-                    lcurly_count--;
+        token = data->tokens + data->size;
+        *token = (mr_token_t){.type=MR_TOKEN_FSTR, .idx=MR_IDX_DECOMPOSE(piece)};
+        mr_lexer_token_end(token, piece);
+        data->size++;
 
-                chr = _mr_config.code[data->idx];
-            }
+        data->idx = idx;
+#ifdef __MR_POOL_STRS__
+        mr_lexer_generate_strlit(data, piece, 0, esc);
+        if (data->flag)
+            return;
+#endif
+    }
 
-            chr = _mr_config.code[++data->idx];
-            if (chr == quot)
-                break;
-            continue;
+    data->idx = idx;
+    mr_lexer_token_set2(MR_TOKEN_FSTR_END, ++);
+    mr_lexer_token_end(token, idx);
+    mr_lexer_token_end(data->tokens + fstr->start, idx + 1);
+
+    data->fsize--;
+    data->idx++;
+}
+
+void mr_lexer_generate_rcurly(
+    mr_lexer_match_t *data)
+{
+    mr_token_t *token;
+    mr_lexer_fstr_t *fstr;
+
+    fstr = data->fstrs + data->fsize - 1;
+    if (!fstr->lcurly)
+    {
+        data->idx++;
+        mr_lexer_generate_fstr_text(data);
+        return;
+    }
+
+    fstr->lcurly--;
+
+    token = data->tokens + data->size;
+    mr_lexer_token_set(MR_TOKEN_R_CURLY, 1);
+}
+
+void mr_lexer_generate_newline(
+    mr_lexer_match_t *data)
+{
+    mr_token_t *token;
+
+    token = data->tokens + data->size;
+    if (mr_lexer_add_newline(token[-1].type))
+        mr_lexer_token_set(MR_TOKEN_NEWLINE, 1);
+    else
+        data->idx++;
+}
+
+void mr_lexer_generate_semicolon(
+    mr_lexer_match_t *data)
+{
+    mr_token_t *token;
+
+    token = data->tokens + data->size;
+    if (token[-1].type == MR_TOKEN_SEMICOLON)
+    {
+        data->idx++;
+        return;
+    }
+    if (token[-1].type == MR_TOKEN_NEWLINE)
+    {
+        token[-1].type = MR_TOKEN_SEMICOLON;
+        data->idx++;
+        return;
+    }
+
+    mr_lexer_token_set(MR_TOKEN_SEMICOLON, 1);
+}
+
+void mr_lexer_generate_backslash(
+    mr_lexer_match_t *data)
+{
+    mr_chr_t chr;
+
+    switch (_mr_config.code[data->idx + 1])
+    {
+    case 'f':
+        chr = _mr_config.code[data->idx + 2];
+        if (chr == '\'' || chr == '"')
+        {
+            mr_lexer_generate_fstr(data, MR_FALSE);
+            return;
         }
+        break;
+    case '\'':
+    case '"':
+        mr_lexer_generate_str(data, MR_FALSE);
+        if (data->flag)
+            return;
 
-        mr_lexer_tokens_realloc;
-        mr_lexer_token_set2(MR_TOKEN_FSTR,);
+        data->idx++;
+        return;
+    }
 
-        do
-            mr_lexer_str_sub;
-        while (chr != quot && chr != '{');
-        data->size++;
-    } while (chr != quot);
+    data->flag = MR_LEXER_MATCH_FLAG_ILLEGAL;
+}
 
-    mr_lexer_tokens_realloc;
-    mr_lexer_token_set2(MR_TOKEN_FSTR_END, ++);
+void mr_lexer_generate_fprefix(
+    mr_lexer_match_t *data)
+{
+    mr_bool_t esc;
+    mr_chr_t chr;
+
+    esc = MR_TRUE;
+    chr = _mr_config.code[data->idx + 1];
+    if (chr == '\\')
+    {
+        esc = MR_FALSE;
+        chr = _mr_config.code[data->idx + 2];
+    }
+
+    if (chr == '\'' || chr == '"')
+    {
+        mr_lexer_generate_fstr(data, esc);
+        return;
+    }
+
+    if (!esc)
+    {
+        data->idx++;
+        data->flag = MR_LEXER_MATCH_FLAG_ILLEGAL;
+        return;
+    }
+
+    mr_lexer_generate_identifier(data);
 }
 
 void mr_lexer_generate_dot(
@@ -0,0 +1,517 @@
+/*
+MIT License
+
+Copyright (c) 2023 MetaReal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+*/
+
+/**
+ * @file scan.c
+ * This file contains definitions of the \a scan.h file.
+*/
+
+#include <lexer/scan.h>
+#include <lexer/unicode.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define __MR_SCAN_X86__
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+/**
+ * Attribute that enables AVX2 instructions for a single function.
+*/
+#define MR_SCAN_AVX2 __attribute__((target("avx2")))
+#else
+#define MR_SCAN_AVX2
+#endif
+
+/**
+ * It returns index of the first character (starting from <em>idx</em>) that is not ' ', '\\t', or '\\r' (scalar version).
+ * @param code
+ * The source code.
+ * @param idx
+ * Starting index of the scan.
+ * @param end
+ * Index of the null terminator of the code.
+ * @return It returns index of the first non-space character.
+*/
+mr_long_t mr_scan_spaces_scalar(
+    mr_str_ct code, mr_long_t idx, mr_long_t end);
+
+/**
+ * It returns index of the first '\\n' or '\\0' character (starting from <em>idx</em>) (scalar version).
+ * @param code
+ * The source code.
+ * @param idx
+ * Starting index of the scan.
+ * @param end
+ * Index of the null terminator of the code.
+ * @return It returns index of the first '\\n' or '\\0' character.
+*/
+mr_long_t mr_scan_line_scalar(
+    mr_str_ct code, mr_long_t idx, mr_long_t end);
+
+/**
+ * It returns index of the first "*#" sequence or '\\0' character (starting from <em>idx</em>) (scalar version).
+ * @param code
+ * The source code.
+ * @param idx
+ * Starting index of the scan.
+ * @param end
+ * Index of the null terminator of the code.
+ * @return It returns index of the '*' character of the first "*#" sequence or index of the first '\\0' character.
+*/
+mr_long_t mr_scan_comment_scalar(
+    mr_str_ct code, mr_long_t idx, mr_long_t end);
+
+/**
+ * It returns index of the first character (starting from <em>idx</em>) that is not a part of a valid UTF-8 sequence (scalar version).
+ * @param code
+ * The source code.
+ * @param idx
+ * Starting index of the scan.
+ * @param end
+ * Ending index of the scan.
+ * @return It returns index of the first invalid character, Or \a end if there is none.
+*/
+mr_long_t mr_scan_utf8_scalar(
+    mr_str_ct code, mr_long_t idx, mr_long_t end);
+
+mr_scan_t _mr_scan = {.spaces=mr_scan_spaces_scalar, .line=mr_scan_line_scalar, .comment=mr_scan_comment_scalar,
+    .utf8=mr_scan_utf8_scalar};
+
+#ifdef __MR_SCAN_X86__
+
+/**
+ * It returns index of the lowest set bit of the <em>mask</em>.
+ * @param mask
+ * A nonzero bit mask.
+ * @return It returns index of the lowest set bit.
+*/
+static mr_long_t mr_scan_ctz(
+    mr_long_t mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (mr_long_t)__builtin_ctz(mask);
+#elif defined(_MSC_VER)
+    unsigned long i;
+
+    _BitScanForward(&i, mask);
+    return (mr_long_t)i;
+#endif
+}
+
+/**
+ * SSE2 version of the \a spaces subroutine.
+*/
+static mr_long_t mr_scan_spaces_sse2(
+    mr_str_ct code, mr_long_t idx, mr_long_t end)
+{
+    __m128i space, tab, cr, chunk;
+    mr_long_t mask;
+
+    space = _mm_set1_epi8(' ');
+    tab = _mm_set1_epi8('\t');
+    cr = _mm_set1_epi8('\r');
+
+    for (; idx + 16 <= end; idx += 16)
+    {
+        chunk = _mm_loadu_si128((const __m128i*)(code + idx));
+        chunk = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)),
+            _mm_cmpeq_epi8(chunk, cr));
+
+        mask = (mr_long_t)_mm_movemask_epi8(chunk) ^ 0xffff;
+        if (mask)
+            return idx + mr_scan_ctz(mask);
+    }
+
+    return mr_scan_spaces_scalar(code, idx, end);
+}
+
+/**
+ * SSE2 version of the \a line subroutine.
+*/
+static mr_long_t mr_scan_line_sse2(
+    mr_str_ct code, mr_long_t idx, mr_long_t end)
+{
+    __m128i newline, zero, chunk;
+    mr_long_t mask;
+
+    newline = _mm_set1_epi8('\n');
+    zero = _mm_setzero_si128();
+
+    for (; idx + 16 <= end; idx += 16)
+    {
+        chunk = _mm_loadu_si128((const __m128i*)(code + idx));
+        chunk = _mm_or_si128(_mm_cmpeq_epi8(chunk, newline), _mm_cmpeq_epi8(chunk, zero));
+
+        mask = (mr_long_t)_mm_movemask_epi8(chunk);
+        if (mask)
+            return idx + mr_scan_ctz(mask);
+    }
+
+    return mr_scan_line_scalar(code, idx, end);
+}
+
+/**
+ * SSE2 version of the \a comment subroutine.
+*/
+static mr_long_t mr_scan_comment_sse2(
+    mr_str_ct code, mr_long_t idx, mr_long_t end)
+{
+    __m128i star, hash, zero, chunk, next;
+    mr_long_t mask;
+
+    star = _mm_set1_epi8('*');
+    hash = _mm_set1_epi8('#');
+    zero = _mm_setzero_si128();
+
+    for (; idx + 16 < end; idx += 16)
+    {
+        chunk = _mm_loadu_si128((const __m128i*)(code + idx));
+        next = _mm_loadu_si128((const __m128i*)(code + idx + 1));
+        chunk = _mm_or_si128(_mm_and_si128(_mm_cmpeq_epi8(chunk, star), _mm_cmpeq_epi8(next, hash)),
+            _mm_cmpeq_epi8(chunk, zero));
+
+        mask = (mr_long_t)_mm_movemask_epi8(chunk);
+        if (mask)
+            return idx + mr_scan_ctz(mask);
+    }
+
+    return mr_scan_comment_scalar(code, idx, end);
+}
+
+/**
+ * SSE2 version of the \a utf8 subroutine. \n
+ * It skips ASCII characters 16 at a time and decodes the non-ASCII runs one sequence at a time.
+*/
+static mr_long_t mr_scan_utf8_sse2(
+    mr_str_ct code, mr_long_t idx, mr_long_t end)
+{
+    __m128i chunk;
+    mr_long_t mask;
+    mr_byte_t size;
+
+    while (idx + 16 <= end)
+    {
+        chunk = _mm_loadu_si128((const __m128i*)(code + idx));
+
+        mask = (mr_long_t)_mm_movemask_epi8(chunk);
+        if (!mask)
+        {
+            idx += 16;
+            continue;
+        }
+
+        idx += mr_scan_ctz(mask);
+        do
+        {
+            if (mr_unicode_decode(code + idx, &size) == MR_UNICODE_INVALID || idx + size > end)
+                return idx;
+
+            idx += size;
+        } while (idx != end && (mr_byte_t)code[idx] >= 0x80);
+    }
+
+    return mr_scan_utf8_scalar(code, idx, end);
+}
+
+/**
+ * It finds the index that the scalar validation resumes from after the vectorized validation stopped at <em>idx</em>. \n
+ * Everything before \a idx is valid, Except for a sequence that starts in the last 3 characters and may be incomplete.
+ * @param code
+ * The source code.
+ * @param idx
+ * Index that the vectorized validation stopped at.
+ * @param start
+ * Starting index of the validation.
+ * @return It returns index of the lead character of the last sequence if it starts in the last 3 characters, And \a idx otherwise.
+*/
+static mr_long_t mr_scan_utf8_resume(
+    mr_str_ct code, mr_long_t idx, mr_long_t start)
+{
+    mr_long_t i;
+
+    for (i = idx; i != start && idx - i != 3;)
+    {
+        i--;
+        if (((mr_byte_t)code[i] & 0xc0) != 0x80)
+            return (mr_byte_t)code[i] >= 0xc0 ? i : idx;
+    }
+
+    return idx;
+}
+
+/**
+ * AVX2 version of the \a spaces subroutine.
+*/
+MR_SCAN_AVX2 static mr_long_t mr_scan_spaces_avx2(
+    mr_str_ct code, mr_long_t idx, mr_long_t end)
+{
+    __m256i space, tab, cr, chunk;
+    mr_long_t mask;
+
+    space = _mm256_set1_epi8(' ');
+    tab = _mm256_set1_epi8('\t');
+    cr = _mm256_set1_epi8('\r');
+
+    for (; idx + 32 <= end; idx += 32)
+    {
+        chunk = _mm256_loadu_si256((const __m256i*)(code + idx));
+        chunk = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, space), _mm256_cmpeq_epi8(chunk, tab)),
+            _mm256_cmpeq_epi8(chunk, cr));
+
+        mask = ~(mr_long_t)_mm256_movemask_epi8(chunk);
+        if (mask)
+            return idx + mr_scan_ctz(mask);
+    }
+
+    return mr_scan_spaces_sse2(code, idx, end);
+}
+
+/**
+ * AVX2 version of the \a line subroutine.
+*/
+MR_SCAN_AVX2 static mr_long_t mr_scan_line_avx2(
+    mr_str_ct code, mr_long_t idx, mr_long_t end)
+{
+    __m256i newline, zero, chunk;
+    mr_long_t mask;
+
+    newline = _mm256_set1_epi8('\n');
+    zero = _mm256_setzero_si256();
+
+    for (; idx + 32 <= end; idx += 32)
+    {
+        chunk = _mm256_loadu_si256((const __m256i*)(code + idx));
+        chunk = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, newline), _mm256_cmpeq_epi8(chunk, zero));
+
+        mask = (mr_long_t)_mm256_movemask_epi8(chunk);
+        if (mask)
+            return idx + mr_scan_ctz(mask);
+    }
+
+    return mr_scan_line_sse2(code, idx, end);
+}
+
+/**
+ * AVX2 version of the \a comment subroutine.
+*/
+MR_SCAN_AVX2 static mr_long_t mr_scan_comment_avx2(
+    mr_str_ct code, mr_long_t idx, mr_long_t end)
+{
+    __m256i star, hash, zero, chunk, next;
+    mr_long_t mask;
+
+    star = _mm256_set1_epi8('*');
+    hash = _mm256_set1_epi8('#');
+    zero = _mm256_setzero_si256();
+
+    for (; idx + 32 < end; idx += 32)
+    {
+        chunk = _mm256_loadu_si256((const __m256i*)(code + idx));
+        next = _mm256_loadu_si256((const __m256i*)(code + idx + 1));
+        chunk = _mm256_or_si256(_mm256_and_si256(_mm256_cmpeq_epi8(chunk, star), _mm256_cmpeq_epi8(next, hash)),
+            _mm256_cmpeq_epi8(chunk, zero));
+
+        mask = (mr_long_t)_mm256_movemask_epi8(chunk);
+        if (mask)
+            return idx + mr_scan_ctz(mask);
+    }
+
+    return mr_scan_comment_sse2(code, idx, end);
+}
+
+/**
+ * AVX2 version of the \a utf8 subroutine. \n
+ * Each character is classified by three table lookups (high and low nibbles of the previous character and high nibble of the character),
+ * Which detect all invalid pairs of characters. Continuation characters after 3 and 4-byte lead characters are checked separately. \n
+ * ASCII blocks are skipped after checking that the previous block didn't end with an incomplete sequence.
+ * When an error is detected, The scalar version finds its exact index.
+*/
+MR_SCAN_AVX2 static mr_long_t mr_scan_utf8_avx2(
+    mr_str_ct code, mr_long_t idx, mr_long_t end)
+{
+    __m256i high1, low1, high2, nibble, limit, cont3, cont4, msb;
+    __m256i chunk, prev, prev1, prev2, prev3, error, incomplete;
+    mr_long_t start;
+
+    /*
+     * Error bits: 0x01 too short, 0x02 too long, 0x04 overlong 3-byte, 0x08 too large, 0x10 surrogate,
+     * 0x20 overlong 2-byte, 0x40 overlong 4-byte or too large (U+1xxxxx), 0x80 two continuations.
+    */
+    high1 = _mm256_setr_epi8(
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, (char)0x80, (char)0x80, (char)0x80, (char)0x80, 0x21, 0x01, 0x15, 0x49,
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, (char)0x80, (char)0x80, (char)0x80, (char)0x80, 0x21, 0x01, 0x15, 0x49);
+    low1 = _mm256_setr_epi8(
+        (char)0xe7, (char)0xa3, (char)0x83, (char)0x83, (char)0x8b, (char)0xcb, (char)0xcb, (char)0xcb,
+        (char)0xcb, (char)0xcb, (char)0xcb, (char)0xcb, (char)0xcb, (char)0xdb, (char)0xcb, (char)0xcb,
+        (char)0xe7, (char)0xa3, (char)0x83, (char)0x83, (char)0x8b, (char)0xcb, (char)0xcb, (char)0xcb,
+        (char)0xcb, (char)0xcb, (char)0xcb, (char)0xcb, (char)0xcb, (char)0xdb, (char)0xcb, (char)0xcb);
+    high2 = _mm256_setr_epi8(
+        0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, (char)0xe6, (char)0xae, (char)0xba, (char)0xba, 0x01, 0x01, 0x01, 0x01,
+        0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, (char)0xe6, (char)0xae, (char)0xba, (char)0xba, 0x01, 0x01, 0x01, 0x01);
+
+    /* A block is incomplete if one of its last 3 characters starts a sequence that is longer than the rest of the block. */
+    limit = _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, (char)0xef, (char)0xdf, (char)0xbf);
+
+    nibble = _mm256_set1_epi8(0x0f);
+    cont3 = _mm256_set1_epi8(0x60);
+    cont4 = _mm256_set1_epi8(0x70);
+    msb = _mm256_set1_epi8((char)0x80);
+
+    start = idx;
+    prev = incomplete = _mm256_setzero_si256();
+
+    for (; idx + 32 <= end; idx += 32)
+    {
+        chunk = _mm256_loadu_si256((const __m256i*)(code + idx));
+        if (!_mm256_movemask_epi8(chunk))
+        {
+            if (!_mm256_testz_si256(incomplete, incomplete))
+                break;
+
+            prev = chunk;
+            continue;
+        }
+
+        prev1 = _mm256_permute2x128_si256(prev, chunk, 0x21);
+        prev2 = _mm256_alignr_epi8(chunk, prev1, 14);
+        prev3 = _mm256_alignr_epi8(chunk, prev1, 13);
+        prev1 = _mm256_alignr_epi8(chunk, prev1, 15);
+
+        error = _mm256_and_si256(_mm256_and_si256(
+            _mm256_shuffle_epi8(high1, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+            _mm256_shuffle_epi8(low1, _mm256_and_si256(prev1, nibble))),
+            _mm256_shuffle_epi8(high2, _mm256_and_si256(_mm256_srli_epi16(chunk, 4), nibble)));
+        error = _mm256_xor_si256(error, _mm256_and_si256(
+            _mm256_or_si256(_mm256_subs_epu8(prev2, cont3), _mm256_subs_epu8(prev3, cont4)), msb));
+        if (!_mm256_testz_si256(error, error))
+            break;
+
+        incomplete = _mm256_subs_epu8(chunk, limit);
+        prev = chunk;
+    }
+
+    return mr_scan_utf8_sse2(code, mr_scan_utf8_resume(code, idx, start), end);
+}
+
+#endif
+
+void mr_scan_init(void)
+{
+#ifdef __MR_SCAN_X86__
+    mr_bool_t sse2, avx2;
+
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    sse2 = __builtin_cpu_supports("sse2") ? MR_TRUE : MR_FALSE;
+    avx2 = __builtin_cpu_supports("avx2") ? MR_TRUE : MR_FALSE;
+#elif defined(_MSC_VER)
+    int info[4];
+
+    __cpuid(info, 1);
+    sse2 = (info[3] >> 26) & 1;
+    avx2 = MR_FALSE;
+
+    if ((info[2] >> 27) & 1 && (_xgetbv(0) & 6) == 6)
+    {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] >> 5) & 1;
+    }
+#endif
+
+    if (avx2)
+        _mr_scan = (mr_scan_t){.spaces=mr_scan_spaces_avx2, .line=mr_scan_line_avx2, .comment=mr_scan_comment_avx2,
+            .utf8=mr_scan_utf8_avx2};
+    else if (sse2)
+        _mr_scan = (mr_scan_t){.spaces=mr_scan_spaces_sse2, .line=mr_scan_line_sse2, .comment=mr_scan_comment_sse2,
+            .utf8=mr_scan_utf8_sse2};
+#endif
+}
+
+mr_long_t mr_scan_spaces_scalar(
+    mr_str_ct code, mr_long_t idx, mr_long_t end)
+{
+    mr_chr_t chr;
+
+    (void)end;
+
+    chr = code[idx];
+    while (chr == ' ' || chr == '\t' || chr == '\r')
+        chr = code[++idx];
+
+    return idx;
+}
+
+mr_long_t mr_scan_line_scalar(
+    mr_str_ct code, mr_long_t idx, mr_long_t end)
+{
+    mr_chr_t chr;
+
+    (void)end;
+
+    chr = code[idx];
+    while (chr != '\0' && chr != '\n')
+        chr = code[++idx];
+
+    return idx;
+}
+
+mr_long_t mr_scan_comment_scalar(
+    mr_str_ct code, mr_long_t idx, mr_long_t end)
+{
+    mr_chr_t chr;
+
+    (void)end;
+
+    chr = code[idx];
+    while (chr != '\0')
+    {
+        if (chr == '*' && code[idx + 1] == '#')
+            break;
+
+        chr = code[++idx];
+    }
+
+    return idx;
+}
+
+mr_long_t mr_scan_utf8_scalar(
+    mr_str_ct code, mr_long_t idx, mr_long_t end)
+{
+    mr_byte_t size;
+
+    while (idx != end)
+    {
+        if ((mr_byte_t)code[idx] < 0x80)
+        {
+            idx++;
+            continue;
+        }
+
+        if (mr_unicode_decode(code + idx, &size) == MR_UNICODE_INVALID || idx + size > end)
+            return idx;
+
+        idx += size;
+    }
+
+    return idx;
+}
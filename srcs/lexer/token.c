@@ -20,7 +20,9 @@ copies or substantial portions of the Software.
 */
 
 #include <lexer/token.h>
+#include <lexer/unicode.h>
 #include <config.h>
+#include <mem.h>
 
 mr_str_ct mr_token_keyword[MR_TOKEN_KEYWORD_COUNT] =
 {
@@ -60,6 +62,62 @@ mr_byte_t mr_token_type_size[MR_TOKEN_TYPE_COUNT] =
     6, 3, 5, 7, 4, 3, 3, 4, 5, 4, 3, 4
 };
 
+mr_byte_t mr_token_ident[MR_TOKEN_IDENT_SIZE] =
+{
+    [2]=MR_TOKEN_TO_K,
+    [3]=MR_TOKEN_WHILE_K,
+    [4]=MR_TOKEN_INCLUDE_K,
+    [5]=MR_TOKEN_PRIVATE_K,
+    [6]=MR_TOKEN_SWITCH_K,
+    [7]=MR_TOKEN_AND_K,
+    [13]=MR_TOKEN_IMPORT_K,
+    [14]=MR_TOKEN_RAISE_K,
+    [15]=MR_TOKEN_FUNC_K,
+    [18]=MR_TOKEN_TRY_K,
+    [19]=MR_TOKEN_PUBLIC_K,
+    [23]=MR_TOKEN_FLOAT_T,
+    [24]=MR_TOKEN_CASE_K,
+    [26]=MR_TOKEN_ELSE_K,
+    [33]=MR_TOKEN_DEFAULT_K,
+    [34]=MR_TOKEN_OR_K,
+    [38]=MR_TOKEN_BREAK_K,
+    [39]=MR_TOKEN_NONE_K,
+    [41]=MR_TOKEN_RETURN_K,
+    [43]=MR_TOKEN_CONTINUE_K,
+    [46]=MR_TOKEN_DO_K,
+    [47]=MR_TOKEN_EXCEPT_K,
+    [49]=MR_TOKEN_SET_T,
+    [51]=MR_TOKEN_CHAR_T,
+    [53]=MR_TOKEN_OBJECT_T,
+    [54]=MR_TOKEN_IS_K,
+    [56]=MR_TOKEN_ARE_K,
+    [58]=MR_TOKEN_ENUM_K,
+    [60]=MR_TOKEN_STRUCT_K,
+    [67]=MR_TOKEN_STATIC_K,
+    [68]=MR_TOKEN_TRUE_K,
+    [69]=MR_TOKEN_COMPLEX_T,
+    [71]=MR_TOKEN_DICT_T,
+    [73]=MR_TOKEN_TUPLE_T,
+    [78]=MR_TOKEN_ELIF_K,
+    [79]=MR_TOKEN_FALSE_K,
+    [86]=MR_TOKEN_BOOL_T,
+    [89]=MR_TOKEN_IF_K,
+    [92]=MR_TOKEN_STEP_K,
+    [93]=MR_TOKEN_FOR_K,
+    [96]=MR_TOKEN_PROTECTED_K,
+    [97]=MR_TOKEN_GLOBAL_K,
+    [101]=MR_TOKEN_CONST_K,
+    [109]=MR_TOKEN_FINALLY_K,
+    [111]=MR_TOKEN_NOT_K,
+    [113]=MR_TOKEN_LIST_T,
+    [115]=MR_TOKEN_CLASS_K,
+    [117]=MR_TOKEN_IN_K,
+    [118]=MR_TOKEN_INT_T,
+    [119]=MR_TOKEN_READONLY_K,
+    [125]=MR_TOKEN_STR_T,
+    [126]=MR_TOKEN_TYPE_T
+};
+
 mr_byte_t mr_token_symbol_size[MR_TOKEN_KEYWORD_PAD] =
 {
     0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0,
@@ -70,9 +128,16 @@ mr_byte_t mr_token_symbol_size[MR_TOKEN_KEYWORD_PAD] =
     1, 1, 1, 1, 1, 1, 3, 1, 1, 1
 };
 
+#ifdef __MR_TOKEN_SPANS__
+mr_token_spans_t _mr_token_spans = {.tokens=NULL, .ends=NULL};
+#endif
+
 mr_long_t mr_token_getsize(
     mr_token_t *token)
 {
+#ifdef __MR_TOKEN_SPANS__
+    return MR_IDX_EXTRACT(_mr_token_spans.ends[token - _mr_token_spans.tokens]) - MR_IDX_EXTRACT(token->idx);
+#else
     mr_long_t idx;
 
     idx = MR_IDX_EXTRACT(token->idx);
@@ -97,6 +162,7 @@ mr_long_t mr_token_getsize(
     }
 
     return mr_token_getsize2(token->type, idx);
+#endif
 }
 
 mr_long_t mr_token_getsize2(
@@ -125,6 +191,9 @@ mr_long_t mr_token_getsize2(
         while ((chr >= 'A' && chr <= 'Z') || (chr >= 'a' && chr <= 'z') || (chr >= '0' && chr <= '9') || chr == '_')
             chr = _mr_config.code[++idx];
 
+        if ((mr_byte_t)chr >= 0x80)
+            idx = mr_unicode_ident_end(_mr_config.code, start);
+
         return idx - start;
     case MR_TOKEN_INT:
         start = idx++;
@@ -223,6 +292,99 @@ mr_long_t mr_token_getsize2(
     }
 }
 
+void mr_token_histogram(
+    mr_long_t *counts, const mr_token_t *tokens)
+{
+    for (; tokens->type != MR_TOKEN_EOF; tokens++)
+        counts[tokens->type]++;
+}
+
+#ifdef __MR_TOKEN_COMPACT__
+
+mr_byte_t mr_token_compact(
+    mr_byte_t **res, const mr_token_t *tokens, mr_long_t size)
+{
+    mr_byte_t *data;
+    mr_long_t i, alloc, prev, delta;
+
+    alloc = 0;
+    prev = 0;
+    for (i = 0; i <= size; i++)
+    {
+        delta = MR_IDX_EXTRACT(tokens[i].idx) - prev;
+        prev += delta;
+
+        alloc += 2;
+        for (; delta >= 0x80; delta >>= 7)
+            alloc++;
+    }
+
+    data = mr_mem_malloc(MR_MEM_LEXER, alloc * sizeof(mr_byte_t));
+    if (!data)
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    *res = data;
+
+    prev = 0;
+    for (i = 0; i <= size; i++)
+    {
+        delta = MR_IDX_EXTRACT(tokens[i].idx) - prev;
+        prev += delta;
+
+        *data++ = tokens[i].type;
+        for (; delta >= 0x80; delta >>= 7)
+            *data++ = (mr_byte_t)(delta | 0x80);
+        *data++ = (mr_byte_t)delta;
+    }
+
+    return MR_NOERROR;
+}
+
+void mr_token_cursor_decode(
+    mr_token_cursor_t *cur)
+{
+    const mr_byte_t *data;
+    mr_long_t delta;
+    mr_byte_t shift;
+
+    data = cur->data + 1;
+    delta = *data & 0x7f;
+    for (shift = 7; *data++ & 0x80; shift += 7)
+        delta |= (mr_long_t)(*data & 0x7f) << shift;
+
+    cur->idx += delta;
+    cur->data = data;
+}
+
+mr_long_t mr_token_cursor_getsize(
+    const mr_token_cursor_t *cur)
+{
+    mr_token_cursor_t end;
+    mr_long_t count;
+
+    if (cur->type != MR_TOKEN_FSTR_START)
+        return mr_token_getsize2(cur->type, cur->idx);
+
+    end = *cur;
+    count = 0;
+    while (1)
+    {
+        mr_token_cursor_next(&end);
+        if (end.type == MR_TOKEN_FSTR_START)
+            count++;
+        else if (end.type == MR_TOKEN_FSTR_END)
+        {
+            if (!count)
+                break;
+            count--;
+        }
+    }
+
+    return end.idx - cur->idx + 1;
+}
+
+#endif
+
 #ifdef __MR_DEBUG__
 
 mr_str_ct mr_token_labels[MR_TOKEN_COUNT] =
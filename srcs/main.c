@@ -21,11 +21,14 @@ copies or substantial portions of the Software.
 */
 
 #include <lexer/lexer.h>
+#include <lexer/scan.h>
 #include <parser/parser.h>
 #include <stack.h>
+#include <source.h>
+#include <pool.h>
+#include <mem.h>
 #include <config.h>
 #include <stdio.h>
-#include <stdlib.h>
 #include <string.h>
 #include <consts.h>
 
@@ -35,7 +38,9 @@ copies or substantial portions of the Software.
 #define MR_HELP_CONTENT "MetaReal [output] [files] [options]\nOptions:\n" \
     "  --help\t\tDisplays the help information.\n"                        \
     "  --version\t\tDisplays the version information.\n"                  \
-    "  --dumpver\t\tDisplays the version data.\n"
+    "  --dumpver\t\tDisplays the version data.\n"                         \
+    "  --mem-stats[=json]\tReports memory usage of each phase.\n"         \
+    "Use - as the file to read the code from the standard input.\n"
 
 /**
  * It compiles the \a code according to MetaReal compile rules. \n
@@ -45,16 +50,31 @@ copies or substantial portions of the Software.
  * </pre>
  * Also, debugger will debug the \a code during compilation process (if enabled). \n
  * Dollar methods are handled with a different mechanism in the optimizer and parser steps.
+ * @param stream
+ * If it's not NULL, the code is read from the \a stream while it's being lexed. Otherwise, the code is taken from <em>_mr_config.code</em>.
  * @return It returns a code which indicates if process was successful or not. \n
  * If process was successful, it returns 0. Otherwise, it returns the error code.
 */
-mr_byte_t mr_compile(void);
+mr_byte_t mr_compile(
+    FILE *stream);
+
+#ifdef __MR_TOKEN_PULL__
+/**
+ * It compiles <em>_mr_config.code</em> with the lexer fused into the parser (only available with pull-based lexing enabled). \n
+ * The parser pulls the tokens from the lexer while it reads them, So the tokens list is never created.
+ * Errors of the lexer are reported instead of the errors of the parser, Like in the \a mr_compile function.
+ * @return It returns a code which indicates if process was successful or not. \n
+ * If process was successful, it returns 0. Otherwise, it returns the error code.
+*/
+mr_byte_t mr_compile_pull(void);
+#endif
 
 /**
  * It handles arguments of the application. \n
  * Supported arguments:
  * <pre>
  *     -O[d0123u]
+ *     --mem-stats[=json]
  * </pre>
  * @param argv
  * The list of arguments.
@@ -68,7 +88,7 @@ int main(
     int argc, mr_str_ct argv[])
 {
     mr_long_t size;
-    mr_byte_t retcode;
+    mr_byte_t retcode, source;
     mr_str_t code;
     FILE *file;
 
@@ -100,6 +120,30 @@ int main(
     if (argc > 2)
         mr_handle_args(argv + 2, (mr_byte_t)argc - 2);
 
+    if (!strcmp(argv[1], "-"))
+    {
+        _mr_config = (mr_config_t){.outstream=stdout, .instream=stdin, .errstream=stderr,
+            .fname="<stdin>"};
+        mr_scan_init();
+
+        retcode = mr_compile(stdin);
+        mr_mem_free((mr_str_t)_mr_config.code);
+        mr_error_lines_free();
+
+        if (retcode == MR_ERROR_NOT_ENOUGH_MEMORY)
+            mr_mem_fail_print(stderr);
+        else if (retcode == MR_ERROR_FILE_TOO_LARGE)
+            fprintf(stderr, "Internal error: File size exceeds the limit (%" PRIu32 ")", MR_FILE_MAXSIZE);
+        else if (retcode == MR_ERROR_READ_FAULT)
+            fputs("Internal Error: Can not read the standard input\n", stderr);
+
+        if (_mr_mem.report != MR_MEM_REPORT_NONE)
+            mr_mem_print(stderr);
+
+        printf("END\n"); // dummy
+        return retcode;
+    }
+
 #if defined(__GNUC__) || defined(__clang__)
     file = fopen(argv[1], "rb");
     if (!file)
@@ -129,38 +173,80 @@ int main(
         return MR_NOERROR;
     }
 
-    code = malloc((size + 1) * sizeof(mr_chr_t));
+#ifdef __MR_SOURCE_MMAP__
+    code = size >= MR_FILE_MAPSIZE ? mr_source_map(argv[1], size) : NULL;
+    source = code ? MR_CONFIG_SOURCE_MAPPED : MR_CONFIG_SOURCE_HEAP;
+#else
+    code = NULL;
+    source = MR_CONFIG_SOURCE_HEAP;
+#endif
+
     if (!code)
     {
-        fclose(file);
-        fputs("Internal error: not enough memory\n", stderr);
-        return MR_ERROR_NOT_ENOUGH_MEMORY;
+        code = mr_source_read(file, size);
+        if (!code)
+        {
+            fclose(file);
+            mr_mem_fail_print(stderr);
+
+            if (_mr_mem.report != MR_MEM_REPORT_NONE)
+                mr_mem_print(stderr);
+            return MR_ERROR_NOT_ENOUGH_MEMORY;
+        }
     }
-
-    fread(code, sizeof(mr_chr_t), size, file);
     fclose(file);
-    code[size] = '\0';
 
     _mr_config = (mr_config_t){.outstream=stdout, .instream=stdin, .errstream=stderr,
-        .code=code, .fname=argv[1], .size=size};
-
-    retcode = mr_compile();
-    free(code);
+        .code=code, .fname=argv[1], .size=size, .source=source};
+    mr_scan_init();
+
+    retcode = mr_compile(NULL);
+#ifdef __MR_SOURCE_MMAP__
+    if (source == MR_CONFIG_SOURCE_MAPPED)
+        mr_source_unmap(code, size);
+    else
+#endif
+    mr_mem_free(code);
+    mr_error_lines_free();
 
     if (retcode == MR_ERROR_NOT_ENOUGH_MEMORY)
-        fputs("Internal Error: Not enough memory\n", stderr);
+        mr_mem_fail_print(stderr);
+
+    if (_mr_mem.report != MR_MEM_REPORT_NONE)
+        mr_mem_print(stderr);
 
     printf("END\n"); // dummy
     return retcode;
 }
 
-mr_byte_t mr_compile(void)
+mr_byte_t mr_compile(
+    FILE *stream)
 {
     mr_byte_t retcode;
     mr_lexer_t lexer;
+    mr_lexer_stream_t lstream;
     mr_parser_t parser;
+    mr_token_cursor_t tokens;
+    mr_long_t counts[MR_TOKEN_COUNT] = {0};
+
+#ifdef __MR_TOKEN_COMPACT__
+    mr_byte_t *compact;
+#endif
+
+#ifdef __MR_TOKEN_PULL__
+    if (!stream)
+        return mr_compile_pull();
+#endif
+
+    if (stream)
+    {
+        lstream = (mr_lexer_stream_t){.file=stream, .chunk=MR_LEXER_STREAM_CHUNK};
+        retcode = mr_lexer_stream(&lstream);
+        lexer = lstream.lexer;
+    }
+    else
+        retcode = mr_lexer(&lexer);
 
-    retcode = mr_lexer(&lexer);
     if (retcode != MR_NOERROR)
     {
         if (retcode == MR_ERROR_BAD_FORMAT)
@@ -168,39 +254,165 @@ mr_byte_t mr_compile(void)
         return retcode;
     }
 
+    mr_mem_unused(MR_MEM_LEXER, mr_pool_unused());
+
     if (lexer.tokens->type == MR_TOKEN_EOF)
     {
-        free(lexer.tokens);
+        mr_mem_free(lexer.tokens);
+        mr_pool_consts_free(&_mr_pool_consts);
+        mr_pool_syms_free(&_mr_pool_syms);
+        mr_pool_strs_free(&_mr_pool_strs);
         return MR_NOERROR;
     }
 
-    retcode = mr_stack_init(_mr_config.size * MR_STACK_SIZE_FACTOR, _mr_config.size / MR_STACK_PSIZE_CHUNK + 1);
+    mr_token_histogram(counts, lexer.tokens);
+    retcode = mr_stack_init(mr_parser_stack_size(counts), MR_STACK_SCRATCH_SIZE);
     if (retcode != MR_NOERROR)
     {
-        free(lexer.tokens);
+        mr_mem_free(lexer.tokens);
+        mr_pool_consts_free(&_mr_pool_consts);
+        mr_pool_syms_free(&_mr_pool_syms);
+        mr_pool_strs_free(&_mr_pool_strs);
         return retcode;
     }
 
+#ifdef __MR_DEBUG__
     mr_token_prints(lexer.tokens);
     putchar('\n');
+#endif
 
-    retcode = mr_parser(&parser, lexer.tokens);
+#ifdef __MR_TOKEN_COMPACT__
+    retcode = mr_token_compact(&compact, lexer.tokens, lexer.size);
+    mr_mem_free(lexer.tokens);
+    if (retcode != MR_NOERROR)
+    {
+        mr_pool_consts_free(&_mr_pool_consts);
+        mr_pool_syms_free(&_mr_pool_syms);
+        mr_pool_strs_free(&_mr_pool_strs);
+        mr_stack_free();
+        return retcode;
+    }
+
+    mr_token_cursor_init(&tokens, compact);
+#else
+    mr_token_cursor_init(&tokens, lexer.tokens);
+#endif
+
+    retcode = mr_parser(&parser, tokens, mr_parser_nodes_size(counts));
     if (retcode != MR_NOERROR)
     {
         if (retcode == MR_ERROR_BAD_FORMAT)
             mr_invalid_syntax_print(&parser.error);
 
-        free(lexer.tokens);
+#ifdef __MR_TOKEN_COMPACT__
+        mr_mem_free(compact);
+#else
+        mr_mem_free(lexer.tokens);
+#endif
+        mr_pool_consts_free(&_mr_pool_consts);
+        mr_pool_syms_free(&_mr_pool_syms);
+        mr_pool_strs_free(&_mr_pool_strs);
+        mr_stack_free();
+        return retcode;
+    }
+
+#ifdef __MR_TOKEN_COMPACT__
+    mr_mem_free(compact);
+#else
+    mr_mem_free(lexer.tokens);
+#endif
+#ifdef __MR_DEBUG__
+    mr_node_prints(parser.nodes, parser.size);
+#endif
+    mr_mem_free(parser.nodes);
+
+    mr_pool_consts_free(&_mr_pool_consts);
+    mr_pool_syms_free(&_mr_pool_syms);
+    mr_pool_strs_free(&_mr_pool_strs);
+    mr_stack_free();
+    return MR_NOERROR;
+}
+
+#ifdef __MR_TOKEN_PULL__
+mr_byte_t mr_compile_pull(void)
+{
+    mr_byte_t retcode, pretcode;
+    mr_lexer_t lexer;
+    mr_parser_t parser;
+    mr_token_cursor_t tokens;
+
+    retcode = mr_lexer_pull_init(&tokens);
+    if (retcode != MR_NOERROR)
+        return retcode;
+
+    if (mr_token_cursor_type(&tokens) == MR_TOKEN_EOF)
+    {
+        retcode = mr_lexer_pull_finish(&lexer, &tokens);
+        if (retcode != MR_NOERROR)
+        {
+            if (retcode == MR_ERROR_BAD_FORMAT)
+                mr_illegal_chr_print(lexer.error);
+            return retcode;
+        }
+
+        mr_pool_consts_free(&_mr_pool_consts);
+        mr_pool_syms_free(&_mr_pool_syms);
+        mr_pool_strs_free(&_mr_pool_strs);
+        return MR_NOERROR;
+    }
+
+    retcode = mr_stack_init(_mr_config.size * MR_STACK_SIZE_FACTOR, MR_STACK_SCRATCH_SIZE);
+    if (retcode != MR_NOERROR)
+    {
+        if (mr_lexer_pull_finish(&lexer, &tokens) == MR_NOERROR)
+        {
+            mr_pool_consts_free(&_mr_pool_consts);
+            mr_pool_syms_free(&_mr_pool_syms);
+            mr_pool_strs_free(&_mr_pool_strs);
+        }
+        return retcode;
+    }
+
+    /* The parser works on a copy of the cursor, But the state of the lexer is shared. */
+    pretcode = mr_parser(&parser, tokens, _mr_config.size / MR_PARSER_NODES_CHUNK + 1);
+    retcode = mr_lexer_pull_finish(&lexer, &tokens);
+    if (retcode != MR_NOERROR)
+    {
+        if (retcode == MR_ERROR_BAD_FORMAT)
+            mr_illegal_chr_print(lexer.error);
+
+        if (pretcode == MR_NOERROR)
+            mr_mem_free(parser.nodes);
         mr_stack_free();
         return retcode;
     }
 
-    free(lexer.tokens);
+    mr_mem_unused(MR_MEM_LEXER, mr_pool_unused());
+
+    if (pretcode != MR_NOERROR)
+    {
+        if (pretcode == MR_ERROR_BAD_FORMAT)
+            mr_invalid_syntax_print(&parser.error);
+
+        mr_pool_consts_free(&_mr_pool_consts);
+        mr_pool_syms_free(&_mr_pool_syms);
+        mr_pool_strs_free(&_mr_pool_strs);
+        mr_stack_free();
+        return pretcode;
+    }
+
+#ifdef __MR_DEBUG__
     mr_node_prints(parser.nodes, parser.size);
+#endif
+    mr_mem_free(parser.nodes);
 
+    mr_pool_consts_free(&_mr_pool_consts);
+    mr_pool_syms_free(&_mr_pool_syms);
+    mr_pool_strs_free(&_mr_pool_strs);
     mr_stack_free();
     return MR_NOERROR;
 }
+#endif
 
 void mr_handle_args(
     mr_str_ct argv[], mr_byte_t size)
@@ -222,5 +434,9 @@ void mr_handle_args(
             mr_config_opt(OPT_LEVEL3);
         else if (!strcmp(str, "-Ou"))
             mr_config_opt(OPT_LEVELU);
+        else if (!strcmp(str, "--mem-stats"))
+            _mr_mem.report = MR_MEM_REPORT_TEXT;
+        else if (!strcmp(str, "--mem-stats=json"))
+            _mr_mem.report = MR_MEM_REPORT_JSON;
     }
 }
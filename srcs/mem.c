@@ -0,0 +1,234 @@
+/*
+MIT License
+
+Copyright (c) 2023 MetaReal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+*/
+
+/**
+ * @file mem.c
+ * File that contains function definitions of the memory accounting.
+*/
+
+#include <mem.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __MR_LEXER_PARALLEL__
+#include <pthread.h>
+
+/**
+ * Lock of the statistics (the lexer allocates on multiple threads).
+*/
+static pthread_mutex_t mr_mem_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+#define mr_mem_lock pthread_mutex_lock(&mr_mem_mutex)
+#define mr_mem_unlock pthread_mutex_unlock(&mr_mem_mutex)
+#else
+#define mr_mem_lock
+#define mr_mem_unlock
+#endif
+
+mr_str_ct mr_mem_names[MR_MEM_PHASES] = {"source", "lexer", "parser", "stack"};
+
+mr_mem_t _mr_mem = {.size=0, .peak=0, .fsize=0, .failed=MR_MEM_PHASES, .report=MR_MEM_REPORT_NONE};
+
+/**
+ * It updates the statistics of the \a phase after a block grew or shrank.
+ * @param phase
+ * The phase (from __MR_MEM_PHASE_ENUM).
+ * @param old
+ * Old size of the block in bytes (zero for new blocks).
+ * @param size
+ * New size of the block in bytes (zero for deallocated blocks).
+*/
+void mr_mem_count(
+    mr_byte_t phase, size_t old, size_t size);
+
+/**
+ * It records an allocation that failed.
+ * @param phase
+ * The phase (from __MR_MEM_PHASE_ENUM).
+ * @param size
+ * Requested size in bytes.
+*/
+void mr_mem_fail(
+    mr_byte_t phase, size_t size);
+
+mr_ptr_t mr_mem_malloc(
+    mr_byte_t phase, size_t size)
+{
+    mr_mem_head_t *head;
+
+    head = size <= (size_t)-1 - sizeof(mr_mem_head_t) ? malloc(sizeof(mr_mem_head_t) + size) : NULL;
+    if (!head)
+    {
+        mr_mem_fail(phase, size);
+        return NULL;
+    }
+
+    head->info.size = size;
+    head->info.phase = phase;
+
+    mr_mem_lock;
+    _mr_mem.stats[phase].allocs++;
+    mr_mem_count(phase, 0, size);
+    mr_mem_unlock;
+    return head + 1;
+}
+
+mr_ptr_t mr_mem_calloc(
+    mr_byte_t phase, size_t count, size_t size)
+{
+    mr_ptr_t block;
+
+    if (size && count > (size_t)-1 / size)
+    {
+        mr_mem_fail(phase, (size_t)-1);
+        return NULL;
+    }
+
+    block = mr_mem_malloc(phase, count * size);
+    if (block)
+        memset(block, 0, count * size);
+    return block;
+}
+
+mr_ptr_t mr_mem_realloc(
+    mr_byte_t phase, mr_ptr_t block, size_t size)
+{
+    mr_mem_head_t *head;
+    size_t old;
+
+    if (!block)
+        return mr_mem_malloc(phase, size);
+
+    head = (mr_mem_head_t*)block - 1;
+    old = head->info.size;
+    phase = head->info.phase;
+
+    head = size <= (size_t)-1 - sizeof(mr_mem_head_t) ? realloc(head, sizeof(mr_mem_head_t) + size) : NULL;
+    if (!head)
+    {
+        mr_mem_fail(phase, size);
+        return NULL;
+    }
+
+    head->info.size = size;
+
+    mr_mem_lock;
+    _mr_mem.stats[phase].reallocs++;
+    mr_mem_count(phase, old, size);
+    mr_mem_unlock;
+    return head + 1;
+}
+
+void mr_mem_free(
+    mr_ptr_t block)
+{
+    mr_mem_head_t *head;
+
+    if (!block)
+        return;
+
+    head = (mr_mem_head_t*)block - 1;
+
+    mr_mem_lock;
+    _mr_mem.stats[head->info.phase].frees++;
+    mr_mem_count(head->info.phase, head->info.size, 0);
+    mr_mem_unlock;
+    free(head);
+}
+
+void mr_mem_unused(
+    mr_byte_t phase, size_t size)
+{
+    _mr_mem.stats[phase].unused = size;
+}
+
+void mr_mem_print(
+    FILE *stream)
+{
+    mr_byte_t i;
+    mr_mem_stat_t *stat;
+
+    if (_mr_mem.report == MR_MEM_REPORT_JSON)
+    {
+        fputs("{\"phases\": {", stream);
+        for (i = 0; i != MR_MEM_PHASES; i++)
+        {
+            stat = _mr_mem.stats + i;
+            fprintf(stream, "%s\"%s\": {\"peak\": %zu, \"allocs\": %" PRIu32 ", \"reallocs\": %" PRIu32
+                ", \"frees\": %" PRIu32 ", \"unused\": %zu}",
+                i ? ", " : "", mr_mem_names[i], stat->peak, stat->allocs, stat->reallocs,
+                stat->frees, stat->unused);
+        }
+
+        fprintf(stream, "}, \"peak\": %zu, ", _mr_mem.peak);
+        if (_mr_mem.failed == MR_MEM_PHASES)
+            fputs("\"failed\": null}\n", stream);
+        else
+            fprintf(stream, "\"failed\": {\"phase\": \"%s\", \"size\": %zu}}\n",
+                mr_mem_names[_mr_mem.failed], _mr_mem.fsize);
+        return;
+    }
+
+    fputs("Memory statistics:\n"
+        "  phase           peak   allocs reallocs    frees         unused\n", stream);
+    for (i = 0; i != MR_MEM_PHASES; i++)
+    {
+        stat = _mr_mem.stats + i;
+        fprintf(stream, "  %-6s %15zu %8" PRIu32 " %8" PRIu32 " %8" PRIu32 " %14zu\n",
+            mr_mem_names[i], stat->peak, stat->allocs, stat->reallocs, stat->frees, stat->unused);
+    }
+
+    fprintf(stream, "  %-6s %15zu\n", "total", _mr_mem.peak);
+    if (_mr_mem.failed != MR_MEM_PHASES)
+        fprintf(stream, "  failed allocation: %zu bytes (%s)\n", _mr_mem.fsize, mr_mem_names[_mr_mem.failed]);
+}
+
+void mr_mem_fail_print(
+    FILE *stream)
+{
+    if (_mr_mem.failed == MR_MEM_PHASES)
+    {
+        fputs("Internal Error: Not enough memory\n", stream);
+        return;
+    }
+
+    fprintf(stream, "Internal Error: Not enough memory (%zu bytes requested by the %s)\n",
+        _mr_mem.fsize, mr_mem_names[_mr_mem.failed]);
+}
+
+void mr_mem_count(
+    mr_byte_t phase, size_t old, size_t size)
+{
+    mr_mem_stat_t *stat;
+
+    stat = _mr_mem.stats + phase;
+    stat->size += size - old;
+    if (stat->size > stat->peak)
+        stat->peak = stat->size;
+
+    _mr_mem.size += size - old;
+    if (_mr_mem.size > _mr_mem.peak)
+        _mr_mem.peak = _mr_mem.size;
+}
+
+void mr_mem_fail(
+    mr_byte_t phase, size_t size)
+{
+    mr_mem_lock;
+    _mr_mem.failed = phase;
+    _mr_mem.fsize = size;
+    mr_mem_unlock;
+}
@@ -22,6 +22,7 @@ copies or substantial portions of the Software.
 #include <parser/node.h>
 #include <lexer/token.h>
 #include <stack.h>
+#include <string.h>
 
 /**
  * @def mr_node_sidx_std(typ)
@@ -93,8 +94,98 @@ copies or substantial portions of the Software.
 mr_byte_t mr_node_get_token(
     mr_byte_t type);
 
+/**
+ * It computes the starting index of a node from its data. \n
+ * The starting indexes of the children are extracted by the \a mr_node_sidx function.
+ * @param node
+ * The specified node.
+ * @return It returns the starting index of the <em>node</em>.
+*/
+mr_long_t mr_node_sidx_calc(
+    mr_node_t node);
+
+/**
+ * It computes the ending index of a node from its data. \n
+ * The ending indexes of the children are extracted by the \a mr_node_eidx function.
+ * @param node
+ * The specified node.
+ * @return It returns the ending index of the <em>node</em>.
+*/
+mr_long_t mr_node_eidx_calc(
+    mr_node_t node);
+
+#ifdef __MR_NODE_SPANS__
+/**
+ * @def mr_node_spanned(type)
+ * It checks if nodes of the \a type have data in the stack (and a span).
+ * @param type
+ * Type of the node.
+*/
+#define mr_node_spanned(type) ((type) > MR_NODE_STR && (type) != MR_NODE_TYPE && (type) != MR_NODE_VAR_ACCESS)
+
+/**
+ * @def mr_node_span(value)
+ * It returns the span of a node.
+ * @param value
+ * Pointer to the data of the node.
+*/
+#define mr_node_span(value) ((mr_node_span_t*)(_mr_stack.data + (value)) - 1)
+
+mr_byte_t mr_node_push(
+    mr_long_t *ptr, mr_byte_t size)
+{
+    mr_byte_t retcode;
+
+    retcode = mr_stack_push(ptr, (mr_byte_t)(sizeof(mr_node_span_t) + size));
+    if (retcode != MR_NOERROR)
+        return retcode;
+
+    *ptr += sizeof(mr_node_span_t);
+    return MR_NOERROR;
+}
+
+mr_node_t mr_node_make(
+    mr_byte_t type, mr_long_t value)
+{
+    mr_long_t sidx, eidx;
+    mr_node_t node;
+    mr_node_span_t *span;
+
+    node = (mr_node_t){.type=type, .value=value};
+    sidx = mr_node_sidx_calc(node);
+    eidx = mr_node_eidx_calc(node);
+
+    span = mr_node_span(value);
+    span->sidx = MR_IDX_DECOMPOSE(sidx);
+    span->eidx = MR_IDX_DECOMPOSE(eidx);
+    return node;
+}
+#endif
+
 mr_long_t mr_node_sidx(
     mr_node_t node)
+{
+#ifdef __MR_NODE_SPANS__
+    if (mr_node_spanned(node.type))
+        return MR_IDX_EXTRACT(mr_node_span(node.value)->sidx);
+#endif
+
+    return mr_node_sidx_calc(node);
+}
+
+mr_long_t mr_node_eidx(
+    mr_node_t node)
+{
+#ifdef __MR_NODE_SPANS__
+    if (mr_node_spanned(node.type))
+        return MR_IDX_EXTRACT(mr_node_span(node.value)->eidx);
+#endif
+
+    return mr_node_eidx_calc(node);
+}
+
+mr_long_t mr_node_sidx_calc(
+    mr_node_t node)
 {
     switch (node.type)
     {
@@ -110,12 +201,7 @@ mr_long_t mr_node_sidx(
         return node.value;
     case MR_NODE_BOOL:
     case MR_NODE_TYPE:
-    {
-        mr_idx_t idx;
-
-        idx = ((mr_token_t*)&node.value)->idx;
-        return MR_IDX_EXTRACT(idx);
-    }
+        return MR_NODE_KEYWORD_IDX(node.value);
     case MR_NODE_FSTR:
     case MR_NODE_LIST:
     case MR_NODE_DICT:
@@ -129,7 +215,7 @@ mr_long_t mr_node_sidx(
         mr_node_t *elems;
 
         value = (mr_node_tuple_t*)(_mr_stack.data + node.value);
-        elems = (mr_node_t*)_mr_stack.ptrs[MR_IDX_EXTRACT(value->elems)];
+        elems = (mr_node_t*)(_mr_stack.data + value->elems);
         return mr_node_sidx(*elems);
     }
     case MR_NODE_BINARY_OP:
@@ -172,7 +258,7 @@ mr_long_t mr_node_sidx(
     }
 }
 
-mr_long_t mr_node_eidx(
+mr_long_t mr_node_eidx_calc(
     mr_node_t node)
 {
     mr_long_t idx;
@@ -191,13 +277,8 @@ mr_long_t mr_node_eidx(
     case MR_NODE_VAR_ACCESS:
         return node.value + mr_token_getsize2(mr_node_get_token(node.type), node.value);
     case MR_NODE_BOOL:
-    {
-        mr_token_t token;
-
-        token = *(mr_token_t*)&node.value;
-        idx = MR_IDX_EXTRACT(token.idx);
-        return idx + mr_token_keyword_size[token.type - MR_TOKEN_KEYWORD_PAD];
-    }
+        return MR_NODE_KEYWORD_IDX(node.value) +
+            mr_token_keyword_size[MR_NODE_KEYWORD_TYPE(node.value, MR_TOKEN_TRUE_K) - MR_TOKEN_KEYWORD_PAD];
     case MR_NODE_FSTR:
     case MR_NODE_LIST:
     case MR_NODE_DICT:
@@ -212,17 +293,12 @@ mr_long_t mr_node_eidx(
 
         value = (mr_node_tuple_t*)(_mr_stack.data + node.value);
         idx = MR_IDX_EXTRACT(value->size);
-        nodes = (mr_node_t*)_mr_stack.ptrs[MR_IDX_EXTRACT(value->elems)];
+        nodes = (mr_node_t*)(_mr_stack.data + value->elems);
         return mr_node_eidx(nodes[idx - 1]);
     }
     case MR_NODE_TYPE:
-    {
-        mr_token_t token;
-
-        token = *(mr_token_t*)&node.value;
-        idx = MR_IDX_EXTRACT(token.idx);
-        return idx + mr_token_type_size[token.type - MR_TOKEN_TYPE_PAD];
-    }
+        return MR_NODE_KEYWORD_IDX(node.value) +
+            mr_token_type_size[MR_NODE_KEYWORD_TYPE(node.value, MR_TOKEN_TYPE_PAD) - MR_TOKEN_TYPE_PAD];
     case MR_NODE_BINARY_OP:
         mr_node_eidx_elem(mr_node_binary_op_t, right);
     case MR_NODE_UNARY_OP:
@@ -247,7 +323,7 @@ mr_long_t mr_node_eidx(
         mr_node_t *params;
 
         value = (mr_node_dollar_method_t*)(_mr_stack.data + node.value);
-        params = (mr_node_t*)_mr_stack.ptrs[MR_IDX_EXTRACT(value->params)];
+        params = (mr_node_t*)(_mr_stack.data + value->params);
         return mr_node_eidx(params[value->size - 1]);
     }
     case MR_NODE_EX_DOLLAR_METHOD:
@@ -272,11 +348,10 @@ mr_long_t mr_node_eidx(
     case MR_NODE_INCLUDE:
     {
         mr_node_import_t *value;
-        mr_idx_t *libs, last;
+        mr_idx_t last;
 
         value = (mr_node_import_t*)(_mr_stack.data + node.value);
-        libs = (mr_idx_t*)_mr_stack.ptrs[MR_IDX_EXTRACT(value->libs)];
-        last = libs[value->size - 1];
+        memcpy(&last, _mr_stack.data + value->libs + (value->size - 1) * sizeof(mr_idx_t), sizeof(mr_idx_t));
         idx = MR_IDX_EXTRACT(last);
         return idx + mr_token_getsize2(MR_TOKEN_IDENTIFIER, idx);
     }
@@ -331,8 +406,10 @@ void mr_node_print(
         fwrite(_mr_config.code + node.value, sizeof(mr_chr_t), size, stdout);
         break;
     case MR_NODE_BOOL:
+        fputs(mr_token_labels[MR_NODE_KEYWORD_TYPE(node.value, MR_TOKEN_TRUE_K)], stdout);
+        break;
     case MR_NODE_TYPE:
-        fputs(mr_token_labels[((mr_token_t*)&node.value)->type], stdout);
+        fputs(mr_token_labels[MR_NODE_KEYWORD_TYPE(node.value, MR_TOKEN_TYPE_PAD)], stdout);
         break;
     case MR_NODE_FSTR:
     case MR_NODE_LIST:
@@ -351,7 +428,7 @@ void mr_node_print(
             break;
         }
 
-        elems = (mr_node_t*)_mr_stack.ptrs[MR_IDX_EXTRACT(value->elems)];
+        elems = (mr_node_t*)(_mr_stack.data + value->elems);
 
         fputs("[(", stdout);
         mr_node_print(*elems);
@@ -374,7 +451,7 @@ void mr_node_print(
 
         value = (mr_node_tuple_t*)(_mr_stack.data + node.value);
         size = MR_IDX_EXTRACT(value->size);
-        elems = (mr_node_t*)_mr_stack.ptrs[MR_IDX_EXTRACT(value->elems)];
+        elems = (mr_node_t*)(_mr_stack.data + value->elems);
 
         fputs("[(", stdout);
         mr_node_print(*elems);
@@ -402,7 +479,7 @@ void mr_node_print(
             break;
         }
 
-        elems = (mr_node_keyval_t*)_mr_stack.ptrs[MR_IDX_EXTRACT(value->elems)];
+        elems = (mr_node_keyval_t*)(_mr_stack.data + value->elems);
 
         fputs("[{(", stdout);
         mr_node_print(elems->key);
@@ -557,7 +634,7 @@ void mr_node_print(
         mr_node_func_call_t *value;
 
         value = (mr_node_func_call_t*)(_mr_stack.data + node.value);
-        args = (mr_node_call_arg_t*)_mr_stack.ptrs[MR_IDX_EXTRACT(value->args)];
+        args = (mr_node_call_arg_t*)(_mr_stack.data + value->args);
 
 
         putchar('(');
@@ -611,7 +688,7 @@ void mr_node_print(
         value = (mr_node_dollar_method_t*)(_mr_stack.data + node.value);
         idx = MR_IDX_EXTRACT(value->name);
         size = mr_token_getsize2(MR_TOKEN_IDENTIFIER, idx);
-        params = (mr_node_t*)_mr_stack.ptrs[MR_IDX_EXTRACT(value->params)];
+        params = (mr_node_t*)(_mr_stack.data + value->params);
 
         printf("\"%.*s\", [(", size, _mr_config.code + idx);
         mr_node_print(*params);
@@ -672,7 +749,7 @@ void mr_node_print(
 
         value = (mr_node_if_elif_t*)(_mr_stack.data + node.value);
         size = MR_IDX_EXTRACT(value->size);
-        cases = (mr_node_keyval_t*)_mr_stack.ptrs[MR_IDX_EXTRACT(value->cases)];
+        cases = (mr_node_keyval_t*)(_mr_stack.data + value->cases);
 
         fputs("[{(", stdout);
         mr_node_print(cases->key);
@@ -710,7 +787,7 @@ void mr_node_print(
         if (!size)
             break;
 
-        cases = (mr_node_keyval_t*)_mr_stack.ptrs[MR_IDX_EXTRACT(value->cases)];
+        cases = (mr_node_keyval_t*)(_mr_stack.data + value->cases);
 
         fputs("), [{(", stdout);
         mr_node_print(cases->key);
@@ -751,7 +828,7 @@ void mr_node_print(
             break;
         }
 
-        cases = (mr_node_keyval_t*)_mr_stack.ptrs[MR_IDX_EXTRACT(value->cases)];
+        cases = (mr_node_keyval_t*)(_mr_stack.data + value->cases);
 
         fputs("[{(", stdout);
         mr_node_print(cases->key);
@@ -777,19 +854,20 @@ void mr_node_print(
     case MR_NODE_INCLUDE:
     {
         mr_byte_t i;
-        mr_idx_t *libs;
+        mr_idx_t lib;
         mr_node_import_t *value;
 
         value = (mr_node_import_t*)(_mr_stack.data + node.value);
-        libs = (mr_idx_t*)_mr_stack.ptrs[MR_IDX_EXTRACT(value->libs)];
 
-        idx = MR_IDX_EXTRACT(*libs);
+        memcpy(&lib, _mr_stack.data + value->libs, sizeof(mr_idx_t));
+        idx = MR_IDX_EXTRACT(lib);
         size = mr_token_getsize2(MR_TOKEN_IDENTIFIER, idx);
         printf("[\"%.*s\"", size, _mr_config.code + idx);
 
         for (i = 1; i != value->size; i++)
         {
-            idx = MR_IDX_EXTRACT(libs[i]);
+            memcpy(&lib, _mr_stack.data + value->libs + i * sizeof(mr_idx_t), sizeof(mr_idx_t));
+            idx = MR_IDX_EXTRACT(lib);
             size = mr_token_getsize2(MR_TOKEN_IDENTIFIER, idx);
             printf(", \"%.*s\"", size, _mr_config.code + idx);
         }
@@ -21,10 +21,14 @@ copies or substantial portions of the Software.
 
 #include <parser/parser.h>
 #include <stack.h>
+#include <mem.h>
 #include <config.h>
-#include <stdlib.h>
 #include <consts.h>
 
+#ifdef __MR_TOKEN_PULL__
+#include <lexer/lexer.h>
+#endif
+
 /**
  * @def mr_parser_bin_op(func1, func2, cond)
  * It handles binary operation formats.
@@ -52,13 +56,14 @@ copies or substantial portions of the Software.
         left = *node;                                                   \
         while (cond)                                                    \
         {                                                               \
-            op = (*tokens)++->type;                                     \
+            op = mr_token_cursor_type(tokens);                          \
+            mr_token_cursor_next(tokens);                               \
                                                                         \
             retcode = func2(res, tokens);                               \
             if (retcode != MR_NOERROR)                                  \
                 return retcode;                                         \
                                                                         \
-            retcode = mr_stack_push(&ptr, sizeof(mr_node_binary_op_t)); \
+            retcode = mr_node_push(&ptr, sizeof(mr_node_binary_op_t));  \
             if (retcode != MR_NOERROR)                                  \
                 return MR_ERROR_NOT_ENOUGH_MEMORY;                      \
                                                                         \
@@ -66,21 +71,33 @@ copies or substantial portions of the Software.
             *value = (mr_node_binary_op_t){                             \
                 .left=left, .right=*node, .op=op};                      \
                                                                         \
-            left = (mr_node_t){.type = MR_NODE_BINARY_OP, .value=ptr};  \
+            left = mr_node_make(MR_NODE_BINARY_OP, ptr);                \
         }                                                               \
                                                                         \
         *node = left;                                                   \
         return MR_NOERROR;                                              \
     } while (0)
 
+/**
+ * @def mr_parser_node_size(typ)
+ * Size of the data of a node in the stack, Including its span (only with node spans enabled).
+ * @param typ
+ * Type of the structure.
+*/
+#define mr_parser_node_size(typ) (sizeof(typ) + MR_NODE_SPAN_SIZE)
+
 /**
  * @def mr_parser_advance_newline
  * If the current token is a newline, this macro will advance to the next token. \n
  * This macro is used after identifiers, data types, right parentheses, and return statements.
 */
-#define mr_parser_advance_newline              \
-    if ((++*tokens)->type == MR_TOKEN_NEWLINE) \
-        (*tokens)++
+#define mr_parser_advance_newline                             \
+    do                                                        \
+    {                                                         \
+        mr_token_cursor_next(tokens);                         \
+        if (mr_token_cursor_type(tokens) == MR_TOKEN_NEWLINE) \
+            mr_token_cursor_next(tokens);                     \
+    } while (0)
 
 /**
  * @def mr_parser_node_data_sub(typ)
@@ -89,367 +106,576 @@ copies or substantial portions of the Software.
  * @param typ
  * Type of the generated node.
 */
-#define mr_parser_node_data_sub(typ)                                                           \
-    do                                                                                         \
-    {                                                                                          \
-        res->nodes[res->size] = (mr_node_t){.type=typ, .value=MR_IDX_EXTRACT((*tokens)->idx)}; \
-        mr_parser_advance_newline;                                                             \
-        return MR_NOERROR;                                                                     \
+#define mr_parser_node_data_sub(typ)                                                                        \
+    do                                                                                                      \
+    {                                                                                                       \
+        res->nodes[res->size] = (mr_node_t){.type=typ, .value=MR_IDX_EXTRACT(mr_token_cursor_idx(tokens))}; \
+        mr_parser_advance_newline;                                                                          \
+        return MR_NOERROR;                                                                                  \
     } while (0)
 
+/**
+ * Precedence of the binary operators (indexed by the token type). \n
+ * Tokens that aren't binary operators have a precedence of 0, So they end the operation.
+*/
+static const mr_byte_t mr_parser_precs[MR_TOKEN_COUNT] =
+{
+    [MR_TOKEN_OR_K] = 1,
+    [MR_TOKEN_AND_K] = 2,
+    [MR_TOKEN_LESS] = 3, [MR_TOKEN_GREATER] = 3, [MR_TOKEN_LESS_EQUAL] = 3, [MR_TOKEN_GREATER_EQUAL] = 3,
+    [MR_TOKEN_EQUAL] = 4, [MR_TOKEN_NEQUAL] = 4, [MR_TOKEN_EX_EQUAL] = 4, [MR_TOKEN_EX_NEQUAL] = 4,
+    [MR_TOKEN_B_OR] = 5,
+    [MR_TOKEN_B_XOR] = 6,
+    [MR_TOKEN_B_AND] = 7,
+    [MR_TOKEN_L_SHIFT] = 8, [MR_TOKEN_R_SHIFT] = 8,
+    [MR_TOKEN_PLUS] = 9, [MR_TOKEN_MINUS] = 9,
+    [MR_TOKEN_MULTIPLY] = 10, [MR_TOKEN_DIVIDE] = 10, [MR_TOKEN_MODULO] = 10, [MR_TOKEN_QUOTIENT] = 10
+};
+
 /**
  * It handles tuples.
  * @param res
  * Result of the \a mr_parser function passed as a pointer.
  * @param tokens
- * List of tokens passed as a pointer.
+ * Cursor of the tokens passed as a pointer.
  * @return It returns a code which indicates if the process was successful or not. \n
  * If the process was successful, it returns 0. Otherwise, it returns the error code.
 */
 mr_byte_t mr_parser_tuple(
-    mr_parser_t *res, mr_token_t **tokens);
+    mr_parser_t *res, mr_token_cursor_t *tokens);
 
+#ifndef __MR_PARSER_STACK__
 /**
  * It handles variable reassignments.
  * @param res
  * Result of the \a mr_parser function passed as a pointer.
  * @param tokens
- * List of tokens passed as a pointer.
+ * Cursor of the tokens passed as a pointer.
  * @return It returns a code which indicates if the process was successful or not. \n
  * If the process was successful, it returns 0. Otherwise, it returns the error code.
 */
 mr_byte_t mr_parser_reassign(
-    mr_parser_t *res, mr_token_t **tokens);
+    mr_parser_t *res, mr_token_cursor_t *tokens);
 
 /**
  * It handles ternary operations.
  * @param res
  * Result of the \a mr_parser function passed as a pointer.
  * @param tokens
- * List of tokens passed as a pointer.
+ * Cursor of the tokens passed as a pointer.
  * @return It returns a code which indicates if the process was successful or not. \n
  * If the process was successful, it returns 0. Otherwise, it returns the error code.
 */
 mr_byte_t mr_parser_ternary(
-    mr_parser_t *res, mr_token_t **tokens);
-
-/**
- * It handles or (`||`, `or`) operation nodes.
- * @param res
- * Result of the \a mr_parser function passed as a pointer.
- * @param tokens
- * List of tokens passed as a pointer.
- * @return It returns a code which indicates if the process was successful or not. \n
- * If the process was successful, it returns 0. Otherwise, it returns the error code.
-*/
-mr_byte_t mr_parser_or(
-    mr_parser_t *res, mr_token_t **tokens);
-
-/**
- * It handles and (`&&`, `and`) operation nodes.
- * @param res
- * Result of the \a mr_parser function passed as a pointer.
- * @param tokens
- * List of tokens passed as a pointer.
- * @return It returns a code which indicates if the process was successful or not. \n
- * If the process was successful, it returns 0. Otherwise, it returns the error code.
-*/
-mr_byte_t mr_parser_and(
-    mr_parser_t *res, mr_token_t **tokens);
-
-/**
- * It handles less than `<`, greater than `>`, less than or equal to `<=`, and greater than or equal to `>=` operation nodes.
- * @param res
- * Result of the \a mr_parser function passed as a pointer.
- * @param tokens
- * List of tokens passed as a pointer.
- * @return It returns a code which indicates if the process was successful or not. \n
- * If the process was successful, it returns 0. Otherwise, it returns the error code.
-*/
-mr_byte_t mr_parser_order(
-    mr_parser_t *res, mr_token_t **tokens);
+    mr_parser_t *res, mr_token_cursor_t *tokens);
 
 /**
- * It handles equal `==`, not equal `!=`, exactly equal `===`, and exactly not equal `!==` operation nodes.
+ * It handles binary operations with the precedence climbing method. \n
+ * Precedence of the operators is read from the \a mr_parser_precs table,
+ * So an operand only goes through one call of this function for each operator around it.
  * @param res
  * Result of the \a mr_parser function passed as a pointer.
  * @param tokens
- * List of tokens passed as a pointer.
+ * Cursor of the tokens passed as a pointer.
+ * @param prec
+ * Only operators with a higher precedence than \a prec are handled.
+ * The operators with the same precedence are handled by the caller, So they're left-associative.
  * @return It returns a code which indicates if the process was successful or not. \n
  * If the process was successful, it returns 0. Otherwise, it returns the error code.
 */
-mr_byte_t mr_parser_cmp(
-    mr_parser_t *res, mr_token_t **tokens);
+mr_byte_t mr_parser_binary(
+    mr_parser_t *res, mr_token_cursor_t *tokens, mr_byte_t prec);
 
 /**
- * It handles binary or `|` operation nodes.
+ * It handles positive `+`, negative `-`, binary not `~`, and logical not (`!`, `not`) unary operation nodes,
+ * And exponentiation `**` (which is right-associative).
  * @param res
  * Result of the \a mr_parser function passed as a pointer.
  * @param tokens
- * List of tokens passed as a pointer.
+ * Cursor of the tokens passed as a pointer.
  * @return It returns a code which indicates if the process was successful or not. \n
  * If the process was successful, it returns 0. Otherwise, it returns the error code.
 */
-mr_byte_t mr_parser_b_or(
-    mr_parser_t *res, mr_token_t **tokens);
+mr_byte_t mr_parser_factor(
+    mr_parser_t *res, mr_token_cursor_t *tokens);
 
 /**
- * It handles binary xor `^` operation nodes.
+ * It handles prefix reassignments (++ and --).
  * @param res
  * Result of the \a mr_parser function passed as a pointer.
  * @param tokens
- * List of tokens passed as a pointer.
+ * Cursor of the tokens passed as a pointer.
  * @return It returns a code which indicates if the process was successful or not. \n
  * If the process was successful, it returns 0. Otherwise, it returns the error code.
 */
-mr_byte_t mr_parser_b_xor(
-    mr_parser_t *res, mr_token_t **tokens);
+mr_byte_t mr_parser_prefix(
+    mr_parser_t *res, mr_token_cursor_t *tokens);
 
 /**
- * It handles binary and `&` operation nodes.
+ * It handles function calls, postfix reassignments (++ and --), and subscript expressions.
  * @param res
  * Result of the \a mr_parser function passed as a pointer.
  * @param tokens
- * List of tokens passed as a pointer.
+ * Cursor of the tokens passed as a pointer.
  * @return It returns a code which indicates if the process was successful or not. \n
  * If the process was successful, it returns 0. Otherwise, it returns the error code.
 */
-mr_byte_t mr_parser_b_and(
-    mr_parser_t *res, mr_token_t **tokens);
+mr_byte_t mr_parser_postfix(
+    mr_parser_t *res, mr_token_cursor_t *tokens);
+#endif
 
 /**
- * It handles left shift `<<` and right shift `>>` operation nodes.
+ * It handles data types, parentheses, statements, and dollar functions.
  * @param res
  * Result of the \a mr_parser function passed as a pointer.
  * @param tokens
- * List of tokens passed as a pointer.
+ * Cursor of the tokens passed as a pointer.
  * @return It returns a code which indicates if the process was successful or not. \n
  * If the process was successful, it returns 0. Otherwise, it returns the error code.
 */
-mr_byte_t mr_parser_shift(
-    mr_parser_t *res, mr_token_t **tokens);
+mr_byte_t mr_parser_core(
+    mr_parser_t *res, mr_token_cursor_t *tokens);
 
+#ifndef __MR_PARSER_STACK__
 /**
- * It handles addition `+` and subtraction `-` nodes.
+ * It generates function calls (both \a FUNC_CALL and \a EX_FUNC_CALL versions).
  * @param res
  * Result of the \a mr_parser function passed as a pointer.
  * @param tokens
- * List of tokens passed as a pointer.
+ * Cursor of the tokens passed as a pointer.
  * @return It returns a code which indicates if the process was successful or not. \n
  * If the process was successful, it returns 0. Otherwise, it returns the error code.
 */
-mr_byte_t mr_parser_expr(
-    mr_parser_t *res, mr_token_t **tokens);
+mr_byte_t mr_parser_handle_call(
+    mr_parser_t *res, mr_token_cursor_t *tokens);
 
 /**
- * It handles multiplication `*`, division `/`, modulo `%`, and quotient `//` operation nodes.
+ * It generates subscript expressions (all <em>SUBSCRIPT</em>, <em>SUBSCRIPT_END</em>, and \a SUBSCRIPT_STEP versions).
  * @param res
  * Result of the \a mr_parser function passed as a pointer.
  * @param tokens
- * List of tokens passed as a pointer.
+ * Cursor of the tokens passed as a pointer.
  * @return It returns a code which indicates if the process was successful or not. \n
  * If the process was successful, it returns 0. Otherwise, it returns the error code.
 */
-mr_byte_t mr_parser_term(
-    mr_parser_t *res, mr_token_t **tokens);
+mr_byte_t mr_parser_handle_subscript(
+    mr_parser_t *res, mr_token_cursor_t *tokens);
 
 /**
- * It handles positive `+`, negative `-`, binary not `~`, and logical not (`!`, `not`) unary operation nodes.
+ * It generates formatted strings.
  * @param res
  * Result of the \a mr_parser function passed as a pointer.
  * @param tokens
- * List of tokens passed as a pointer.
+ * Cursor of the tokens passed as a pointer.
  * @return It returns a code which indicates if the process was successful or not. \n
  * If the process was successful, it returns 0. Otherwise, it returns the error code.
 */
-mr_byte_t mr_parser_factor(
-    mr_parser_t *res, mr_token_t **tokens);
+mr_byte_t mr_parser_handle_fstr(
+    mr_parser_t *res, mr_token_cursor_t *tokens);
 
 /**
- * It handles exponentiation `**`
+ * It generates lists.
  * @param res
  * Result of the \a mr_parser function passed as a pointer.
  * @param tokens
- * List of tokens passed as a pointer.
+ * Cursor of the tokens passed as a pointer.
  * @return It returns a code which indicates if the process was successful or not. \n
  * If the process was successful, it returns 0. Otherwise, it returns the error code.
 */
-mr_byte_t mr_parser_power(
-    mr_parser_t *res, mr_token_t **tokens);
+mr_byte_t mr_parser_handle_list(
+    mr_parser_t *res, mr_token_cursor_t *tokens);
 
 /**
- * It handles prefix reassignments (++ and --).
+ * It generates dictionaries and starts defining sets.
  * @param res
  * Result of the \a mr_parser function passed as a pointer.
  * @param tokens
- * List of tokens passed as a pointer.
+ * Cursor of the tokens passed as a pointer.
  * @return It returns a code which indicates if the process was successful or not. \n
  * If the process was successful, it returns 0. Otherwise, it returns the error code.
 */
-mr_byte_t mr_parser_prefix(
-    mr_parser_t *res, mr_token_t **tokens);
+mr_byte_t mr_parser_handle_dict(
+    mr_parser_t *res, mr_token_cursor_t *tokens);
 
 /**
- * It handles function calls, postfix reassignments (++ and --), and subscript expressions.
+ * It generates sets.
  * @param res
  * Result of the \a mr_parser function passed as a pointer.
  * @param tokens
- * List of tokens passed as a pointer.
+ * Cursor of the tokens passed as a pointer.
+ * @param value
+ * Value of the \a set node type (created in the \a mr_parser_handle_dict function).
  * @return It returns a code which indicates if the process was successful or not. \n
  * If the process was successful, it returns 0. Otherwise, it returns the error code.
 */
-mr_byte_t mr_parser_postfix(
-    mr_parser_t *res, mr_token_t **tokens);
+mr_byte_t mr_parser_handle_set(
+    mr_parser_t *res, mr_token_cursor_t *tokens, mr_long_t ptr);
 
 /**
- * It handles data types, parentheses, statements, and dollar functions.
+ * It generates variable assignments.
  * @param res
  * Result of the \a mr_parser function passed as a pointer.
  * @param tokens
- * List of tokens passed as a pointer.
+ * Cursor of the tokens passed as a pointer.
  * @return It returns a code which indicates if the process was successful or not. \n
  * If the process was successful, it returns 0. Otherwise, it returns the error code.
 */
-mr_byte_t mr_parser_core(
-    mr_parser_t *res, mr_token_t **tokens);
+mr_byte_t mr_parser_handle_var_assign(
+    mr_parser_t *res, mr_token_cursor_t *tokens);
 
 /**
- * It generates function calls (both \a FUNC_CALL and \a EX_FUNC_CALL versions).
+ * It generates dollar methods (both \a DOLLAR_METHOD and \a EX_DOLLAR_METHOD versions).
  * @param res
  * Result of the \a mr_parser function passed as a pointer.
  * @param tokens
- * List of tokens passed as a pointer.
+ * Cursor of the tokens passed as a pointer.
  * @return It returns a code which indicates if the process was successful or not. \n
  * If the process was successful, it returns 0. Otherwise, it returns the error code.
 */
-mr_byte_t mr_parser_handle_call(
-    mr_parser_t *res, mr_token_t **tokens);
+mr_byte_t mr_parser_handle_dollar_method(
+    mr_parser_t *res, mr_token_cursor_t *tokens);
+#endif
 
 /**
- * It generates subscript expressions (all <em>SUBSCRIPT</em>, <em>SUBSCRIPT_END</em>, and \a SUBSCRIPT_STEP versions).
+ * It generates the modifiers, the type, and the name of a variable assignment. \n
+ * If the variable isn't assigned, the whole node is generated. Otherwise, the caller generates the value.
  * @param res
  * Result of the \a mr_parser function passed as a pointer.
  * @param tokens
- * List of tokens passed as a pointer.
+ * Cursor of the tokens passed as a pointer.
+ * @param ptr
+ * It receives pointer to the value of the node (in the stack).
+ * @param assigned
+ * It receives <em>MR_TRUE</em> if the variable is assigned (the cursor points to the first token of the value),
+ * And <em>MR_FALSE</em> otherwise.
  * @return It returns a code which indicates if the process was successful or not. \n
  * If the process was successful, it returns 0. Otherwise, it returns the error code.
 */
-mr_byte_t mr_parser_handle_subscript(
-    mr_parser_t *res, mr_token_t **tokens);
+mr_byte_t mr_parser_var_assign_head(
+    mr_parser_t *res, mr_token_cursor_t *tokens, mr_long_t *ptr, mr_bool_t *assigned);
 
 /**
- * It generates formatted strings.
+ * It generates import and include statements.
  * @param res
  * Result of the \a mr_parser function passed as a pointer.
  * @param tokens
- * List of tokens passed as a pointer.
+ * Cursor of the tokens passed as a pointer.
+ * @param type
+ * Type of the generated node (<em>MR_NODE_IMPORT</em> or <em>MR_NODE_INCLUDE</em>).
  * @return It returns a code which indicates if the process was successful or not. \n
  * If the process was successful, it returns 0. Otherwise, it returns the error code.
 */
-mr_byte_t mr_parser_handle_fstr(
-    mr_parser_t *res, mr_token_t **tokens);
+mr_byte_t mr_parser_handle_import(
+    mr_parser_t *res, mr_token_cursor_t *tokens, mr_byte_t type);
 
+#ifdef __MR_PARSER_STACK__
 /**
- * It generates lists.
- * @param res
- * Result of the \a mr_parser function passed as a pointer.
- * @param tokens
- * List of tokens passed as a pointer.
- * @return It returns a code which indicates if the process was successful or not. \n
- * If the process was successful, it returns 0. Otherwise, it returns the error code.
+ * @enum __MR_PARSER_STATE_ENUM
+ * List of the points that a frame of the explicit-stack parser continues from. \n
+ * Each rule starts from the state with its own name, And the other states continue it after a nested rule.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_TUPLE
+ * Start of a tuple.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_TUPLE_FIRST
+ * After the first element of a tuple.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_TUPLE_NEXT
+ * Before the next element of a tuple (pointing to the comma).
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_TUPLE_ELEM
+ * After an element of a tuple.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_TUPLE_END
+ * End of a tuple.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_REASSIGN
+ * Start of a reassignment.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_REASSIGN_LEFT
+ * After the left side of a reassignment.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_REASSIGN_OP
+ * Before the operator of a reassignment.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_REASSIGN_RIGHT
+ * After the right side of a reassignment.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_TERNARY
+ * Start of a ternary operation.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_TERNARY_COND
+ * After the condition of a ternary operation.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_TERNARY_LEFT
+ * After the left side of a ternary operation.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_TERNARY_ELSE
+ * Before the right side of a ternary operation (pointing to the colon).
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_TERNARY_RIGHT
+ * After the right side of a ternary operation.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_BINARY
+ * Start of a binary operation.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_BINARY_LEFT
+ * After the first operand of a binary operation.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_BINARY_OP
+ * Before the next operator of a binary operation.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_BINARY_RIGHT
+ * After the right operand of a binary operation.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_FACTOR
+ * Start of a factor.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_FACTOR_BASE
+ * After the base of a power operation.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_FACTOR_POWER
+ * Before the next exponent of a power operation (pointing to the operator).
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_FACTOR_RIGHT
+ * After an exponent of a power operation.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_PREFIX
+ * Start of a prefix operation.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_UNARY
+ * After the operand of a unary operation (both factor and prefix operations).
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_POSTFIX
+ * Start of a postfix operation.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_POSTFIX_NEXT
+ * Before the next operator of a postfix operation.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_POSTFIX_DOT
+ * After the right side of a dot operation.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_CORE
+ * Start of a core.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_CORE_PAREN
+ * After the tuple of a parenthesized core.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_LIST
+ * Start of a list.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_LIST_ELEM
+ * After an element of a list.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_CALL
+ * Start of a function call.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_CALL_ARG
+ * Before the next argument of a function call.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_CALL_VALUE
+ * After the value of an argument of a function call.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_SUBSCRIPT
+ * Start of a subscript.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_SUBSCRIPT_START
+ * After the index (or start) of a subscript.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_SUBSCRIPT_END
+ * Before the end of a subscript (pointing to the colon).
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_SUBSCRIPT_END_VALUE
+ * After the end of a subscript.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_SUBSCRIPT_END_CHECK
+ * After the end of a subscript is set.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_SUBSCRIPT_STEP
+ * Before the step of a subscript (pointing to the colon).
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_SUBSCRIPT_STEP_VALUE
+ * After the step of a subscript.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_SUBSCRIPT_FINISH
+ * After the step of a subscript is set.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_FSTR
+ * Start of a formatted string.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_FSTR_EXPR
+ * After an expression of a formatted string.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_FSTR_NEXT
+ * Before the next fragment or expression of a formatted string.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_DICT
+ * Start of a dict (or a set).
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_DICT_FIRST
+ * After the first element of a dict (or a set).
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_DICT_KEY
+ * After a key of a dict.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_DICT_VALUE
+ * After a value of a dict.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_SET_ELEM
+ * After an element of a set.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_SET_NEXT
+ * Before the next element of a set (pointing to the comma).
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_SET_END
+ * End of a set.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_VAR_ASSIGN
+ * Start of a variable assignment.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_VAR_ASSIGN_VALUE
+ * After the value of a variable assignment.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_DOLLAR_METHOD
+ * Start of a dollar method.
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_DOLLAR_METHOD_PARAM
+ * Before the next parameter of a dollar method (pointing to the colon or the comma).
+ * @var __MR_PARSER_STATE_ENUM::MR_PARSER_STATE_DOLLAR_METHOD_VALUE
+ * After a parameter of a dollar method.
 */
-mr_byte_t mr_parser_handle_list(
-    mr_parser_t *res, mr_token_t **tokens);
+enum __MR_PARSER_STATE_ENUM
+{
+    MR_PARSER_STATE_TUPLE,
+    MR_PARSER_STATE_TUPLE_FIRST,
+    MR_PARSER_STATE_TUPLE_NEXT,
+    MR_PARSER_STATE_TUPLE_ELEM,
+    MR_PARSER_STATE_TUPLE_END,
+
+    MR_PARSER_STATE_REASSIGN,
+    MR_PARSER_STATE_REASSIGN_LEFT,
+    MR_PARSER_STATE_REASSIGN_OP,
+    MR_PARSER_STATE_REASSIGN_RIGHT,
+
+    MR_PARSER_STATE_TERNARY,
+    MR_PARSER_STATE_TERNARY_COND,
+    MR_PARSER_STATE_TERNARY_LEFT,
+    MR_PARSER_STATE_TERNARY_ELSE,
+    MR_PARSER_STATE_TERNARY_RIGHT,
+
+    MR_PARSER_STATE_BINARY,
+    MR_PARSER_STATE_BINARY_LEFT,
+    MR_PARSER_STATE_BINARY_OP,
+    MR_PARSER_STATE_BINARY_RIGHT,
+
+    MR_PARSER_STATE_FACTOR,
+    MR_PARSER_STATE_FACTOR_BASE,
+    MR_PARSER_STATE_FACTOR_POWER,
+    MR_PARSER_STATE_FACTOR_RIGHT,
+
+    MR_PARSER_STATE_PREFIX,
+    MR_PARSER_STATE_UNARY,
+
+    MR_PARSER_STATE_POSTFIX,
+    MR_PARSER_STATE_POSTFIX_NEXT,
+    MR_PARSER_STATE_POSTFIX_DOT,
+
+    MR_PARSER_STATE_CORE,
+    MR_PARSER_STATE_CORE_PAREN,
+
+    MR_PARSER_STATE_LIST,
+    MR_PARSER_STATE_LIST_ELEM,
+
+    MR_PARSER_STATE_CALL,
+    MR_PARSER_STATE_CALL_ARG,
+    MR_PARSER_STATE_CALL_VALUE,
+
+    MR_PARSER_STATE_SUBSCRIPT,
+    MR_PARSER_STATE_SUBSCRIPT_START,
+    MR_PARSER_STATE_SUBSCRIPT_END,
+    MR_PARSER_STATE_SUBSCRIPT_END_VALUE,
+    MR_PARSER_STATE_SUBSCRIPT_END_CHECK,
+    MR_PARSER_STATE_SUBSCRIPT_STEP,
+    MR_PARSER_STATE_SUBSCRIPT_STEP_VALUE,
+    MR_PARSER_STATE_SUBSCRIPT_FINISH,
+
+    MR_PARSER_STATE_FSTR,
+    MR_PARSER_STATE_FSTR_EXPR,
+    MR_PARSER_STATE_FSTR_NEXT,
+
+    MR_PARSER_STATE_DICT,
+    MR_PARSER_STATE_DICT_FIRST,
+    MR_PARSER_STATE_DICT_KEY,
+    MR_PARSER_STATE_DICT_VALUE,
+
+    MR_PARSER_STATE_SET_ELEM,
+    MR_PARSER_STATE_SET_NEXT,
+    MR_PARSER_STATE_SET_END,
+
+    MR_PARSER_STATE_VAR_ASSIGN,
+    MR_PARSER_STATE_VAR_ASSIGN_VALUE,
+
+    MR_PARSER_STATE_DOLLAR_METHOD,
+    MR_PARSER_STATE_DOLLAR_METHOD_PARAM,
+    MR_PARSER_STATE_DOLLAR_METHOD_VALUE
+};
 
 /**
- * It generates dictionaries and starts defining sets.
- * @param res
- * Result of the \a mr_parser function passed as a pointer.
- * @param tokens
- * List of tokens passed as a pointer.
- * @return It returns a code which indicates if the process was successful or not. \n
- * If the process was successful, it returns 0. Otherwise, it returns the error code.
+ * @def mr_parser_stack_call(first, resume)
+ * It starts a nested rule in the \a mr_parser_stack_run function. \n
+ * The current frame continues from the \a resume state when the nested rule is finished.
+ * @param first
+ * Starting state of the nested rule.
+ * @param resume
+ * The state that the current frame continues from.
 */
-mr_byte_t mr_parser_handle_dict(
-    mr_parser_t *res, mr_token_t **tokens);
+#define mr_parser_stack_call(first, resume)                                 \
+    do                                                                      \
+    {                                                                       \
+        frame->state = resume;                                              \
+        if (res->fsize == res->falloc && mr_parser_frames_grow(res))        \
+            return MR_ERROR_NOT_ENOUGH_MEMORY;                              \
+                                                                            \
+        res->frames[res->fsize++].state = first;                            \
+    } while (0)
 
 /**
- * It generates sets.
- * @param res
- * Result of the \a mr_parser function passed as a pointer.
- * @param tokens
- * List of tokens passed as a pointer.
- * @param value
- * Value of the \a set node type (created in the \a mr_parser_handle_dict function).
- * @return It returns a code which indicates if the process was successful or not. \n
- * If the process was successful, it returns 0. Otherwise, it returns the error code.
+ * @def mr_parser_stack_enter(resume)
+ * It starts a nested rule in the \a mr_parser_stack_run function by falling through to its starting state. \n
+ * The current frame continues from the \a resume state when the nested rule is finished,
+ * And the \a frame points to the frame of the nested rule (its state is set by the nested rule).
+ * @param resume
+ * The state that the current frame continues from.
 */
-mr_byte_t mr_parser_handle_set(
-    mr_parser_t *res, mr_token_t **tokens, mr_long_t ptr);
+#define mr_parser_stack_enter(resume)                                       \
+    do                                                                      \
+    {                                                                       \
+        frame->state = resume;                                              \
+        if (res->fsize == res->falloc && mr_parser_frames_grow(res))        \
+            return MR_ERROR_NOT_ENOUGH_MEMORY;                              \
+                                                                            \
+        frame = res->frames + res->fsize++;                                 \
+    } while (0)
 
 /**
- * It generates variable assignments.
+ * It handles a rule with the explicit stack (only available with the explicit-stack parser enabled). \n
+ * The rule and all of its nested expressions are handled by a single call, So the nesting depth isn't limited by the call stack.
  * @param res
  * Result of the \a mr_parser function passed as a pointer.
  * @param tokens
- * List of tokens passed as a pointer.
+ * Cursor of the tokens passed as a pointer.
+ * @param state
+ * Starting state of the rule.
  * @return It returns a code which indicates if the process was successful or not. \n
  * If the process was successful, it returns 0. Otherwise, it returns the error code.
 */
-mr_byte_t mr_parser_handle_var_assign(
-    mr_parser_t *res, mr_token_t **tokens);
+mr_byte_t mr_parser_stack(
+    mr_parser_t *res, mr_token_cursor_t *tokens, mr_byte_t state);
 
 /**
- * It generates dollar methods (both \a DOLLAR_METHOD and \a EX_DOLLAR_METHOD versions).
+ * It runs the frames of the explicit stack until the frames above \a base are finished.
  * @param res
  * Result of the \a mr_parser function passed as a pointer.
  * @param tokens
- * List of tokens passed as a pointer.
+ * Cursor of the tokens passed as a pointer.
+ * @param base
+ * Size of the \a frames stack before the first frame of the rule was pushed.
  * @return It returns a code which indicates if the process was successful or not. \n
  * If the process was successful, it returns 0. Otherwise, it returns the error code.
 */
-mr_byte_t mr_parser_handle_dollar_method(
-    mr_parser_t *res, mr_token_t **tokens);
+mr_byte_t mr_parser_stack_run(
+    mr_parser_t *res, mr_token_cursor_t *tokens, mr_long_t base);
 
 /**
- * It generates import and include statements.
+ * It doubles the allocated size of the \a frames stack.
  * @param res
  * Result of the \a mr_parser function passed as a pointer.
- * @param tokens
- * List of tokens passed as a pointer.
- * @param type
- * Type of the generated node (<em>MR_NODE_IMPORT</em> or <em>MR_NODE_INCLUDE</em>).
  * @return It returns a code which indicates if the process was successful or not. \n
  * If the process was successful, it returns 0. Otherwise, it returns the error code.
 */
-mr_byte_t mr_parser_handle_import(
-    mr_parser_t *res, mr_token_t **tokens, mr_byte_t type);
+mr_byte_t mr_parser_frames_grow(
+    mr_parser_t *res);
+#endif
 
 mr_byte_t mr_parser(
-    mr_parser_t *res, mr_token_t *tokens)
+    mr_parser_t *res, mr_token_cursor_t tokens, mr_long_t alloc)
 {
-    mr_long_t alloc, size;
+    mr_long_t size;
     mr_byte_t retcode;
     mr_node_t *block;
-    mr_token_t *ptr;
+    mr_token_cursor_t ptr;
+    mr_stack_mark_t mark;
 
-    alloc = _mr_config.size / MR_PARSER_NODES_CHUNK + 1;
-    res->nodes = malloc(alloc * sizeof(mr_node_t));
+    res->nodes = mr_mem_malloc(MR_MEM_PARSER, alloc * sizeof(mr_node_t));
     if (!res->nodes)
         return MR_ERROR_NOT_ENOUGH_MEMORY;
 
     res->size = 0;
     size = alloc;
+    mark = mr_stack_mark();
+
+#ifdef __MR_PARSER_STACK__
+    res->frames = NULL;
+    res->fsize = res->falloc = 0;
+#endif
 
     ptr = tokens;
     do
     {
         if (res->size == size)
         {
-            block = realloc(res->nodes, (size += alloc) * sizeof(mr_node_t));
+            block = mr_mem_realloc(MR_MEM_PARSER, res->nodes, (size += alloc) * sizeof(mr_node_t));
             if (!block)
             {
-                free(res->nodes);
+                mr_mem_free(res->nodes);
+                mr_stack_release(mark);
+#ifdef __MR_PARSER_STACK__
+                mr_mem_free(res->frames);
+#endif
                 return MR_ERROR_NOT_ENOUGH_MEMORY;
             }
 
@@ -459,248 +685,1302 @@ mr_byte_t mr_parser(
         retcode = mr_parser_tuple(res, &ptr);
         if (retcode != MR_NOERROR)
         {
-            free(res->nodes);
+            mr_mem_free(res->nodes);
+            mr_stack_release(mark);
+#ifdef __MR_PARSER_STACK__
+            mr_mem_free(res->frames);
+#endif
             return retcode;
         }
 
         res->size++;
-        if (ptr->type == MR_TOKEN_SEMICOLON)
-            ptr++;
-        else if (ptr[-1].type != MR_TOKEN_NEWLINE)
+        if (mr_token_cursor_type(&ptr) == MR_TOKEN_SEMICOLON)
+            mr_token_cursor_next(&ptr);
+        else if (mr_token_cursor_prev(&ptr) != MR_TOKEN_NEWLINE)
             break;
-    } while (ptr->type != MR_TOKEN_EOF);
+    } while (mr_token_cursor_type(&ptr) != MR_TOKEN_EOF);
 
-    if (ptr->type != MR_TOKEN_EOF)
+    if (mr_token_cursor_type(&ptr) != MR_TOKEN_EOF)
     {
         res->error = (mr_invalid_syntax_t){.detail="Expected end of file or line", .token=ptr};
 
-        free(res->nodes);
+        mr_mem_free(res->nodes);
+        mr_stack_release(mark);
+#ifdef __MR_PARSER_STACK__
+        mr_mem_free(res->frames);
+#endif
         return MR_ERROR_BAD_FORMAT;
     }
 
+#ifdef __MR_PARSER_STACK__
+    mr_mem_free(res->frames);
+#endif
+
+    mr_mem_unused(MR_MEM_PARSER, (size - res->size) * sizeof(mr_node_t));
     return MR_NOERROR;
 }
 
+mr_long_t mr_parser_nodes_size(
+    const mr_long_t *counts)
+{
+    return counts[MR_TOKEN_NEWLINE] + counts[MR_TOKEN_SEMICOLON] + 1;
+}
+
+mr_long_t mr_parser_stack_size(
+    const mr_long_t *counts)
+{
+    uint64_t size, tuple, elem, paren, square;
+    mr_byte_t i;
+
+    /* Statements, parentheses, subscript slots, fstr expressions, ternary branches, and assigned values can be tuples */
+    tuple = mr_parser_node_size(mr_node_tuple_t) + sizeof(mr_node_t);
+    elem = sizeof(mr_node_keyval_t) > sizeof(mr_node_call_arg_t) ? sizeof(mr_node_keyval_t) : sizeof(mr_node_call_arg_t);
+    paren = mr_parser_node_size(mr_node_func_call_t) + sizeof(mr_node_call_arg_t);
+    if (paren < tuple)
+        paren = tuple;
+    square = mr_parser_node_size(mr_node_subscript_t) + tuple;
+    if (square < mr_parser_node_size(mr_node_list_t) + sizeof(mr_node_t))
+        square = mr_parser_node_size(mr_node_list_t) + sizeof(mr_node_t);
+
+    size = (uint64_t)mr_parser_nodes_size(counts) * tuple;
+
+    for (i = MR_TOKEN_MULTIPLY; i <= MR_TOKEN_GREATER_EQUAL; i++)
+        size += (uint64_t)counts[i] * mr_parser_node_size(mr_node_binary_op_t);
+    for (i = MR_TOKEN_INCREMENT; i <= MR_TOKEN_DECREMENT_POST; i++)
+        size += (uint64_t)counts[i] * mr_parser_node_size(mr_node_unary_op_t);
+    for (i = MR_TOKEN_ASSIGN; i <= MR_TOKEN_R_SHIFT_ASSIGN; i++)
+        size += (uint64_t)counts[i] * (mr_parser_node_size(mr_node_binary_op_t) > tuple ? mr_parser_node_size(mr_node_binary_op_t) : tuple);
+    for (i = MR_TOKEN_PLUS; i <= MR_TOKEN_MINUS; i++)
+        size += (uint64_t)counts[i] * mr_parser_node_size(mr_node_binary_op_t);
+    for (i = MR_TOKEN_B_NOT; i <= MR_TOKEN_NOT_K; i++)
+        size += (uint64_t)counts[i] * mr_parser_node_size(mr_node_unary_op_t);
+    for (i = MR_TOKEN_IS_K; i <= MR_TOKEN_OR_K; i++)
+        size += (uint64_t)counts[i] * mr_parser_node_size(mr_node_binary_op_t);
+    for (i = MR_TOKEN_PRIVATE_K; i <= MR_TOKEN_STATIC_K; i++)
+        size += (uint64_t)counts[i] * mr_parser_node_size(mr_node_var_assign_t);
+    for (i = MR_TOKEN_OBJECT_T; i < MR_TOKEN_COUNT; i++)
+        size += (uint64_t)counts[i] * mr_parser_node_size(mr_node_var_assign_t);
+
+    size += (uint64_t)counts[MR_TOKEN_DOT] * mr_parser_node_size(mr_node_binary_op_t);
+    size += (uint64_t)counts[MR_TOKEN_QUESTION] * (mr_parser_node_size(mr_node_ternary_op_t) + tuple);
+    size += (uint64_t)counts[MR_TOKEN_COLON] * (sizeof(mr_node_t) + tuple);
+    size += (uint64_t)counts[MR_TOKEN_COMMA] * elem;
+    size += (uint64_t)counts[MR_TOKEN_L_PAREN] * paren;
+    size += (uint64_t)counts[MR_TOKEN_L_SQUARE] * square;
+    size += (uint64_t)counts[MR_TOKEN_L_CURLY] * (mr_parser_node_size(mr_node_list_t) + sizeof(mr_node_keyval_t));
+    size += (uint64_t)counts[MR_TOKEN_FSTR_START] * (mr_parser_node_size(mr_node_list_t) + sizeof(mr_node_t) + tuple);
+    size += (uint64_t)counts[MR_TOKEN_FSTR] * (sizeof(mr_node_t) * 2 + tuple);
+    size += (uint64_t)counts[MR_TOKEN_DOLLAR] * (mr_parser_node_size(mr_node_dollar_method_t) + sizeof(mr_node_t));
+    size += (uint64_t)(counts[MR_TOKEN_IMPORT_K] + counts[MR_TOKEN_INCLUDE_K]) * (mr_parser_node_size(mr_node_import_t) + sizeof(mr_idx_t));
+
+    if (size > (uint64_t)_mr_config.size * MR_STACK_SIZE_FACTOR)
+        return _mr_config.size * MR_STACK_SIZE_FACTOR;
+    return (mr_long_t)size;
+}
+
+#ifdef __MR_PARSER_STACK__
 mr_byte_t mr_parser_tuple(
-    mr_parser_t *res, mr_token_t **tokens)
+    mr_parser_t *res, mr_token_cursor_t *tokens)
+{
+    return mr_parser_stack(res, tokens, MR_PARSER_STATE_TUPLE);
+}
+
+mr_byte_t mr_parser_stack(
+    mr_parser_t *res, mr_token_cursor_t *tokens, mr_byte_t state)
 {
-    mr_long_t ptr, pidx, size, alloc;
+    mr_long_t base;
     mr_byte_t retcode;
-    mr_node_tuple_t *value;
-    mr_node_t *node, *elems;
 
-    retcode = mr_parser_reassign(res, tokens);
-    if (retcode != MR_NOERROR || (*tokens)->type != MR_TOKEN_COMMA)
-        return retcode;
+    if (res->fsize == res->falloc && mr_parser_frames_grow(res))
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
 
-    retcode = mr_stack_push(&ptr, sizeof(mr_node_tuple_t));
-    if (retcode != MR_NOERROR)
-        return retcode;
+    base = res->fsize;
+    res->frames[res->fsize++].state = state;
 
-    retcode = mr_stack_palloc(&pidx, MR_PARSER_TUPLE_SIZE * sizeof(mr_node_t));
-    if (retcode != MR_NOERROR)
-        return retcode;
+    retcode = mr_parser_stack_run(res, tokens, base);
 
-    node = res->nodes + res->size;
-    value = (mr_node_tuple_t*)(_mr_stack.data + ptr);
+    res->fsize = base;
+    return retcode;
+}
 
-    value->elems = MR_IDX_DECOMPOSE(pidx);
-    elems = (mr_node_t*)_mr_stack.ptrs[pidx];
-    *elems = *node;
+mr_byte_t mr_parser_stack_run(
+    mr_parser_t *res, mr_token_cursor_t *tokens, mr_long_t base)
+{
+    mr_long_t ptr, elems;
+    mr_byte_t retcode, prec, next;
+    mr_parser_frame_t *frame;
+    mr_node_t *node;
+    mr_node_tuple_t *tvalue;
+    mr_node_ternary_op_t *cvalue;
+    mr_node_binary_op_t *bvalue;
+    mr_node_unary_op_t *uvalue;
+    mr_node_list_t *lvalue;
+    mr_node_func_call_t *fvalue;
+    mr_node_ex_func_call_t *evalue;
+    mr_node_call_arg_t arg;
+    mr_node_subscript_t *svalue;
+    mr_node_subscript_end_t *sevalue;
+    mr_node_subscript_step_t *ssvalue;
+    mr_node_keyval_t kvalue;
+    mr_node_var_assign_t *avalue;
+    mr_node_dollar_method_t *dvalue;
+    mr_node_ex_dollar_method_t *edvalue;
+    mr_node_t frag;
+    mr_bool_t assigned;
 
-    size = 1;
-    alloc = MR_PARSER_TUPLE_SIZE;
-    do
+    node = res->nodes + res->size;
+    while (res->fsize != base)
     {
-        if ((++*tokens)->type == MR_TOKEN_EOF || (*tokens)->type == MR_TOKEN_SEMICOLON || (*tokens)->type == MR_TOKEN_R_PAREN)
-            break;
+        frame = res->frames + res->fsize - 1;
+        switch (frame->state)
+        {
+        case MR_PARSER_STATE_TUPLE:
+            mr_parser_stack_enter(MR_PARSER_STATE_TUPLE_FIRST);
+            /* fall through */
+        case MR_PARSER_STATE_REASSIGN:
+            mr_parser_stack_enter(MR_PARSER_STATE_REASSIGN_LEFT);
+            /* fall through */
+        case MR_PARSER_STATE_TERNARY:
+            mr_parser_stack_enter(MR_PARSER_STATE_TERNARY_COND);
+            frame->prec = 0;
+            /* fall through */
+        case MR_PARSER_STATE_BINARY:
+            mr_parser_stack_enter(MR_PARSER_STATE_BINARY_LEFT);
+            /* fall through */
+        case MR_PARSER_STATE_FACTOR:
+            if (mr_token_cursor_type(tokens) >= MR_TOKEN_PLUS && mr_token_cursor_type(tokens) <= MR_TOKEN_NOT_K)
+            {
+                frame->sidx = mr_token_cursor_idx(tokens);
+                frame->op = mr_token_cursor_type(tokens);
+                mr_token_cursor_next(tokens);
 
-        retcode = mr_parser_reassign(res, tokens);
-        if (retcode != MR_NOERROR)
-            return retcode;
+                mr_parser_stack_call(MR_PARSER_STATE_FACTOR, MR_PARSER_STATE_UNARY);
+                break;
+            }
 
-        if (size == alloc)
-        {
-            retcode = mr_stack_prealloc(pidx, (alloc += MR_PARSER_TUPLE_SIZE) * sizeof(mr_node_t));
+            if (mr_token_cursor_type(tokens) == MR_TOKEN_INCREMENT || mr_token_cursor_type(tokens) == MR_TOKEN_DECREMENT)
+            {
+                mr_parser_stack_call(MR_PARSER_STATE_PREFIX, MR_PARSER_STATE_FACTOR_BASE);
+                break;
+            }
+
+            mr_parser_stack_enter(MR_PARSER_STATE_FACTOR_BASE);
+            /* fall through */
+        case MR_PARSER_STATE_POSTFIX:
+            mr_parser_stack_enter(MR_PARSER_STATE_POSTFIX_NEXT);
+            /* fall through */
+        case MR_PARSER_STATE_CORE:
+            if (mr_token_cursor_type(tokens) == MR_TOKEN_L_PAREN)
+            {
+                mr_token_cursor_next(tokens);
+                mr_parser_stack_call(MR_PARSER_STATE_TUPLE, MR_PARSER_STATE_CORE_PAREN);
+                break;
+            }
+            if (mr_token_cursor_type(tokens) == MR_TOKEN_L_SQUARE)
+            {
+                frame->state = MR_PARSER_STATE_LIST;
+                break;
+            }
+            if (mr_token_cursor_type(tokens) == MR_TOKEN_FSTR_START)
+            {
+                frame->state = MR_PARSER_STATE_FSTR;
+                break;
+            }
+            if (mr_token_cursor_type(tokens) == MR_TOKEN_L_CURLY)
+            {
+                frame->state = MR_PARSER_STATE_DICT;
+                break;
+            }
+            if (mr_token_cursor_type(tokens) == MR_TOKEN_DOLLAR)
+            {
+                frame->state = MR_PARSER_STATE_DOLLAR_METHOD;
+                break;
+            }
+            if (mr_token_cursor_type(tokens) >= MR_TOKEN_PRIVATE_K && mr_token_cursor_type(tokens) <= MR_TOKEN_STATIC_K)
+            {
+                frame->state = MR_PARSER_STATE_VAR_ASSIGN;
+                break;
+            }
+            if (mr_token_cursor_type(tokens) >= MR_TOKEN_OBJECT_T)
+            {
+                next = mr_token_cursor_peek(tokens);
+                if ((next >= MR_TOKEN_PRIVATE_K && next <= MR_TOKEN_STATIC_K) || next == MR_TOKEN_IDENTIFIER)
+                {
+                    frame->state = MR_PARSER_STATE_VAR_ASSIGN;
+                    break;
+                }
+            }
+
+            /* The other rules of the core don't nest expressions. */
+            retcode = mr_parser_core(res, tokens);
             if (retcode != MR_NOERROR)
                 return retcode;
 
-            elems = (mr_node_t*)_mr_stack.ptrs[pidx];
-        }
-
-        elems[size++] = *node;
-    } while ((*tokens)->type == MR_TOKEN_COMMA);
+            res->fsize--;
+            break;
 
-    if (size != alloc)
-    {
-        retcode = mr_stack_prealloc(pidx, size * sizeof(mr_node_t));
-        if (retcode != MR_NOERROR)
-            return retcode;
-    }
+        case MR_PARSER_STATE_TUPLE_FIRST:
+            if (mr_token_cursor_type(tokens) != MR_TOKEN_COMMA)
+            {
+                res->fsize--;
+                break;
+            }
 
-    value->size = MR_IDX_DECOMPOSE(size);
+            frame->base = _mr_stack.sptr;
+            retcode = mr_stack_scratch_push(node, sizeof(mr_node_t));
+            if (retcode != MR_NOERROR)
+                return retcode;
 
-    *node = (mr_node_t){.type=MR_NODE_TUPLE, .value=ptr};
-    return MR_NOERROR;
-}
+            frame->size = 1;
+            /* fall through */
+        case MR_PARSER_STATE_TUPLE_NEXT:
+            mr_token_cursor_next(tokens);
+            if (mr_token_cursor_type(tokens) != MR_TOKEN_EOF && mr_token_cursor_type(tokens) != MR_TOKEN_SEMICOLON && mr_token_cursor_type(tokens) != MR_TOKEN_R_PAREN)
+            {
+                mr_parser_stack_call(MR_PARSER_STATE_REASSIGN, MR_PARSER_STATE_TUPLE_ELEM);
+                break;
+            }
 
-mr_byte_t mr_parser_reassign(
-    mr_parser_t *res, mr_token_t **tokens)
-{
-    mr_parser_bin_op(mr_parser_ternary, mr_parser_tuple,
-        (*tokens)->type >= MR_TOKEN_ASSIGN && (*tokens)->type <= MR_TOKEN_R_SHIFT_ASSIGN);
-}
+            frame->state = MR_PARSER_STATE_TUPLE_END;
+            break;
+        case MR_PARSER_STATE_TUPLE_ELEM:
+            retcode = mr_stack_scratch_push(node, sizeof(mr_node_t));
+            if (retcode != MR_NOERROR)
+                return retcode;
 
-mr_byte_t mr_parser_ternary(
-    mr_parser_t *res, mr_token_t **tokens)
-{
-    mr_long_t ptr;
-    mr_byte_t retcode;
-    mr_node_ternary_op_t *value;
-    mr_node_t *node;
+            frame->size++;
+            if (mr_token_cursor_type(tokens) == MR_TOKEN_COMMA)
+            {
+                frame->state = MR_PARSER_STATE_TUPLE_NEXT;
+                break;
+            }
+            /* fall through */
+        case MR_PARSER_STATE_TUPLE_END:
+            retcode = mr_stack_scratch_pop(&elems, frame->base);
+            if (retcode != MR_NOERROR)
+                return retcode;
 
-    retcode = mr_parser_or(res, tokens);
-    if (retcode != MR_NOERROR || (*tokens)->type != MR_TOKEN_QUESTION)
-        return retcode;
+            retcode = mr_node_push(&ptr, sizeof(mr_node_tuple_t));
+            if (retcode != MR_NOERROR)
+                return retcode;
 
-    retcode = mr_stack_push(&ptr, sizeof(mr_node_ternary_op_t));
-    if (retcode != MR_NOERROR)
-        return retcode;
+            tvalue = (mr_node_tuple_t*)(_mr_stack.data + ptr);
+            *tvalue = (mr_node_tuple_t){.elems=elems, .size=MR_IDX_DECOMPOSE(frame->size)};
 
-    node = res->nodes + res->size;
-    value = (mr_node_ternary_op_t*)(_mr_stack.data + ptr);
-    value->cond = *node;
+            *node = mr_node_make(MR_NODE_TUPLE, ptr);
+            res->fsize--;
+            break;
 
-    if ((++*tokens)->type != MR_TOKEN_COLON)
-    {
-        retcode = mr_parser_tuple(res, tokens);
-        if (retcode != MR_NOERROR)
-            return retcode;
+        case MR_PARSER_STATE_REASSIGN_LEFT:
+            frame->left = *node;
+            /* fall through */
+        case MR_PARSER_STATE_REASSIGN_OP:
+            if (mr_token_cursor_type(tokens) >= MR_TOKEN_ASSIGN && mr_token_cursor_type(tokens) <= MR_TOKEN_R_SHIFT_ASSIGN)
+            {
+                frame->op = mr_token_cursor_type(tokens);
+                mr_token_cursor_next(tokens);
 
-        value->left = *node;
-        if ((*tokens)->type != MR_TOKEN_COLON)
-        {
-            value->right.type = MR_NODE_NULL;
-            *node = (mr_node_t){.type=MR_NODE_TERNARY_OP, .value=ptr};
-            return MR_NOERROR;
-        }
-    }
-    else
-        value->left.type = MR_NODE_NULL;
+                mr_parser_stack_call(MR_PARSER_STATE_TUPLE, MR_PARSER_STATE_REASSIGN_RIGHT);
+                break;
+            }
 
-    ++*tokens;
-    retcode = mr_parser_tuple(res, tokens);
-    if (retcode != MR_NOERROR)
-        return retcode;
+            *node = frame->left;
+            res->fsize--;
+            break;
+        case MR_PARSER_STATE_REASSIGN_RIGHT:
+            retcode = mr_node_push(&ptr, sizeof(mr_node_binary_op_t));
+            if (retcode != MR_NOERROR)
+                return MR_ERROR_NOT_ENOUGH_MEMORY;
 
-    value->right = *node;
-    *node = (mr_node_t){.type=MR_NODE_TERNARY_OP, .value=ptr};
-    return MR_NOERROR;
-}
+            bvalue = (mr_node_binary_op_t*)(_mr_stack.data + ptr);
+            *bvalue = (mr_node_binary_op_t){.left=frame->left, .right=*node, .op=frame->op};
 
-mr_byte_t mr_parser_or(
-    mr_parser_t *res, mr_token_t **tokens)
-{
-    mr_parser_bin_op(mr_parser_and, mr_parser_and, (*tokens)->type == MR_TOKEN_OR_K);
-}
+            frame->left = mr_node_make(MR_NODE_BINARY_OP, ptr);
+            frame->state = MR_PARSER_STATE_REASSIGN_OP;
+            break;
 
-mr_byte_t mr_parser_and(
-    mr_parser_t *res, mr_token_t **tokens)
-{
-    mr_parser_bin_op(mr_parser_order, mr_parser_order, (*tokens)->type == MR_TOKEN_AND_K);
-}
+        case MR_PARSER_STATE_TERNARY_COND:
+            if (mr_token_cursor_type(tokens) != MR_TOKEN_QUESTION)
+            {
+                res->fsize--;
+                break;
+            }
 
-mr_byte_t mr_parser_order(
-    mr_parser_t *res, mr_token_t **tokens)
-{
-    mr_parser_bin_op(mr_parser_cmp, mr_parser_cmp, (*tokens)->type >= MR_TOKEN_LESS && (*tokens)->type <= MR_TOKEN_GREATER_EQUAL);
-}
+            retcode = mr_node_push(&frame->ptr, sizeof(mr_node_ternary_op_t));
+            if (retcode != MR_NOERROR)
+                return retcode;
 
-mr_byte_t mr_parser_cmp(
-    mr_parser_t *res, mr_token_t **tokens)
-{
-    mr_parser_bin_op(mr_parser_b_or, mr_parser_b_or, (*tokens)->type >= MR_TOKEN_EQUAL && (*tokens)->type <= MR_TOKEN_EX_NEQUAL);
-}
+            cvalue = (mr_node_ternary_op_t*)(_mr_stack.data + frame->ptr);
+            cvalue->cond = *node;
 
-mr_byte_t mr_parser_b_or(
-    mr_parser_t *res, mr_token_t **tokens)
-{
-    mr_parser_bin_op(mr_parser_b_xor, mr_parser_b_xor, (*tokens)->type == MR_TOKEN_B_OR);
+            mr_token_cursor_next(tokens);
+            if (mr_token_cursor_type(tokens) != MR_TOKEN_COLON)
+            {
+                mr_parser_stack_call(MR_PARSER_STATE_TUPLE, MR_PARSER_STATE_TERNARY_LEFT);
+                break;
+            }
+
+            cvalue->left.type = MR_NODE_NULL;
+            frame->state = MR_PARSER_STATE_TERNARY_ELSE;
+            break;
+        case MR_PARSER_STATE_TERNARY_LEFT:
+            cvalue = (mr_node_ternary_op_t*)(_mr_stack.data + frame->ptr);
+            cvalue->left = *node;
+            if (mr_token_cursor_type(tokens) != MR_TOKEN_COLON)
+            {
+                cvalue->right.type = MR_NODE_NULL;
+
+                *node = mr_node_make(MR_NODE_TERNARY_OP, frame->ptr);
+                res->fsize--;
+                break;
+            }
+            /* fall through */
+        case MR_PARSER_STATE_TERNARY_ELSE:
+            mr_token_cursor_next(tokens);
+            mr_parser_stack_call(MR_PARSER_STATE_TUPLE, MR_PARSER_STATE_TERNARY_RIGHT);
+            break;
+        case MR_PARSER_STATE_TERNARY_RIGHT:
+            cvalue = (mr_node_ternary_op_t*)(_mr_stack.data + frame->ptr);
+            cvalue->right = *node;
+
+            *node = mr_node_make(MR_NODE_TERNARY_OP, frame->ptr);
+            res->fsize--;
+            break;
+
+        case MR_PARSER_STATE_BINARY_LEFT:
+            frame->left = *node;
+            /* fall through */
+        case MR_PARSER_STATE_BINARY_OP:
+            prec = mr_parser_precs[mr_token_cursor_type(tokens)];
+            if (prec > frame->prec)
+            {
+                frame->op = mr_token_cursor_type(tokens);
+                mr_token_cursor_next(tokens);
+
+                mr_parser_stack_call(MR_PARSER_STATE_BINARY, MR_PARSER_STATE_BINARY_RIGHT);
+                res->frames[res->fsize - 1].prec = prec;
+                break;
+            }
+
+            *node = frame->left;
+            res->fsize--;
+            break;
+        case MR_PARSER_STATE_BINARY_RIGHT:
+            retcode = mr_node_push(&ptr, sizeof(mr_node_binary_op_t));
+            if (retcode != MR_NOERROR)
+                return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+            bvalue = (mr_node_binary_op_t*)(_mr_stack.data + ptr);
+            *bvalue = (mr_node_binary_op_t){.left=frame->left, .right=*node, .op=frame->op};
+
+            frame->left = mr_node_make(MR_NODE_BINARY_OP, ptr);
+            frame->state = MR_PARSER_STATE_BINARY_OP;
+            break;
+
+        case MR_PARSER_STATE_FACTOR_BASE:
+            if (mr_token_cursor_type(tokens) != MR_TOKEN_POWER)
+            {
+                res->fsize--;
+                break;
+            }
+
+            frame->left = *node;
+            /* fall through */
+        case MR_PARSER_STATE_FACTOR_POWER:
+            mr_token_cursor_next(tokens);
+            mr_parser_stack_call(MR_PARSER_STATE_FACTOR, MR_PARSER_STATE_FACTOR_RIGHT);
+            break;
+        case MR_PARSER_STATE_FACTOR_RIGHT:
+            retcode = mr_node_push(&ptr, sizeof(mr_node_binary_op_t));
+            if (retcode != MR_NOERROR)
+                return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+            bvalue = (mr_node_binary_op_t*)(_mr_stack.data + ptr);
+            *bvalue = (mr_node_binary_op_t){.left=frame->left, .right=*node, .op=MR_TOKEN_POWER};
+
+            frame->left = mr_node_make(MR_NODE_BINARY_OP, ptr);
+            if (mr_token_cursor_type(tokens) == MR_TOKEN_POWER)
+            {
+                frame->state = MR_PARSER_STATE_FACTOR_POWER;
+                break;
+            }
+
+            *node = frame->left;
+            res->fsize--;
+            break;
+
+        case MR_PARSER_STATE_PREFIX:
+            if (mr_token_cursor_type(tokens) == MR_TOKEN_INCREMENT || mr_token_cursor_type(tokens) == MR_TOKEN_DECREMENT)
+            {
+                frame->sidx = mr_token_cursor_idx(tokens);
+                frame->op = mr_token_cursor_type(tokens);
+                mr_token_cursor_next(tokens);
+
+                mr_parser_stack_call(MR_PARSER_STATE_PREFIX, MR_PARSER_STATE_UNARY);
+                break;
+            }
+
+            frame->state = MR_PARSER_STATE_POSTFIX;
+            break;
+        case MR_PARSER_STATE_UNARY:
+            retcode = mr_node_push(&ptr, sizeof(mr_node_unary_op_t));
+            if (retcode != MR_NOERROR)
+                return retcode;
+
+            uvalue = (mr_node_unary_op_t*)(_mr_stack.data + ptr);
+            *uvalue = (mr_node_unary_op_t){.operand=*node, .sidx=frame->sidx, .op=frame->op};
+
+            *node = mr_node_make(MR_NODE_UNARY_OP, ptr);
+            res->fsize--;
+            break;
+
+        case MR_PARSER_STATE_POSTFIX_NEXT:
+            switch (mr_token_cursor_type(tokens))
+            {
+            case MR_TOKEN_L_PAREN:
+                mr_parser_stack_call(MR_PARSER_STATE_CALL, MR_PARSER_STATE_POSTFIX_NEXT);
+                break;
+            case MR_TOKEN_L_SQUARE:
+                mr_parser_stack_call(MR_PARSER_STATE_SUBSCRIPT, MR_PARSER_STATE_POSTFIX_NEXT);
+                break;
+            case MR_TOKEN_DOT:
+                frame->left = *node;
+
+                mr_token_cursor_next(tokens);
+                mr_parser_stack_call(MR_PARSER_STATE_CORE, MR_PARSER_STATE_POSTFIX_DOT);
+                break;
+            case MR_TOKEN_INCREMENT:
+            case MR_TOKEN_DECREMENT:
+                retcode = mr_node_push(&ptr, sizeof(mr_node_unary_op_t));
+                if (retcode != MR_NOERROR)
+                    return retcode;
+
+                uvalue = (mr_node_unary_op_t*)(_mr_stack.data + ptr);
+                *uvalue = (mr_node_unary_op_t){.operand=*node, .sidx=mr_token_cursor_idx(tokens), .op=mr_token_cursor_type(tokens) + 2};
+
+                *node = mr_node_make(MR_NODE_UNARY_OP, ptr);
+                mr_token_cursor_next(tokens);
+                break;
+            default:
+                res->fsize--;
+                break;
+            }
+            break;
+        case MR_PARSER_STATE_POSTFIX_DOT:
+            retcode = mr_node_push(&ptr, sizeof(mr_node_binary_op_t));
+            if (retcode != MR_NOERROR)
+                return retcode;
+
+            bvalue = (mr_node_binary_op_t*)(_mr_stack.data + ptr);
+            *bvalue = (mr_node_binary_op_t){.left=frame->left, .right=*node, .op=MR_TOKEN_DOT};
+
+            *node = mr_node_make(MR_NODE_BINARY_OP, ptr);
+            frame->state = MR_PARSER_STATE_POSTFIX_NEXT;
+            break;
+
+        case MR_PARSER_STATE_CORE_PAREN:
+            if (mr_token_cursor_type(tokens) != MR_TOKEN_R_PAREN)
+            {
+                res->error = (mr_invalid_syntax_t){.detail="Expected ')'", .token=*tokens};
+                return MR_ERROR_BAD_FORMAT;
+            }
+
+            mr_parser_advance_newline;
+            res->fsize--;
+            break;
+
+        case MR_PARSER_STATE_LIST:
+            retcode = mr_node_push(&frame->ptr, sizeof(mr_node_list_t));
+            if (retcode != MR_NOERROR)
+                return retcode;
+
+            lvalue = (mr_node_list_t*)(_mr_stack.data + frame->ptr);
+            lvalue->sidx = mr_token_cursor_idx(tokens);
+            mr_token_cursor_next(tokens);
+
+            if (mr_token_cursor_type(tokens) == MR_TOKEN_R_SQUARE)
+            {
+                lvalue->size = MR_ZERO_IDX;
+                lvalue->eidx = mr_token_cursor_idx(tokens);
+
+                *node = mr_node_make(MR_NODE_LIST, frame->ptr);
+                mr_parser_advance_newline;
+                res->fsize--;
+                break;
+            }
+
+            frame->base = _mr_stack.sptr;
+            frame->size = 0;
+            mr_parser_stack_call(MR_PARSER_STATE_REASSIGN, MR_PARSER_STATE_LIST_ELEM);
+            break;
+        case MR_PARSER_STATE_LIST_ELEM:
+            retcode = mr_stack_scratch_push(node, sizeof(mr_node_t));
+            if (retcode != MR_NOERROR)
+                return retcode;
+
+            frame->size++;
+            if (mr_token_cursor_type(tokens) == MR_TOKEN_COMMA)
+            {
+                mr_token_cursor_next(tokens);
+                if (mr_token_cursor_type(tokens) != MR_TOKEN_R_SQUARE)
+                {
+                    mr_parser_stack_call(MR_PARSER_STATE_REASSIGN, MR_PARSER_STATE_LIST_ELEM);
+                    break;
+                }
+            }
+
+            if (mr_token_cursor_type(tokens) != MR_TOKEN_R_SQUARE)
+            {
+                res->error = (mr_invalid_syntax_t){.detail="Expected ']' or ','", .token=*tokens};
+                return MR_ERROR_BAD_FORMAT;
+            }
+
+            retcode = mr_stack_scratch_pop(&elems, frame->base);
+            if (retcode != MR_NOERROR)
+                return retcode;
+
+            lvalue = (mr_node_list_t*)(_mr_stack.data + frame->ptr);
+            lvalue->elems = elems;
+            lvalue->size = MR_IDX_DECOMPOSE(frame->size);
+            lvalue->eidx = mr_token_cursor_idx(tokens);
+
+            *node = mr_node_make(MR_NODE_LIST, frame->ptr);
+            mr_parser_advance_newline;
+            res->fsize--;
+            break;
+
+        case MR_PARSER_STATE_CALL:
+            mr_token_cursor_next(tokens);
+            if (mr_token_cursor_type(tokens) == MR_TOKEN_R_PAREN)
+            {
+                retcode = mr_node_push(&ptr, sizeof(mr_node_ex_func_call_t));
+                if (retcode != MR_NOERROR)
+                    return retcode;
+
+                mr_token_cursor_next(tokens);
+
+                evalue = (mr_node_ex_func_call_t*)(_mr_stack.data + ptr);
+                *evalue = (mr_node_ex_func_call_t){.func=*node, .eidx=mr_token_cursor_idx(tokens)};
+
+                mr_parser_advance_newline;
+
+                *node = mr_node_make(MR_NODE_EX_FUNC_CALL, ptr);
+                res->fsize--;
+                break;
+            }
+
+            frame->left = *node;
+            frame->base = _mr_stack.sptr;
+            frame->size = 0;
+            /* fall through */
+        case MR_PARSER_STATE_CALL_ARG:
+            if (frame->size == MR_PARSER_FUNC_CALL_MAX)
+            {
+                res->error = (mr_invalid_syntax_t){.detail="Number of function call arguments exceeds the limit", .token=*tokens};
+                return MR_ERROR_BAD_FORMAT;
+            }
+
+            if (mr_token_cursor_type(tokens) == MR_TOKEN_IDENTIFIER && mr_token_cursor_peek(tokens) == MR_TOKEN_ASSIGN)
+            {
+                frame->sidx = mr_token_cursor_idx(tokens);
+                mr_token_cursor_next(tokens);
+                mr_token_cursor_next(tokens);
+            }
+            else
+                frame->sidx = MR_INVALID_IDX;
+
+            mr_parser_stack_call(MR_PARSER_STATE_REASSIGN, MR_PARSER_STATE_CALL_VALUE);
+            break;
+        case MR_PARSER_STATE_CALL_VALUE:
+            arg = (mr_node_call_arg_t){.value=*node, .name=frame->sidx};
+            retcode = mr_stack_scratch_push(&arg, sizeof(mr_node_call_arg_t));
+            if (retcode != MR_NOERROR)
+                return retcode;
+
+            frame->size++;
+            if (mr_token_cursor_type(tokens) == MR_TOKEN_COMMA)
+            {
+                mr_token_cursor_next(tokens);
+                frame->state = MR_PARSER_STATE_CALL_ARG;
+                break;
+            }
+
+            if (mr_token_cursor_type(tokens) != MR_TOKEN_R_PAREN)
+            {
+                res->error = (mr_invalid_syntax_t){.detail="Expected ')' or ','", .token=*tokens};
+                return MR_ERROR_BAD_FORMAT;
+            }
+
+            retcode = mr_stack_scratch_pop(&elems, frame->base);
+            if (retcode != MR_NOERROR)
+                return retcode;
+
+            retcode = mr_node_push(&ptr, sizeof(mr_node_func_call_t));
+            if (retcode != MR_NOERROR)
+                return retcode;
+
+            fvalue = (mr_node_func_call_t*)(_mr_stack.data + ptr);
+            fvalue->args = elems;
+            fvalue->size = (mr_byte_t)frame->size;
+            fvalue->func = frame->left;
+
+            mr_parser_advance_newline;
+
+            *node = mr_node_make(MR_NODE_FUNC_CALL, ptr);
+            res->fsize--;
+            break;
+
+        case MR_PARSER_STATE_SUBSCRIPT:
+            frame->left = *node;
+
+            mr_token_cursor_next(tokens);
+            if (mr_token_cursor_type(tokens) != MR_TOKEN_COLON)
+            {
+                mr_parser_stack_call(MR_PARSER_STATE_TUPLE, MR_PARSER_STATE_SUBSCRIPT_START);
+                break;
+            }
+
+            frame->start.type = MR_NODE_NULL;
+            frame->state = MR_PARSER_STATE_SUBSCRIPT_END;
+            break;
+        case MR_PARSER_STATE_SUBSCRIPT_START:
+            if (mr_token_cursor_type(tokens) == MR_TOKEN_R_SQUARE)
+            {
+                retcode = mr_node_push(&ptr, sizeof(mr_node_subscript_t));
+                if (retcode != MR_NOERROR)
+                    return retcode;
+
+                svalue = (mr_node_subscript_t*)(_mr_stack.data + ptr);
+                *svalue = (mr_node_subscript_t){.node=frame->left, .idx=*node, .eidx=mr_token_cursor_idx(tokens)};
+
+                *node = mr_node_make(MR_NODE_SUBSCRIPT, ptr);
+                mr_parser_advance_newline;
+                res->fsize--;
+                break;
+            }
+
+            if (mr_token_cursor_type(tokens) != MR_TOKEN_COLON)
+            {
+                res->error = (mr_invalid_syntax_t){.detail="Expected ']' or ':'", .token=*tokens};
+                return MR_ERROR_BAD_FORMAT;
+            }
+
+            frame->start = *node;
+            /* fall through */
+        case MR_PARSER_STATE_SUBSCRIPT_END:
+            mr_token_cursor_next(tokens);
+            if (mr_token_cursor_type(tokens) == MR_TOKEN_COLON)
+            {
+                frame->end.type = MR_NODE_NULL;
+                frame->state = MR_PARSER_STATE_SUBSCRIPT_STEP;
+                break;
+            }
+            if (mr_token_cursor_type(tokens) != MR_TOKEN_R_SQUARE)
+            {
+                mr_parser_stack_call(MR_PARSER_STATE_TUPLE, MR_PARSER_STATE_SUBSCRIPT_END_VALUE);
+                break;
+            }
+
+            frame->end.type = MR_NODE_NULL;
+            frame->state = MR_PARSER_STATE_SUBSCRIPT_END_CHECK;
+            break;
+        case MR_PARSER_STATE_SUBSCRIPT_END_VALUE:
+            frame->end = *node;
+            /* fall through */
+        case MR_PARSER_STATE_SUBSCRIPT_END_CHECK:
+            if (mr_token_cursor_type(tokens) == MR_TOKEN_R_SQUARE)
+            {
+                retcode = mr_node_push(&ptr, sizeof(mr_node_subscript_end_t));
+                if (retcode != MR_NOERROR)
+                    return retcode;
+
+                sevalue = (mr_node_subscript_end_t*)(_mr_stack.data + ptr);
+                *sevalue = (mr_node_subscript_end_t){.node=frame->left, .start=frame->start, .end=frame->end, .eidx=mr_token_cursor_idx(tokens)};
+
+                *node = mr_node_make(MR_NODE_SUBSCRIPT_END, ptr);
+                mr_parser_advance_newline;
+                res->fsize--;
+                break;
+            }
+
+            if (mr_token_cursor_type(tokens) != MR_TOKEN_COLON)
+            {
+                res->error = (mr_invalid_syntax_t){.detail="Expected ']' or ':'", .token=*tokens};
+                return MR_ERROR_BAD_FORMAT;
+            }
+            /* fall through */
+        case MR_PARSER_STATE_SUBSCRIPT_STEP:
+            mr_token_cursor_next(tokens);
+            if (mr_token_cursor_type(tokens) != MR_TOKEN_R_SQUARE)
+            {
+                mr_parser_stack_call(MR_PARSER_STATE_TUPLE, MR_PARSER_STATE_SUBSCRIPT_STEP_VALUE);
+                break;
+            }
+
+            frame->step.type = MR_NODE_NULL;
+            frame->state = MR_PARSER_STATE_SUBSCRIPT_FINISH;
+            break;
+        case MR_PARSER_STATE_SUBSCRIPT_STEP_VALUE:
+            if (mr_token_cursor_type(tokens) != MR_TOKEN_R_SQUARE)
+            {
+                res->error = (mr_invalid_syntax_t){.detail="Expected ']'", .token=*tokens};
+                return MR_ERROR_BAD_FORMAT;
+            }
+
+            frame->step = *node;
+            /* fall through */
+        case MR_PARSER_STATE_SUBSCRIPT_FINISH:
+            retcode = mr_node_push(&ptr, sizeof(mr_node_subscript_step_t));
+            if (retcode != MR_NOERROR)
+                return retcode;
+
+            ssvalue = (mr_node_subscript_step_t*)(_mr_stack.data + ptr);
+            *ssvalue = (mr_node_subscript_step_t){.node=frame->left, .start=frame->start, .end=frame->end, .step=frame->step,
+                .eidx=mr_token_cursor_idx(tokens)};
+
+            *node = mr_node_make(MR_NODE_SUBSCRIPT_STEP, ptr);
+            mr_parser_advance_newline;
+            res->fsize--;
+            break;
+
+        case MR_PARSER_STATE_FSTR:
+            retcode = mr_node_push(&frame->ptr, sizeof(mr_node_list_t));
+            if (retcode != MR_NOERROR)
+                return retcode;
+
+            lvalue = (mr_node_list_t*)(_mr_stack.data + frame->ptr);
+            lvalue->sidx = mr_token_cursor_idx(tokens);
+            mr_token_cursor_next(tokens);
+
+            if (mr_token_cursor_type(tokens) == MR_TOKEN_FSTR_END)
+            {
+                lvalue->size = MR_ZERO_IDX;
+                lvalue->eidx = mr_token_cursor_idx(tokens);
+
+                *node = mr_node_make(MR_NODE_FSTR, frame->ptr);
+                mr_parser_advance_newline;
+                res->fsize--;
+                break;
+            }
+
+            frame->base = _mr_stack.sptr;
+            frame->size = 0;
+            frame->state = MR_PARSER_STATE_FSTR_NEXT;
+            break;
+        case MR_PARSER_STATE_FSTR_EXPR:
+            retcode = mr_stack_scratch_push(node, sizeof(mr_node_t));
+            if (retcode != MR_NOERROR)
+                return retcode;
+
+            frame->size++;
+            /* fall through */
+        case MR_PARSER_STATE_FSTR_NEXT:
+            while (mr_token_cursor_type(tokens) == MR_TOKEN_FSTR)
+            {
+                frag = (mr_node_t){.type=MR_NODE_FSTR_FRAG, .value=MR_IDX_EXTRACT(mr_token_cursor_idx(tokens))};
+                retcode = mr_stack_scratch_push(&frag, sizeof(mr_node_t));
+                if (retcode != MR_NOERROR)
+                    return retcode;
+
+                frame->size++;
+                mr_token_cursor_next(tokens);
+            }
+
+            if (mr_token_cursor_type(tokens) != MR_TOKEN_FSTR_END)
+            {
+                mr_parser_stack_call(MR_PARSER_STATE_TUPLE, MR_PARSER_STATE_FSTR_EXPR);
+                break;
+            }
+
+            retcode = mr_stack_scratch_pop(&elems, frame->base);
+            if (retcode != MR_NOERROR)
+                return retcode;
+
+            lvalue = (mr_node_list_t*)(_mr_stack.data + frame->ptr);
+            lvalue->elems = elems;
+            lvalue->size = MR_IDX_DECOMPOSE(frame->size);
+            lvalue->eidx = mr_token_cursor_idx(tokens);
+
+            *node = mr_node_make(MR_NODE_FSTR, frame->ptr);
+            mr_parser_advance_newline;
+            res->fsize--;
+            break;
+
+        case MR_PARSER_STATE_DICT:
+            retcode = mr_node_push(&frame->ptr, sizeof(mr_node_list_t));
+            if (retcode != MR_NOERROR)
+                return retcode;
+
+            lvalue = (mr_node_list_t*)(_mr_stack.data + frame->ptr);
+            lvalue->sidx = mr_token_cursor_idx(tokens);
+            mr_token_cursor_next(tokens);
+
+            if (mr_token_cursor_type(tokens) == MR_TOKEN_R_CURLY)
+            {
+                lvalue->size = MR_ZERO_IDX;
+                lvalue->eidx = mr_token_cursor_idx(tokens);
+
+                *node = mr_node_make(MR_NODE_DICT, frame->ptr);
+                mr_parser_advance_newline;
+                res->fsize--;
+                break;
+            }
+            if (mr_token_cursor_type(tokens) == MR_TOKEN_COMMA)
+            {
+                mr_token_cursor_next(tokens);
+                if (mr_token_cursor_type(tokens) != MR_TOKEN_R_CURLY)
+                {
+                    res->error = (mr_invalid_syntax_t){.detail="Expected '}'", .token=*tokens};
+                    return MR_ERROR_BAD_FORMAT;
+                }
+
+                lvalue->size = MR_ZERO_IDX;
+                lvalue->eidx = mr_token_cursor_idx(tokens);
+
+                *node = mr_node_make(MR_NODE_SET, frame->ptr);
+                mr_parser_advance_newline;
+                res->fsize--;
+                break;
+            }
+
+            frame->base = _mr_stack.sptr;
+            mr_parser_stack_call(MR_PARSER_STATE_REASSIGN, MR_PARSER_STATE_DICT_FIRST);
+            break;
+        case MR_PARSER_STATE_DICT_FIRST:
+            if (mr_token_cursor_type(tokens) == MR_TOKEN_COMMA)
+            {
+                retcode = mr_stack_scratch_push(node, sizeof(mr_node_t));
+                if (retcode != MR_NOERROR)
+                    return retcode;
+
+                frame->size = 1;
+                frame->state = MR_PARSER_STATE_SET_NEXT;
+                break;
+            }
+            if (mr_token_cursor_type(tokens) != MR_TOKEN_COLON)
+            {
+                res->error = (mr_invalid_syntax_t){.detail="Expected ':' or ','", .token=*tokens};
+                return MR_ERROR_BAD_FORMAT;
+            }
+
+            frame->left = *node;
+            frame->size = 0;
+
+            mr_token_cursor_next(tokens);
+            mr_parser_stack_call(MR_PARSER_STATE_REASSIGN, MR_PARSER_STATE_DICT_VALUE);
+            break;
+        case MR_PARSER_STATE_DICT_KEY:
+            if (mr_token_cursor_type(tokens) != MR_TOKEN_COLON)
+            {
+                res->error = (mr_invalid_syntax_t){.detail="Expected ':'", .token=*tokens};
+                return MR_ERROR_BAD_FORMAT;
+            }
+
+            frame->left = *node;
+
+            mr_token_cursor_next(tokens);
+            mr_parser_stack_call(MR_PARSER_STATE_REASSIGN, MR_PARSER_STATE_DICT_VALUE);
+            break;
+        case MR_PARSER_STATE_DICT_VALUE:
+            kvalue = (mr_node_keyval_t){.key=frame->left, .value=*node};
+            retcode = mr_stack_scratch_push(&kvalue, sizeof(mr_node_keyval_t));
+            if (retcode != MR_NOERROR)
+                return retcode;
+
+            frame->size++;
+            if (mr_token_cursor_type(tokens) == MR_TOKEN_COMMA)
+            {
+                mr_token_cursor_next(tokens);
+                if (mr_token_cursor_type(tokens) != MR_TOKEN_R_CURLY)
+                {
+                    mr_parser_stack_call(MR_PARSER_STATE_REASSIGN, MR_PARSER_STATE_DICT_KEY);
+                    break;
+                }
+            }
+
+            if (mr_token_cursor_type(tokens) != MR_TOKEN_R_CURLY)
+            {
+                res->error = (mr_invalid_syntax_t){.detail="Expected '}' or ','", .token=*tokens};
+                return MR_ERROR_BAD_FORMAT;
+            }
+
+            retcode = mr_stack_scratch_pop(&elems, frame->base);
+            if (retcode != MR_NOERROR)
+                return retcode;
+
+            lvalue = (mr_node_list_t*)(_mr_stack.data + frame->ptr);
+            lvalue->elems = elems;
+            lvalue->size = MR_IDX_DECOMPOSE(frame->size);
+            lvalue->eidx = mr_token_cursor_idx(tokens);
+
+            *node = mr_node_make(MR_NODE_DICT, frame->ptr);
+            mr_parser_advance_newline;
+            res->fsize--;
+            break;
+
+        case MR_PARSER_STATE_SET_ELEM:
+            retcode = mr_stack_scratch_push(node, sizeof(mr_node_t));
+            if (retcode != MR_NOERROR)
+                return retcode;
+
+            frame->size++;
+            if (mr_token_cursor_type(tokens) != MR_TOKEN_COMMA)
+            {
+                frame->state = MR_PARSER_STATE_SET_END;
+                break;
+            }
+            /* fall through */
+        case MR_PARSER_STATE_SET_NEXT:
+            mr_token_cursor_next(tokens);
+            if (mr_token_cursor_type(tokens) != MR_TOKEN_R_CURLY)
+            {
+                mr_parser_stack_call(MR_PARSER_STATE_REASSIGN, MR_PARSER_STATE_SET_ELEM);
+                break;
+            }
+            /* fall through */
+        case MR_PARSER_STATE_SET_END:
+            if (mr_token_cursor_type(tokens) != MR_TOKEN_R_CURLY)
+            {
+                res->error = (mr_invalid_syntax_t){.detail="Expected '}' or ','", .token=*tokens};
+                return MR_ERROR_BAD_FORMAT;
+            }
+
+            retcode = mr_stack_scratch_pop(&elems, frame->base);
+            if (retcode != MR_NOERROR)
+                return retcode;
+
+            lvalue = (mr_node_list_t*)(_mr_stack.data + frame->ptr);
+            lvalue->elems = elems;
+            lvalue->size = MR_IDX_DECOMPOSE(frame->size);
+            lvalue->eidx = mr_token_cursor_idx(tokens);
+
+            *node = mr_node_make(MR_NODE_SET, frame->ptr);
+            mr_parser_advance_newline;
+            res->fsize--;
+            break;
+
+        case MR_PARSER_STATE_VAR_ASSIGN:
+            retcode = mr_parser_var_assign_head(res, tokens, &frame->ptr, &assigned);
+            if (retcode != MR_NOERROR)
+                return retcode;
+
+            if (!assigned)
+            {
+                res->fsize--;
+                break;
+            }
+
+            mr_parser_stack_call(MR_PARSER_STATE_TUPLE, MR_PARSER_STATE_VAR_ASSIGN_VALUE);
+            break;
+        case MR_PARSER_STATE_VAR_ASSIGN_VALUE:
+            avalue = (mr_node_var_assign_t*)(_mr_stack.data + frame->ptr);
+            avalue->value = *node;
+
+            *node = mr_node_make(MR_NODE_VAR_ASSIGN, frame->ptr);
+            res->fsize--;
+            break;
+
+        case MR_PARSER_STATE_DOLLAR_METHOD:
+            frame->sidx = mr_token_cursor_idx(tokens);
+
+            mr_token_cursor_next(tokens);
+            if (mr_token_cursor_type(tokens) != MR_TOKEN_IDENTIFIER)
+            {
+                res->error = (mr_invalid_syntax_t){.detail="Expected an identifier", .token=*tokens};
+                return MR_ERROR_BAD_FORMAT;
+            }
+
+            frame->left.value = MR_IDX_EXTRACT(mr_token_cursor_idx(tokens));
+            mr_parser_advance_newline;
+
+            if (mr_token_cursor_type(tokens) != MR_TOKEN_COLON)
+            {
+                retcode = mr_node_push(&ptr, sizeof(mr_node_ex_dollar_method_t));
+                if (retcode != MR_NOERROR)
+                    return retcode;
+
+                edvalue = (mr_node_ex_dollar_method_t*)(_mr_stack.data + ptr);
+                *edvalue = (mr_node_ex_dollar_method_t){.name=MR_IDX_DECOMPOSE(frame->left.value), .sidx=frame->sidx};
+
+                *node = mr_node_make(MR_NODE_EX_DOLLAR_METHOD, ptr);
+                res->fsize--;
+                break;
+            }
+
+            frame->base = _mr_stack.sptr;
+            frame->size = 0;
+            /* fall through */
+        case MR_PARSER_STATE_DOLLAR_METHOD_PARAM:
+            if (frame->size == MR_PARSER_DOLLAR_METHOD_MAX)
+            {
+                res->error = (mr_invalid_syntax_t){.detail="Number of dollar method parameters exceeds the limit", .token=*tokens};
+                return MR_ERROR_BAD_FORMAT;
+            }
+
+            mr_token_cursor_next(tokens);
+            mr_parser_stack_call(MR_PARSER_STATE_REASSIGN, MR_PARSER_STATE_DOLLAR_METHOD_VALUE);
+            break;
+        case MR_PARSER_STATE_DOLLAR_METHOD_VALUE:
+            retcode = mr_stack_scratch_push(node, sizeof(mr_node_t));
+            if (retcode != MR_NOERROR)
+                return retcode;
+
+            frame->size++;
+            if (mr_token_cursor_type(tokens) == MR_TOKEN_COMMA)
+            {
+                frame->state = MR_PARSER_STATE_DOLLAR_METHOD_PARAM;
+                break;
+            }
+
+            retcode = mr_stack_scratch_pop(&elems, frame->base);
+            if (retcode != MR_NOERROR)
+                return retcode;
+
+            retcode = mr_node_push(&ptr, sizeof(mr_node_dollar_method_t));
+            if (retcode != MR_NOERROR)
+                return retcode;
+
+            dvalue = (mr_node_dollar_method_t*)(_mr_stack.data + ptr);
+            *dvalue = (mr_node_dollar_method_t){.params=elems, .size=(mr_byte_t)frame->size,
+                .name=MR_IDX_DECOMPOSE(frame->left.value), .sidx=frame->sidx};
+
+            *node = mr_node_make(MR_NODE_DOLLAR_METHOD, ptr);
+            res->fsize--;
+            break;
+        }
+    }
+
+    return MR_NOERROR;
 }
 
-mr_byte_t mr_parser_b_xor(
-    mr_parser_t *res, mr_token_t **tokens)
+mr_byte_t mr_parser_frames_grow(
+    mr_parser_t *res)
 {
-    mr_parser_bin_op(mr_parser_b_and, mr_parser_b_and, (*tokens)->type == MR_TOKEN_B_XOR);
-}
+    mr_long_t alloc;
+    mr_ptr_t block;
 
-mr_byte_t mr_parser_b_and(
-    mr_parser_t *res, mr_token_t **tokens)
+    alloc = res->falloc ? res->falloc * 2 : MR_PARSER_STACK_SIZE;
+    block = mr_mem_realloc(MR_MEM_PARSER, res->frames, alloc * sizeof(mr_parser_frame_t));
+    if (!block)
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    res->frames = block;
+    res->falloc = alloc;
+    return MR_NOERROR;
+}
+#else
+mr_byte_t mr_parser_tuple(
+    mr_parser_t *res, mr_token_cursor_t *tokens)
 {
-    mr_parser_bin_op(mr_parser_shift, mr_parser_shift, (*tokens)->type == MR_TOKEN_B_AND);
+    mr_long_t ptr, elems, base, size;
+    mr_byte_t retcode;
+    mr_node_tuple_t *value;
+    mr_node_t *node;
+
+    retcode = mr_parser_reassign(res, tokens);
+    if (retcode != MR_NOERROR || mr_token_cursor_type(tokens) != MR_TOKEN_COMMA)
+        return retcode;
+
+    node = res->nodes + res->size;
+    base = _mr_stack.sptr;
+
+    retcode = mr_stack_scratch_push(node, sizeof(mr_node_t));
+    if (retcode != MR_NOERROR)
+        return retcode;
+
+    size = 1;
+    do
+    {
+        mr_token_cursor_next(tokens);
+        if (mr_token_cursor_type(tokens) == MR_TOKEN_EOF || mr_token_cursor_type(tokens) == MR_TOKEN_SEMICOLON || mr_token_cursor_type(tokens) == MR_TOKEN_R_PAREN)
+            break;
+
+        retcode = mr_parser_reassign(res, tokens);
+        if (retcode != MR_NOERROR)
+            return retcode;
+
+        retcode = mr_stack_scratch_push(node, sizeof(mr_node_t));
+        if (retcode != MR_NOERROR)
+            return retcode;
+
+        size++;
+    } while (mr_token_cursor_type(tokens) == MR_TOKEN_COMMA);
+
+    retcode = mr_stack_scratch_pop(&elems, base);
+    if (retcode != MR_NOERROR)
+        return retcode;
+
+    retcode = mr_node_push(&ptr, sizeof(mr_node_tuple_t));
+    if (retcode != MR_NOERROR)
+        return retcode;
+
+    value = (mr_node_tuple_t*)(_mr_stack.data + ptr);
+    *value = (mr_node_tuple_t){.elems=elems, .size=MR_IDX_DECOMPOSE(size)};
+
+    *node = mr_node_make(MR_NODE_TUPLE, ptr);
+    return MR_NOERROR;
 }
 
-mr_byte_t mr_parser_shift(
-    mr_parser_t *res, mr_token_t **tokens)
+mr_byte_t mr_parser_reassign(
+    mr_parser_t *res, mr_token_cursor_t *tokens)
 {
-    mr_parser_bin_op(mr_parser_expr, mr_parser_expr, (*tokens)->type == MR_TOKEN_L_SHIFT || (*tokens)->type == MR_TOKEN_R_SHIFT);
+    mr_parser_bin_op(mr_parser_ternary, mr_parser_tuple,
+        mr_token_cursor_type(tokens) >= MR_TOKEN_ASSIGN && mr_token_cursor_type(tokens) <= MR_TOKEN_R_SHIFT_ASSIGN);
 }
 
-mr_byte_t mr_parser_expr(
-    mr_parser_t *res, mr_token_t **tokens)
+mr_byte_t mr_parser_ternary(
+    mr_parser_t *res, mr_token_cursor_t *tokens)
 {
-    mr_parser_bin_op(mr_parser_term, mr_parser_term, (*tokens)->type == MR_TOKEN_PLUS || (*tokens)->type == MR_TOKEN_MINUS);
+    mr_long_t ptr;
+    mr_byte_t retcode;
+    mr_node_ternary_op_t *value;
+    mr_node_t *node;
+
+    retcode = mr_parser_binary(res, tokens, 0);
+    if (retcode != MR_NOERROR || mr_token_cursor_type(tokens) != MR_TOKEN_QUESTION)
+        return retcode;
+
+    retcode = mr_node_push(&ptr, sizeof(mr_node_ternary_op_t));
+    if (retcode != MR_NOERROR)
+        return retcode;
+
+    node = res->nodes + res->size;
+    value = (mr_node_ternary_op_t*)(_mr_stack.data + ptr);
+    value->cond = *node;
+
+    mr_token_cursor_next(tokens);
+    if (mr_token_cursor_type(tokens) != MR_TOKEN_COLON)
+    {
+        retcode = mr_parser_tuple(res, tokens);
+        if (retcode != MR_NOERROR)
+            return retcode;
+
+        value->left = *node;
+        if (mr_token_cursor_type(tokens) != MR_TOKEN_COLON)
+        {
+            value->right.type = MR_NODE_NULL;
+            *node = mr_node_make(MR_NODE_TERNARY_OP, ptr);
+            return MR_NOERROR;
+        }
+    }
+    else
+        value->left.type = MR_NODE_NULL;
+
+    mr_token_cursor_next(tokens);
+    retcode = mr_parser_tuple(res, tokens);
+    if (retcode != MR_NOERROR)
+        return retcode;
+
+    value->right = *node;
+    *node = mr_node_make(MR_NODE_TERNARY_OP, ptr);
+    return MR_NOERROR;
 }
 
-mr_byte_t mr_parser_term(
-    mr_parser_t *res, mr_token_t **tokens)
+mr_byte_t mr_parser_binary(
+    mr_parser_t *res, mr_token_cursor_t *tokens, mr_byte_t prec)
 {
-    mr_parser_bin_op(mr_parser_factor, mr_parser_factor, (*tokens)->type >= MR_TOKEN_MULTIPLY && (*tokens)->type <= MR_TOKEN_QUOTIENT);
+    mr_long_t ptr;
+    mr_byte_t retcode, op, oprec;
+    mr_node_binary_op_t *value;
+    mr_node_t left, *node;
+
+    retcode = mr_parser_factor(res, tokens);
+    if (retcode != MR_NOERROR)
+        return retcode;
+
+    node = res->nodes + res->size;
+    left = *node;
+    while ((oprec = mr_parser_precs[mr_token_cursor_type(tokens)]) > prec)
+    {
+        op = mr_token_cursor_type(tokens);
+        mr_token_cursor_next(tokens);
+
+        retcode = mr_parser_binary(res, tokens, oprec);
+        if (retcode != MR_NOERROR)
+            return retcode;
+
+        retcode = mr_node_push(&ptr, sizeof(mr_node_binary_op_t));
+        if (retcode != MR_NOERROR)
+            return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+        value = (mr_node_binary_op_t*)(_mr_stack.data + ptr);
+        *value = (mr_node_binary_op_t){.left=left, .right=*node, .op=op};
+
+        left = mr_node_make(MR_NODE_BINARY_OP, ptr);
+    }
+
+    *node = left;
+    return MR_NOERROR;
 }
 
 mr_byte_t mr_parser_factor(
-    mr_parser_t *res, mr_token_t **tokens)
+    mr_parser_t *res, mr_token_cursor_t *tokens)
 {
-    if ((*tokens)->type >= MR_TOKEN_PLUS && (*tokens)->type <= MR_TOKEN_NOT_K)
-    {
-        mr_long_t ptr;
-        mr_byte_t op, retcode;
-        mr_node_unary_op_t *value;
-        mr_node_t *node;
-        mr_idx_t sidx;
+    mr_long_t ptr;
+    mr_byte_t op, retcode;
+    mr_node_unary_op_t *uvalue;
+    mr_node_binary_op_t *value;
+    mr_node_t left, *node;
+    mr_idx_t sidx;
 
-        sidx = (*tokens)->idx;
-        op = (*tokens)++->type;
+    if (mr_token_cursor_type(tokens) >= MR_TOKEN_PLUS && mr_token_cursor_type(tokens) <= MR_TOKEN_NOT_K)
+    {
+        sidx = mr_token_cursor_idx(tokens);
+        op = mr_token_cursor_type(tokens);
+        mr_token_cursor_next(tokens);
 
         retcode = mr_parser_factor(res, tokens);
         if (retcode != MR_NOERROR)
             return retcode;
 
-        retcode = mr_stack_push(&ptr, sizeof(mr_node_unary_op_t));
+        retcode = mr_node_push(&ptr, sizeof(mr_node_unary_op_t));
         if (retcode != MR_NOERROR)
             return retcode;
 
-        value = (mr_node_unary_op_t*)(_mr_stack.data + ptr);
+        uvalue = (mr_node_unary_op_t*)(_mr_stack.data + ptr);
         node = res->nodes + res->size;
-        *value = (mr_node_unary_op_t){.operand=*node, .sidx=sidx, .op=op};
+        *uvalue = (mr_node_unary_op_t){.operand=*node, .sidx=sidx, .op=op};
 
-        *node = (mr_node_t){.type=MR_NODE_UNARY_OP, .value=ptr};
+        *node = mr_node_make(MR_NODE_UNARY_OP, ptr);
         return MR_NOERROR;
     }
 
-    return mr_parser_power(res, tokens);
-}
+    /* The prefix function is skipped for most operands. */
+    if (mr_token_cursor_type(tokens) == MR_TOKEN_INCREMENT || mr_token_cursor_type(tokens) == MR_TOKEN_DECREMENT)
+        retcode = mr_parser_prefix(res, tokens);
+    else
+        retcode = mr_parser_postfix(res, tokens);
+    if (retcode != MR_NOERROR || mr_token_cursor_type(tokens) != MR_TOKEN_POWER)
+        return retcode;
 
-mr_byte_t mr_parser_power(
-    mr_parser_t *res, mr_token_t **tokens)
-{
-    mr_parser_bin_op(mr_parser_prefix, mr_parser_factor, (*tokens)->type == MR_TOKEN_POWER);
+    node = res->nodes + res->size;
+    left = *node;
+    do
+    {
+        mr_token_cursor_next(tokens);
+
+        retcode = mr_parser_factor(res, tokens);
+        if (retcode != MR_NOERROR)
+            return retcode;
+
+        retcode = mr_node_push(&ptr, sizeof(mr_node_binary_op_t));
+        if (retcode != MR_NOERROR)
+            return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+        value = (mr_node_binary_op_t*)(_mr_stack.data + ptr);
+        *value = (mr_node_binary_op_t){.left=left, .right=*node, .op=MR_TOKEN_POWER};
+
+        left = mr_node_make(MR_NODE_BINARY_OP, ptr);
+    } while (mr_token_cursor_type(tokens) == MR_TOKEN_POWER);
+
+    *node = left;
+    return MR_NOERROR;
 }
 
 mr_byte_t mr_parser_prefix(
-    mr_parser_t *res, mr_token_t **tokens)
+    mr_parser_t *res, mr_token_cursor_t *tokens)
 {
-    if ((*tokens)->type == MR_TOKEN_INCREMENT || (*tokens)->type == MR_TOKEN_DECREMENT)
+    if (mr_token_cursor_type(tokens) == MR_TOKEN_INCREMENT || mr_token_cursor_type(tokens) == MR_TOKEN_DECREMENT)
     {
         mr_long_t ptr;
         mr_byte_t op, retcode;
@@ -708,14 +1988,15 @@ mr_byte_t mr_parser_prefix(
         mr_node_t *node;
         mr_idx_t sidx;
 
-        sidx = (*tokens)->idx;
-        op = (*tokens)++->type;
+        sidx = mr_token_cursor_idx(tokens);
+        op = mr_token_cursor_type(tokens);
+        mr_token_cursor_next(tokens);
 
         retcode = mr_parser_prefix(res, tokens);
         if (retcode != MR_NOERROR)
             return retcode;
 
-        retcode = mr_stack_push(&ptr, sizeof(mr_node_unary_op_t));
+        retcode = mr_node_push(&ptr, sizeof(mr_node_unary_op_t));
         if (retcode != MR_NOERROR)
             return retcode;
 
@@ -723,7 +2004,7 @@ mr_byte_t mr_parser_prefix(
         node = res->nodes + res->size;
         *value = (mr_node_unary_op_t){.operand=*node, .sidx=sidx, .op=op};
 
-        *node = (mr_node_t){.type=MR_NODE_UNARY_OP, .value=ptr};
+        *node = mr_node_make(MR_NODE_UNARY_OP, ptr);
         return MR_NOERROR;
     }
 
@@ -731,7 +2012,7 @@ mr_byte_t mr_parser_prefix(
 }
 
 mr_byte_t mr_parser_postfix(
-    mr_parser_t *res, mr_token_t **tokens)
+    mr_parser_t *res, mr_token_cursor_t *tokens)
 {
     mr_byte_t retcode;
     mr_node_t *node;
@@ -743,21 +2024,21 @@ mr_byte_t mr_parser_postfix(
     node = res->nodes + res->size;
     while (1)
     {
-        if ((*tokens)->type == MR_TOKEN_L_PAREN)
+        if (mr_token_cursor_type(tokens) == MR_TOKEN_L_PAREN)
         {
             retcode = mr_parser_handle_call(res, tokens);
             if (retcode != MR_NOERROR)
                 return retcode;
             continue;
         }
-        if ((*tokens)->type == MR_TOKEN_L_SQUARE)
+        if (mr_token_cursor_type(tokens) == MR_TOKEN_L_SQUARE)
         {
             retcode = mr_parser_handle_subscript(res, tokens);
             if (retcode != MR_NOERROR)
                 return retcode;
             continue;
         }
-        if ((*tokens)->type == MR_TOKEN_DOT)
+        if (mr_token_cursor_type(tokens) == MR_TOKEN_DOT)
         {
             mr_long_t ptr;
             mr_node_binary_op_t *value;
@@ -765,35 +2046,35 @@ mr_byte_t mr_parser_postfix(
 
             left = *node;
 
-            ++*tokens;
+            mr_token_cursor_next(tokens);
             retcode = mr_parser_core(res, tokens);
             if (retcode != MR_NOERROR)
                 return retcode;
 
-            retcode = mr_stack_push(&ptr, sizeof(mr_node_binary_op_t));
+            retcode = mr_node_push(&ptr, sizeof(mr_node_binary_op_t));
             if (retcode != MR_NOERROR)
                 return retcode;
 
             value = (mr_node_binary_op_t*)(_mr_stack.data + ptr);
             *value = (mr_node_binary_op_t){.left=left, .right=*node, .op=MR_TOKEN_DOT};
 
-            *node = (mr_node_t){.type=MR_NODE_BINARY_OP, .value=ptr};
+            *node = mr_node_make(MR_NODE_BINARY_OP, ptr);
             continue;
         }
-        if ((*tokens)->type == MR_TOKEN_INCREMENT || (*tokens)->type == MR_TOKEN_DECREMENT)
+        if (mr_token_cursor_type(tokens) == MR_TOKEN_INCREMENT || mr_token_cursor_type(tokens) == MR_TOKEN_DECREMENT)
         {
             mr_long_t ptr;
             mr_node_unary_op_t *value;
 
-            retcode = mr_stack_push(&ptr, sizeof(mr_node_unary_op_t));
+            retcode = mr_node_push(&ptr, sizeof(mr_node_unary_op_t));
             if (retcode != MR_NOERROR)
                 return retcode;
 
             value = (mr_node_unary_op_t*)(_mr_stack.data + ptr);
-            *value = (mr_node_unary_op_t){.operand=*node, .sidx=(*tokens)->idx, .op=(*tokens)->type + 2};
+            *value = (mr_node_unary_op_t){.operand=*node, .sidx=mr_token_cursor_idx(tokens), .op=mr_token_cursor_type(tokens) + 2};
 
-            *node = (mr_node_t){.type=MR_NODE_UNARY_OP, .value=ptr};
-            ++*tokens;
+            *node = mr_node_make(MR_NODE_UNARY_OP, ptr);
+            mr_token_cursor_next(tokens);
             continue;
         }
 
@@ -802,13 +2083,16 @@ mr_byte_t mr_parser_postfix(
 
     return MR_NOERROR;
 }
+#endif
 
 mr_byte_t mr_parser_core(
-    mr_parser_t *res, mr_token_t **tokens)
+    mr_parser_t *res, mr_token_cursor_t *tokens)
 {
+#ifndef __MR_PARSER_STACK__
     mr_byte_t retcode;
+#endif
 
-    switch ((*tokens)->type)
+    switch (mr_token_cursor_type(tokens))
     {
     case MR_TOKEN_IDENTIFIER:
         mr_parser_node_data_sub(MR_NODE_VAR_ACCESS);
@@ -822,11 +2106,13 @@ mr_byte_t mr_parser_core(
         mr_parser_node_data_sub(MR_NODE_CHR);
     case MR_TOKEN_TRUE_K:
     case MR_TOKEN_FALSE_K:
-        res->nodes[res->size] = (mr_node_t){.type=MR_NODE_BOOL, .value=*(mr_long_t*)*tokens};
+        res->nodes[res->size] = (mr_node_t){.type=MR_NODE_BOOL,
+            .value=MR_NODE_KEYWORD_MAKE(MR_IDX_EXTRACT(mr_token_cursor_idx(tokens)), mr_token_cursor_type(tokens), MR_TOKEN_TRUE_K)};
         mr_parser_advance_newline;
         return MR_NOERROR;
     case MR_TOKEN_STR:
         mr_parser_node_data_sub(MR_NODE_STR);
+#ifndef __MR_PARSER_STACK__
     case MR_TOKEN_FSTR_START:
         return mr_parser_handle_fstr(res, tokens);
     case MR_TOKEN_L_SQUARE:
@@ -836,13 +2122,13 @@ mr_byte_t mr_parser_core(
     case MR_TOKEN_DOLLAR:
         return mr_parser_handle_dollar_method(res, tokens);
     case MR_TOKEN_L_PAREN:
-        ++*tokens;
+        mr_token_cursor_next(tokens);
 
         retcode = mr_parser_tuple(res, tokens);
         if (retcode != MR_NOERROR)
             return retcode;
 
-        if ((*tokens)->type != MR_TOKEN_R_PAREN)
+        if (mr_token_cursor_type(tokens) != MR_TOKEN_R_PAREN)
         {
             res->error = (mr_invalid_syntax_t){.detail="Expected ')'", .token=*tokens};
             return MR_ERROR_BAD_FORMAT;
@@ -850,23 +2136,29 @@ mr_byte_t mr_parser_core(
 
         mr_parser_advance_newline;
         return MR_NOERROR;
+#endif
     case MR_TOKEN_IMPORT_K:
         return mr_parser_handle_import(res, tokens, MR_NODE_IMPORT);
     case MR_TOKEN_INCLUDE_K:
         return mr_parser_handle_import(res, tokens, MR_NODE_INCLUDE);
     }
 
-    if ((*tokens)->type >= MR_TOKEN_PRIVATE_K && (*tokens)->type <= MR_TOKEN_STATIC_K)
+#ifndef __MR_PARSER_STACK__
+    if (mr_token_cursor_type(tokens) >= MR_TOKEN_PRIVATE_K && mr_token_cursor_type(tokens) <= MR_TOKEN_STATIC_K)
         return mr_parser_handle_var_assign(res, tokens);
-    if ((*tokens)->type >= MR_TOKEN_OBJECT_T)
+#endif
+    if (mr_token_cursor_type(tokens) >= MR_TOKEN_OBJECT_T)
     {
-        mr_token_t *ptr;
+#ifndef __MR_PARSER_STACK__
+        mr_byte_t next;
 
-        ptr = *tokens + 1;
-        if (ptr->type >= MR_TOKEN_PRIVATE_K && ptr->type <= MR_TOKEN_STATIC_K || ptr->type == MR_TOKEN_IDENTIFIER)
+        next = mr_token_cursor_peek(tokens);
+        if ((next >= MR_TOKEN_PRIVATE_K && next <= MR_TOKEN_STATIC_K) || next == MR_TOKEN_IDENTIFIER)
             return mr_parser_handle_var_assign(res, tokens);
+#endif
 
-        res->nodes[res->size] = (mr_node_t){.type=MR_NODE_TYPE, .value=*(mr_long_t*)*tokens};
+        res->nodes[res->size] = (mr_node_t){.type=MR_NODE_TYPE,
+            .value=MR_NODE_KEYWORD_MAKE(MR_IDX_EXTRACT(mr_token_cursor_idx(tokens)), mr_token_cursor_type(tokens), MR_TOKEN_TYPE_PAD)};
         mr_parser_advance_newline;
         return MR_NOERROR;
     }
@@ -875,109 +2167,101 @@ mr_byte_t mr_parser_core(
     return MR_ERROR_BAD_FORMAT;
 }
 
+#ifndef __MR_PARSER_STACK__
 mr_byte_t mr_parser_handle_call(
-    mr_parser_t *res, mr_token_t **tokens)
+    mr_parser_t *res, mr_token_cursor_t *tokens)
 {
-    mr_long_t ptr, idx;
-    mr_byte_t retcode, alloc;
+    mr_long_t ptr, args, base;
+    mr_byte_t retcode, size;
     mr_node_func_call_t *value;
-    mr_node_call_arg_t *args, *arg;
-    mr_node_t *node;
+    mr_node_call_arg_t arg;
+    mr_node_t *node, func;
 
     node = res->nodes + res->size;
-    if ((++*tokens)->type == MR_TOKEN_R_PAREN)
+    mr_token_cursor_next(tokens);
+    if (mr_token_cursor_type(tokens) == MR_TOKEN_R_PAREN)
     {
         mr_node_ex_func_call_t *ex_value;
 
-        retcode = mr_stack_push(&ptr, sizeof(mr_node_ex_func_call_t));
+        retcode = mr_node_push(&ptr, sizeof(mr_node_ex_func_call_t));
         if (retcode != MR_NOERROR)
             return retcode;
 
+        mr_token_cursor_next(tokens);
+
         ex_value = (mr_node_ex_func_call_t*)(_mr_stack.data + ptr);
-        *ex_value = (mr_node_ex_func_call_t){.func=*node, .eidx=(++*tokens)->idx};
+        *ex_value = (mr_node_ex_func_call_t){.func=*node, .eidx=mr_token_cursor_idx(tokens)};
 
         mr_parser_advance_newline;
 
-        *node = (mr_node_t){.type=MR_NODE_EX_FUNC_CALL, .value=ptr};
+        *node = mr_node_make(MR_NODE_EX_FUNC_CALL, ptr);
         return MR_NOERROR;
     }
 
-    retcode = mr_stack_push(&ptr, sizeof(mr_node_func_call_t));
-    if (retcode != MR_NOERROR)
-        return retcode;
-
-    retcode = mr_stack_palloc(&idx, MR_PARSER_FUNC_CALL_SIZE * sizeof(mr_node_call_arg_t));
-    if (retcode != MR_NOERROR)
-        return retcode;
+    func = *node;
+    base = _mr_stack.sptr;
 
-    value = (mr_node_func_call_t*)(_mr_stack.data + ptr);
-    value->func = *node;
-    value->size = 0;
-
-    alloc = MR_PARSER_FUNC_CALL_SIZE;
-
-    value->args = MR_IDX_DECOMPOSE(idx);
-    args = _mr_stack.ptrs[idx];
+    size = 0;
     do
-    {
-        if (value->size == alloc)
-        {
-            if (alloc == MR_PARSER_FUNC_CALL_MAX)
-            {
-                res->error = (mr_invalid_syntax_t){.detail="Number of function call arguments exceeds the limit", .token=*tokens};
-                return MR_ERROR_BAD_FORMAT;
-            }
-
-            retcode = mr_stack_prealloc(idx, (alloc += MR_PARSER_FUNC_CALL_SIZE) * sizeof(mr_node_call_arg_t));
-            if (retcode != MR_NOERROR)
-                return MR_ERROR_BAD_FORMAT;
-
-            args = _mr_stack.ptrs[idx];
+    {
+        if (size == MR_PARSER_FUNC_CALL_MAX)
+        {
+            res->error = (mr_invalid_syntax_t){.detail="Number of function call arguments exceeds the limit", .token=*tokens};
+            return MR_ERROR_BAD_FORMAT;
         }
 
-        arg = (mr_node_call_arg_t*)(args + value->size);
-        if ((*tokens)->type == MR_TOKEN_IDENTIFIER && (*tokens)[1].type == MR_TOKEN_ASSIGN)
+        if (mr_token_cursor_type(tokens) == MR_TOKEN_IDENTIFIER && mr_token_cursor_peek(tokens) == MR_TOKEN_ASSIGN)
         {
-            arg->name = (*tokens)->idx;
-            *tokens += 2;
+            arg.name = mr_token_cursor_idx(tokens);
+            mr_token_cursor_next(tokens);
+            mr_token_cursor_next(tokens);
         }
         else
-            arg->name = MR_INVALID_IDX;
+            arg.name = MR_INVALID_IDX;
 
         retcode = mr_parser_reassign(res, tokens);
         if (retcode != MR_NOERROR)
             return retcode;
 
-        arg->value = *node;
-        value->size++;
+        arg.value = *node;
+        retcode = mr_stack_scratch_push(&arg, sizeof(mr_node_call_arg_t));
+        if (retcode != MR_NOERROR)
+            return retcode;
 
-        if ((*tokens)->type != MR_TOKEN_COMMA)
+        size++;
+        if (mr_token_cursor_type(tokens) != MR_TOKEN_COMMA)
             break;
 
-        ++*tokens;
+        mr_token_cursor_next(tokens);
     } while (1);
 
-    if ((*tokens)->type != MR_TOKEN_R_PAREN)
+    if (mr_token_cursor_type(tokens) != MR_TOKEN_R_PAREN)
     {
         res->error = (mr_invalid_syntax_t){.detail="Expected ')' or ','", .token=*tokens};
         return MR_ERROR_BAD_FORMAT;
     }
 
-    if (value->size != alloc)
-    {
-        retcode = mr_stack_prealloc(idx, value->size * sizeof(mr_node_call_arg_t));
-        if (retcode != MR_NOERROR)
-            return retcode;
-    }
+    retcode = mr_stack_scratch_pop(&args, base);
+    if (retcode != MR_NOERROR)
+        return retcode;
+
+    retcode = mr_node_push(&ptr, sizeof(mr_node_func_call_t));
+    if (retcode != MR_NOERROR)
+        return retcode;
+
+    value = (mr_node_func_call_t*)(_mr_stack.data + ptr);
+    value->args = args;
+    value->size = size;
+    value->func = func;
 
     mr_parser_advance_newline;
 
-    *node = (mr_node_t){.type=MR_NODE_FUNC_CALL, .value=ptr};
+    *node = mr_node_make(MR_NODE_FUNC_CALL, ptr);
     return MR_NOERROR;
 }
 
 mr_byte_t mr_parser_handle_subscript(
-    mr_parser_t *res, mr_token_t **tokens)
+    mr_parser_t *res, mr_token_cursor_t *tokens)
 {
     mr_long_t ptr;
     mr_byte_t retcode;
@@ -987,29 +2271,30 @@ mr_byte_t mr_parser_handle_subscript(
     cnode = res->nodes + res->size;
     node = *cnode;
 
-    if ((++*tokens)->type != MR_TOKEN_COLON)
+    mr_token_cursor_next(tokens);
+    if (mr_token_cursor_type(tokens) != MR_TOKEN_COLON)
     {
         retcode = mr_parser_tuple(res, tokens);
         if (retcode != MR_NOERROR)
             return retcode;
 
-        if ((*tokens)->type == MR_TOKEN_R_SQUARE)
+        if (mr_token_cursor_type(tokens) == MR_TOKEN_R_SQUARE)
         {
             mr_node_subscript_t *ex_value;
 
-            retcode = mr_stack_push(&ptr, sizeof(mr_node_subscript_t));
+            retcode = mr_node_push(&ptr, sizeof(mr_node_subscript_t));
             if (retcode != MR_NOERROR)
                 return retcode;
 
             ex_value = (mr_node_subscript_t*)(_mr_stack.data + ptr);
-            *ex_value = (mr_node_subscript_t){.node=node, .idx=*cnode, .eidx=(*tokens)->idx};
+            *ex_value = (mr_node_subscript_t){.node=node, .idx=*cnode, .eidx=mr_token_cursor_idx(tokens)};
 
-            *cnode = (mr_node_t){.type=MR_NODE_SUBSCRIPT, .value=ptr};
+            *cnode = mr_node_make(MR_NODE_SUBSCRIPT, ptr);
             mr_parser_advance_newline;
             return MR_NOERROR;
         }
 
-        if ((*tokens)->type != MR_TOKEN_COLON)
+        if (mr_token_cursor_type(tokens) != MR_TOKEN_COLON)
         {
             res->error = (mr_invalid_syntax_t){.detail="Expected ']' or ':'", .token=*tokens};
             return MR_ERROR_BAD_FORMAT;
@@ -1020,11 +2305,12 @@ mr_byte_t mr_parser_handle_subscript(
     else
         start.type = MR_NODE_NULL;
 
-    if ((++*tokens)->type != MR_TOKEN_COLON)
+    mr_token_cursor_next(tokens);
+    if (mr_token_cursor_type(tokens) != MR_TOKEN_COLON)
     {
         mr_node_subscript_end_t *ex_value;
 
-        if ((*tokens)->type != MR_TOKEN_R_SQUARE)
+        if (mr_token_cursor_type(tokens) != MR_TOKEN_R_SQUARE)
         {
             retcode = mr_parser_tuple(res, tokens);
             if (retcode != MR_NOERROR)
@@ -1035,20 +2321,20 @@ mr_byte_t mr_parser_handle_subscript(
         else
             end.type = MR_NODE_NULL;
 
-        if ((*tokens)->type == MR_TOKEN_R_SQUARE)
+        if (mr_token_cursor_type(tokens) == MR_TOKEN_R_SQUARE)
         {
-            retcode = mr_stack_push(&ptr, sizeof(mr_node_subscript_end_t));
+            retcode = mr_node_push(&ptr, sizeof(mr_node_subscript_end_t));
             if (retcode != MR_NOERROR)
                 return retcode;
 
             ex_value = (mr_node_subscript_end_t*)(_mr_stack.data + ptr);
-            *ex_value = (mr_node_subscript_end_t){.node=node, .start=start, .end=end, .eidx=(*tokens)->idx};
+            *ex_value = (mr_node_subscript_end_t){.node=node, .start=start, .end=end, .eidx=mr_token_cursor_idx(tokens)};
 
-            *cnode = (mr_node_t){.type=MR_NODE_SUBSCRIPT_END, .value=ptr};
+            *cnode = mr_node_make(MR_NODE_SUBSCRIPT_END, ptr);
             mr_parser_advance_newline;
             return MR_NOERROR;
         }
-        if ((*tokens)->type != MR_TOKEN_COLON)
+        if (mr_token_cursor_type(tokens) != MR_TOKEN_COLON)
         {
             res->error = (mr_invalid_syntax_t){.detail="Expected ']' or ':'", .token=*tokens};
             return MR_ERROR_BAD_FORMAT;
@@ -1057,13 +2343,14 @@ mr_byte_t mr_parser_handle_subscript(
     else
         end.type = MR_NODE_NULL;
 
-    if ((++*tokens)->type != MR_TOKEN_R_SQUARE)
+    mr_token_cursor_next(tokens);
+    if (mr_token_cursor_type(tokens) != MR_TOKEN_R_SQUARE)
     {
         retcode = mr_parser_tuple(res, tokens);
         if (retcode != MR_NOERROR)
             return retcode;
 
-        if ((*tokens)->type != MR_TOKEN_R_SQUARE)
+        if (mr_token_cursor_type(tokens) != MR_TOKEN_R_SQUARE)
         {
             res->error = (mr_invalid_syntax_t){.detail="Expected ']'", .token=*tokens};
             return MR_ERROR_BAD_FORMAT;
@@ -1074,68 +2361,59 @@ mr_byte_t mr_parser_handle_subscript(
     else
         step.type = MR_NODE_NULL;
 
-    retcode = mr_stack_push(&ptr, sizeof(mr_node_subscript_step_t));
+    retcode = mr_node_push(&ptr, sizeof(mr_node_subscript_step_t));
     if (retcode != MR_NOERROR)
         return retcode;
 
     value = (mr_node_subscript_step_t*)(_mr_stack.data + ptr);
-    *value = (mr_node_subscript_step_t){.node=node, .start=start, .end=end, .step=step, .eidx=(*tokens)->idx};
+    *value = (mr_node_subscript_step_t){.node=node, .start=start, .end=end, .step=step, .eidx=mr_token_cursor_idx(tokens)};
 
-    *cnode = (mr_node_t){.type=MR_NODE_SUBSCRIPT_STEP, .value=ptr};
+    *cnode = mr_node_make(MR_NODE_SUBSCRIPT_STEP, ptr);
     mr_parser_advance_newline;
     return MR_NOERROR;
 }
 
 mr_byte_t mr_parser_handle_fstr(
-    mr_parser_t *res, mr_token_t **tokens)
+    mr_parser_t *res, mr_token_cursor_t *tokens)
 {
-    mr_long_t ptr, pidx, size, alloc;
+    mr_long_t ptr, elems, base, size;
     mr_byte_t retcode;
     mr_node_list_t *value;
-    mr_node_t *node, *elems;
+    mr_node_t *node, frag;
 
-    retcode = mr_stack_push(&ptr, sizeof(mr_node_list_t));
+    retcode = mr_node_push(&ptr, sizeof(mr_node_list_t));
     if (retcode != MR_NOERROR)
         return retcode;
 
     node = res->nodes + res->size;
     value = (mr_node_list_t*)(_mr_stack.data + ptr);
-    value->sidx = (*tokens)++->idx;
+    value->sidx = mr_token_cursor_idx(tokens);
+    mr_token_cursor_next(tokens);
 
-    if ((*tokens)->type == MR_TOKEN_FSTR_END)
+    if (mr_token_cursor_type(tokens) == MR_TOKEN_FSTR_END)
     {
         value->size = MR_ZERO_IDX;
-        value->eidx = (*tokens)->idx;
+        value->eidx = mr_token_cursor_idx(tokens);
 
-        *node = (mr_node_t){.type=MR_NODE_FSTR, .value=ptr};
+        *node = mr_node_make(MR_NODE_FSTR, ptr);
         mr_parser_advance_newline;
         return MR_NOERROR;
     }
 
-    retcode = mr_stack_palloc(&pidx, MR_PARSER_FSTR_SIZE * sizeof(mr_node_t));
-    if (retcode != MR_NOERROR)
-        return retcode;
-
-    value->elems = MR_IDX_DECOMPOSE(pidx);
-    elems = (mr_node_t*)_mr_stack.ptrs[pidx];
+    base = _mr_stack.sptr;
 
     size = 0;
-    alloc = MR_PARSER_FSTR_SIZE;
     do
     {
-        if (size == alloc)
+        if (mr_token_cursor_type(tokens) == MR_TOKEN_FSTR)
         {
-            retcode = mr_stack_prealloc(pidx, (alloc += MR_PARSER_FSTR_SIZE) * sizeof(mr_node_t));
+            frag = (mr_node_t){.type=MR_NODE_FSTR_FRAG, .value=MR_IDX_EXTRACT(mr_token_cursor_idx(tokens))};
+            retcode = mr_stack_scratch_push(&frag, sizeof(mr_node_t));
             if (retcode != MR_NOERROR)
                 return retcode;
 
-            elems = (mr_node_t*)_mr_stack.ptrs[pidx];
-        }
-
-        if ((*tokens)->type == MR_TOKEN_FSTR)
-        {
-            elems[size++] = (mr_node_t){.type=MR_NODE_FSTR_FRAG, .value=MR_IDX_EXTRACT((*tokens)->idx)};
-            ++*tokens;
+            size++;
+            mr_token_cursor_next(tokens);
             continue;
         }
 
@@ -1143,138 +2421,136 @@ mr_byte_t mr_parser_handle_fstr(
         if (retcode != MR_NOERROR)
             return retcode;
 
-        elems[size++] = *node;
-    }
-    while ((*tokens)->type != MR_TOKEN_FSTR_END);
-
-    if (size != alloc)
-    {
-        retcode = mr_stack_prealloc(pidx, size * sizeof(mr_node_t));
+        retcode = mr_stack_scratch_push(node, sizeof(mr_node_t));
         if (retcode != MR_NOERROR)
             return retcode;
+
+        size++;
     }
+    while (mr_token_cursor_type(tokens) != MR_TOKEN_FSTR_END);
+
+    retcode = mr_stack_scratch_pop(&elems, base);
+    if (retcode != MR_NOERROR)
+        return retcode;
 
+    value = (mr_node_list_t*)(_mr_stack.data + ptr);
+    value->elems = elems;
     value->size = MR_IDX_DECOMPOSE(size);
-    value->eidx = (*tokens)->idx;
+    value->eidx = mr_token_cursor_idx(tokens);
 
-    *node = (mr_node_t){.type=MR_NODE_FSTR, .value=ptr};
+    *node = mr_node_make(MR_NODE_FSTR, ptr);
     mr_parser_advance_newline;
     return MR_NOERROR;
 }
 
 mr_byte_t mr_parser_handle_list(
-    mr_parser_t *res, mr_token_t **tokens)
+    mr_parser_t *res, mr_token_cursor_t *tokens)
 {
-    mr_long_t ptr, pidx, size, alloc;
+    mr_long_t ptr, elems, base, size;
     mr_byte_t retcode;
     mr_node_list_t *value;
-    mr_node_t *node, *elems;
+    mr_node_t *node;
 
-    retcode = mr_stack_push(&ptr, sizeof(mr_node_list_t));
+    retcode = mr_node_push(&ptr, sizeof(mr_node_list_t));
     if (retcode != MR_NOERROR)
         return retcode;
 
     node = res->nodes + res->size;
     value = (mr_node_list_t*)(_mr_stack.data + ptr);
-    value->sidx = (*tokens)++->idx;
+    value->sidx = mr_token_cursor_idx(tokens);
+    mr_token_cursor_next(tokens);
 
-    if ((*tokens)->type == MR_TOKEN_R_SQUARE)
+    if (mr_token_cursor_type(tokens) == MR_TOKEN_R_SQUARE)
     {
         value->size = MR_ZERO_IDX;
-        value->eidx = (*tokens)->idx;
+        value->eidx = mr_token_cursor_idx(tokens);
 
-        *node = (mr_node_t){.type=MR_NODE_LIST, .value=ptr};
+        *node = mr_node_make(MR_NODE_LIST, ptr);
         mr_parser_advance_newline;
         return MR_NOERROR;
     }
 
-    retcode = mr_stack_palloc(&pidx, MR_PARSER_LIST_SIZE * sizeof(mr_node_t));
-    if (retcode != MR_NOERROR)
-        return retcode;
-
-    value->elems = MR_IDX_DECOMPOSE(pidx);
-    elems = (mr_node_t*)_mr_stack.ptrs[pidx];
+    base = _mr_stack.sptr;
 
     size = 0;
-    alloc = MR_PARSER_LIST_SIZE;
     do
     {
         retcode = mr_parser_reassign(res, tokens);
         if (retcode != MR_NOERROR)
             return retcode;
 
-        if (size == alloc)
-        {
-            retcode = mr_stack_prealloc(pidx, (alloc += MR_PARSER_LIST_SIZE) * sizeof(mr_node_t));
-            if (retcode != MR_NOERROR)
-                return retcode;
+        retcode = mr_stack_scratch_push(node, sizeof(mr_node_t));
+        if (retcode != MR_NOERROR)
+            return retcode;
 
-            elems = (mr_node_t*)_mr_stack.ptrs[pidx];
-        }
+        size++;
+        if (mr_token_cursor_type(tokens) != MR_TOKEN_COMMA)
+            break;
 
-        elems[size++] = *node;
-        if ((*tokens)->type != MR_TOKEN_COMMA || (++*tokens)->type == MR_TOKEN_R_SQUARE)
+        mr_token_cursor_next(tokens);
+        if (mr_token_cursor_type(tokens) == MR_TOKEN_R_SQUARE)
             break;
     } while (1);
 
-    if ((*tokens)->type != MR_TOKEN_R_SQUARE)
+    if (mr_token_cursor_type(tokens) != MR_TOKEN_R_SQUARE)
     {
         res->error = (mr_invalid_syntax_t){.detail="Expected ']' or ','", .token=*tokens};
         return MR_ERROR_BAD_FORMAT;
     }
 
-    if (size != alloc)
-    {
-        retcode = mr_stack_prealloc(pidx, size * sizeof(mr_node_t));
-        if (retcode != MR_NOERROR)
-            return retcode;
-    }
+    retcode = mr_stack_scratch_pop(&elems, base);
+    if (retcode != MR_NOERROR)
+        return retcode;
 
+    value = (mr_node_list_t*)(_mr_stack.data + ptr);
+    value->elems = elems;
     value->size = MR_IDX_DECOMPOSE(size);
-    value->eidx = (*tokens)->idx;
+    value->eidx = mr_token_cursor_idx(tokens);
 
-    *node = (mr_node_t){.type=MR_NODE_LIST, .value=ptr};
+    *node = mr_node_make(MR_NODE_LIST, ptr);
     mr_parser_advance_newline;
     return MR_NOERROR;
 }
 
 mr_byte_t mr_parser_handle_dict(
-    mr_parser_t *res, mr_token_t **tokens)
+    mr_parser_t *res, mr_token_cursor_t *tokens)
 {
-    mr_long_t ptr, pidx, size, alloc;
+    mr_long_t ptr, elems, base, size;
     mr_byte_t retcode;
-    mr_node_keyval_t *elems;
+    mr_node_keyval_t elem;
     mr_node_list_t *value;
     mr_node_t *node;
 
-    retcode = mr_stack_push(&ptr, sizeof(mr_node_list_t));
+    retcode = mr_node_push(&ptr, sizeof(mr_node_list_t));
     if (retcode != MR_NOERROR)
         return retcode;
 
     value = (mr_node_list_t*)(_mr_stack.data + ptr);
-    value->sidx = (*tokens)++->idx;
+    value->sidx = mr_token_cursor_idx(tokens);
+    mr_token_cursor_next(tokens);
 
-    if ((*tokens)->type == MR_TOKEN_R_CURLY)
+    if (mr_token_cursor_type(tokens) == MR_TOKEN_R_CURLY)
     {
         value->size = MR_ZERO_IDX;
-        value->eidx = (*tokens)->idx;
+        value->eidx = mr_token_cursor_idx(tokens);
 
-        res->nodes[res->size] = (mr_node_t){.type=MR_NODE_DICT, .value=ptr};
+        res->nodes[res->size] = mr_node_make(MR_NODE_DICT, ptr);
         mr_parser_advance_newline;
         return MR_NOERROR;
     }
-    if ((*tokens)->type == MR_TOKEN_COMMA)
+    if (mr_token_cursor_type(tokens) == MR_TOKEN_COMMA)
     {
-        if ((++*tokens)->type != MR_TOKEN_R_CURLY)
+        mr_token_cursor_next(tokens);
+        if (mr_token_cursor_type(tokens) != MR_TOKEN_R_CURLY)
         {
             res->error = (mr_invalid_syntax_t){.detail="Expected '}'", .token=*tokens};
             return MR_ERROR_BAD_FORMAT;
         }
 
         value->size = MR_ZERO_IDX;
-        value->eidx = (*tokens)->idx;
+        value->eidx = mr_token_cursor_idx(tokens);
 
-        res->nodes[res->size] = (mr_node_t){.type=MR_NODE_SET, .value=ptr};
+        res->nodes[res->size] = mr_node_make(MR_NODE_SET, ptr);
         mr_parser_advance_newline;
         return MR_NOERROR;
     }
@@ -1283,182 +2559,263 @@ mr_byte_t mr_parser_handle_dict(
     if (retcode != MR_NOERROR)
         return retcode;
 
-    if ((*tokens)->type == MR_TOKEN_COMMA)
+    if (mr_token_cursor_type(tokens) == MR_TOKEN_COMMA)
         return mr_parser_handle_set(res, tokens, ptr);
-    if ((*tokens)->type != MR_TOKEN_COLON)
+    if (mr_token_cursor_type(tokens) != MR_TOKEN_COLON)
     {
         res->error = (mr_invalid_syntax_t){.detail="Expected ':' or ','", .token=*tokens};
         return MR_ERROR_BAD_FORMAT;
     }
 
-    retcode = mr_stack_palloc(&pidx, MR_PARSER_DICT_SIZE * sizeof(mr_node_keyval_t));
-    if (retcode != MR_NOERROR)
-        return retcode;
-
-    value->elems = MR_IDX_DECOMPOSE(pidx);
-    elems = (mr_node_keyval_t*)_mr_stack.ptrs[pidx];
-
     node = res->nodes + res->size;
-    elems->key = *node;
+    elem.key = *node;
 
-    ++*tokens;
+    mr_token_cursor_next(tokens);
     retcode = mr_parser_reassign(res, tokens);
     if (retcode != MR_NOERROR)
         return retcode;
 
-    elems->value = *node;
+    elem.value = *node;
+
+    base = _mr_stack.sptr;
+    retcode = mr_stack_scratch_push(&elem, sizeof(mr_node_keyval_t));
+    if (retcode != MR_NOERROR)
+        return retcode;
 
     size = 1;
-    alloc = MR_PARSER_DICT_SIZE;
-    while ((*tokens)->type == MR_TOKEN_COMMA)
+    while (mr_token_cursor_type(tokens) == MR_TOKEN_COMMA)
     {
-        if ((++*tokens)->type == MR_TOKEN_R_CURLY)
+        mr_token_cursor_next(tokens);
+        if (mr_token_cursor_type(tokens) == MR_TOKEN_R_CURLY)
             break;
 
-        if (size == alloc)
-        {
-            retcode = mr_stack_prealloc(pidx, (alloc += MR_PARSER_DICT_SIZE) * sizeof(mr_node_keyval_t));
-            if (retcode != MR_NOERROR)
-                return retcode;
-
-            elems = (mr_node_keyval_t*)_mr_stack.ptrs[pidx];
-        }
-
         retcode = mr_parser_reassign(res, tokens);
         if (retcode != MR_NOERROR)
             return retcode;
 
-        if ((*tokens)->type != MR_TOKEN_COLON)
+        if (mr_token_cursor_type(tokens) != MR_TOKEN_COLON)
         {
             res->error = (mr_invalid_syntax_t){.detail="Expected ':'", .token=*tokens};
             return MR_ERROR_BAD_FORMAT;
         }
 
-        elems[size].key = *node;
+        elem.key = *node;
 
-        ++*tokens;
+        mr_token_cursor_next(tokens);
         retcode = mr_parser_reassign(res, tokens);
         if (retcode != MR_NOERROR)
             return retcode;
 
-        elems[size++].value = *node;
+        elem.value = *node;
+        retcode = mr_stack_scratch_push(&elem, sizeof(mr_node_keyval_t));
+        if (retcode != MR_NOERROR)
+            return retcode;
+
+        size++;
     }
 
-    if ((*tokens)->type != MR_TOKEN_R_CURLY)
+    if (mr_token_cursor_type(tokens) != MR_TOKEN_R_CURLY)
     {
         res->error = (mr_invalid_syntax_t){.detail="Expected '}' or ','", .token=*tokens};
         return MR_ERROR_BAD_FORMAT;
     }
 
-    if (size != alloc)
-    {
-        retcode = mr_stack_prealloc(pidx, size * sizeof(mr_node_keyval_t));
-        if (retcode != MR_NOERROR)
-            return retcode;
-    }
+    retcode = mr_stack_scratch_pop(&elems, base);
+    if (retcode != MR_NOERROR)
+        return retcode;
 
+    value = (mr_node_list_t*)(_mr_stack.data + ptr);
+    value->elems = elems;
     value->size = MR_IDX_DECOMPOSE(size);
-    value->eidx = (*tokens)->idx;
+    value->eidx = mr_token_cursor_idx(tokens);
 
-    *node = (mr_node_t){.type=MR_NODE_DICT, .value=ptr};
+    *node = mr_node_make(MR_NODE_DICT, ptr);
     mr_parser_advance_newline;
     return MR_NOERROR;
 }
 
 mr_byte_t mr_parser_handle_set(
-    mr_parser_t *res, mr_token_t **tokens, mr_long_t ptr)
+    mr_parser_t *res, mr_token_cursor_t *tokens, mr_long_t ptr)
 {
-    mr_long_t pidx, size, alloc;
+    mr_long_t elems, base, size;
     mr_byte_t retcode;
     mr_node_list_t *value;
-    mr_node_t *node, *elems;
+    mr_node_t *node;
 
-    retcode = mr_stack_palloc(&pidx, MR_PARSER_SET_SIZE * sizeof(mr_node_t));
+    node = res->nodes + res->size;
+    base = _mr_stack.sptr;
+
+    retcode = mr_stack_scratch_push(node, sizeof(mr_node_t));
     if (retcode != MR_NOERROR)
         return retcode;
 
-    value = (mr_node_list_t*)(_mr_stack.data + ptr);
-    value->elems = MR_IDX_DECOMPOSE(pidx);
-    elems = (mr_node_t*)_mr_stack.ptrs[pidx];
-
-    node = res->nodes + res->size;
-    *elems = *node;
-
     size = 1;
-    alloc = MR_PARSER_SET_SIZE;
     do
     {
-        if ((++*tokens)->type == MR_TOKEN_R_CURLY)
+        mr_token_cursor_next(tokens);
+        if (mr_token_cursor_type(tokens) == MR_TOKEN_R_CURLY)
             break;
 
-        if (size == alloc)
-        {
-            retcode = mr_stack_prealloc(pidx, (alloc += MR_PARSER_SET_SIZE) * sizeof(mr_node_t));
-            if (retcode != MR_NOERROR)
-                return retcode;
-
-            elems = (mr_node_t*)_mr_stack.ptrs[pidx];
-        }
-
         retcode = mr_parser_reassign(res, tokens);
         if (retcode != MR_NOERROR)
             return retcode;
 
-        elems[size++] = *node;
-    } while ((*tokens)->type == MR_TOKEN_COMMA);
+        retcode = mr_stack_scratch_push(node, sizeof(mr_node_t));
+        if (retcode != MR_NOERROR)
+            return retcode;
 
-    if ((*tokens)->type != MR_TOKEN_R_CURLY)
+        size++;
+    } while (mr_token_cursor_type(tokens) == MR_TOKEN_COMMA);
+
+    if (mr_token_cursor_type(tokens) != MR_TOKEN_R_CURLY)
     {
         res->error = (mr_invalid_syntax_t){.detail="Expected '}' or ','", .token=*tokens};
         return MR_ERROR_BAD_FORMAT;
     }
 
-    if (size != alloc)
-    {
-        retcode = mr_stack_prealloc(pidx, size * sizeof(mr_node_t));
-        if (retcode != MR_NOERROR)
-            return retcode;
-    }
+    retcode = mr_stack_scratch_pop(&elems, base);
+    if (retcode != MR_NOERROR)
+        return retcode;
 
+    value = (mr_node_list_t*)(_mr_stack.data + ptr);
+    value->elems = elems;
     value->size = MR_IDX_DECOMPOSE(size);
-    value->eidx = (*tokens)->idx;
+    value->eidx = mr_token_cursor_idx(tokens);
 
-    *node = (mr_node_t){.type=MR_NODE_SET, .value=ptr};
+    *node = mr_node_make(MR_NODE_SET, ptr);
     mr_parser_advance_newline;
     return MR_NOERROR;
 }
 
 mr_byte_t mr_parser_handle_var_assign(
-    mr_parser_t *res, mr_token_t **tokens)
+    mr_parser_t *res, mr_token_cursor_t *tokens)
 {
     mr_long_t ptr;
     mr_byte_t retcode;
-    mr_bool_t access, used_global, used_readonly, used_const, used_static;
+    mr_bool_t assigned;
     mr_node_var_assign_t *value;
     mr_node_t *node;
 
-    retcode = mr_stack_push(&ptr, sizeof(mr_node_var_assign_t));
+    retcode = mr_parser_var_assign_head(res, tokens, &ptr, &assigned);
+    if (retcode != MR_NOERROR || !assigned)
+        return retcode;
+
+    node = res->nodes + res->size;
+    retcode = mr_parser_tuple(res, tokens);
     if (retcode != MR_NOERROR)
         return retcode;
 
     value = (mr_node_var_assign_t*)(_mr_stack.data + ptr);
+    value->value = *node;
+    *node = mr_node_make(MR_NODE_VAR_ASSIGN, ptr);
+    return MR_NOERROR;
+}
+
+mr_byte_t mr_parser_handle_dollar_method(
+    mr_parser_t *res, mr_token_cursor_t *tokens)
+{
+    mr_long_t ptr, params, base;
+    mr_byte_t retcode, size;
+    mr_node_dollar_method_t *value;
+    mr_node_t *node;
+    mr_idx_t sidx, name;
+
+    node = res->nodes + res->size;
+    sidx = mr_token_cursor_idx(tokens);
+
+    mr_token_cursor_next(tokens);
+    if (mr_token_cursor_type(tokens) != MR_TOKEN_IDENTIFIER)
+    {
+        res->error = (mr_invalid_syntax_t){.detail="Expected an identifier", .token=*tokens};
+        return MR_ERROR_BAD_FORMAT;
+    }
+
+    name = mr_token_cursor_idx(tokens);
+    mr_parser_advance_newline;
+
+    if (mr_token_cursor_type(tokens) != MR_TOKEN_COLON)
+    {
+        mr_node_ex_dollar_method_t *ex_value;
+
+        retcode = mr_node_push(&ptr, sizeof(mr_node_ex_dollar_method_t));
+        if (retcode != MR_NOERROR)
+            return retcode;
+
+        ex_value = (mr_node_ex_dollar_method_t*)(_mr_stack.data + ptr);
+        *ex_value = (mr_node_ex_dollar_method_t){.name=name, .sidx=sidx};
+
+        *node = mr_node_make(MR_NODE_EX_DOLLAR_METHOD, ptr);
+        return MR_NOERROR;
+    }
+
+    base = _mr_stack.sptr;
+
+    size = 0;
+    do
+    {
+        if (size == MR_PARSER_DOLLAR_METHOD_MAX)
+        {
+            res->error = (mr_invalid_syntax_t){.detail="Number of dollar method parameters exceeds the limit", .token=*tokens};
+            return MR_ERROR_BAD_FORMAT;
+        }
+
+        mr_token_cursor_next(tokens);
+        retcode = mr_parser_reassign(res, tokens);
+        if (retcode != MR_NOERROR)
+            return retcode;
+
+        retcode = mr_stack_scratch_push(node, sizeof(mr_node_t));
+        if (retcode != MR_NOERROR)
+            return retcode;
+
+        size++;
+    } while (mr_token_cursor_type(tokens) == MR_TOKEN_COMMA);
+
+    retcode = mr_stack_scratch_pop(&params, base);
+    if (retcode != MR_NOERROR)
+        return retcode;
+
+    retcode = mr_node_push(&ptr, sizeof(mr_node_dollar_method_t));
+    if (retcode != MR_NOERROR)
+        return retcode;
+
+    value = (mr_node_dollar_method_t*)(_mr_stack.data + ptr);
+    *value = (mr_node_dollar_method_t){.params=params, .size=size, .name=name, .sidx=sidx};
+
+    *node = mr_node_make(MR_NODE_DOLLAR_METHOD, ptr);
+    return MR_NOERROR;
+}
+#endif
+
+mr_byte_t mr_parser_var_assign_head(
+    mr_parser_t *res, mr_token_cursor_t *tokens, mr_long_t *ptr, mr_bool_t *assigned)
+{
+    mr_byte_t retcode;
+    mr_bool_t access, used_global, used_readonly, used_const, used_static;
+    mr_node_var_assign_t *value;
+
+    retcode = mr_node_push(ptr, sizeof(mr_node_var_assign_t));
+    if (retcode != MR_NOERROR)
+        return retcode;
+
+    value = (mr_node_var_assign_t*)(_mr_stack.data + *ptr);
     *value = (mr_node_var_assign_t){.access=0, .is_global=MR_FALSE, .is_readonly=MR_FALSE,
-        .is_const=MR_FALSE, .is_static=MR_FALSE, .is_link=MR_FALSE, .type=MR_TOKEN_EOF, .sidx=(*tokens)->idx};
+        .is_const=MR_FALSE, .is_static=MR_FALSE, .is_link=MR_FALSE, .type=MR_TOKEN_EOF, .sidx=mr_token_cursor_idx(tokens)};
 
     access = used_global = used_readonly = used_const = used_static = MR_FALSE;
     while (1)
     {
-        if ((*tokens)->type >= MR_TOKEN_OBJECT_T)
+        if (mr_token_cursor_type(tokens) >= MR_TOKEN_OBJECT_T)
         {
             if (value->type != MR_TOKEN_EOF)
                 break;
 
-            value->type = (*tokens)->type;
+            value->type = mr_token_cursor_type(tokens);
             mr_parser_advance_newline;
             continue;
         }
 
-        switch ((*tokens)->type)
+        switch (mr_token_cursor_type(tokens))
         {
         case MR_TOKEN_PRIVATE_K:
         case MR_TOKEN_PUBLIC_K:
@@ -1466,7 +2823,8 @@ mr_byte_t mr_parser_handle_var_assign(
             if (access)
                 break;
 
-            value->access = (*tokens)++->type - MR_TOKEN_PRIVATE_K + 1;
+            value->access = mr_token_cursor_type(tokens) - MR_TOKEN_PRIVATE_K + 1;
+            mr_token_cursor_next(tokens);
             access = MR_TRUE;
             continue;
         case MR_TOKEN_GLOBAL_K:
@@ -1475,7 +2833,7 @@ mr_byte_t mr_parser_handle_var_assign(
 
             value->is_global = MR_TRUE;
             used_global = MR_TRUE;
-            ++*tokens;
+            mr_token_cursor_next(tokens);
             continue;
         case MR_TOKEN_READONLY_K:
             if (used_readonly)
@@ -1483,7 +2841,7 @@ mr_byte_t mr_parser_handle_var_assign(
 
             value->is_readonly = MR_TRUE;
             used_readonly = MR_TRUE;
-            ++*tokens;
+            mr_token_cursor_next(tokens);
             continue;
         case MR_TOKEN_CONST_K:
             if (used_const)
@@ -1491,7 +2849,7 @@ mr_byte_t mr_parser_handle_var_assign(
 
             value->is_const = MR_TRUE;
             used_const = MR_TRUE;
-            ++*tokens;
+            mr_token_cursor_next(tokens);
             continue;
         case MR_TOKEN_STATIC_K:
             if (used_static)
@@ -1499,185 +2857,86 @@ mr_byte_t mr_parser_handle_var_assign(
 
             value->is_static = MR_TRUE;
             used_static = MR_TRUE;
-            ++*tokens;
+            mr_token_cursor_next(tokens);
             continue;
         }
 
         break;
     }
 
-    if ((*tokens)->type != MR_TOKEN_IDENTIFIER)
+    if (mr_token_cursor_type(tokens) != MR_TOKEN_IDENTIFIER)
     {
         res->error = (mr_invalid_syntax_t){.detail="Expected an identifier", .token=*tokens};
         return MR_ERROR_BAD_FORMAT;
     }
 
-    node = res->nodes + res->size;
-    value->name = (*tokens)->idx;
+    value->name = mr_token_cursor_idx(tokens);
     mr_parser_advance_newline;
 
-    if ((*tokens)->type == MR_TOKEN_LINK)
+    if (mr_token_cursor_type(tokens) == MR_TOKEN_LINK)
         value->is_link = MR_TRUE;
-    else if ((*tokens)->type != MR_TOKEN_ASSIGN)
+    else if (mr_token_cursor_type(tokens) != MR_TOKEN_ASSIGN)
     {
         value->value.type = MR_NODE_NULL;
-        *node = (mr_node_t){.type=MR_NODE_VAR_ASSIGN, .value=ptr};
+        res->nodes[res->size] = mr_node_make(MR_NODE_VAR_ASSIGN, *ptr);
+
+        *assigned = MR_FALSE;
         return MR_NOERROR;
     }
 
-    ++*tokens;
-    retcode = mr_parser_tuple(res, tokens);
-    if (retcode != MR_NOERROR)
-        return retcode;
+    mr_token_cursor_next(tokens);
 
-    value->value = *node;
-    *node = (mr_node_t){.type=MR_NODE_VAR_ASSIGN, .value=ptr};
+    *assigned = MR_TRUE;
     return MR_NOERROR;
 }
 
-mr_byte_t mr_parser_handle_dollar_method(
-    mr_parser_t *res, mr_token_t **tokens)
+mr_byte_t mr_parser_handle_import(
+    mr_parser_t *res, mr_token_cursor_t *tokens, mr_byte_t type)
 {
-    mr_long_t ptr, pidx;
-    mr_byte_t retcode, alloc;
-    mr_node_dollar_method_t *value;
-    mr_node_t *node, *params;
-    mr_idx_t sidx, name;
-
-    node = res->nodes + res->size;
-    sidx = (*tokens)->idx;
-
-    if ((++*tokens)->type != MR_TOKEN_IDENTIFIER)
-    {
-        res->error = (mr_invalid_syntax_t){.detail="Expected an identifier", .token=*tokens};
-        return MR_ERROR_BAD_FORMAT;
-    }
-
-    name = (*tokens)->idx;
-    mr_parser_advance_newline;
-
-    if ((*tokens)->type != MR_TOKEN_COLON)
-    {
-        mr_node_ex_dollar_method_t *ex_value;
-
-        retcode = mr_stack_push(&ptr, sizeof(mr_node_ex_dollar_method_t));
-        if (retcode != MR_NOERROR)
-            return retcode;
-
-        ex_value = (mr_node_ex_dollar_method_t*)(_mr_stack.data + ptr);
-        *ex_value = (mr_node_ex_dollar_method_t){.name=name, .sidx=sidx};
-
-        *node = (mr_node_t){.type=MR_NODE_EX_DOLLAR_METHOD, .value=ptr};
-        return MR_NOERROR;
-    }
-
-    retcode = mr_stack_push(&ptr, sizeof(mr_node_dollar_method_t));
-    if (retcode != MR_NOERROR)
-        return retcode;
-
-    retcode = mr_stack_palloc(&pidx, MR_PARSER_DOLLAR_METHOD_SIZE * sizeof(mr_node_t));
-    if (retcode != MR_NOERROR)
-        return retcode;
+    mr_long_t ptr, libs, base;
+    mr_byte_t retcode, size;
+    mr_node_import_t *value;
+    mr_idx_t sidx, lib;
 
-    value = (mr_node_dollar_method_t*)(_mr_stack.data + ptr);
-    *value = (mr_node_dollar_method_t){.params=MR_IDX_DECOMPOSE(pidx), .size=0};
+    sidx = mr_token_cursor_idx(tokens);
+    base = _mr_stack.sptr;
 
-    params = (mr_node_t*)_mr_stack.ptrs[pidx];
-    alloc = MR_PARSER_DOLLAR_METHOD_SIZE;
+    size = 0;
     do
     {
-        if (value->size == alloc)
+        mr_token_cursor_next(tokens);
+        if (mr_token_cursor_type(tokens) != MR_TOKEN_IDENTIFIER)
         {
-            if (alloc == MR_PARSER_DOLLAR_METHOD_MAX)
-            {
-                res->error = (mr_invalid_syntax_t){.detail="Number of dollar method parameters exceeds the limit", .token=*tokens};
-                return MR_ERROR_BAD_FORMAT;
-            }
-
-            retcode = mr_stack_prealloc(pidx, (alloc += MR_PARSER_DOLLAR_METHOD_SIZE) * sizeof(mr_node_t));
-            if (retcode != MR_NOERROR)
-                return retcode;
-
-            params = (mr_node_t*)_mr_stack.ptrs[pidx];
+            res->error = (mr_invalid_syntax_t){.detail="Expected an identifier", .token=*tokens};
+            return MR_ERROR_BAD_FORMAT;
         }
 
-        ++*tokens;
-        retcode = mr_parser_reassign(res, tokens);
-        if (retcode != MR_NOERROR)
-            return retcode;
-
-        params[value->size++] = *node;
-    } while ((*tokens)->type == MR_TOKEN_COMMA);
+        if (size == MR_PARSER_IMPORT_MAX)
+        {
+            res->error = (mr_invalid_syntax_t){.detail="Number of libraries exceeds the limit", .token=*tokens};
+            return MR_ERROR_BAD_FORMAT;
+        }
 
-    if (value->size != alloc)
-    {
-        retcode = mr_stack_prealloc(pidx, value->size * sizeof(mr_node_t));
+        lib = mr_token_cursor_idx(tokens);
+        retcode = mr_stack_scratch_push(&lib, sizeof(mr_idx_t));
         if (retcode != MR_NOERROR)
             return retcode;
-    }
 
-    value->name = name;
-    value->sidx = sidx;
-
-    *node = (mr_node_t){.type=MR_NODE_DOLLAR_METHOD, .value=ptr};
-    return MR_NOERROR;
-}
-
-mr_byte_t mr_parser_handle_import(
-    mr_parser_t *res, mr_token_t **tokens, mr_byte_t type)
-{
-    mr_long_t ptr, pidx;
-    mr_byte_t retcode, alloc;
-    mr_idx_t *libs;
-    mr_node_import_t *value;
+        size++;
+        mr_parser_advance_newline;
+    } while (mr_token_cursor_type(tokens) == MR_TOKEN_COMMA);
 
-    retcode = mr_stack_push(&ptr, sizeof(mr_node_import_t));
+    retcode = mr_stack_scratch_pop(&libs, base);
     if (retcode != MR_NOERROR)
         return retcode;
 
-    retcode = mr_stack_palloc(&pidx, MR_PARSER_IMPORT_SIZE * sizeof(mr_idx_t));
+    retcode = mr_node_push(&ptr, sizeof(mr_node_import_t));
     if (retcode != MR_NOERROR)
         return retcode;
 
     value = (mr_node_import_t*)(_mr_stack.data + ptr);
-    *value = (mr_node_import_t){.libs=MR_IDX_DECOMPOSE(pidx), .size=0, .sidx=(*tokens)->idx};
-
-    libs = (mr_idx_t*)_mr_stack.ptrs[pidx];
-    alloc = MR_PARSER_IMPORT_SIZE;
-    do
-    {
-        if ((++*tokens)->type != MR_TOKEN_IDENTIFIER)
-        {
-            res->error = (mr_invalid_syntax_t){.detail="Expected an identifier", .token=*tokens};
-            return MR_ERROR_BAD_FORMAT;
-        }
-
-        if (value->size == alloc)
-        {
-            if (alloc == MR_PARSER_IMPORT_MAX)
-            {
-                res->error = (mr_invalid_syntax_t){.detail="Number of libraries exceeds the limit", .token=*tokens};
-                return MR_ERROR_BAD_FORMAT;
-            }
-
-            retcode = mr_stack_prealloc(pidx, (alloc += MR_PARSER_IMPORT_SIZE) * sizeof(mr_idx_t));
-            if (retcode != MR_NOERROR)
-                return retcode;
-
-            libs = (mr_idx_t*)_mr_stack.ptrs[pidx];
-        }
-
-        libs[value->size++] = (*tokens)->idx;
-        mr_parser_advance_newline;
-    } while ((*tokens)->type == MR_TOKEN_COMMA);
-
-    if (value->size != alloc)
-    {
-        retcode = mr_stack_prealloc(pidx, value->size * sizeof(mr_idx_t));
-        if (retcode != MR_NOERROR)
-            return retcode;
-    }
+    *value = (mr_node_import_t){.libs=libs, .size=size, .sidx=sidx};
 
-    res->nodes[res->size] = (mr_node_t){.type=type, .value=ptr};
+    res->nodes[res->size] = mr_node_make(type, ptr);
     return MR_NOERROR;
 }
@@ -0,0 +1,1248 @@
+/*
+MIT License
+
+Copyright (c) 2023 MetaReal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+*/
+
+/**
+ * @file pool.c
+ * This file contains definitions of the \a pool.h file.
+*/
+
+#include <pool.h>
+#include <mem.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <consts.h>
+#include <config.h>
+
+#if (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || \
+    defined(_M_X64) || defined(_M_IX86) || defined(_M_ARM64)
+#define __MR_POOL_SWAR__
+#endif
+
+/**
+ * Size of the buffer that floating point literals are copied into (without underscores) before being converted. \n
+ * Longer literals are copied into a dynamically allocated buffer.
+*/
+#define MR_POOL_FLOAT_SIZE 64
+
+/**
+ * Largest integer that a double holds exactly along with all smaller ones (2^53).
+*/
+#define MR_POOL_FLOAT_EXACT ((uint64_t)1 << 53)
+
+/**
+ * Largest power of ten that a double holds exactly.
+*/
+#define MR_POOL_FLOAT_POW10 22
+
+/**
+ * Largest integer that can be multiplied by 10^8 and added to an 8 digit number without an overflow.
+*/
+#define MR_POOL_INT_LIMIT8 ((uint64_t)184467440736)
+
+/**
+ * Largest integer that can be multiplied by 10 and added to a digit without an overflow.
+*/
+#define MR_POOL_INT_LIMIT1 ((uint64_t)1844674407370955160)
+
+/**
+ * @def mr_pool_const_hash(val)
+ * It hashes a constant (Fibonacci hashing over its type and value bits).
+ * @param val
+ * The constant.
+*/
+#define mr_pool_const_hash(val) \
+    ((mr_long_t)((((val).value.i ^ ((uint64_t)(val).type << 56)) * 0x9e3779b97f4a7c15u) >> 32))
+
+mr_pool_consts_t _mr_pool_consts = {.data=NULL, .size=0, .alloc=0,
+    .table=NULL, .mask=0, .refs={.data=NULL, .size=0, .alloc=0}};
+mr_pool_strs_t _mr_pool_strs = {.data=NULL, .size=0, .alloc=0, .arena=NULL, .asize=0, .aalloc=0,
+    .table=NULL, .mask=0, .refs={.data=NULL, .size=0, .alloc=0}, .copy=MR_FALSE};
+mr_pool_syms_t _mr_pool_syms = {.data=NULL, .size=0, .alloc=0, .names=NULL, .nsize=0, .nalloc=0,
+    .table=NULL, .mask=0, .refs={.data=NULL, .size=0, .alloc=0}};
+
+/**
+ * Powers of ten that a double holds exactly.
+*/
+static const double mr_pool_pow10[MR_POOL_FLOAT_POW10 + 1] =
+{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/**
+ * It finds the slot of a constant and adds the constant to the pool if it doesn't exist.
+ * @param id
+ * Index of the slot.
+ * @param pool
+ * The constant pool.
+ * @param value
+ * The constant.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em>.
+*/
+mr_byte_t mr_pool_consts_intern(
+    mr_long_t *id, mr_pool_consts_t *pool, mr_pool_const_t value);
+
+/**
+ * It doubles the number of buckets in the hash table and rehashes the constants.
+ * @param pool
+ * The constant pool.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em>.
+*/
+mr_byte_t mr_pool_consts_rehash(
+    mr_pool_consts_t *pool);
+
+/**
+ * It finds the slot of a symbol and interns the symbol if it doesn't exist.
+ * @param id
+ * The symbol ID.
+ * @param pool
+ * The symbol pool.
+ * @param str
+ * Starting point of the identifier.
+ * @param size
+ * Size of the identifier in characters.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em>.
+*/
+mr_byte_t mr_pool_syms_intern(
+    mr_long_t *id, mr_pool_syms_t *pool, mr_str_ct str, mr_long_t size);
+
+/**
+ * It doubles the number of buckets in the hash table and rehashes the symbols.
+ * @param pool
+ * The symbol pool.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em>.
+*/
+mr_byte_t mr_pool_syms_rehash(
+    mr_pool_syms_t *pool);
+
+/**
+ * It finds the slot of a literal and interns the literal if it doesn't exist. \n
+ * A new literal is copied into the \a arena list if it's not a slice.
+ * @param id
+ * The string ID.
+ * @param pool
+ * The string pool.
+ * @param str
+ * Starting point of the literal (it can't be a part of the \a arena list).
+ * @param size
+ * Size of the literal in characters.
+ * @param esc
+ * It indicates that the literal contains escape sequences.
+ * @param slice
+ * It indicates that the \a str is a part of <em>_mr_config.code</em> and it's kept as a slice.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em>.
+*/
+mr_byte_t mr_pool_strs_intern(
+    mr_long_t *id, mr_pool_strs_t *pool, mr_str_ct str, mr_long_t size, mr_bool_t esc, mr_bool_t slice);
+
+/**
+ * It returns the characters of a literal as they're written in the source code.
+ * @param pool
+ * The string pool.
+ * @param id
+ * The string ID.
+ * @return It returns the first character of the literal.
+*/
+mr_str_ct mr_pool_strs_literal(
+    mr_pool_strs_t *pool, mr_long_t id);
+
+/**
+ * It doubles the number of buckets in the hash table and rehashes the strings.
+ * @param pool
+ * The string pool.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em>.
+*/
+mr_byte_t mr_pool_strs_rehash(
+    mr_pool_strs_t *pool);
+
+/**
+ * It makes sure that the \a arena list has room for \a size more characters.
+ * @param pool
+ * The string pool.
+ * @param size
+ * Number of characters that are going to be added.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em>.
+*/
+mr_byte_t mr_pool_arena_reserve(
+    mr_pool_strs_t *pool, mr_long_t size);
+
+/**
+ * It hashes a string (8 characters at a time).
+ * @param str
+ * Starting point of the string.
+ * @param size
+ * Size of the string in characters.
+ * @return It returns the hash.
+*/
+mr_long_t mr_pool_hash_str(
+    mr_str_ct str, mr_long_t size);
+
+/**
+ * It makes sure that the \a refs list has room for \a size more references.
+ * @param refs
+ * The references list.
+ * @param size
+ * Number of references that are going to be added.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em>.
+*/
+mr_byte_t mr_pool_refs_reserve(
+    mr_pool_refs_t *refs, mr_long_t size);
+
+/**
+ * It appends the references of the \a src to the <em>refs</em>, Replacing their slot indices using the \a ids list.
+ * @param refs
+ * The references list.
+ * @param src
+ * The appended references.
+ * @param ids
+ * New slot index of every old slot index.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em>.
+*/
+mr_byte_t mr_pool_refs_append(
+    mr_pool_refs_t *refs, mr_pool_refs_t *src, mr_long_t *ids);
+
+/**
+ * It finds the position of the first reference that starts at or after the <em>idx</em>.
+ * @param refs
+ * The references list.
+ * @param idx
+ * Index in the source code.
+ * @return It returns the position in the \a data list (equal to its size if all references start before the <em>idx</em>).
+*/
+mr_long_t mr_pool_refs_bound(
+    mr_pool_refs_t *refs, mr_long_t idx);
+
+/**
+ * It finds the slot referenced from the <em>idx</em>.
+ * @param refs
+ * The references list.
+ * @param idx
+ * Starting index of the literal or identifier in the source code.
+ * @return It returns index of the slot, Or <em>MR_INVALID_IDX_CODE</em> if there is no reference from the <em>idx</em>.
+*/
+mr_long_t mr_pool_refs_find(
+    mr_pool_refs_t *refs, mr_long_t idx);
+
+/**
+ * It converts a floating point literal with the fast path of the \a mr_pool_decode_float function.
+ * @param res
+ * The decoded number.
+ * @param str
+ * Starting point of the literal.
+ * @param size
+ * Size of the literal in characters.
+ * @return It returns \a MR_TRUE if the literal is converted and \a MR_FALSE if it's not eligible for the fast path.
+*/
+mr_bool_t mr_pool_decode_float_fast(
+    double *res, mr_str_ct str, mr_long_t size);
+
+#ifdef __MR_POOL_SWAR__
+/**
+ * It checks whether all 8 characters of the <em>chunk</em> are digits.
+ * @param chunk
+ * 8 characters loaded as a little endian integer.
+ * @return It returns \a MR_TRUE if all characters are digits and \a MR_FALSE otherwise.
+*/
+mr_bool_t mr_pool_swar_digits(
+    uint64_t chunk);
+
+/**
+ * It converts 8 digits into an integer at once.
+ * @param chunk
+ * 8 digits loaded as a little endian integer.
+ * @return It returns the converted integer.
+*/
+uint64_t mr_pool_swar_parse(
+    uint64_t chunk);
+#endif
+
+mr_byte_t mr_pool_consts_add(
+    mr_pool_consts_t *pool, mr_long_t idx, mr_pool_const_t value)
+{
+    mr_long_t id;
+
+    if (mr_pool_refs_reserve(&pool->refs, 1) || mr_pool_consts_intern(&id, pool, value))
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    pool->refs.data[pool->refs.size++] = (mr_pool_ref_t){.idx=idx, .id=id};
+    return MR_NOERROR;
+}
+
+mr_byte_t mr_pool_consts_merge(
+    mr_pool_consts_t *pool, mr_pool_consts_t *src)
+{
+    mr_long_t i;
+    mr_long_t *ids;
+
+    if (!pool->refs.size && !pool->size)
+    {
+        mr_pool_consts_free(pool);
+
+        *pool = *src;
+        *src = MR_POOL_CONSTS_EMPTY;
+        return MR_NOERROR;
+    }
+
+    if (!src->refs.size)
+    {
+        mr_pool_consts_free(src);
+        return MR_NOERROR;
+    }
+
+    ids = mr_mem_malloc(MR_MEM_LEXER, src->size * sizeof(mr_long_t));
+    if (!ids)
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    for (i = 0; i != src->size; i++)
+        if (mr_pool_consts_intern(ids + i, pool, src->data[i]))
+        {
+            mr_mem_free(ids);
+            return MR_ERROR_NOT_ENOUGH_MEMORY;
+        }
+
+    if (mr_pool_refs_append(&pool->refs, &src->refs, ids))
+    {
+        mr_mem_free(ids);
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+    }
+
+    mr_mem_free(ids);
+    mr_pool_consts_free(src);
+    return MR_NOERROR;
+}
+
+void mr_pool_consts_rollback(
+    mr_pool_consts_t *pool, mr_long_t size, mr_long_t rsize)
+{
+    mr_long_t bucket;
+
+    /* Constants are removed in the reverse order of their addition, So probe sequences of the remaining ones stay intact. */
+    for (; pool->size > size; pool->size--)
+    {
+        bucket = mr_pool_const_hash(pool->data[pool->size - 1]) & pool->mask;
+        while (pool->table[bucket].id != pool->size)
+            bucket = (bucket + 1) & pool->mask;
+
+        pool->table[bucket].id = 0;
+    }
+
+    pool->refs.size = rsize;
+}
+
+mr_long_t mr_pool_consts_find(
+    mr_pool_consts_t *pool, mr_long_t idx)
+{
+    return mr_pool_refs_find(&pool->refs, idx);
+}
+
+void mr_pool_consts_free(
+    mr_pool_consts_t *pool)
+{
+    mr_mem_free(pool->data);
+    mr_mem_free(pool->table);
+    mr_mem_free(pool->refs.data);
+
+    *pool = MR_POOL_CONSTS_EMPTY;
+}
+
+mr_byte_t mr_pool_syms_add(
+    mr_pool_syms_t *pool, mr_long_t idx, mr_str_ct str, mr_long_t size)
+{
+    mr_long_t id;
+
+    if (mr_pool_refs_reserve(&pool->refs, 1) || mr_pool_syms_intern(&id, pool, str, size))
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    pool->refs.data[pool->refs.size++] = (mr_pool_ref_t){.idx=idx, .id=id};
+    return MR_NOERROR;
+}
+
+mr_byte_t mr_pool_syms_merge(
+    mr_pool_syms_t *pool, mr_pool_syms_t *src)
+{
+    mr_long_t i;
+    mr_long_t *ids;
+
+    if (!pool->refs.size && !pool->size)
+    {
+        mr_pool_syms_free(pool);
+
+        *pool = *src;
+        *src = MR_POOL_SYMS_EMPTY;
+        return MR_NOERROR;
+    }
+
+    if (!src->refs.size)
+    {
+        mr_pool_syms_free(src);
+        return MR_NOERROR;
+    }
+
+    ids = mr_mem_malloc(MR_MEM_LEXER, src->size * sizeof(mr_long_t));
+    if (!ids)
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    for (i = 0; i != src->size; i++)
+        if (mr_pool_syms_intern(ids + i, pool, src->names + src->data[i].name, src->data[i].size))
+        {
+            mr_mem_free(ids);
+            return MR_ERROR_NOT_ENOUGH_MEMORY;
+        }
+
+    if (mr_pool_refs_append(&pool->refs, &src->refs, ids))
+    {
+        mr_mem_free(ids);
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+    }
+
+    mr_mem_free(ids);
+    mr_pool_syms_free(src);
+    return MR_NOERROR;
+}
+
+void mr_pool_syms_rollback(
+    mr_pool_syms_t *pool, mr_long_t size, mr_long_t rsize)
+{
+    mr_long_t bucket;
+    mr_pool_sym_t *sym;
+
+    /* Symbols are removed in the reverse order of their addition, So probe sequences of the remaining ones stay intact. */
+    for (; pool->size > size; pool->size--)
+    {
+        sym = pool->data + pool->size - 1;
+
+        bucket = mr_pool_hash_str(pool->names + sym->name, sym->size) & pool->mask;
+        while (pool->table[bucket].id != pool->size)
+            bucket = (bucket + 1) & pool->mask;
+
+        pool->table[bucket].id = 0;
+        pool->nsize = sym->name;
+    }
+
+    pool->refs.size = rsize;
+}
+
+mr_long_t mr_pool_syms_find(
+    mr_pool_syms_t *pool, mr_long_t idx)
+{
+    return mr_pool_refs_find(&pool->refs, idx);
+}
+
+void mr_pool_syms_free(
+    mr_pool_syms_t *pool)
+{
+    mr_mem_free(pool->data);
+    mr_mem_free(pool->names);
+    mr_mem_free(pool->table);
+    mr_mem_free(pool->refs.data);
+
+    *pool = MR_POOL_SYMS_EMPTY;
+}
+
+mr_byte_t mr_pool_strs_add(
+    mr_pool_strs_t *pool, mr_long_t idx, mr_str_ct str, mr_long_t size, mr_bool_t esc)
+{
+    mr_long_t id;
+
+    if (mr_pool_refs_reserve(&pool->refs, 1))
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    esc = esc && memchr(str, '\\', size);
+    if (mr_pool_strs_intern(&id, pool, str, size, esc, !pool->copy))
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    pool->refs.data[pool->refs.size++] = (mr_pool_ref_t){.idx=idx, .id=id};
+    return MR_NOERROR;
+}
+
+mr_byte_t mr_pool_strs_merge(
+    mr_pool_strs_t *pool, mr_pool_strs_t *src)
+{
+    mr_long_t i;
+    mr_long_t *ids;
+    mr_pool_str_t *str;
+
+    if (!pool->refs.size && !pool->size)
+    {
+        src->copy = pool->copy;
+        mr_pool_strs_free(pool);
+
+        *pool = *src;
+        *src = MR_POOL_STRS_EMPTY;
+        return MR_NOERROR;
+    }
+
+    if (!src->refs.size)
+    {
+        mr_pool_strs_free(src);
+        return MR_NOERROR;
+    }
+
+    ids = mr_mem_malloc(MR_MEM_LEXER, src->size * sizeof(mr_long_t));
+    if (!ids)
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    for (i = 0; i != src->size; i++)
+    {
+        str = src->data + i;
+        if (mr_pool_strs_intern(ids + i, pool, mr_pool_strs_literal(src, i), str->size, str->esc, str->slice))
+            break;
+    }
+
+    if (i != src->size || mr_pool_refs_append(&pool->refs, &src->refs, ids))
+    {
+        mr_mem_free(ids);
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+    }
+
+    mr_mem_free(ids);
+    mr_pool_strs_free(src);
+    return MR_NOERROR;
+}
+
+void mr_pool_strs_rollback(
+    mr_pool_strs_t *pool, mr_long_t size, mr_long_t rsize)
+{
+    mr_long_t bucket;
+    mr_pool_str_t *str;
+
+    /* Strings are removed in the reverse order of their addition, So probe sequences of the remaining ones stay intact. */
+    for (; pool->size > size; pool->size--)
+    {
+        str = pool->data + pool->size - 1;
+
+        bucket = mr_pool_hash_str(mr_pool_strs_literal(pool, pool->size - 1), str->size) & pool->mask;
+        while (pool->table[bucket].id != pool->size)
+            bucket = (bucket + 1) & pool->mask;
+
+        pool->table[bucket].id = 0;
+        if (!str->slice)
+            pool->asize = str->start;
+    }
+
+    pool->refs.size = rsize;
+}
+
+mr_long_t mr_pool_strs_find(
+    mr_pool_strs_t *pool, mr_long_t idx)
+{
+    return mr_pool_refs_find(&pool->refs, idx);
+}
+
+mr_str_ct mr_pool_strs_get(
+    mr_long_t *size, mr_pool_strs_t *pool, mr_long_t id)
+{
+    mr_long_t i, j;
+    mr_pool_str_t *str;
+    mr_str_ct lit;
+    mr_str_t dst;
+
+    str = pool->data + id;
+    if (!str->esc)
+    {
+        *size = str->size;
+        return mr_pool_strs_literal(pool, id);
+    }
+
+    if (str->value == MR_INVALID_IDX_CODE)
+    {
+        /* Decoded strings are never longer than their literals. */
+        if (mr_pool_arena_reserve(pool, str->size))
+            return NULL;
+
+        lit = mr_pool_strs_literal(pool, id);
+        dst = pool->arena + pool->asize;
+        for (i = j = 0; i != str->size; i++)
+            dst[j++] = lit[i] == '\\' ? mr_pool_escape(lit[++i]) : lit[i];
+
+        str->value = pool->asize;
+        str->vsize = j;
+        pool->asize += j;
+    }
+
+    *size = str->vsize;
+    return pool->arena + str->value;
+}
+
+mr_byte_t mr_pool_strs_edit(
+    mr_pool_strs_t *pool, mr_long_t start, mr_long_t end, mr_long_t delta)
+{
+    mr_long_t i;
+    mr_pool_str_t *str;
+
+    for (i = 0; i != pool->size; i++)
+    {
+        str = pool->data + i;
+        if (!str->slice || str->start + str->size <= start || str->start >= end)
+            continue;
+
+        if (mr_pool_arena_reserve(pool, str->size))
+            return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+        memcpy(pool->arena + pool->asize, _mr_config.code + str->start, str->size * sizeof(mr_chr_t));
+        str->start = pool->asize;
+        str->slice = MR_FALSE;
+        pool->asize += str->size;
+    }
+
+    if (delta)
+        for (i = 0; i != pool->size; i++)
+        {
+            str = pool->data + i;
+            if (str->slice && str->start >= end)
+                str->start += delta;
+        }
+
+    return MR_NOERROR;
+}
+
+void mr_pool_strs_free(
+    mr_pool_strs_t *pool)
+{
+    mr_mem_free(pool->data);
+    mr_mem_free(pool->arena);
+    mr_mem_free(pool->table);
+    mr_mem_free(pool->refs.data);
+
+    *pool = MR_POOL_STRS_EMPTY;
+}
+
+size_t mr_pool_unused(void)
+{
+    size_t size;
+
+    size = (_mr_pool_consts.alloc - _mr_pool_consts.size) * sizeof(mr_pool_const_t);
+    size += (_mr_pool_consts.refs.alloc - _mr_pool_consts.refs.size) * sizeof(mr_pool_ref_t);
+
+    size += (_mr_pool_syms.alloc - _mr_pool_syms.size) * sizeof(mr_pool_sym_t);
+    size += (_mr_pool_syms.nalloc - _mr_pool_syms.nsize) * sizeof(mr_chr_t);
+    size += (_mr_pool_syms.refs.alloc - _mr_pool_syms.refs.size) * sizeof(mr_pool_ref_t);
+
+    size += (_mr_pool_strs.alloc - _mr_pool_strs.size) * sizeof(mr_pool_str_t);
+    size += (_mr_pool_strs.aalloc - _mr_pool_strs.asize) * sizeof(mr_chr_t);
+    size += (_mr_pool_strs.refs.alloc - _mr_pool_strs.refs.size) * sizeof(mr_pool_ref_t);
+    return size;
+}
+
+mr_byte_t mr_pool_refs_splice(
+    mr_pool_refs_t *refs, mr_long_t start, mr_long_t end, mr_pool_refs_t *src, mr_long_t delta)
+{
+    mr_long_t first, last, i;
+
+    first = mr_pool_refs_bound(refs, start);
+    last = mr_pool_refs_bound(refs, end);
+
+    if (src->size > last - first && mr_pool_refs_reserve(refs, src->size - (last - first)))
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    if (last != refs->size)
+        memmove(refs->data + first + src->size, refs->data + last, (refs->size - last) * sizeof(mr_pool_ref_t));
+    if (src->size)
+        memcpy(refs->data + first, src->data, src->size * sizeof(mr_pool_ref_t));
+
+    refs->size = refs->size - (last - first) + src->size;
+    if (delta)
+        for (i = first + src->size; i != refs->size; i++)
+            refs->data[i].idx += delta;
+
+    mr_mem_free(src->data);
+    *src = MR_POOL_REFS_EMPTY;
+    return MR_NOERROR;
+}
+
+mr_bool_t mr_pool_decode_int(
+    uint64_t *res, mr_str_ct str, mr_long_t size)
+{
+    uint64_t value, digit;
+    mr_long_t i;
+#ifdef __MR_POOL_SWAR__
+    uint64_t chunk;
+#endif
+
+    value = 0;
+    for (i = 0; i != size;)
+    {
+#ifdef __MR_POOL_SWAR__
+        if (size - i >= 8)
+        {
+            memcpy(&chunk, str + i, sizeof(uint64_t));
+            if (mr_pool_swar_digits(chunk))
+            {
+                digit = mr_pool_swar_parse(chunk);
+                if (value > MR_POOL_INT_LIMIT8 && value > (UINT64_MAX - digit) / 100000000)
+                    return MR_FALSE;
+
+                value = value * 100000000 + digit;
+                i += 8;
+                continue;
+            }
+        }
+#endif
+
+        if (str[i] == '_')
+        {
+            i++;
+            continue;
+        }
+
+        digit = (uint64_t)(str[i++] - '0');
+        if (value > MR_POOL_INT_LIMIT1 && value > (UINT64_MAX - digit) / 10)
+            return MR_FALSE;
+
+        value = value * 10 + digit;
+    }
+
+    *res = value;
+    return MR_TRUE;
+}
+
+mr_byte_t mr_pool_decode_float(
+    double *res, mr_str_ct str, mr_long_t size)
+{
+    mr_chr_t buffer[MR_POOL_FLOAT_SIZE];
+    mr_str_t num;
+    mr_long_t i, j;
+
+    if (mr_pool_decode_float_fast(res, str, size))
+        return MR_NOERROR;
+
+    num = buffer;
+    if (size >= MR_POOL_FLOAT_SIZE)
+    {
+        num = mr_mem_malloc(MR_MEM_LEXER, (size + 1) * sizeof(mr_chr_t));
+        if (!num)
+            return MR_ERROR_NOT_ENOUGH_MEMORY;
+    }
+
+    for (i = j = 0; i != size; i++)
+        if (str[i] != '_')
+            num[j++] = str[i];
+    num[j] = '\0';
+
+    *res = strtod(num, NULL);
+
+    if (num != buffer)
+        mr_mem_free(num);
+    return MR_NOERROR;
+}
+
+mr_chr_t mr_pool_escape(
+    mr_chr_t chr)
+{
+    switch (chr)
+    {
+    case 'a':
+        return '\a';
+    case 'b':
+        return '\b';
+    case 'f':
+        return '\f';
+    case 'n':
+        return '\n';
+    case 'r':
+        return '\r';
+    case 't':
+        return '\t';
+    case 'v':
+        return '\v';
+    case '0':
+        return '\0';
+    default:
+        return chr;
+    }
+}
+
+mr_byte_t mr_pool_consts_intern(
+    mr_long_t *id, mr_pool_consts_t *pool, mr_pool_const_t value)
+{
+    mr_long_t hash, bucket, slot;
+    mr_pool_const_t *block;
+
+    if (pool->size * 2 >= pool->mask && mr_pool_consts_rehash(pool))
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    hash = mr_pool_const_hash(value);
+    bucket = hash & pool->mask;
+    while ((slot = pool->table[bucket].id))
+    {
+        block = pool->data + slot - 1;
+        if (pool->table[bucket].hash == hash && block->type == value.type && block->value.i == value.value.i)
+        {
+            *id = slot - 1;
+            return MR_NOERROR;
+        }
+
+        bucket = (bucket + 1) & pool->mask;
+    }
+
+    if (pool->size == pool->alloc)
+    {
+        block = mr_mem_realloc(MR_MEM_LEXER, pool->data, (pool->alloc ? pool->alloc * 2 : MR_POOL_CONSTS_SIZE) * sizeof(mr_pool_const_t));
+        if (!block)
+            return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+        pool->data = block;
+        pool->alloc = pool->alloc ? pool->alloc * 2 : MR_POOL_CONSTS_SIZE;
+    }
+
+    *id = pool->size;
+    pool->data[pool->size++] = value;
+    pool->table[bucket] = (mr_pool_bucket_t){.id=pool->size, .hash=hash};
+    return MR_NOERROR;
+}
+
+mr_byte_t mr_pool_consts_rehash(
+    mr_pool_consts_t *pool)
+{
+    mr_long_t size, hash, bucket, i;
+    mr_pool_bucket_t *table;
+
+    size = pool->table ? (pool->mask + 1) * 2 : MR_POOL_CONSTS_SIZE * 2;
+    table = mr_mem_calloc(MR_MEM_LEXER, size, sizeof(mr_pool_bucket_t));
+    if (!table)
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    mr_mem_free(pool->table);
+    pool->table = table;
+    pool->mask = size - 1;
+
+    /* Constants are added in the order of their slots, So the rollback can still remove them in the reverse order. */
+    for (i = 0; i != pool->size; i++)
+    {
+        hash = mr_pool_const_hash(pool->data[i]);
+        bucket = hash & pool->mask;
+        while (table[bucket].id)
+            bucket = (bucket + 1) & pool->mask;
+
+        table[bucket] = (mr_pool_bucket_t){.id=i + 1, .hash=hash};
+    }
+
+    return MR_NOERROR;
+}
+
+mr_byte_t mr_pool_syms_intern(
+    mr_long_t *id, mr_pool_syms_t *pool, mr_str_ct str, mr_long_t size)
+{
+    mr_long_t hash, bucket, slot, alloc;
+    mr_pool_sym_t *sym;
+    mr_str_t names;
+
+    if (pool->size * 2 >= pool->mask && mr_pool_syms_rehash(pool))
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    hash = mr_pool_hash_str(str, size);
+    bucket = hash & pool->mask;
+    while ((slot = pool->table[bucket].id))
+    {
+        if (pool->table[bucket].hash == hash)
+        {
+            sym = pool->data + slot - 1;
+            if (sym->size == size && !memcmp(pool->names + sym->name, str, size))
+            {
+                *id = slot - 1;
+                return MR_NOERROR;
+            }
+        }
+
+        bucket = (bucket + 1) & pool->mask;
+    }
+
+    if (pool->size == pool->alloc)
+    {
+        sym = mr_mem_realloc(MR_MEM_LEXER, pool->data, (pool->alloc ? pool->alloc * 2 : MR_POOL_SYMS_SIZE) * sizeof(mr_pool_sym_t));
+        if (!sym)
+            return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+        pool->data = sym;
+        pool->alloc = pool->alloc ? pool->alloc * 2 : MR_POOL_SYMS_SIZE;
+    }
+
+    if (pool->nsize + size > pool->nalloc)
+    {
+        alloc = pool->nalloc ? pool->nalloc * 2 : MR_POOL_NAMES_SIZE;
+        while (alloc < pool->nsize + size)
+            alloc *= 2;
+
+        names = mr_mem_realloc(MR_MEM_LEXER, pool->names, alloc * sizeof(mr_chr_t));
+        if (!names)
+            return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+        pool->names = names;
+        pool->nalloc = alloc;
+    }
+
+    memcpy(pool->names + pool->nsize, str, size * sizeof(mr_chr_t));
+
+    *id = pool->size;
+    pool->data[pool->size++] = (mr_pool_sym_t){.name=pool->nsize, .size=size};
+    pool->nsize += size;
+
+    pool->table[bucket] = (mr_pool_bucket_t){.id=pool->size, .hash=hash};
+    return MR_NOERROR;
+}
+
+mr_byte_t mr_pool_syms_rehash(
+    mr_pool_syms_t *pool)
+{
+    mr_long_t size, hash, bucket, i;
+    mr_pool_bucket_t *table;
+
+    size = pool->table ? (pool->mask + 1) * 2 : MR_POOL_SYMS_SIZE * 2;
+    table = mr_mem_calloc(MR_MEM_LEXER, size, sizeof(mr_pool_bucket_t));
+    if (!table)
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    mr_mem_free(pool->table);
+    pool->table = table;
+    pool->mask = size - 1;
+
+    /* Symbols are added in the order of their IDs, So the rollback can still remove them in the reverse order. */
+    for (i = 0; i != pool->size; i++)
+    {
+        hash = mr_pool_hash_str(pool->names + pool->data[i].name, pool->data[i].size);
+        bucket = hash & pool->mask;
+        while (table[bucket].id)
+            bucket = (bucket + 1) & pool->mask;
+
+        table[bucket] = (mr_pool_bucket_t){.id=i + 1, .hash=hash};
+    }
+
+    return MR_NOERROR;
+}
+
+mr_byte_t mr_pool_strs_intern(
+    mr_long_t *id, mr_pool_strs_t *pool, mr_str_ct str, mr_long_t size, mr_bool_t esc, mr_bool_t slice)
+{
+    mr_long_t hash, bucket, slot;
+    mr_pool_str_t *block;
+
+    if (pool->size * 2 >= pool->mask && mr_pool_strs_rehash(pool))
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    hash = mr_pool_hash_str(str, size);
+    bucket = hash & pool->mask;
+    while ((slot = pool->table[bucket].id))
+    {
+        if (pool->table[bucket].hash == hash && pool->data[slot - 1].size == size && pool->data[slot - 1].esc == esc &&
+            !memcmp(mr_pool_strs_literal(pool, slot - 1), str, size * sizeof(mr_chr_t)))
+        {
+            *id = slot - 1;
+            return MR_NOERROR;
+        }
+
+        bucket = (bucket + 1) & pool->mask;
+    }
+
+    if (pool->size == pool->alloc)
+    {
+        block = mr_mem_realloc(MR_MEM_LEXER, pool->data, (pool->alloc ? pool->alloc * 2 : MR_POOL_STRS_SIZE) * sizeof(mr_pool_str_t));
+        if (!block)
+            return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+        pool->data = block;
+        pool->alloc = pool->alloc ? pool->alloc * 2 : MR_POOL_STRS_SIZE;
+    }
+
+    *id = pool->size;
+    if (slice)
+        pool->data[pool->size++] = (mr_pool_str_t){.start=str - _mr_config.code, .size=size,
+            .value=MR_INVALID_IDX_CODE, .vsize=0, .slice=MR_TRUE, .esc=esc};
+    else
+    {
+        if (mr_pool_arena_reserve(pool, size))
+            return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+        memcpy(pool->arena + pool->asize, str, size * sizeof(mr_chr_t));
+        pool->data[pool->size++] = (mr_pool_str_t){.start=pool->asize, .size=size,
+            .value=MR_INVALID_IDX_CODE, .vsize=0, .slice=MR_FALSE, .esc=esc};
+        pool->asize += size;
+    }
+
+    pool->table[bucket] = (mr_pool_bucket_t){.id=pool->size, .hash=hash};
+    return MR_NOERROR;
+}
+
+mr_byte_t mr_pool_strs_rehash(
+    mr_pool_strs_t *pool)
+{
+    mr_long_t size, hash, bucket, i;
+    mr_pool_bucket_t *table;
+
+    size = pool->table ? (pool->mask + 1) * 2 : MR_POOL_STRS_SIZE * 2;
+    table = mr_mem_calloc(MR_MEM_LEXER, size, sizeof(mr_pool_bucket_t));
+    if (!table)
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    mr_mem_free(pool->table);
+    pool->table = table;
+    pool->mask = size - 1;
+
+    /* Strings are added in the order of their IDs, So the rollback can still remove them in the reverse order. */
+    for (i = 0; i != pool->size; i++)
+    {
+        hash = mr_pool_hash_str(mr_pool_strs_literal(pool, i), pool->data[i].size);
+        bucket = hash & pool->mask;
+        while (table[bucket].id)
+            bucket = (bucket + 1) & pool->mask;
+
+        table[bucket] = (mr_pool_bucket_t){.id=i + 1, .hash=hash};
+    }
+
+    return MR_NOERROR;
+}
+
+mr_str_ct mr_pool_strs_literal(
+    mr_pool_strs_t *pool, mr_long_t id)
+{
+    if (pool->data[id].slice)
+        return _mr_config.code + pool->data[id].start;
+    return pool->arena + pool->data[id].start;
+}
+
+mr_byte_t mr_pool_arena_reserve(
+    mr_pool_strs_t *pool, mr_long_t size)
+{
+    mr_long_t alloc;
+    mr_str_t block;
+
+    if (pool->arena && pool->asize + size <= pool->aalloc)
+        return MR_NOERROR;
+
+    alloc = pool->aalloc ? pool->aalloc * 2 : MR_POOL_ARENA_SIZE;
+    while (alloc < pool->asize + size)
+        alloc *= 2;
+
+    block = mr_mem_realloc(MR_MEM_LEXER, pool->arena, alloc * sizeof(mr_chr_t));
+    if (!block)
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    pool->arena = block;
+    pool->aalloc = alloc;
+    return MR_NOERROR;
+}
+
+mr_long_t mr_pool_hash_str(
+    mr_str_ct str, mr_long_t size)
+{
+    uint64_t hash, chunk;
+    uint32_t low, high;
+    mr_str_ct end;
+
+    hash = (uint64_t)size * 0x9e3779b97f4a7c15u;
+    end = str + size;
+
+    for (; end - str > 8; str += 8)
+    {
+        memcpy(&chunk, str, sizeof(uint64_t));
+        hash = (hash ^ chunk) * 0xff51afd7ed558ccdu;
+        hash ^= hash >> 32;
+    }
+
+    /* The last chunk overlaps the previous one (or its own halves), So short identifiers don't need a loop over the remaining characters. */
+    if (size >= 8)
+        memcpy(&chunk, end - 8, sizeof(uint64_t));
+    else if (size >= 4)
+    {
+        memcpy(&low, str, sizeof(uint32_t));
+        memcpy(&high, end - 4, sizeof(uint32_t));
+        chunk = (uint64_t)high << 32 | low;
+    }
+    else if (size)
+        chunk = (uint64_t)(mr_byte_t)str[0] << 16 | (uint64_t)(mr_byte_t)str[size >> 1] << 8 | (mr_byte_t)end[-1];
+    else
+        chunk = 0;
+
+    hash = (hash ^ chunk) * 0xff51afd7ed558ccdu;
+    hash ^= hash >> 32;
+    return (mr_long_t)hash;
+}
+
+mr_byte_t mr_pool_refs_reserve(
+    mr_pool_refs_t *refs, mr_long_t size)
+{
+    mr_long_t alloc;
+    mr_pool_ref_t *block;
+
+    if (refs->size + size <= refs->alloc)
+        return MR_NOERROR;
+
+    alloc = refs->alloc ? refs->alloc * 2 : MR_POOL_REFS_SIZE;
+    if (alloc < refs->size + size)
+        alloc = refs->size + size;
+
+    block = mr_mem_realloc(MR_MEM_LEXER, refs->data, alloc * sizeof(mr_pool_ref_t));
+    if (!block)
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    refs->data = block;
+    refs->alloc = alloc;
+    return MR_NOERROR;
+}
+
+mr_byte_t mr_pool_refs_append(
+    mr_pool_refs_t *refs, mr_pool_refs_t *src, mr_long_t *ids)
+{
+    mr_long_t i;
+
+    if (mr_pool_refs_reserve(refs, src->size))
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    for (i = 0; i != src->size; i++)
+        refs->data[refs->size++] = (mr_pool_ref_t){.idx=src->data[i].idx, .id=ids[src->data[i].id]};
+
+    return MR_NOERROR;
+}
+
+mr_long_t mr_pool_refs_bound(
+    mr_pool_refs_t *refs, mr_long_t idx)
+{
+    mr_long_t low, high, mid;
+
+    low = 0;
+    high = refs->size;
+    while (low != high)
+    {
+        mid = low + (high - low) / 2;
+        if (refs->data[mid].idx < idx)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    return low;
+}
+
+mr_long_t mr_pool_refs_find(
+    mr_pool_refs_t *refs, mr_long_t idx)
+{
+    mr_long_t pos;
+
+    pos = mr_pool_refs_bound(refs, idx);
+    if (pos == refs->size || refs->data[pos].idx != idx)
+        return MR_INVALID_IDX_CODE;
+    return refs->data[pos].id;
+}
+
+mr_bool_t mr_pool_decode_float_fast(
+    double *res, mr_str_ct str, mr_long_t size)
+{
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    uint64_t mantissa;
+    mr_long_t i, exp, eexp;
+    mr_bool_t fraction, negative;
+    mr_chr_t chr;
+
+    mantissa = 0;
+    exp = 0;
+    fraction = MR_FALSE;
+    for (i = 0; i != size; i++)
+    {
+        chr = str[i];
+        if (chr == '_')
+            continue;
+        if (chr == '.')
+        {
+            fraction = MR_TRUE;
+            continue;
+        }
+        if (chr == 'e' || chr == 'E')
+            break;
+
+        mantissa = mantissa * 10 + (uint64_t)(chr - '0');
+        if (mantissa > MR_POOL_FLOAT_EXACT)
+            return MR_FALSE;
+
+        exp += fraction;
+    }
+
+    eexp = 0;
+    negative = MR_FALSE;
+    if (i != size)
+    {
+        chr = str[++i];
+        if (chr == '+' || chr == '-')
+        {
+            negative = chr == '-';
+            i++;
+        }
+
+        for (; i != size; i++)
+        {
+            eexp = eexp * 10 + (mr_long_t)(str[i] - '0');
+            if (eexp > MR_POOL_FLOAT_POW10 * 2)
+                return MR_FALSE;
+        }
+    }
+
+    if (negative)
+    {
+        if (exp + eexp > MR_POOL_FLOAT_POW10)
+            return MR_FALSE;
+
+        *res = (double)mantissa / mr_pool_pow10[exp + eexp];
+        return MR_TRUE;
+    }
+
+    if (eexp >= exp)
+    {
+        if (eexp - exp > MR_POOL_FLOAT_POW10)
+            return MR_FALSE;
+
+        *res = (double)mantissa * mr_pool_pow10[eexp - exp];
+        return MR_TRUE;
+    }
+
+    if (exp - eexp > MR_POOL_FLOAT_POW10)
+        return MR_FALSE;
+
+    *res = (double)mantissa / mr_pool_pow10[exp - eexp];
+    return MR_TRUE;
+#else
+    (void)res;
+    (void)str;
+    (void)size;
+    return MR_FALSE;
+#endif
+}
+
+#ifdef __MR_POOL_SWAR__
+mr_bool_t mr_pool_swar_digits(
+    uint64_t chunk)
+{
+    return ((chunk & 0xf0f0f0f0f0f0f0f0u) |
+        (((chunk + 0x0606060606060606u) & 0xf0f0f0f0f0f0f0f0u) >> 4)) == 0x3333333333333333u;
+}
+
+uint64_t mr_pool_swar_parse(
+    uint64_t chunk)
+{
+    chunk -= 0x3030303030303030u;
+    chunk = chunk * 10 + (chunk >> 8);
+
+    return ((chunk & 0x000000ff000000ffu) * (100 + ((uint64_t)1000000 << 32)) +
+        ((chunk >> 16) & 0x000000ff000000ffu) * (1 + ((uint64_t)10000 << 32))) >> 32;
+}
+#endif
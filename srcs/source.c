@@ -0,0 +1,76 @@
+/*
+MIT License
+
+Copyright (c) 2023 MetaReal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+*/
+
+/**
+ * @file source.c
+ * This file contains definitions of the \a source.h file.
+*/
+
+#include <source.h>
+#include <mem.h>
+#include <consts.h>
+#include <string.h>
+
+#ifdef __MR_SOURCE_MMAP__
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+mr_str_t mr_source_read(
+    FILE *file, mr_long_t size)
+{
+    mr_str_t code;
+
+    code = mr_mem_malloc(MR_MEM_SOURCE, (size + MR_LEXER_MARGIN) * sizeof(mr_chr_t));
+    if (!code)
+        return NULL;
+
+    fread(code, sizeof(mr_chr_t), size, file);
+    memset(code + size, '\0', MR_LEXER_MARGIN * sizeof(mr_chr_t));
+    return code;
+}
+
+#ifdef __MR_SOURCE_MMAP__
+mr_str_t mr_source_map(
+    mr_str_ct fname, mr_long_t size)
+{
+    long page;
+    int fd;
+    mr_ptr_t code;
+
+    page = sysconf(_SC_PAGESIZE);
+    if (page <= 0 || !(size % page) || page - (long)(size % page) < MR_LEXER_MARGIN)
+        return NULL;
+
+    fd = open(fname, O_RDONLY);
+    if (fd == -1)
+        return NULL;
+
+    code = mmap(NULL, size * sizeof(mr_chr_t), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (code == MAP_FAILED)
+        return NULL;
+    return code;
+}
+
+void mr_source_unmap(
+    mr_str_t code, mr_long_t size)
+{
+    munmap(code, size * sizeof(mr_chr_t));
+}
+#endif
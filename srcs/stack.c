@@ -19,25 +19,69 @@ copies or substantial portions of the Software.
  * File that contains function definitions of the stack data structure.
 */
 
+#ifdef __MR_STACK_RESERVE__
+#define _DEFAULT_SOURCE /* MAP_ANONYMOUS */
+#endif
+
 #include <stack.h>
-#include <stdlib.h>
+#include <mem.h>
+#include <string.h>
+
+#ifdef __MR_STACK_RESERVE__
+#include <consts.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/**
+ * It commits the pages of the reserved range until at least \a size bytes of the stack data are usable. \n
+ * The committed size grows in steps of \a exalloc (a multiple of the page size) and never passes the reserved range.
+ * @param size
+ * Requested size of the stack data in bytes.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns the error code (defined in \a defs.h header file).
+*/
+mr_byte_t mr_stack_commit(
+    mr_long_t size);
+#endif
 
-mr_stack_t _mr_stack = {.data=NULL, .data=NULL, .size=0, .ptr=0, .exalloc=0, .psize=0, .pptr=0, .pexalloc=0};
+mr_stack_t _mr_stack = {.data=NULL, .scratch=NULL, .size=0, .ptr=0, .exalloc=0, .ssize=0, .sptr=0};
 
 mr_byte_t mr_stack_init(
-    mr_long_t size, mr_long_t psize)
+    mr_long_t size, mr_long_t ssize)
 {
+#ifdef __MR_STACK_RESERVE__
+    mr_ptr_t block;
+    mr_long_t page;
 
-    _mr_stack = (mr_stack_t){.size=size, .ptr=0, .exalloc=size, .psize=psize, .pptr=0, .pexalloc=psize};
+    page = (mr_long_t)sysconf(_SC_PAGESIZE);
+    _mr_stack = (mr_stack_t){.size=0, .ptr=0, .exalloc=(size / page + 1) * page, .ssize=ssize, .sptr=0};
+
+    block = mmap(NULL, MR_STACK_RESERVE_SIZE, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (block == MAP_FAILED)
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    _mr_stack.data = block;
+    if (mr_stack_commit(size) != MR_NOERROR)
+    {
+        munmap(block, MR_STACK_RESERVE_SIZE);
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+    }
+#else
+    _mr_stack = (mr_stack_t){.size=size, .ptr=0, .exalloc=size, .ssize=ssize, .sptr=0};
 
-    _mr_stack.data = malloc(size * sizeof(mr_byte_t));
+    _mr_stack.data = mr_mem_malloc(MR_MEM_STACK, size * sizeof(mr_byte_t));
     if (!_mr_stack.data)
         return MR_ERROR_NOT_ENOUGH_MEMORY;
+#endif
 
-    _mr_stack.ptrs = malloc(psize * sizeof(mr_ptr_t));
-    if (!_mr_stack.ptrs)
+    _mr_stack.scratch = mr_mem_malloc(MR_MEM_STACK, ssize * sizeof(mr_byte_t));
+    if (!_mr_stack.scratch)
     {
-        free(_mr_stack.data);
+#ifdef __MR_STACK_RESERVE__
+        munmap(_mr_stack.data, MR_STACK_RESERVE_SIZE);
+#else
+        mr_mem_free(_mr_stack.data);
+#endif
         return MR_ERROR_NOT_ENOUGH_MEMORY;
     }
 
@@ -49,13 +93,18 @@ mr_byte_t mr_stack_push(
 {
     if (_mr_stack.ptr + size > _mr_stack.size)
     {
+#ifdef __MR_STACK_RESERVE__
+        if (mr_stack_commit(_mr_stack.ptr + size) != MR_NOERROR)
+            return MR_ERROR_NOT_ENOUGH_MEMORY;
+#else
         mr_byte_t *block;
 
-        block = realloc(_mr_stack.data, (_mr_stack.size += _mr_stack.exalloc) * sizeof(mr_byte_t));
+        block = mr_mem_realloc(MR_MEM_STACK, _mr_stack.data, (_mr_stack.size += _mr_stack.exalloc) * sizeof(mr_byte_t));
         if (!block)
             return MR_ERROR_NOT_ENOUGH_MEMORY;
 
         _mr_stack.data = block;
+#endif
     }
 
     *ptr = _mr_stack.ptr;
@@ -63,46 +112,105 @@ mr_byte_t mr_stack_push(
     return MR_NOERROR;
 }
 
-mr_byte_t mr_stack_palloc(
-    mr_long_t *ptr, mr_long_t size)
+mr_byte_t mr_stack_scratch_push(
+    mr_ptr_t elem, mr_byte_t size)
 {
-    if (_mr_stack.pptr == _mr_stack.psize)
+    if (_mr_stack.sptr + size > _mr_stack.ssize)
     {
-        mr_ptr_t *block;
+        mr_byte_t *block;
 
-        block = realloc(_mr_stack.ptrs, (_mr_stack.psize += _mr_stack.pexalloc) * sizeof(mr_ptr_t));
+        block = mr_mem_realloc(MR_MEM_STACK, _mr_stack.scratch, _mr_stack.ssize * 2 * sizeof(mr_byte_t));
         if (!block)
             return MR_ERROR_NOT_ENOUGH_MEMORY;
 
-        _mr_stack.ptrs = block;
+        _mr_stack.scratch = block;
+        _mr_stack.ssize *= 2;
     }
 
-    _mr_stack.ptrs[_mr_stack.pptr] = malloc(size);
-    if (!_mr_stack.ptrs[_mr_stack.pptr])
-        return MR_ERROR_NOT_ENOUGH_MEMORY;
-
-    *ptr = _mr_stack.pptr++;
+    memcpy(_mr_stack.scratch + _mr_stack.sptr, elem, size);
+    _mr_stack.sptr += size;
     return MR_NOERROR;
 }
 
-mr_byte_t mr_stack_prealloc(
-    mr_long_t ptr, mr_long_t size)
+mr_byte_t mr_stack_scratch_pop(
+    mr_long_t *ptr, mr_long_t base)
 {
-    mr_ptr_t block;
+    mr_long_t size;
 
-    block = realloc(_mr_stack.ptrs[ptr], size);
-    if (!block)
-        return MR_ERROR_NOT_ENOUGH_MEMORY;
+    size = _mr_stack.sptr - base;
+    if (_mr_stack.ptr + size > _mr_stack.size)
+    {
+#ifdef __MR_STACK_RESERVE__
+        if (mr_stack_commit(_mr_stack.ptr + size) != MR_NOERROR)
+            return MR_ERROR_NOT_ENOUGH_MEMORY;
+#else
+        mr_byte_t *block;
+        mr_long_t alloc;
+
+        alloc = _mr_stack.size;
+        do
+            alloc += _mr_stack.exalloc;
+        while (_mr_stack.ptr + size > alloc);
 
-    _mr_stack.ptrs[ptr] = block;
+        block = mr_mem_realloc(MR_MEM_STACK, _mr_stack.data, alloc * sizeof(mr_byte_t));
+        if (!block)
+            return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+        _mr_stack.data = block;
+        _mr_stack.size = alloc;
+#endif
+    }
+
+    memcpy(_mr_stack.data + _mr_stack.ptr, _mr_stack.scratch + base, size);
+    _mr_stack.sptr = base;
+
+    *ptr = _mr_stack.ptr;
+    _mr_stack.ptr += size;
     return MR_NOERROR;
 }
 
+mr_stack_mark_t mr_stack_mark(void)
+{
+    return (mr_stack_mark_t){.ptr=_mr_stack.ptr, .sptr=_mr_stack.sptr};
+}
+
+void mr_stack_release(
+    mr_stack_mark_t mark)
+{
+    _mr_stack.ptr = mark.ptr;
+    _mr_stack.sptr = mark.sptr;
+}
+
 void mr_stack_free(void)
 {
-    free(_mr_stack.data);
+#ifdef __MR_STACK_RESERVE__
+    munmap(_mr_stack.data, MR_STACK_RESERVE_SIZE);
+#else
+    mr_mem_unused(MR_MEM_STACK, _mr_stack.size - _mr_stack.ptr);
+    mr_mem_free(_mr_stack.data);
+#endif
+    mr_mem_free(_mr_stack.scratch);
+}
+
+#ifdef __MR_STACK_RESERVE__
+mr_byte_t mr_stack_commit(
+    mr_long_t size)
+{
+    mr_long_t alloc;
 
-    while (_mr_stack.pptr--)
-        free(_mr_stack.ptrs[_mr_stack.pptr]);
-    free(_mr_stack.ptrs);
+    if (size > MR_STACK_RESERVE_SIZE)
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    alloc = _mr_stack.size;
+    do
+        alloc = alloc > MR_STACK_RESERVE_SIZE - _mr_stack.exalloc ?
+            MR_STACK_RESERVE_SIZE : alloc + _mr_stack.exalloc;
+    while (size > alloc);
+
+    if (mprotect(_mr_stack.data + _mr_stack.size, alloc - _mr_stack.size, PROT_READ | PROT_WRITE))
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    _mr_stack.size = alloc;
+    return MR_NOERROR;
 }
+#endif
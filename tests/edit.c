@@ -0,0 +1,416 @@
+/*
+MIT License
+
+Copyright (c) 2023 MetaReal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+*/
+
+/**
+ * @file edit.c
+ * Regression test of the \a mr_lexer_edit function. \n
+ * Every edit is checked against a full \a mr_lexer call on the edited code. Both calls must return the same code,
+ * And the same tokens (or the same error index). The \a fstrs list of the result must match its formatted strings. \n
+ * The fixed cases are edits that were handled wrongly before, And the random cases are generated from a fixed seed.
+*/
+
+#include <test.h>
+#include <lexer/lexer.h>
+#include <pool.h>
+#include <mem.h>
+#include <config.h>
+#include <consts.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Number of the random codes.
+*/
+#define MR_TEST_CODES ((mr_long_t)10000)
+
+/**
+ * Maximum number of the edits of each random code.
+*/
+#define MR_TEST_EDITS ((mr_long_t)30)
+
+/**
+ * Maximum size of the random codes in characters.
+*/
+#define MR_TEST_SIZE ((mr_long_t)2048)
+
+/**
+ * @struct __MR_TEST_CASE_T
+ * A fixed edit.
+ * @var mr_str_ct __MR_TEST_CASE_T::code
+ * The code before the edit.
+ * @var mr_long_t __MR_TEST_CASE_T::start
+ * Index of the first replaced character.
+ * @var mr_long_t __MR_TEST_CASE_T::end
+ * Index of the first character after the replaced ones.
+ * @var mr_str_ct __MR_TEST_CASE_T::text
+ * The new characters.
+*/
+struct __MR_TEST_CASE_T
+{
+    mr_str_ct code;
+    mr_long_t start;
+    mr_long_t end;
+    mr_str_ct text;
+};
+typedef struct __MR_TEST_CASE_T mr_test_case_t;
+
+/**
+ * @struct __MR_TEST_T
+ * State of the test.
+ * @var mr_lexer_t __MR_TEST_T::res
+ * Result of the lexer on the edited code.
+ * @var mr_byte_t __MR_TEST_T::retcode
+ * Return code of the last lexer call.
+ * @var mr_chr_t __MR_TEST_T::code
+ * Expected code (edited without the lexer).
+ * @var mr_long_t __MR_TEST_T::size
+ * Size of the expected code.
+ * @var mr_test_state_t __MR_TEST_T::state
+ * Shared state of the test (the \a runs field counts the checked edits).
+*/
+struct __MR_TEST_T
+{
+    mr_lexer_t res;
+    mr_byte_t retcode;
+
+    mr_chr_t code[MR_TEST_SIZE];
+    mr_long_t size;
+
+    mr_test_state_t state;
+};
+typedef struct __MR_TEST_T mr_test_t;
+
+/**
+ * Edits that were handled wrongly before.
+*/
+const mr_test_case_t mr_test_cases[] =
+{
+    /* Lexing an unterminated literal after a growing edit must stop at the margin. */
+    {"\"a\"", 1, 1, "'\\"},
+    {"a = 1", 5, 5, "'\\"},
+
+    /* A shrinking edit must not leave the old characters after the new end of the code. */
+    {"'\\x'", 2, 4, ""},
+    {"x = 'a'", 6, 7, ""},
+    {"\"abc\"", 4, 5, ""},
+
+    /* Edits in formatted strings restart from the start of the outermost formatted string. */
+    {"a = 1\nf\"x{a}y\"\n", 10, 11, "b + c"},
+    {"f\"{f'{b}'}\"\nx\n", 6, 7, "c}{d"},
+    {"a\nf\"{b}\"\n", 5, 7, ""},
+    {"f\"x{a}y\"\nf'{1}{2}'\n", 0, 1, ""},
+    {"f\"x{a}y\"\nb + c\n", 9, 9, "f\"{"},
+    {"f\"{a}\"\nf\"{b}\"\nf\"{c}\"\n", 8, 12, "}\"\nf\"{"},
+
+    /* A byte order mark is skipped only at the start of the code. */
+    {"\xef\xbb\xbf\na = 1\n", 0, 1, ""},
+    {"a = 1\n", 0, 0, "\xef\xbb\xbf"},
+    {"\xef\xbb\xbf" "a = 1\n", 3, 3, "\xef\xbb\xbf"}
+};
+
+/**
+ * Parts of the random codes and edits.
+*/
+mr_str_ct mr_test_frags[] =
+{
+    "a = 1\n", "b + c\n", "# c\n", "#*", "*#", "\n", "x", "(", ")", "1", ".", "1e", "0x",
+    "\"", "'", "\\", "'\\", "'\\x'", "\\u", "\\x4",
+    "f\"x{a}y\"\n", "f\"{f'{b}'}\"\n", "f'{1}{2}'", "f\"", "f\"{", "}\"", "{", "}", "\xef\xbb\xbf"
+};
+
+/**
+ * It lexes the expected code in a block that can be edited.
+ * @param test
+ * State of the test.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns the error code of the lexer.
+*/
+mr_byte_t mr_test_lex(
+    mr_test_t *test);
+
+/**
+ * It edits the code with the \a mr_lexer_edit function and checks the result.
+ * @param test
+ * State of the test.
+ * @param start
+ * Index of the first replaced character.
+ * @param end
+ * Index of the first character after the replaced ones.
+ * @param text
+ * The new characters.
+ * @param size
+ * Number of the new characters.
+ * @return It returns true if the result is correct. Otherwise, it returns false.
+*/
+mr_bool_t mr_test_edit(
+    mr_test_t *test, mr_long_t start, mr_long_t end, mr_str_ct text, mr_long_t size);
+
+/**
+ * It compares the result of the test with a full \a mr_lexer call on the expected code.
+ * @param test
+ * State of the test.
+ * @return It returns true if they match. Otherwise, it returns false.
+*/
+mr_bool_t mr_test_compare(
+    mr_test_t *test);
+
+/**
+ * It checks that the \a fstrs list of the result holds the first and the last token of every outermost formatted string.
+ * @param res
+ * The result.
+ * @return It returns true if the list is correct. Otherwise, it returns false.
+*/
+mr_bool_t mr_test_fstrs(
+    const mr_lexer_t *res);
+
+/**
+ * It frees the result and the code of the test.
+ * @param test
+ * State of the test.
+*/
+void mr_test_free(
+    mr_test_t *test);
+
+/**
+ * It checks that a code which belongs to the caller can't be edited.
+ * @param test
+ * State of the test.
+*/
+void mr_test_protect(
+    mr_test_t *test);
+
+int main(void)
+{
+    static mr_test_t test;
+    mr_long_t i, j;
+    mr_long_t start, end, size;
+    mr_chr_t text[64];
+
+    for (i = 0; i != sizeof(mr_test_cases) / sizeof(*mr_test_cases); i++)
+    {
+        test.size = (mr_long_t)strlen(mr_test_cases[i].code);
+        memcpy(test.code, mr_test_cases[i].code, test.size * sizeof(mr_chr_t));
+        if (mr_test_lex(&test) != MR_NOERROR)
+        {
+            printf("Case %" PRIu32 ": Lexing the code failed (%" PRIu8 ")\n", i, test.retcode);
+            test.state.failures++;
+            continue;
+        }
+
+        mr_test_edit(&test, mr_test_cases[i].start, mr_test_cases[i].end,
+            mr_test_cases[i].text, (mr_long_t)strlen(mr_test_cases[i].text));
+        mr_test_free(&test);
+    }
+
+    test.state.seed = MR_TEST_SEED;
+    for (i = 0; i != MR_TEST_CODES; i++)
+    {
+        test.size = 0;
+        mr_test_frag(&test.state, test.code, &test.size, MR_TEST_SIZE,
+            mr_test_frags, sizeof(mr_test_frags) / sizeof(*mr_test_frags), mr_test_rand(&test.state, 30) + 1);
+        if (mr_test_lex(&test) != MR_NOERROR)
+            continue;
+
+        for (j = 0; j != MR_TEST_EDITS; j++)
+        {
+            start = mr_test_rand(&test.state, test.size + 1);
+            end = test.size - start < 12 ? test.size : start + 12;
+            end = start + mr_test_rand(&test.state, end - start + 1);
+
+            size = 0;
+            mr_test_frag(&test.state, text, &size, sizeof(text) / sizeof(*text),
+                mr_test_frags, sizeof(mr_test_frags) / sizeof(*mr_test_frags), mr_test_rand(&test.state, 3));
+            if (test.size - (end - start) + size > MR_TEST_SIZE)
+                break;
+
+            if (!mr_test_edit(&test, start, end, text, size) || test.retcode != MR_NOERROR)
+                break;
+        }
+        mr_test_free(&test);
+    }
+
+    mr_test_protect(&test);
+    return mr_test_report(&test.state, "edits");
+}
+
+mr_byte_t mr_test_lex(
+    mr_test_t *test)
+{
+    mr_str_t code;
+
+    code = mr_mem_malloc(MR_MEM_SOURCE, (test->size + MR_LEXER_MARGIN) * sizeof(mr_chr_t));
+    if (!code)
+        return test->retcode = MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    memcpy(code, test->code, test->size * sizeof(mr_chr_t));
+    memset(code + test->size, '\0', MR_LEXER_MARGIN * sizeof(mr_chr_t));
+
+    _mr_config = (mr_config_t){.outstream=stdout, .instream=stdin, .errstream=stderr,
+        .code=code, .fname="edit", .size=test->size, .source=MR_CONFIG_SOURCE_HEAP};
+    test->retcode = mr_lexer(&test->res);
+    if (test->retcode != MR_NOERROR)
+        mr_mem_free(code);
+    return test->retcode;
+}
+
+mr_bool_t mr_test_edit(
+    mr_test_t *test, mr_long_t start, mr_long_t end, mr_str_ct text, mr_long_t size)
+{
+    memmove(test->code + start + size, test->code + end, (test->size - end) * sizeof(mr_chr_t));
+    memcpy(test->code + start, text, size * sizeof(mr_chr_t));
+    test->size += size - (end - start);
+
+    test->retcode = mr_lexer_edit(&test->res, start, end, text, size);
+    test->state.runs++;
+    if (mr_test_compare(test))
+        return MR_TRUE;
+
+    if (mr_test_fail(&test->state))
+        printf("Edit %" PRIu32 ": Replacing [%" PRIu32 ", %" PRIu32 ") with \"%.*s\" gives a different result (%" PRIu8 ") for:\n%.*s\n",
+            test->state.runs, start, end, (int)size, text, test->retcode, (int)test->size, test->code);
+    return MR_FALSE;
+}
+
+mr_bool_t mr_test_compare(
+    mr_test_t *test)
+{
+    mr_lexer_t ref;
+    mr_byte_t retcode;
+    mr_str_t code;
+    mr_str_ct ecode;
+    mr_long_t esize, i;
+    mr_pool_consts_t consts;
+    mr_pool_syms_t syms;
+    mr_pool_strs_t strs;
+    mr_bool_t match;
+
+    ecode = _mr_config.code;
+    esize = _mr_config.size;
+    if (esize != test->size || memcmp(ecode, test->code, esize * sizeof(mr_chr_t)))
+        return MR_FALSE;
+    for (i = 0; i != MR_LEXER_MARGIN; i++)
+        if (ecode[esize + i] != '\0')
+            return MR_FALSE;
+
+    code = mr_mem_malloc(MR_MEM_SOURCE, (esize + MR_LEXER_MARGIN) * sizeof(mr_chr_t));
+    if (!code)
+        return MR_FALSE;
+
+    memcpy(code, ecode, (esize + MR_LEXER_MARGIN) * sizeof(mr_chr_t));
+    consts = _mr_pool_consts;
+    syms = _mr_pool_syms;
+    strs = _mr_pool_strs;
+
+    _mr_config.code = code;
+    retcode = mr_lexer(&ref);
+
+    if (retcode != test->retcode)
+        match = MR_FALSE;
+    else if (retcode != MR_NOERROR)
+        match = ref.error.idx == test->res.error.idx;
+    else
+    {
+        match = ref.size == test->res.size && mr_test_fstrs(&test->res);
+        for (i = 0; match && i <= ref.size; i++)
+            match = ref.tokens[i].type == test->res.tokens[i].type &&
+                MR_IDX_EXTRACT(ref.tokens[i].idx) == MR_IDX_EXTRACT(test->res.tokens[i].idx);
+
+#ifdef __MR_TOKEN_SPANS__
+        for (i = 0; match && i <= ref.size; i++)
+            match = MR_IDX_EXTRACT(ref.ends[i]) == MR_IDX_EXTRACT(test->res.ends[i]);
+#endif
+    }
+
+    if (retcode == MR_NOERROR)
+    {
+        mr_mem_free(ref.tokens);
+        mr_pool_consts_free(&_mr_pool_consts);
+        mr_pool_syms_free(&_mr_pool_syms);
+        mr_pool_strs_free(&_mr_pool_strs);
+    }
+    mr_mem_free(code);
+
+    _mr_config.code = ecode;
+    _mr_pool_consts = consts;
+    _mr_pool_syms = syms;
+    _mr_pool_strs = strs;
+    return match;
+}
+
+mr_bool_t mr_test_fstrs(
+    const mr_lexer_t *res)
+{
+    mr_long_t depth, count, i;
+
+    depth = 0;
+    count = 0;
+    for (i = 0; i != res->size; i++)
+        if (res->tokens[i].type == MR_TOKEN_FSTR_START)
+        {
+            if (!depth++ && (count == res->fsize || res->fstrs[count * 2] != i))
+                return MR_FALSE;
+        }
+        else if (res->tokens[i].type == MR_TOKEN_FSTR_END && !--depth)
+        {
+            if (res->fstrs[count * 2 + 1] != i)
+                return MR_FALSE;
+            count++;
+        }
+
+    return count == res->fsize;
+}
+
+void mr_test_free(
+    mr_test_t *test)
+{
+    if (test->retcode == MR_NOERROR)
+    {
+        mr_mem_free(test->res.tokens);
+        mr_mem_free(test->res.fstrs);
+        mr_pool_consts_free(&_mr_pool_consts);
+        mr_pool_syms_free(&_mr_pool_syms);
+        mr_pool_strs_free(&_mr_pool_strs);
+    }
+
+    mr_mem_free((mr_str_t)_mr_config.code);
+}
+
+void mr_test_protect(
+    mr_test_t *test)
+{
+    mr_byte_t retcode;
+
+    test->size = 6;
+    memcpy(test->code, "a = 1\n", test->size * sizeof(mr_chr_t));
+    if (mr_test_lex(test) != MR_NOERROR)
+    {
+        printf("Protect: Lexing the code failed (%" PRIu8 ")\n", test->retcode);
+        test->state.failures++;
+        return;
+    }
+
+    _mr_config.source = MR_CONFIG_SOURCE_BORROWED;
+    retcode = mr_lexer_edit(&test->res, 0, 1, "b", 1);
+    _mr_config.source = MR_CONFIG_SOURCE_HEAP;
+
+    test->state.runs++;
+    if (retcode != MR_ERROR_WRITE_PROTECT || !mr_test_compare(test))
+    {
+        printf("Protect: Editing a borrowed code returned %" PRIu8 "\n", retcode);
+        test->state.failures++;
+    }
+    mr_test_free(test);
+}
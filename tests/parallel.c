@@ -0,0 +1,299 @@
+/*
+MIT License
+
+Copyright (c) 2023 MetaReal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+*/
+
+/**
+ * @file parallel.c
+ * Regression test of the \a mr_lexer_parallel function (only built with the \a MR_LEXER_PARALLEL build option). \n
+ * Every code is lexed by the \a mr_lexer function (the codes are too small for the parallel mode, So it's done sequentially),
+ * And by the \a mr_lexer_parallel function with up to <em>MR_LEXER_PARALLEL_THREADS</em> threads, So the chunks are a few lines long. \n
+ * Both calls must return the same tokens and pools (or the same error). The codes are generated from a fixed seed.
+ * Their parts put the seams between chunks after newlines and semicolons that the newline rule merges or drops,
+ * And inside strings, comments, and formatted strings.
+*/
+
+#include <test.h>
+#include <lexer/lexer.h>
+#include <pool.h>
+#include <mem.h>
+#include <config.h>
+#include <consts.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Number of the random codes.
+*/
+#define MR_TEST_CODES ((mr_long_t)5000)
+
+/**
+ * Maximum number of the parts of each random code.
+*/
+#define MR_TEST_PARTS ((mr_long_t)60)
+
+/**
+ * Maximum size of the codes in characters.
+*/
+#define MR_TEST_SIZE ((mr_long_t)2048)
+
+/**
+ * @struct __MR_TEST_T
+ * State of the test.
+ * @var mr_chr_t __MR_TEST_T::code
+ * The current code.
+ * @var mr_long_t __MR_TEST_T::size
+ * Size of the current code.
+ * @var mr_lexer_t __MR_TEST_T::ref
+ * Result of the \a mr_lexer function on the current code.
+ * @var mr_byte_t __MR_TEST_T::retcode
+ * Return code of the \a mr_lexer function on the current code.
+ * @var mr_pool_consts_t __MR_TEST_T::consts
+ * Constant pool of the \a mr_lexer function.
+ * @var mr_pool_syms_t __MR_TEST_T::syms
+ * Symbol pool of the \a mr_lexer function.
+ * @var mr_pool_strs_t __MR_TEST_T::strs
+ * String pool of the \a mr_lexer function.
+ * @var mr_test_state_t __MR_TEST_T::state
+ * Shared state of the test (the \a runs field counts the checked calls).
+*/
+struct __MR_TEST_T
+{
+    mr_chr_t code[MR_TEST_SIZE];
+    mr_long_t size;
+
+    mr_lexer_t ref;
+    mr_byte_t retcode;
+    mr_pool_consts_t consts;
+    mr_pool_syms_t syms;
+    mr_pool_strs_t strs;
+
+    mr_test_state_t state;
+};
+typedef struct __MR_TEST_T mr_test_t;
+
+/**
+ * Numbers of threads that the codes are lexed with.
+*/
+const mr_byte_t mr_test_counts[] = {2, 3, 4, 5, 8, MR_LEXER_PARALLEL_THREADS};
+
+/**
+ * Parts of the random codes.
+*/
+mr_str_ct mr_test_frags[] =
+{
+    "a = 1\n", "b + c\n", "x", "1", "1.5", "'a'", "\"abc\"", "\"a\\\"b\"", "(", ")", "[", "]", "{", "}", ",", " ", "\r\n",
+    "\n", "\n\n", ";", ";\n", "\n;", " \n ", "return\n", "true\n", "int\n", "+\n",
+    "# c\n", "#* c\n d *#", "\"a\nb\"", "'\n'", "f\"x{a}y\"\n", "f\"{a +\n b}\"", "f'{f\"{\n1}\"}'\n", "f\"\n{\"\n\"}\"",
+    "\xc3\xa9\n", "\"\xe2\x82\xac\"\n", "\"", "#*", "f\"{", "`", "\xe2\x82"
+};
+
+/**
+ * It lexes the code with the \a mr_lexer function.
+ * @param test
+ * State of the test.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em>.
+*/
+mr_byte_t mr_test_lex(
+    mr_test_t *test);
+
+/**
+ * It lexes the code with the \a mr_lexer_parallel function and compares the result with the result of the \a mr_lexer function.
+ * @param test
+ * State of the test.
+ * @param count
+ * Number of threads.
+ * @return It returns true if they match. Otherwise, it returns false.
+*/
+mr_bool_t mr_test_parallel(
+    mr_test_t *test, mr_byte_t count);
+
+/**
+ * It compares two lists of pool references.
+ * @param refs1
+ * The first list.
+ * @param refs2
+ * The second list.
+ * @return It returns true if they match. Otherwise, it returns false.
+*/
+mr_bool_t mr_test_refs(
+    const mr_pool_refs_t *refs1, const mr_pool_refs_t *refs2);
+
+/**
+ * It compares the pools of the \a mr_lexer_parallel function (<em>_mr_pool_consts</em>, <em>_mr_pool_syms</em>, and <em>_mr_pool_strs</em>)
+ * with the pools of the \a mr_lexer function.
+ * @param test
+ * State of the test.
+ * @return It returns true if they match. Otherwise, it returns false.
+*/
+mr_bool_t mr_test_pools(
+    mr_test_t *test);
+
+int main(void)
+{
+    static mr_test_t test;
+    mr_long_t i, j;
+
+    test.state.seed = MR_TEST_SEED;
+    for (i = 0; i != MR_TEST_CODES; i++)
+    {
+        test.size = 0;
+        mr_test_frag(&test.state, test.code, &test.size, MR_TEST_SIZE,
+            mr_test_frags, sizeof(mr_test_frags) / sizeof(*mr_test_frags), mr_test_rand(&test.state, MR_TEST_PARTS) + 1);
+        if (mr_test_lex(&test) != MR_NOERROR)
+        {
+            printf("Code %" PRIu32 ": Lexing the code failed\n", i);
+            test.state.failures++;
+            continue;
+        }
+
+        for (j = 0; j != sizeof(mr_test_counts) / sizeof(*mr_test_counts); j++)
+        {
+            test.state.runs++;
+            if (!mr_test_parallel(&test, mr_test_counts[j]) && mr_test_fail(&test.state))
+                printf("Call %" PRIu32 ": Lexing with %" PRIu8 " threads gives a different result for:\n%.*s\n",
+                    test.state.runs, mr_test_counts[j], (int)test.size, test.code);
+        }
+
+        if (test.retcode == MR_NOERROR)
+        {
+            mr_mem_free(test.ref.tokens);
+            mr_pool_consts_free(&test.consts);
+            mr_pool_syms_free(&test.syms);
+            mr_pool_strs_free(&test.strs);
+        }
+        mr_mem_free((mr_str_t)_mr_config.code);
+    }
+
+    return mr_test_report(&test.state, "calls");
+}
+
+mr_byte_t mr_test_lex(
+    mr_test_t *test)
+{
+    mr_str_t code;
+
+    code = mr_mem_malloc(MR_MEM_SOURCE, (test->size + MR_LEXER_MARGIN) * sizeof(mr_chr_t));
+    if (!code)
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+    memcpy(code, test->code, test->size * sizeof(mr_chr_t));
+    memset(code + test->size, '\0', MR_LEXER_MARGIN * sizeof(mr_chr_t));
+
+    _mr_config = (mr_config_t){.outstream=stdout, .instream=stdin, .errstream=stderr,
+        .code=code, .fname="parallel", .size=test->size, .source=MR_CONFIG_SOURCE_HEAP};
+    test->retcode = mr_lexer(&test->ref);
+    if (test->retcode == MR_ERROR_NOT_ENOUGH_MEMORY)
+    {
+        mr_mem_free(code);
+        return MR_ERROR_NOT_ENOUGH_MEMORY;
+    }
+
+    test->consts = _mr_pool_consts;
+    test->syms = _mr_pool_syms;
+    test->strs = _mr_pool_strs;
+    return MR_NOERROR;
+}
+
+mr_bool_t mr_test_parallel(
+    mr_test_t *test, mr_byte_t count)
+{
+    mr_lexer_t res;
+    mr_byte_t retcode;
+    mr_long_t i;
+    mr_bool_t match;
+
+    retcode = mr_lexer_parallel(&res, count);
+    if (retcode != test->retcode)
+        match = MR_FALSE;
+    else if (retcode != MR_NOERROR)
+        match = res.error.idx == test->ref.error.idx && res.error.expected == test->ref.error.expected &&
+            res.error.size == test->ref.error.size &&
+            !memcmp(res.error.chr, test->ref.error.chr, res.error.size * sizeof(mr_chr_t));
+    else
+    {
+        match = res.size == test->ref.size && mr_test_pools(test);
+        for (i = 0; match && i <= res.size; i++)
+            match = res.tokens[i].type == test->ref.tokens[i].type &&
+                MR_IDX_EXTRACT(res.tokens[i].idx) == MR_IDX_EXTRACT(test->ref.tokens[i].idx);
+
+#ifdef __MR_TOKEN_SPANS__
+        for (i = 0; match && i <= res.size; i++)
+            match = MR_IDX_EXTRACT(res.ends[i]) == MR_IDX_EXTRACT(test->ref.ends[i]);
+#endif
+    }
+
+    if (retcode == MR_NOERROR)
+    {
+        mr_mem_free(res.tokens);
+        mr_pool_consts_free(&_mr_pool_consts);
+        mr_pool_syms_free(&_mr_pool_syms);
+        mr_pool_strs_free(&_mr_pool_strs);
+    }
+    return match;
+}
+
+mr_bool_t mr_test_refs(
+    const mr_pool_refs_t *refs1, const mr_pool_refs_t *refs2)
+{
+    mr_long_t i;
+
+    if (refs1->size != refs2->size)
+        return MR_FALSE;
+
+    for (i = 0; i != refs1->size; i++)
+        if (refs1->data[i].idx != refs2->data[i].idx || refs1->data[i].id != refs2->data[i].id)
+            return MR_FALSE;
+    return MR_TRUE;
+}
+
+mr_bool_t mr_test_pools(
+    mr_test_t *test)
+{
+    mr_long_t i;
+    const mr_pool_sym_t *sym1, *sym2;
+    const mr_pool_str_t *str1, *str2;
+
+    /* IDs are numbered in the order of first appearance, So the merged pools must match the sequential ones exactly. */
+    if (_mr_pool_consts.size != test->consts.size || !mr_test_refs(&_mr_pool_consts.refs, &test->consts.refs) ||
+        _mr_pool_syms.size != test->syms.size || !mr_test_refs(&_mr_pool_syms.refs, &test->syms.refs) ||
+        _mr_pool_strs.size != test->strs.size || !mr_test_refs(&_mr_pool_strs.refs, &test->strs.refs))
+        return MR_FALSE;
+
+    for (i = 0; i != test->consts.size; i++)
+        if (_mr_pool_consts.data[i].type != test->consts.data[i].type ||
+            _mr_pool_consts.data[i].value.i != test->consts.data[i].value.i)
+            return MR_FALSE;
+
+    for (i = 0; i != test->syms.size; i++)
+    {
+        sym1 = _mr_pool_syms.data + i;
+        sym2 = test->syms.data + i;
+        if (sym1->size != sym2->size ||
+            memcmp(_mr_pool_syms.names + sym1->name, test->syms.names + sym2->name, sym1->size * sizeof(mr_chr_t)))
+            return MR_FALSE;
+    }
+
+    for (i = 0; i != test->strs.size; i++)
+    {
+        str1 = _mr_pool_strs.data + i;
+        str2 = test->strs.data + i;
+        if (str1->size != str2->size || str1->esc != str2->esc ||
+            memcmp((str1->slice ? _mr_config.code : _mr_pool_strs.arena) + str1->start,
+                (str2->slice ? _mr_config.code : test->strs.arena) + str2->start, str1->size * sizeof(mr_chr_t)))
+            return MR_FALSE;
+    }
+    return MR_TRUE;
+}
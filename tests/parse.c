@@ -0,0 +1,564 @@
+/*
+MIT License
+
+Copyright (c) 2023 MetaReal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+*/
+
+/**
+ * @file parse.c
+ * Test of the precedence and the associativity of the operators in the parser. \n
+ * Random expression trees are generated from a fixed seed, And every tree is written as a code twice:
+ * With only the parentheses that the precedence of the operators requires (plus a few redundant ones),
+ * And with every operation in parentheses. \n
+ * Both codes are lexed and parsed the way the \a mr_compile function does it, And both ASTs must match the tree.
+ * The expected parentheses are derived from the operator table of this file, Not from the parser,
+ * So the test is also valid for the explicit-stack parser (see the \a MR_PARSER_STACK build option). \n
+ * Every code is parsed twice, And the stack is released to a mark after each parse.
+ * The release must restore the stack pointers, And the second parse must not grow the stack. \n
+ * With node spans enabled, Every stored span must match the span that is computed recursively from the AST.
+*/
+
+#include <test.h>
+#include <parser/parser.h>
+#include <lexer/lexer.h>
+#include <stack.h>
+#include <pool.h>
+#include <mem.h>
+#include <config.h>
+#include <consts.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Number of the random trees.
+*/
+#define MR_TEST_TREES ((mr_long_t)20000)
+
+/**
+ * Maximum depth of the random trees.
+*/
+#define MR_TEST_DEPTH 6
+
+/**
+ * Maximum number of the nodes of a tree (a full binary tree of <em>MR_TEST_DEPTH</em> levels).
+*/
+#define MR_TEST_NODES ((2 << MR_TEST_DEPTH) - 1)
+
+/**
+ * Maximum size of the codes in characters.
+*/
+#define MR_TEST_SIZE ((mr_long_t)4096)
+
+/**
+ * Precedence of the exponentiation (higher than all of the binary operators of the <em>mr_test_binary</em> table).
+*/
+#define MR_TEST_POWER_PREC 11
+
+/**
+ * @struct __MR_TEST_OP_T
+ * An operator.
+ * @var mr_str_ct __MR_TEST_OP_T::str
+ * The operator in the code.
+ * @var mr_byte_t __MR_TEST_OP_T::op
+ * Token type of the operator (like the \a op field of the operation nodes).
+ * @var mr_byte_t __MR_TEST_OP_T::prec
+ * Precedence of the operator (binary operators only).
+*/
+struct __MR_TEST_OP_T
+{
+    mr_str_ct str;
+    mr_byte_t op;
+    mr_byte_t prec;
+};
+typedef struct __MR_TEST_OP_T mr_test_op_t;
+
+/**
+ * @struct __MR_TEST_EXPR_T
+ * A node of a random tree.
+ * @var mr_byte_t __MR_TEST_EXPR_T::type
+ * Type of the node (<em>MR_NODE_VAR_ACCESS</em>, <em>MR_NODE_INT</em>, <em>MR_NODE_UNARY_OP</em> or <em>MR_NODE_BINARY_OP</em>).
+ * @var mr_chr_t __MR_TEST_EXPR_T::chr
+ * Name of the variable or the digit of the integer.
+ * @var const mr_test_op_t* __MR_TEST_EXPR_T::op
+ * Operator of the operation.
+ * @var mr_long_t __MR_TEST_EXPR_T::left
+ * Index of the left operand (or the operand of the unary operation).
+ * @var mr_long_t __MR_TEST_EXPR_T::right
+ * Index of the right operand.
+*/
+struct __MR_TEST_EXPR_T
+{
+    mr_byte_t type;
+    mr_chr_t chr;
+    const mr_test_op_t *op;
+
+    mr_long_t left;
+    mr_long_t right;
+};
+typedef struct __MR_TEST_EXPR_T mr_test_expr_t;
+
+/**
+ * @struct __MR_TEST_T
+ * State of the test.
+ * @var mr_test_expr_t __MR_TEST_T::exprs
+ * Nodes of the current tree.
+ * @var mr_long_t __MR_TEST_T::esize
+ * Number of the nodes of the current tree.
+ * @var mr_chr_t __MR_TEST_T::code
+ * The current code.
+ * @var mr_long_t __MR_TEST_T::size
+ * Size of the current code.
+ * @var mr_test_state_t __MR_TEST_T::state
+ * Shared state of the test (the \a runs field counts the checked codes).
+*/
+struct __MR_TEST_T
+{
+    mr_test_expr_t exprs[MR_TEST_NODES];
+    mr_long_t esize;
+
+    mr_chr_t code[MR_TEST_SIZE];
+    mr_long_t size;
+
+    mr_test_state_t state;
+};
+typedef struct __MR_TEST_T mr_test_t;
+
+/**
+ * Binary operators and their precedence (the lowest first).
+ * Operators with the same precedence are left-associative. The exponentiation is right-associative,
+ * And its left operand can't be a unary operation.
+*/
+const mr_test_op_t mr_test_binary[] =
+{
+    {"or", MR_TOKEN_OR_K, 1}, {"||", MR_TOKEN_OR_K, 1},
+    {"and", MR_TOKEN_AND_K, 2}, {"&&", MR_TOKEN_AND_K, 2},
+    {"<", MR_TOKEN_LESS, 3}, {">", MR_TOKEN_GREATER, 3}, {"<=", MR_TOKEN_LESS_EQUAL, 3}, {">=", MR_TOKEN_GREATER_EQUAL, 3},
+    {"==", MR_TOKEN_EQUAL, 4}, {"!=", MR_TOKEN_NEQUAL, 4}, {"===", MR_TOKEN_EX_EQUAL, 4}, {"!==", MR_TOKEN_EX_NEQUAL, 4},
+    {"|", MR_TOKEN_B_OR, 5},
+    {"^", MR_TOKEN_B_XOR, 6},
+    {"&", MR_TOKEN_B_AND, 7},
+    {"<<", MR_TOKEN_L_SHIFT, 8}, {">>", MR_TOKEN_R_SHIFT, 8},
+    {"+", MR_TOKEN_PLUS, 9}, {"-", MR_TOKEN_MINUS, 9},
+    {"*", MR_TOKEN_MULTIPLY, 10}, {"/", MR_TOKEN_DIVIDE, 10}, {"%", MR_TOKEN_MODULO, 10}, {"//", MR_TOKEN_QUOTIENT, 10},
+    {"**", MR_TOKEN_POWER, MR_TEST_POWER_PREC}
+};
+
+/**
+ * Unary operators. Their operand can be an exponentiation without parentheses.
+*/
+const mr_test_op_t mr_test_unary[] =
+{
+    {"+", MR_TOKEN_PLUS, 0}, {"-", MR_TOKEN_MINUS, 0}, {"~", MR_TOKEN_B_NOT, 0},
+    {"not", MR_TOKEN_NOT_K, 0}, {"!", MR_TOKEN_NOT_K, 0}
+};
+
+/**
+ * It generates a random tree.
+ * @param test
+ * State of the test.
+ * @param depth
+ * Maximum depth of the tree.
+ * @return It returns index of the root of the tree.
+*/
+mr_long_t mr_test_generate(
+    mr_test_t *test, mr_byte_t depth);
+
+/**
+ * It appends a tree to the code.
+ * @param test
+ * State of the test.
+ * @param idx
+ * Index of the root of the tree.
+ * @param full
+ * It indicates whether every operation should be in parentheses (MR_TRUE) or not (MR_FALSE).
+*/
+void mr_test_write(
+    mr_test_t *test, mr_long_t idx, mr_bool_t full);
+
+/**
+ * It checks whether an operand must be in parentheses.
+ * @param test
+ * State of the test.
+ * @param parent
+ * Index of the operation.
+ * @param child
+ * Index of the operand.
+ * @param right
+ * It indicates whether the operand is the right operand of a binary operation (MR_TRUE) or not (MR_FALSE).
+ * @return It returns true if the operand must be in parentheses. Otherwise, it returns false.
+*/
+mr_bool_t mr_test_paren(
+    mr_test_t *test, mr_long_t parent, mr_long_t child, mr_bool_t right);
+
+/**
+ * It lexes and parses the code and compares the AST with the tree. \n
+ * The code is parsed twice with the stack released in between, And the stack must be reused by the second parse.
+ * @param test
+ * State of the test.
+ * @param root
+ * Index of the root of the tree.
+ * @return It returns true if they match. Otherwise, it returns false.
+*/
+mr_bool_t mr_test_parse(
+    mr_test_t *test, mr_long_t root);
+
+/**
+ * It compares a node with a tree.
+ * @param test
+ * State of the test.
+ * @param node
+ * The node.
+ * @param idx
+ * Index of the root of the tree.
+ * @return It returns true if they match. Otherwise, it returns false.
+*/
+mr_bool_t mr_test_compare(
+    mr_test_t *test, mr_node_t node, mr_long_t idx);
+
+#ifdef __MR_NODE_SPANS__
+/**
+ * It computes the starting index of a node recursively (without the stored spans of the node and its children).
+ * @param node
+ * The node.
+ * @return It returns the starting index of the <em>node</em>.
+*/
+mr_long_t mr_test_sidx(
+    mr_node_t node);
+
+/**
+ * It computes the ending index of a node recursively (without the stored spans of the node and its children).
+ * @param node
+ * The node.
+ * @return It returns the ending index of the <em>node</em>.
+*/
+mr_long_t mr_test_eidx(
+    mr_node_t node);
+
+/**
+ * It compares the stored spans of a node and its children with the recursive computation.
+ * @param node
+ * The node.
+ * @return It returns true if they match. Otherwise, it returns false.
+*/
+mr_bool_t mr_test_spans(
+    mr_node_t node);
+#endif
+
+int main(void)
+{
+    static mr_test_t test;
+    mr_long_t i, root;
+    mr_byte_t full;
+
+    test.state.seed = MR_TEST_SEED;
+    for (i = 0; i != MR_TEST_TREES; i++)
+    {
+        test.esize = 0;
+        root = mr_test_generate(&test, MR_TEST_DEPTH);
+
+        for (full = 0; full != 2; full++)
+        {
+            test.size = 0;
+            mr_test_write(&test, root, full);
+            test.code[test.size++] = '\n';
+
+            test.state.runs++;
+            if (!mr_test_parse(&test, root) && mr_test_fail(&test.state))
+                printf("Code %" PRIu32 ": The AST doesn't match the tree (or the stack wasn't reused) for:\n%.*s",
+                    test.state.runs, (int)test.size, test.code);
+        }
+    }
+
+    return mr_test_report(&test.state, "codes");
+}
+
+mr_long_t mr_test_generate(
+    mr_test_t *test, mr_byte_t depth)
+{
+    mr_long_t idx;
+    mr_test_expr_t *expr;
+
+    idx = test->esize++;
+    expr = test->exprs + idx;
+
+    if (!depth || !mr_test_rand(&test->state, 4))
+    {
+        if (mr_test_rand(&test->state, 2))
+            *expr = (mr_test_expr_t){.type=MR_NODE_VAR_ACCESS, .chr='a' + mr_test_rand(&test->state, 5)};
+        else
+            *expr = (mr_test_expr_t){.type=MR_NODE_INT, .chr='0' + mr_test_rand(&test->state, 10)};
+        return idx;
+    }
+
+    if (!mr_test_rand(&test->state, 6))
+    {
+        *expr = (mr_test_expr_t){.type=MR_NODE_UNARY_OP,
+            .op=mr_test_unary + mr_test_rand(&test->state, sizeof(mr_test_unary) / sizeof(*mr_test_unary))};
+        expr->left = mr_test_generate(test, depth - 1);
+        return idx;
+    }
+
+    *expr = (mr_test_expr_t){.type=MR_NODE_BINARY_OP,
+        .op=mr_test_binary + mr_test_rand(&test->state, sizeof(mr_test_binary) / sizeof(*mr_test_binary))};
+    expr->left = mr_test_generate(test, depth - 1);
+    expr->right = mr_test_generate(test, depth - 1);
+    return idx;
+}
+
+void mr_test_write(
+    mr_test_t *test, mr_long_t idx, mr_bool_t full)
+{
+    const mr_test_expr_t *expr;
+    mr_long_t size, child;
+    mr_bool_t paren;
+
+    expr = test->exprs + idx;
+    if (expr->type == MR_NODE_VAR_ACCESS || expr->type == MR_NODE_INT)
+    {
+        test->code[test->size++] = expr->chr;
+        return;
+    }
+
+    if (expr->type == MR_NODE_BINARY_OP)
+    {
+        paren = full || mr_test_paren(test, idx, expr->left, MR_FALSE);
+        if (paren)
+            test->code[test->size++] = '(';
+        mr_test_write(test, expr->left, full);
+        if (paren)
+            test->code[test->size++] = ')';
+        test->code[test->size++] = ' ';
+    }
+
+    size = (mr_long_t)strlen(expr->op->str);
+    memcpy(test->code + test->size, expr->op->str, size * sizeof(mr_chr_t));
+    test->size += size;
+    test->code[test->size++] = ' ';
+
+    child = expr->type == MR_NODE_BINARY_OP ? expr->right : expr->left;
+    paren = full || mr_test_paren(test, idx, child, expr->type == MR_NODE_BINARY_OP);
+    if (paren)
+        test->code[test->size++] = '(';
+    mr_test_write(test, child, full);
+    if (paren)
+        test->code[test->size++] = ')';
+}
+
+mr_bool_t mr_test_paren(
+    mr_test_t *test, mr_long_t parent, mr_long_t child, mr_bool_t right)
+{
+    const mr_test_expr_t *pexpr, *cexpr;
+
+    pexpr = test->exprs + parent;
+    cexpr = test->exprs + child;
+    if (cexpr->type == MR_NODE_VAR_ACCESS || cexpr->type == MR_NODE_INT)
+        return MR_FALSE;
+
+    /* Redundant parentheses must not change the AST either. */
+    if (!mr_test_rand(&test->state, 16))
+        return MR_TRUE;
+
+    if (pexpr->type == MR_NODE_UNARY_OP)
+        return cexpr->type == MR_NODE_BINARY_OP && cexpr->op->prec != MR_TEST_POWER_PREC;
+
+    if (pexpr->op->prec == MR_TEST_POWER_PREC)
+    {
+        if (!right)
+            return MR_TRUE;
+        return cexpr->type == MR_NODE_BINARY_OP && cexpr->op->prec != MR_TEST_POWER_PREC;
+    }
+
+    if (cexpr->type == MR_NODE_UNARY_OP)
+        return MR_FALSE;
+    return right ? cexpr->op->prec <= pexpr->op->prec : cexpr->op->prec < pexpr->op->prec;
+}
+
+mr_bool_t mr_test_parse(
+    mr_test_t *test, mr_long_t root)
+{
+    mr_byte_t retcode;
+    mr_str_t code;
+    mr_lexer_t lexer;
+    mr_parser_t parser;
+    mr_token_cursor_t tokens;
+    mr_long_t counts[MR_TOKEN_COUNT];
+    mr_bool_t match;
+    mr_stack_mark_t mark;
+    mr_long_t ptr, size;
+    mr_byte_t pass;
+
+#ifdef __MR_TOKEN_COMPACT__
+    mr_byte_t *compact;
+#endif
+
+    code = mr_mem_malloc(MR_MEM_SOURCE, (test->size + MR_LEXER_MARGIN) * sizeof(mr_chr_t));
+    if (!code)
+        return MR_FALSE;
+
+    memcpy(code, test->code, test->size * sizeof(mr_chr_t));
+    memset(code + test->size, '\0', MR_LEXER_MARGIN * sizeof(mr_chr_t));
+
+    _mr_config = (mr_config_t){.outstream=stdout, .instream=stdin, .errstream=stderr,
+        .code=code, .fname="parse", .size=test->size, .source=MR_CONFIG_SOURCE_HEAP};
+    retcode = mr_lexer(&lexer);
+    if (retcode != MR_NOERROR)
+    {
+        mr_mem_free(code);
+        return MR_FALSE;
+    }
+
+    memset(counts, 0, sizeof(counts));
+    mr_token_histogram(counts, lexer.tokens);
+    retcode = mr_stack_init(mr_parser_stack_size(counts), MR_STACK_SCRATCH_SIZE);
+    if (retcode != MR_NOERROR)
+    {
+        mr_mem_free(lexer.tokens);
+        mr_pool_consts_free(&_mr_pool_consts);
+        mr_pool_syms_free(&_mr_pool_syms);
+        mr_pool_strs_free(&_mr_pool_strs);
+        mr_mem_free(code);
+        return MR_FALSE;
+    }
+
+#ifdef __MR_TOKEN_COMPACT__
+    retcode = mr_token_compact(&compact, lexer.tokens, lexer.size);
+    mr_mem_free(lexer.tokens);
+    if (retcode != MR_NOERROR)
+    {
+        mr_pool_consts_free(&_mr_pool_consts);
+        mr_pool_syms_free(&_mr_pool_syms);
+        mr_pool_strs_free(&_mr_pool_strs);
+        mr_stack_free();
+        mr_mem_free(code);
+        return MR_FALSE;
+    }
+
+    mr_token_cursor_init(&tokens, compact);
+#else
+    mr_token_cursor_init(&tokens, lexer.tokens);
+#endif
+
+    mark = mr_stack_mark();
+    ptr = size = 0;
+    match = MR_TRUE;
+    for (pass = 0; match && pass != 2; pass++)
+    {
+        retcode = mr_parser(&parser, tokens, mr_parser_nodes_size(counts));
+        match = retcode == MR_NOERROR && parser.size == 1 && mr_test_compare(test, *parser.nodes, root) &&
+            _mr_stack.sptr == mark.sptr;
+#ifdef __MR_NODE_SPANS__
+        match = match && mr_test_spans(*parser.nodes);
+#endif
+        if (retcode == MR_NOERROR)
+            mr_mem_free(parser.nodes);
+
+        /* The second parse must take the same stack data without growing the stack. */
+        if (!pass)
+        {
+            ptr = _mr_stack.ptr;
+            size = _mr_stack.size;
+        }
+        else
+            match = match && _mr_stack.ptr == ptr && _mr_stack.size == size;
+
+        mr_stack_release(mark);
+        match = match && _mr_stack.ptr == mark.ptr && _mr_stack.sptr == mark.sptr;
+    }
+
+#ifdef __MR_TOKEN_COMPACT__
+    mr_mem_free(compact);
+#else
+    mr_mem_free(lexer.tokens);
+#endif
+    mr_pool_consts_free(&_mr_pool_consts);
+    mr_pool_syms_free(&_mr_pool_syms);
+    mr_pool_strs_free(&_mr_pool_strs);
+    mr_stack_free();
+    mr_mem_free(code);
+    return match;
+}
+
+mr_bool_t mr_test_compare(
+    mr_test_t *test, mr_node_t node, mr_long_t idx)
+{
+    const mr_test_expr_t *expr;
+    const mr_node_binary_op_t *bvalue;
+    const mr_node_unary_op_t *uvalue;
+
+    expr = test->exprs + idx;
+    if (node.type != expr->type)
+        return MR_FALSE;
+
+    switch (node.type)
+    {
+    case MR_NODE_VAR_ACCESS:
+    case MR_NODE_INT:
+        return _mr_config.code[node.value] == expr->chr;
+    case MR_NODE_UNARY_OP:
+        uvalue = (mr_node_unary_op_t*)(_mr_stack.data + node.value);
+        return uvalue->op == expr->op->op && mr_test_compare(test, uvalue->operand, expr->left);
+    default:
+        bvalue = (mr_node_binary_op_t*)(_mr_stack.data + node.value);
+        return bvalue->op == expr->op->op &&
+            mr_test_compare(test, bvalue->left, expr->left) && mr_test_compare(test, bvalue->right, expr->right);
+    }
+}
+
+#ifdef __MR_NODE_SPANS__
+mr_long_t mr_test_sidx(
+    mr_node_t node)
+{
+    switch (node.type)
+    {
+    case MR_NODE_UNARY_OP:
+        return MR_IDX_EXTRACT(((mr_node_unary_op_t*)(_mr_stack.data + node.value))->sidx);
+    case MR_NODE_BINARY_OP:
+        return mr_test_sidx(((mr_node_binary_op_t*)(_mr_stack.data + node.value))->left);
+    default:
+        return mr_node_sidx(node);
+    }
+}
+
+mr_long_t mr_test_eidx(
+    mr_node_t node)
+{
+    switch (node.type)
+    {
+    case MR_NODE_UNARY_OP:
+        return mr_test_eidx(((mr_node_unary_op_t*)(_mr_stack.data + node.value))->operand);
+    case MR_NODE_BINARY_OP:
+        return mr_test_eidx(((mr_node_binary_op_t*)(_mr_stack.data + node.value))->right);
+    default:
+        return mr_node_eidx(node);
+    }
+}
+
+mr_bool_t mr_test_spans(
+    mr_node_t node)
+{
+    const mr_node_binary_op_t *bvalue;
+
+    /* Names and literals have no stored span. */
+    if (node.type != MR_NODE_UNARY_OP && node.type != MR_NODE_BINARY_OP)
+        return MR_TRUE;
+
+    if (mr_node_sidx(node) != mr_test_sidx(node) || mr_node_eidx(node) != mr_test_eidx(node))
+        return MR_FALSE;
+
+    if (node.type == MR_NODE_UNARY_OP)
+        return mr_test_spans(((mr_node_unary_op_t*)(_mr_stack.data + node.value))->operand);
+
+    bvalue = (mr_node_binary_op_t*)(_mr_stack.data + node.value);
+    return mr_test_spans(bvalue->left) && mr_test_spans(bvalue->right);
+}
+#endif
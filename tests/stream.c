@@ -0,0 +1,430 @@
+/*
+MIT License
+
+Copyright (c) 2023 MetaReal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+*/
+
+/**
+ * @file stream.c
+ * Regression test of the \a mr_lexer_stream function. \n
+ * Every code is written to a temporary file and streamed with small chunks, With and without a consumer.
+ * The result is checked against a full \a mr_lexer call on the code. Both calls must return the same code,
+ * And the same tokens (or the same error). An illegal character error must also keep the whole line of the error in the window. \n
+ * The fixed cases are long lines with an illegal character, And the random cases are generated from a fixed seed,
+ * So tokens are rolled back at the end of the window inside strings, formatted strings, comments, and UTF-8 sequences.
+*/
+
+#include <test.h>
+#include <lexer/lexer.h>
+#include <pool.h>
+#include <mem.h>
+#include <config.h>
+#include <consts.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Number of the random codes.
+*/
+#define MR_TEST_CODES ((mr_long_t)2000)
+
+/**
+ * Maximum number of the parts of each random code.
+*/
+#define MR_TEST_PARTS ((mr_long_t)80)
+
+/**
+ * Maximum size of the random codes in characters.
+*/
+#define MR_TEST_CODE_SIZE ((mr_long_t)1024)
+
+/**
+ * Maximum size of the codes in characters.
+*/
+#define MR_TEST_SIZE ((mr_long_t)0x11000)
+
+/**
+ * Number of the parts that can't make an error on their own (the first parts of the <em>mr_test_frags</em> list).
+*/
+#define MR_TEST_LEGAL_FRAGS ((mr_long_t)24)
+
+/**
+ * @struct __MR_TEST_LINE_T
+ * A fixed case. The code is a long line with an illegal character, Between a few short lines.
+ * @var mr_long_t __MR_TEST_LINE_T::start
+ * Index of the first character of the line.
+ * @var mr_long_t __MR_TEST_LINE_T::error
+ * Index of the illegal character.
+ * @var mr_long_t __MR_TEST_LINE_T::end
+ * Index of the newline at the end of the line.
+ * @var mr_long_t __MR_TEST_LINE_T::chunk
+ * Number of characters read from the file at once.
+*/
+struct __MR_TEST_LINE_T
+{
+    mr_long_t start;
+    mr_long_t error;
+    mr_long_t end;
+    mr_long_t chunk;
+};
+typedef struct __MR_TEST_LINE_T mr_test_line_t;
+
+/**
+ * @struct __MR_TEST_T
+ * State of the test.
+ * @var mr_chr_t __MR_TEST_T::code
+ * The current code.
+ * @var mr_long_t __MR_TEST_T::size
+ * Size of the current code.
+ * @var FILE* __MR_TEST_T::file
+ * The temporary file that holds the current code.
+ * @var mr_lexer_t __MR_TEST_T::ref
+ * Result of the \a mr_lexer function on the current code.
+ * @var mr_byte_t __MR_TEST_T::retcode
+ * Return code of the \a mr_lexer function on the current code.
+ * @var mr_token_t __MR_TEST_T::tokens
+ * Tokens handed over to the consumer (indices are relative to the whole code).
+ * @var mr_idx_t __MR_TEST_T::ends
+ * Ending index of each token handed over to the consumer (only available with token spans enabled).
+ * @var mr_long_t __MR_TEST_T::tsize
+ * Number of the tokens handed over to the consumer.
+ * @var mr_bool_t __MR_TEST_T::broken
+ * It indicates that the consumer received a window which doesn't match the code.
+ * @var mr_test_state_t __MR_TEST_T::state
+ * Shared state of the test (the \a runs field counts the checked streams).
+*/
+struct __MR_TEST_T
+{
+    mr_chr_t code[MR_TEST_SIZE];
+    mr_long_t size;
+    FILE *file;
+
+    mr_lexer_t ref;
+    mr_byte_t retcode;
+
+    mr_token_t tokens[MR_TEST_SIZE + 1];
+#ifdef __MR_TOKEN_SPANS__
+    mr_idx_t ends[MR_TEST_SIZE + 1];
+#endif
+    mr_long_t tsize;
+    mr_bool_t broken;
+
+    mr_test_state_t state;
+};
+typedef struct __MR_TEST_T mr_test_t;
+
+/**
+ * Long lines with an illegal character that the window cuts off. \n
+ * The first one is the line that was printed truncated when the code was read from the standard input.
+*/
+const mr_test_line_t mr_test_lines[] =
+{
+    {65230, 65530, 66063, MR_LEXER_STREAM_CHUNK},
+    {0, 3, 100, 1},
+    {20, 40, 300, 16},
+    {10, 12, 200, 7},
+    {0, 60, 61, 64}
+};
+
+/**
+ * Sizes of the chunks that the random codes are streamed with.
+*/
+const mr_long_t mr_test_chunks[] = {1, 2, 3, 4, 5, 8, 13, 32, 256};
+
+/**
+ * Parts of the random codes. The first <em>MR_TEST_LEGAL_FRAGS</em> parts can't make an error on their own.
+*/
+mr_str_ct mr_test_frags[] =
+{
+    "a = 1\n", "b + c\n", "x", "1", "1.5", "0x1f", " ..", "a.b", "# c\n", "#* c\n *#", "\n", ";", " ", "\t", "\r\n",
+    "(", ")", "\"abc\"", "'\\x41'", "f\"x{a}y\"\n", "f\"{f'{b}'}\"\n", "f'{1}{2}'", "\xc3\xa9 = 2\n", "\"\xe2\x82\xac\"",
+    "1e", ".", "#*", "*#", "\"", "'", "\\", "f\"", "f\"{", "}\"", "{", "}", "\xe2\x82", "\xef\xbb\xbf", "`"
+};
+
+/**
+ * It sets the code to a fixed case.
+ * @param test
+ * State of the test.
+ * @param line
+ * The fixed case.
+*/
+void mr_test_line(
+    mr_test_t *test, const mr_test_line_t *line);
+
+/**
+ * It lexes the code with the \a mr_lexer function, And streams it with each chunk size, With and without a consumer.
+ * @param test
+ * State of the test.
+ * @param chunks
+ * List of the chunk sizes.
+ * @param count
+ * Number of the chunk sizes.
+*/
+void mr_test_code(
+    mr_test_t *test, const mr_long_t *chunks, mr_long_t count);
+
+/**
+ * It streams the code and compares the result with the result of the \a mr_lexer function.
+ * @param test
+ * State of the test.
+ * @param chunk
+ * Number of characters read from the file at once.
+ * @param consumer
+ * It indicates whether the tokens should be handed over to a consumer (MR_TRUE) or kept (MR_FALSE).
+ * @return It returns true if they match. Otherwise, it returns false.
+*/
+mr_bool_t mr_test_stream(
+    mr_test_t *test, mr_long_t chunk, mr_bool_t consumer);
+
+/**
+ * The consumer of the streams. It appends tokens of the batch to the \a tokens list of the test.
+ * @param arg
+ * State of the test.
+ * @param batch
+ * The batch.
+ * @return It returns <em>MR_NOERROR</em>.
+*/
+mr_byte_t mr_test_consumer(
+    mr_ptr_t arg, mr_lexer_batch_t *batch);
+
+/**
+ * It compares a list of tokens with the result of the \a mr_lexer function.
+ * @param test
+ * State of the test.
+ * @param tokens
+ * The list (ended with an <em>MR_TOKEN_EOF</em> token).
+ * @param ends
+ * Ending index of each token (only used with token spans enabled).
+ * @param size
+ * Number of tokens in the list (without the <em>MR_TOKEN_EOF</em> token).
+ * @return It returns true if they match. Otherwise, it returns false.
+*/
+mr_bool_t mr_test_tokens(
+    mr_test_t *test, const mr_token_t *tokens, const mr_idx_t *ends, mr_long_t size);
+
+/**
+ * It checks that the window of an illegal character error matches the code and reaches the end of the line of the error.
+ * @param test
+ * State of the test.
+ * @param res
+ * Result of the stream.
+ * @return It returns true if the window is correct. Otherwise, it returns false.
+*/
+mr_bool_t mr_test_window(
+    mr_test_t *test, const mr_lexer_stream_t *res);
+
+int main(void)
+{
+    static mr_test_t test;
+    mr_long_t i;
+
+    for (i = 0; i != sizeof(mr_test_lines) / sizeof(*mr_test_lines); i++)
+    {
+        mr_test_line(&test, mr_test_lines + i);
+        mr_test_code(&test, &mr_test_lines[i].chunk, 1);
+    }
+
+    test.state.seed = MR_TEST_SEED;
+    for (i = 0; i != MR_TEST_CODES; i++)
+    {
+        test.size = 0;
+        mr_test_frag(&test.state, test.code, &test.size, MR_TEST_CODE_SIZE,
+            mr_test_frags, i % 2 ? MR_TEST_LEGAL_FRAGS : sizeof(mr_test_frags) / sizeof(*mr_test_frags),
+            mr_test_rand(&test.state, MR_TEST_PARTS) + 1);
+        mr_test_code(&test, mr_test_chunks, sizeof(mr_test_chunks) / sizeof(*mr_test_chunks));
+    }
+
+    return mr_test_report(&test.state, "streams");
+}
+
+void mr_test_line(
+    mr_test_t *test, const mr_test_line_t *line)
+{
+    mr_long_t i;
+
+    for (i = 0; i != line->start; i++)
+        test->code[i] = (i + 1) % 8 && i + 1 != line->start ? 'a' : '\n';
+    for (; i != line->error; i++)
+        test->code[i] = 'c';
+    test->code[i++] = '`';
+    for (; i != line->end; i++)
+        test->code[i] = 'd';
+
+    test->size = i;
+    memcpy(test->code + test->size, "\nx = 2\n", 7 * sizeof(mr_chr_t));
+    test->size += 7;
+}
+
+void mr_test_code(
+    mr_test_t *test, const mr_long_t *chunks, mr_long_t count)
+{
+    mr_str_t code;
+    mr_long_t i;
+    mr_byte_t consumer;
+
+    code = mr_mem_malloc(MR_MEM_SOURCE, (test->size + MR_LEXER_MARGIN) * sizeof(mr_chr_t));
+    test->file = tmpfile();
+    if (!code || !test->file || fwrite(test->code, sizeof(mr_chr_t), test->size, test->file) != test->size)
+    {
+        printf("Code %" PRIu32 ": Preparing the code failed\n", test->state.runs);
+        test->state.failures++;
+        if (test->file)
+            fclose(test->file);
+        mr_mem_free(code);
+        return;
+    }
+
+    memcpy(code, test->code, test->size * sizeof(mr_chr_t));
+    memset(code + test->size, '\0', MR_LEXER_MARGIN * sizeof(mr_chr_t));
+
+    _mr_config = (mr_config_t){.outstream=stdout, .instream=stdin, .errstream=stderr,
+        .code=code, .fname="stream", .size=test->size, .source=MR_CONFIG_SOURCE_HEAP};
+    test->retcode = mr_lexer(&test->ref);
+    if (test->retcode == MR_NOERROR)
+    {
+        mr_pool_consts_free(&_mr_pool_consts);
+        mr_pool_syms_free(&_mr_pool_syms);
+        mr_pool_strs_free(&_mr_pool_strs);
+    }
+    mr_mem_free(code);
+
+    for (i = 0; i != count; i++)
+        for (consumer = 0; consumer != 2; consumer++)
+        {
+            test->state.runs++;
+            if (!mr_test_stream(test, chunks[i], consumer) && mr_test_fail(&test->state))
+                printf("Stream %" PRIu32 ": Streaming with chunks of %" PRIu32 " characters (%s) gives a different result for:\n%.*s\n",
+                    test->state.runs, chunks[i], consumer ? "consumer" : "no consumer",
+                    (int)(test->size < MR_TEST_CODE_SIZE ? test->size : MR_TEST_CODE_SIZE), test->code);
+        }
+
+    if (test->retcode == MR_NOERROR)
+        mr_mem_free(test->ref.tokens);
+    fclose(test->file);
+}
+
+mr_bool_t mr_test_stream(
+    mr_test_t *test, mr_long_t chunk, mr_bool_t consumer)
+{
+    mr_lexer_stream_t res;
+    mr_byte_t retcode;
+    mr_bool_t match;
+    const mr_idx_t *ends;
+
+    rewind(test->file);
+    test->tsize = 0;
+    test->broken = MR_FALSE;
+
+    _mr_config = (mr_config_t){.outstream=stdout, .instream=stdin, .errstream=stderr, .fname="stream"};
+    res = (mr_lexer_stream_t){.file=test->file, .chunk=chunk, .consumer=consumer ? mr_test_consumer : NULL, .arg=test};
+    retcode = mr_lexer_stream(&res);
+
+    if (retcode != test->retcode)
+        match = MR_FALSE;
+    else if (retcode != MR_NOERROR)
+        match = res.lexer.error.idx == test->ref.error.idx && res.lexer.error.expected == test->ref.error.expected &&
+            res.lexer.error.size == test->ref.error.size &&
+            !memcmp(res.lexer.error.chr, test->ref.error.chr, res.lexer.error.size * sizeof(mr_chr_t)) &&
+            mr_test_window(test, &res);
+    else if (consumer)
+    {
+#ifdef __MR_TOKEN_SPANS__
+        ends = test->ends;
+#else
+        ends = NULL;
+#endif
+        match = !test->broken && test->tsize && mr_test_tokens(test, test->tokens, ends, test->tsize - 1);
+    }
+    else
+    {
+#ifdef __MR_TOKEN_SPANS__
+        ends = res.lexer.ends;
+#else
+        ends = NULL;
+#endif
+        match = res.base == 0 && res.size == test->size && !memcmp(res.code, test->code, test->size * sizeof(mr_chr_t)) &&
+            mr_test_tokens(test, res.lexer.tokens, ends, res.lexer.size);
+    }
+
+    if (retcode == MR_NOERROR)
+    {
+        if (!consumer)
+            mr_mem_free(res.lexer.tokens);
+        mr_pool_consts_free(&_mr_pool_consts);
+        mr_pool_syms_free(&_mr_pool_syms);
+        mr_pool_strs_free(&_mr_pool_strs);
+    }
+    mr_mem_free(res.code);
+    return match;
+}
+
+mr_byte_t mr_test_consumer(
+    mr_ptr_t arg, mr_lexer_batch_t *batch)
+{
+    mr_test_t *test;
+    mr_long_t i;
+
+    test = arg;
+    if (batch->base + batch->release > test->size ||
+        memcmp(batch->code, test->code + batch->base, batch->release * sizeof(mr_chr_t)))
+        test->broken = MR_TRUE;
+
+    for (i = 0; i != batch->size; i++)
+    {
+        test->tokens[test->tsize] = (mr_token_t){.type=batch->tokens[i].type,
+            .idx=MR_IDX_DECOMPOSE(MR_IDX_EXTRACT(batch->tokens[i].idx) + batch->base)};
+#ifdef __MR_TOKEN_SPANS__
+        test->ends[test->tsize] = MR_IDX_DECOMPOSE(MR_IDX_EXTRACT(batch->ends[i]) + batch->base);
+#endif
+        test->tsize++;
+    }
+    return MR_NOERROR;
+}
+
+mr_bool_t mr_test_tokens(
+    mr_test_t *test, const mr_token_t *tokens, const mr_idx_t *ends, mr_long_t size)
+{
+    mr_long_t i;
+
+    if (size != test->ref.size)
+        return MR_FALSE;
+
+    for (i = 0; i <= size; i++)
+        if (tokens[i].type != test->ref.tokens[i].type ||
+            MR_IDX_EXTRACT(tokens[i].idx) != MR_IDX_EXTRACT(test->ref.tokens[i].idx))
+            return MR_FALSE;
+
+#ifdef __MR_TOKEN_SPANS__
+    for (i = 0; i <= size; i++)
+        if (MR_IDX_EXTRACT(ends[i]) != MR_IDX_EXTRACT(test->ref.ends[i]))
+            return MR_FALSE;
+#else
+    (void)ends;
+#endif
+    return MR_TRUE;
+}
+
+mr_bool_t mr_test_window(
+    mr_test_t *test, const mr_lexer_stream_t *res)
+{
+    mr_long_t end;
+
+    if (!res->code || res->base > res->lexer.error.idx || res->base + res->size > test->size ||
+        memcmp(res->code, test->code + res->base, res->size * sizeof(mr_chr_t)))
+        return MR_FALSE;
+
+    for (end = res->lexer.error.idx; end != test->size; end++)
+        if (test->code[end] == '\n')
+            return res->base + res->size > end;
+    return res->base + res->size == test->size;
+}
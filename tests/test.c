@@ -0,0 +1,65 @@
+/*
+MIT License
+
+Copyright (c) 2023 MetaReal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+*/
+
+/**
+ * @file test.c
+ * This file contains definitions of the \a test.h file.
+*/
+
+#include <test.h>
+#include <stdio.h>
+#include <string.h>
+
+mr_long_t mr_test_rand(
+    mr_test_state_t *state, mr_long_t range)
+{
+    state->seed ^= state->seed << 13;
+    state->seed ^= state->seed >> 7;
+    state->seed ^= state->seed << 17;
+    return (mr_long_t)((state->seed >> 32) % range);
+}
+
+void mr_test_frag(
+    mr_test_state_t *state, mr_str_t str, mr_long_t *size, mr_long_t max,
+    const mr_str_ct *frags, mr_long_t range, mr_long_t count)
+{
+    mr_str_ct frag;
+    mr_long_t fsize;
+
+    for (; count; count--)
+    {
+        frag = frags[mr_test_rand(state, range)];
+        fsize = (mr_long_t)strlen(frag);
+        if (*size + fsize > max)
+            return;
+
+        memcpy(str + *size, frag, fsize * sizeof(mr_chr_t));
+        *size += fsize;
+    }
+}
+
+mr_bool_t mr_test_fail(
+    mr_test_state_t *state)
+{
+    return state->failures++ < MR_TEST_PRINTS;
+}
+
+int mr_test_report(
+    const mr_test_state_t *state, mr_str_ct name)
+{
+    printf("%" PRIu32 " %s, %" PRIu32 " failures\n", state->runs, name, state->failures);
+    return state->failures != 0;
+}
@@ -0,0 +1,110 @@
+/*
+MIT License
+
+Copyright (c) 2023 MetaReal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+*/
+
+/**
+ * @file test.h
+ * This file contains the shared parts of the tests (see the \a MR_TESTS build option). \n
+ * Random cases are generated from a fixed seed, So every run of a test checks the same cases. \n
+ * All things defined in \a test.c and this file have the \a mr_test prefix.
+*/
+
+#ifndef __MR_TEST__
+#define __MR_TEST__
+
+#include <defs.h>
+
+/**
+ * Seed of the random cases.
+*/
+#define MR_TEST_SEED ((uint64_t)0x9e3779b97f4a7c15)
+
+/**
+ * Maximum number of the printed failures.
+*/
+#define MR_TEST_PRINTS ((mr_long_t)8)
+
+/**
+ * @struct __MR_TEST_STATE_T
+ * Shared state of a test.
+ * @var mr_long_t __MR_TEST_STATE_T::runs
+ * Number of the checked cases.
+ * @var mr_long_t __MR_TEST_STATE_T::failures
+ * Number of the failed cases.
+ * @var uint64_t __MR_TEST_STATE_T::seed
+ * State of the random number generator (xorshift64).
+*/
+struct __MR_TEST_STATE_T
+{
+    mr_long_t runs;
+    mr_long_t failures;
+    uint64_t seed;
+};
+typedef struct __MR_TEST_STATE_T mr_test_state_t;
+
+/**
+ * It returns a random number between zero and \a range (exclusive).
+ * @param state
+ * State of the test.
+ * @param range
+ * The range.
+ * @return It returns the number.
+*/
+mr_long_t mr_test_rand(
+    mr_test_state_t *state, mr_long_t range);
+
+/**
+ * It appends random parts to the \a str. \n
+ * Appending stops at the first part that doesn't fit in the string.
+ * @param state
+ * State of the test.
+ * @param str
+ * The string.
+ * @param size
+ * Size of the string (it's updated).
+ * @param max
+ * Maximum size of the string.
+ * @param frags
+ * List of the parts.
+ * @param range
+ * Number of the first parts of the \a frags list that can be chosen.
+ * @param count
+ * Number of the parts.
+*/
+void mr_test_frag(
+    mr_test_state_t *state, mr_str_t str, mr_long_t *size, mr_long_t max,
+    const mr_str_ct *frags, mr_long_t range, mr_long_t count);
+
+/**
+ * It counts a failed case.
+ * @param state
+ * State of the test.
+ * @return It returns true if the failure should be printed (only the first <em>MR_TEST_PRINTS</em> failures are printed).
+*/
+mr_bool_t mr_test_fail(
+    mr_test_state_t *state);
+
+/**
+ * It prints the number of the checked cases and the failures.
+ * @param state
+ * State of the test.
+ * @param name
+ * Name of the cases (like "edits").
+ * @return It returns the exit code of the test (zero if there isn't any failure).
+*/
+int mr_test_report(
+    const mr_test_state_t *state, mr_str_ct name);
+
+#endif
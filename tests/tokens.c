@@ -0,0 +1,254 @@
+/*
+MIT License
+
+Copyright (c) 2023 MetaReal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+*/
+
+/**
+ * @file tokens.c
+ * Token dump test of the lexer engines. \n
+ * Every case is lexed by the \a mr_lexer function, And its tokens (type, starting index, and the code up to the next token) or its error are dumped.
+ * The dump must match the expected dump in \a tokens.txt, Which is checked in. The test runs in both the default build
+ * and the \a MR_LEXER_DFA build, So the hand-written engine and the table-driven engine are tested against each other. \n
+ * The cases cover the operators, The longest match with backtracking (like ".." which is lexed as two dots), Numbers,
+ * Strings, Formatted strings, Comments, And errors. \n
+ * Usage: <em>test_tokens [expected]</em>. Without the expected dump, It prints the dump (to regenerate the \a tokens.txt file).
+*/
+
+#include <lexer/lexer.h>
+#include <pool.h>
+#include <mem.h>
+#include <config.h>
+#include <consts.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * The cases.
+*/
+mr_str_ct mr_test_cases[] =
+{
+    /* Operators. */
+    "+ ++ += - -- -= -> * *= ** **= / /= // //= % %=",
+    "& &= && | |= || ^ ^= ~ !",
+    "= == === != !== < <= << <<= > >= >> >>=",
+    "( ) [ ] , . ... : ? $",
+    "a+++b", "a---b", "a****b", "a<<<=b", "a>>>=b", "a!===b", "a====b", "a&&&b", "a|||b", "a//=/b",
+
+    /* Longest match with backtracking. */
+    "..", "....", ".....", "a..b", "a...b", "1..2", "1...2", ".5..", "1.e", "a.1",
+
+    /* Numbers. */
+    "0 12 1.5 .5 1. 1e5 1.5e-3 1e 1e+ 0x1f 0b101 0o17 3i 2.5i 007",
+
+    /* Keywords, types, and identifiers. */
+    "and or not if else return true false none int float str fstr object",
+    "_a1 aB iff int_ \xc3\xa9t\xc3\xa9 f fa f1",
+
+    /* Characters and strings. */
+    "'a' '\\n' '\\x41' \"abc\" \"a\\\"b\" \"a\nb\" '\"' \"'\"",
+
+    /* Formatted strings. */
+    "f\"x{a}y\"", "f'{1}{2}'", "f\"{f'{b}'}\"", "f\"{ {1: 2} }\"", "f\"{a + {b}}\"", "f\"\"", "f\"{}\"", "f\"a\\{b\"",
+
+    /* Newlines, semicolons, and comments. */
+    "a\n\n;b;\n;c", "a # c\nb", "a #* c\nd *# b", "(\n1\n)", "return\nx", "+\n1",
+
+    /* Errors. */
+    "`", "a = \xe2\x82\xac", "a \xe2\x82 b", "\"abc", "'ab'", "'\\", "f\"{1", "f\"{a}", "#* c", "1 \\ 2", "a\n}", "\"\\q\" @"
+};
+
+/**
+ * It writes a part of the code with its special characters escaped.
+ * @param file
+ * The output.
+ * @param str
+ * The part.
+ * @param size
+ * Size of the part.
+*/
+void mr_test_escape(
+    FILE *file, mr_str_ct str, mr_long_t size);
+
+/**
+ * It lexes the cases and dumps the results.
+ * @param file
+ * The output.
+ * @return It returns a code which indicates if the process was successful or not. \n
+ * If the process was successful, it returns <em>MR_NOERROR</em>. Otherwise, it returns <em>MR_ERROR_NOT_ENOUGH_MEMORY</em>.
+*/
+mr_byte_t mr_test_dump(
+    FILE *file);
+
+/**
+ * It compares the dump with the expected dump.
+ * @param dump
+ * The dump.
+ * @param expected
+ * The expected dump.
+ * @return It returns true if they match. Otherwise, it returns false.
+*/
+mr_bool_t mr_test_compare(
+    FILE *dump, FILE *expected);
+
+int main(int argc, char **argv)
+{
+    FILE *dump, *expected;
+    mr_bool_t match;
+
+    if (argc < 2)
+        return mr_test_dump(stdout) != MR_NOERROR;
+
+    expected = fopen(argv[1], "rb");
+    if (!expected)
+    {
+        printf("Can't open the expected dump \"%s\"\n", argv[1]);
+        return 1;
+    }
+
+    dump = tmpfile();
+    if (!dump || mr_test_dump(dump) != MR_NOERROR)
+    {
+        puts("Dumping the tokens failed");
+        if (dump)
+            fclose(dump);
+        fclose(expected);
+        return 1;
+    }
+
+    rewind(dump);
+    match = mr_test_compare(dump, expected);
+    fclose(dump);
+    fclose(expected);
+
+    printf("%" PRIu32 " cases, %s\n", (mr_long_t)(sizeof(mr_test_cases) / sizeof(*mr_test_cases)),
+        match ? "The dump matches" : "The dump doesn't match");
+    return !match;
+}
+
+void mr_test_escape(
+    FILE *file, mr_str_ct str, mr_long_t size)
+{
+    mr_long_t i;
+    mr_chr_t chr;
+
+    fputc('"', file);
+    for (i = 0; i != size; i++)
+    {
+        chr = str[i];
+        if (chr == '\n')
+            fputs("\\n", file);
+        else if (chr == '"' || chr == '\\')
+            fprintf(file, "\\%c", chr);
+        else if ((mr_byte_t)chr < 0x20 || (mr_byte_t)chr >= 0x7f)
+            fprintf(file, "\\x%02" PRIX8, (mr_byte_t)chr);
+        else
+            fputc(chr, file);
+    }
+    fputc('"', file);
+}
+
+mr_byte_t mr_test_dump(
+    FILE *file)
+{
+    mr_str_t code;
+    mr_long_t i, size, idx, end;
+    mr_byte_t retcode;
+    mr_lexer_t res;
+    mr_token_t *token;
+
+    for (i = 0; i != sizeof(mr_test_cases) / sizeof(*mr_test_cases); i++)
+    {
+        size = (mr_long_t)strlen(mr_test_cases[i]);
+        code = mr_mem_malloc(MR_MEM_SOURCE, (size + MR_LEXER_MARGIN) * sizeof(mr_chr_t));
+        if (!code)
+            return MR_ERROR_NOT_ENOUGH_MEMORY;
+
+        memcpy(code, mr_test_cases[i], size * sizeof(mr_chr_t));
+        memset(code + size, '\0', MR_LEXER_MARGIN * sizeof(mr_chr_t));
+
+        _mr_config = (mr_config_t){.outstream=stdout, .instream=stdin, .errstream=stderr,
+            .code=code, .fname="tokens", .size=size, .source=MR_CONFIG_SOURCE_HEAP};
+        retcode = mr_lexer(&res);
+
+        fprintf(file, "case %" PRIu32 ": ", i);
+        mr_test_escape(file, code, size);
+        fputc('\n', file);
+
+        if (retcode == MR_ERROR_NOT_ENOUGH_MEMORY)
+        {
+            mr_mem_free(code);
+            return retcode;
+        }
+
+        if (retcode != MR_NOERROR)
+        {
+            fprintf(file, "    error %" PRIu32 " %s ", res.error.idx, res.error.expected ? "expected" : "illegal");
+            mr_test_escape(file, res.error.chr, res.error.size);
+            fputc('\n', file);
+            mr_mem_free(code);
+            continue;
+        }
+
+        for (token = res.tokens; token->type != MR_TOKEN_EOF; token++)
+        {
+            idx = MR_IDX_EXTRACT(token->idx);
+            fprintf(file, "    %" PRIu8 " %" PRIu32 " ", token->type, idx);
+
+            /* Sizes of the tokens depend on the token spans option, So the text runs up to the next token. */
+            end = MR_IDX_EXTRACT(token[1].idx);
+            while (end > idx && (code[end - 1] == ' ' || code[end - 1] == '\t' || code[end - 1] == '\r'))
+                end--;
+            mr_test_escape(file, code + idx, end - idx);
+            fputc('\n', file);
+        }
+        fprintf(file, "    eof %" PRIu32 "\n", MR_IDX_EXTRACT(token->idx));
+
+        mr_mem_free(res.tokens);
+        mr_pool_consts_free(&_mr_pool_consts);
+        mr_pool_syms_free(&_mr_pool_syms);
+        mr_pool_strs_free(&_mr_pool_strs);
+        mr_mem_free(code);
+    }
+
+    return MR_NOERROR;
+}
+
+mr_bool_t mr_test_compare(
+    FILE *dump, FILE *expected)
+{
+    mr_long_t line;
+    int chr1, chr2;
+
+    line = 1;
+    do
+    {
+        chr1 = fgetc(dump);
+        chr2 = fgetc(expected);
+
+        /* The expected dump can be checked out with CRLF newlines. */
+        if (chr2 == '\r')
+            chr2 = fgetc(expected);
+
+        if (chr1 != chr2)
+        {
+            printf("Line %" PRIu32 " of the dump doesn't match the expected dump\n", line);
+            return MR_FALSE;
+        }
+
+        if (chr1 == '\n')
+            line++;
+    } while (chr1 != EOF);
+
+    return MR_TRUE;
+}
@@ -0,0 +1,647 @@
+/*
+MIT License
+
+Copyright (c) 2023 MetaReal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+*/
+
+/**
+ * @file dfagen.c
+ * Build-time generator of the table-driven lexer engine. \n
+ * It reads the token specification (\a dfa.spec file), groups characters into classes,
+ * builds a DFA over the token rules (subset construction), and writes the tables into a C header. \n
+ * Usage: `dfagen <spec> <header>` \n
+ * All things defined in this file have the \a mr_dfagen prefix.
+*/
+
+#include <defs.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Maximum number of character sets (classes and literal characters) in the specification.
+*/
+#define MR_DFAGEN_SET_MAXSIZE 256
+
+/**
+ * Maximum number of rules in the specification.
+*/
+#define MR_DFAGEN_RULE_MAXSIZE 128
+
+/**
+ * Maximum number of steps (characters or classes) in a single pattern.
+*/
+#define MR_DFAGEN_STEP_MAXSIZE 7
+
+/**
+ * Maximum number of DFA states (state 0 is the dead state).
+*/
+#define MR_DFAGEN_STATE_MAXSIZE 256
+
+/**
+ * Maximum number of actions.
+*/
+#define MR_DFAGEN_ACTION_MAXSIZE 32
+
+/**
+ * Maximum size of a name (class, token type, or action).
+*/
+#define MR_DFAGEN_NAME_MAXSIZE 64
+
+/**
+ * Number of items (rule and position pairs) in the \a items field of a DFA state.
+*/
+#define MR_DFAGEN_ITEM_COUNT (MR_DFAGEN_RULE_MAXSIZE * (MR_DFAGEN_STEP_MAXSIZE + 1))
+
+/**
+ * @struct __MR_DFAGEN_SET_T
+ * A set of characters.
+ * @var __MR_DFAGEN_SET_T::name
+ * Name of the set (empty for literal characters).
+ * @var __MR_DFAGEN_SET_T::chrs
+ * Membership of all 256 characters.
+*/
+struct __MR_DFAGEN_SET_T
+{
+    mr_chr_t name[MR_DFAGEN_NAME_MAXSIZE];
+    mr_bool_t chrs[256];
+};
+typedef struct __MR_DFAGEN_SET_T mr_dfagen_set_t;
+
+/**
+ * @struct __MR_DFAGEN_RULE_T
+ * A token rule.
+ * @var __MR_DFAGEN_RULE_T::steps
+ * Character sets of the pattern (indices of the \a sets list).
+ * @var __MR_DFAGEN_RULE_T::size
+ * Number of steps.
+ * @var __MR_DFAGEN_RULE_T::result
+ * Token type name or action index (based on the \a action field).
+ * @var __MR_DFAGEN_RULE_T::action
+ * Action index plus one, Or zero if the rule produces a token.
+*/
+struct __MR_DFAGEN_RULE_T
+{
+    mr_short_t steps[MR_DFAGEN_STEP_MAXSIZE];
+    mr_byte_t size;
+    mr_chr_t result[MR_DFAGEN_NAME_MAXSIZE];
+    mr_byte_t action;
+};
+typedef struct __MR_DFAGEN_RULE_T mr_dfagen_rule_t;
+
+/**
+ * @struct __MR_DFAGEN_STATE_T
+ * A DFA state.
+ * @var __MR_DFAGEN_STATE_T::items
+ * Set of rule positions that are alive in the state (item = rule * (MR_DFAGEN_STEP_MAXSIZE + 1) + position).
+ * @var __MR_DFAGEN_STATE_T::next
+ * Transitions of the state (indexed by character class).
+ * @var __MR_DFAGEN_STATE_T::rule
+ * Index of the rule accepted by the state plus one, Or zero if the state doesn't accept.
+*/
+struct __MR_DFAGEN_STATE_T
+{
+    mr_bool_t items[MR_DFAGEN_ITEM_COUNT];
+    mr_byte_t next[256];
+    mr_byte_t rule;
+};
+typedef struct __MR_DFAGEN_STATE_T mr_dfagen_state_t;
+
+mr_dfagen_set_t mr_dfagen_sets[MR_DFAGEN_SET_MAXSIZE]; /**< Character sets of the specification */
+mr_short_t mr_dfagen_sets_size = 0; /**< Number of character sets */
+
+mr_dfagen_rule_t mr_dfagen_rules[MR_DFAGEN_RULE_MAXSIZE]; /**< Rules of the specification */
+mr_byte_t mr_dfagen_rules_size = 0; /**< Number of rules */
+
+mr_chr_t mr_dfagen_actions[MR_DFAGEN_ACTION_MAXSIZE][MR_DFAGEN_NAME_MAXSIZE]; /**< Names of the actions */
+mr_byte_t mr_dfagen_actions_size = 0; /**< Number of actions */
+
+mr_byte_t mr_dfagen_class[256]; /**< Character class of each character */
+mr_short_t mr_dfagen_class_size; /**< Number of character classes */
+
+mr_dfagen_state_t mr_dfagen_states[MR_DFAGEN_STATE_MAXSIZE]; /**< States of the DFA */
+mr_short_t mr_dfagen_states_size; /**< Number of DFA states */
+
+mr_long_t mr_dfagen_line = 0; /**< Current line of the specification (for error messages) */
+
+/**
+ * It prints out an error message that refers to the current line of the specification and exits.
+ * @param msg
+ * The error message.
+*/
+void mr_dfagen_error(
+    mr_str_ct msg);
+
+/**
+ * It parses a single line of the specification.
+ * @param line
+ * The line.
+*/
+void mr_dfagen_parse(
+    mr_str_t line);
+
+/**
+ * It parses a quoted string and decodes its escape sequences.
+ * @param str
+ * Pointer to the opening quote. It will be advanced past the closing quote.
+ * @param dst
+ * Buffer for the decoded characters.
+ * @return It returns number of the decoded characters.
+*/
+mr_short_t mr_dfagen_quoted(
+    mr_str_t *str, mr_chr_t *dst);
+
+/**
+ * It parses a name (letters, digits, and underscores).
+ * @param str
+ * Pointer to the first character of the name. It will be advanced past the name.
+ * @param dst
+ * Buffer for the name.
+*/
+void mr_dfagen_name(
+    mr_str_t *str, mr_chr_t *dst);
+
+/**
+ * It groups characters into classes. \n
+ * Two characters belong to the same class if every set of the specification contains either both or none of them. \n
+ * Characters that are not in any set belong to class 0.
+*/
+void mr_dfagen_classify(void);
+
+/**
+ * It builds the DFA states with subset construction.
+*/
+void mr_dfagen_build(void);
+
+/**
+ * It writes the generated header.
+ * @param file
+ * The output file.
+ * @param spec
+ * Path of the specification (for the header comment).
+*/
+void mr_dfagen_write(
+    FILE *file, mr_str_ct spec);
+
+int main(
+    int argc, mr_str_ct argv[])
+{
+    mr_chr_t line[1024];
+    FILE *file;
+
+    if (argc != 3)
+    {
+        fputs("Usage: dfagen <spec> <header>\n", stderr);
+        return 1;
+    }
+
+    file = fopen(argv[1], "r");
+    if (!file)
+    {
+        fprintf(stderr, "dfagen: Can not open the file \"%s\"\n", argv[1]);
+        return 1;
+    }
+
+    while (fgets(line, sizeof(line), file))
+    {
+        mr_dfagen_line++;
+        mr_dfagen_parse(line);
+    }
+    fclose(file);
+
+    mr_dfagen_classify();
+    mr_dfagen_build();
+
+    file = fopen(argv[2], "w");
+    if (!file)
+    {
+        fprintf(stderr, "dfagen: Can not create the file \"%s\"\n", argv[2]);
+        return 1;
+    }
+
+    mr_dfagen_write(file, argv[1]);
+    fclose(file);
+    return 0;
+}
+
+void mr_dfagen_error(
+    mr_str_ct msg)
+{
+    if (mr_dfagen_line)
+        fprintf(stderr, "dfagen: line %" PRIu32 ": %s\n", mr_dfagen_line, msg);
+    else
+        fprintf(stderr, "dfagen: %s\n", msg);
+    exit(1);
+}
+
+void mr_dfagen_parse(
+    mr_str_t line)
+{
+    mr_chr_t buf[256], name[MR_DFAGEN_NAME_MAXSIZE];
+    mr_short_t size, i;
+    mr_dfagen_set_t *set;
+    mr_dfagen_rule_t *rule;
+
+    while (*line == ' ' || *line == '\t')
+        line++;
+    if (*line == '#' || *line == '\n' || *line == '\r' || *line == '\0')
+        return;
+
+    if (!strncmp(line, "class", 5) && (line[5] == ' ' || line[5] == '\t'))
+    {
+        if (mr_dfagen_sets_size == MR_DFAGEN_SET_MAXSIZE)
+            mr_dfagen_error("too many character sets");
+
+        line += 5;
+        while (*line == ' ' || *line == '\t')
+            line++;
+
+        set = mr_dfagen_sets + mr_dfagen_sets_size++;
+        memset(set, 0, sizeof(mr_dfagen_set_t));
+        mr_dfagen_name(&line, set->name);
+
+        while (*line == ' ' || *line == '\t')
+            line++;
+        size = mr_dfagen_quoted(&line, buf);
+
+        for (i = 0; i != size; i++)
+        {
+            if (i + 2 < size && buf[i + 1] == '-')
+            {
+                mr_short_t chr;
+
+                for (chr = (mr_byte_t)buf[i]; chr <= (mr_byte_t)buf[i + 2]; chr++)
+                    set->chrs[chr] = MR_TRUE;
+
+                i += 2;
+                continue;
+            }
+
+            set->chrs[(mr_byte_t)buf[i]] = MR_TRUE;
+        }
+
+        return;
+    }
+
+    if (mr_dfagen_rules_size == MR_DFAGEN_RULE_MAXSIZE)
+        mr_dfagen_error("too many rules");
+
+    rule = mr_dfagen_rules + mr_dfagen_rules_size++;
+    memset(rule, 0, sizeof(mr_dfagen_rule_t));
+
+    while (*line == '"' || *line == '{')
+    {
+        if (*line == '{')
+        {
+            line++;
+            mr_dfagen_name(&line, name);
+            if (*line++ != '}')
+                mr_dfagen_error("expected '}'");
+
+            for (i = 0; i != mr_dfagen_sets_size; i++)
+                if (!strcmp(mr_dfagen_sets[i].name, name))
+                    break;
+            if (i == mr_dfagen_sets_size)
+                mr_dfagen_error("undefined class");
+
+            if (rule->size == MR_DFAGEN_STEP_MAXSIZE)
+                mr_dfagen_error("pattern is too long");
+            rule->steps[rule->size++] = i;
+            continue;
+        }
+
+        size = mr_dfagen_quoted(&line, buf);
+        for (i = 0; i != size; i++)
+        {
+            if (rule->size == MR_DFAGEN_STEP_MAXSIZE)
+                mr_dfagen_error("pattern is too long");
+            if (mr_dfagen_sets_size == MR_DFAGEN_SET_MAXSIZE)
+                mr_dfagen_error("too many character sets");
+
+            set = mr_dfagen_sets + mr_dfagen_sets_size;
+            memset(set, 0, sizeof(mr_dfagen_set_t));
+            set->chrs[(mr_byte_t)buf[i]] = MR_TRUE;
+
+            rule->steps[rule->size++] = mr_dfagen_sets_size++;
+        }
+    }
+
+    if (!rule->size)
+        mr_dfagen_error("expected a pattern");
+
+    while (*line == ' ' || *line == '\t')
+        line++;
+
+    if (*line == '@')
+    {
+        line++;
+        mr_dfagen_name(&line, rule->result);
+
+        for (i = 0; i != mr_dfagen_actions_size; i++)
+            if (!strcmp(mr_dfagen_actions[i], rule->result))
+                break;
+
+        if (i == mr_dfagen_actions_size)
+        {
+            if (mr_dfagen_actions_size == MR_DFAGEN_ACTION_MAXSIZE)
+                mr_dfagen_error("too many actions");
+
+            strcpy(mr_dfagen_actions[mr_dfagen_actions_size++], rule->result);
+        }
+
+        rule->action = (mr_byte_t)i + 1;
+    }
+    else
+        mr_dfagen_name(&line, rule->result);
+
+    if (!*rule->result)
+        mr_dfagen_error("expected a result");
+}
+
+mr_short_t mr_dfagen_quoted(
+    mr_str_t *str, mr_chr_t *dst)
+{
+    mr_short_t size;
+    mr_str_t ptr;
+
+    ptr = *str;
+    if (*ptr++ != '"')
+        mr_dfagen_error("expected '\"'");
+
+    size = 0;
+    while (*ptr != '"')
+    {
+        if (*ptr == '\0' || *ptr == '\n')
+            mr_dfagen_error("expected '\"'");
+        if (size == 255)
+            mr_dfagen_error("string is too long");
+
+        if (*ptr != '\\')
+        {
+            dst[size++] = *ptr++;
+            continue;
+        }
+
+        switch (*++ptr)
+        {
+        case 'n':
+            dst[size++] = '\n';
+            break;
+        case 't':
+            dst[size++] = '\t';
+            break;
+        case 'r':
+            dst[size++] = '\r';
+            break;
+        case '\\':
+        case '"':
+        case '\'':
+            dst[size++] = *ptr;
+            break;
+        default:
+            mr_dfagen_error("invalid escape sequence");
+        }
+
+        ptr++;
+    }
+
+    *str = ptr + 1;
+    return size;
+}
+
+void mr_dfagen_name(
+    mr_str_t *str, mr_chr_t *dst)
+{
+    mr_byte_t size;
+    mr_str_t ptr;
+
+    ptr = *str;
+    size = 0;
+    while ((*ptr >= 'A' && *ptr <= 'Z') || (*ptr >= 'a' && *ptr <= 'z') || (*ptr >= '0' && *ptr <= '9') || *ptr == '_')
+    {
+        if (size == MR_DFAGEN_NAME_MAXSIZE - 1)
+            mr_dfagen_error("name is too long");
+
+        dst[size++] = *ptr++;
+    }
+
+    if (!size)
+        mr_dfagen_error("expected a name");
+
+    dst[size] = '\0';
+    *str = ptr;
+}
+
+void mr_dfagen_classify(void)
+{
+    mr_short_t chr, prev, i;
+
+    memset(mr_dfagen_class, 0, sizeof(mr_dfagen_class));
+    mr_dfagen_class_size = 1;
+
+    for (chr = 0; chr != 256; chr++)
+    {
+        for (i = 0; i != mr_dfagen_sets_size; i++)
+            if (mr_dfagen_sets[i].chrs[chr])
+                break;
+        if (i == mr_dfagen_sets_size)
+            continue;
+
+        for (prev = 0; prev != chr; prev++)
+        {
+            if (!mr_dfagen_class[prev])
+                continue;
+
+            for (i = 0; i != mr_dfagen_sets_size; i++)
+                if (mr_dfagen_sets[i].chrs[chr] != mr_dfagen_sets[i].chrs[prev])
+                    break;
+            if (i == mr_dfagen_sets_size)
+                break;
+        }
+
+        if (prev != chr)
+            mr_dfagen_class[chr] = mr_dfagen_class[prev];
+        else
+        {
+            if (mr_dfagen_class_size == 256)
+                mr_dfagen_error("too many character classes");
+
+            mr_dfagen_class[chr] = (mr_byte_t)mr_dfagen_class_size++;
+        }
+    }
+}
+
+void mr_dfagen_build(void)
+{
+    mr_short_t state, chr, i;
+    mr_byte_t cls, r, p;
+    mr_bool_t items[MR_DFAGEN_ITEM_COUNT], alive;
+    mr_dfagen_rule_t *rule;
+
+    mr_dfagen_line = 0;
+
+    memset(mr_dfagen_states, 0, 2 * sizeof(mr_dfagen_state_t));
+    for (r = 0; r != mr_dfagen_rules_size; r++)
+        mr_dfagen_states[1].items[r * (MR_DFAGEN_STEP_MAXSIZE + 1)] = MR_TRUE;
+    mr_dfagen_states_size = 2;
+
+    for (state = 1; state != mr_dfagen_states_size; state++)
+    {
+        for (cls = 1; cls != mr_dfagen_class_size; cls++)
+        {
+            for (chr = 0; mr_dfagen_class[chr] != cls; chr++);
+
+            memset(items, 0, sizeof(items));
+            alive = MR_FALSE;
+
+            for (r = 0; r != mr_dfagen_rules_size; r++)
+            {
+                rule = mr_dfagen_rules + r;
+                for (p = 0; p != rule->size; p++)
+                    if (mr_dfagen_states[state].items[r * (MR_DFAGEN_STEP_MAXSIZE + 1) + p] &&
+                        mr_dfagen_sets[rule->steps[p]].chrs[chr])
+                    {
+                        items[r * (MR_DFAGEN_STEP_MAXSIZE + 1) + p + 1] = MR_TRUE;
+                        alive = MR_TRUE;
+                    }
+            }
+
+            if (!alive)
+                continue;
+
+            for (i = 2; i != mr_dfagen_states_size; i++)
+                if (!memcmp(mr_dfagen_states[i].items, items, sizeof(items)))
+                    break;
+
+            if (i == mr_dfagen_states_size)
+            {
+                if (mr_dfagen_states_size == MR_DFAGEN_STATE_MAXSIZE)
+                    mr_dfagen_error("too many DFA states");
+
+                memset(mr_dfagen_states + i, 0, sizeof(mr_dfagen_state_t));
+                memcpy(mr_dfagen_states[i].items, items, sizeof(items));
+                mr_dfagen_states_size++;
+
+                for (r = 0; r != mr_dfagen_rules_size; r++)
+                {
+                    rule = mr_dfagen_rules + r;
+                    if (!items[r * (MR_DFAGEN_STEP_MAXSIZE + 1) + rule->size])
+                        continue;
+
+                    if (mr_dfagen_states[i].rule)
+                    {
+                        rule = mr_dfagen_rules + mr_dfagen_states[i].rule - 1;
+                        if (strcmp(rule->result, mr_dfagen_rules[r].result) || rule->action != mr_dfagen_rules[r].action)
+                            mr_dfagen_error("ambiguous rules");
+                        continue;
+                    }
+
+                    mr_dfagen_states[i].rule = r + 1;
+                }
+            }
+
+            mr_dfagen_states[state].next[cls] = (mr_byte_t)i;
+        }
+    }
+}
+
+void mr_dfagen_write(
+    FILE *file, mr_str_ct spec)
+{
+    mr_short_t i, j;
+    mr_str_ct ptr;
+    mr_chr_t name[MR_DFAGEN_NAME_MAXSIZE];
+    mr_dfagen_rule_t *rule;
+
+    ptr = strrchr(spec, '/');
+    spec = ptr ? ptr + 1 : spec;
+
+    fputs("/*\n"
+        "MIT License\n\n"
+        "Copyright (c) 2023 MetaReal\n\n"
+        "Permission is hereby granted, free of charge, to any person obtaining a copy\n"
+        "of this software and associated documentation files (the \"Software\"), to deal\n"
+        "in the Software without restriction, including without limitation the rights\n"
+        "to use, copy, modify, merge, publish, distribute, sublicense, and/or sell\n"
+        "copies of the Software, and to permit persons to whom the Software is\n"
+        "furnished to do so, subject to the following conditions:\n\n"
+        "The above copyright notice and this permission notice shall be included in all\n"
+        "copies or substantial portions of the Software.\n"
+        "*/\n\n", file);
+
+    fprintf(file, "/**\n"
+        " * @file dfa.h\n"
+        " * Tables of the table-driven lexer engine. \\n\n"
+        " * This file is generated by the \\a dfagen tool from the \\a %s file. Do not edit it.\n"
+        "*/\n\n"
+        "#ifndef __MR_DFA__\n"
+        "#define __MR_DFA__\n\n"
+        "#include <lexer/token.h>\n\n", spec);
+
+    fputs("/**\n * Starting state of the DFA (state 0 is the dead state).\n*/\n"
+        "#define MR_LEXER_DFA_START ((mr_byte_t)1)\n\n", file);
+    fprintf(file, "/**\n * Number of character classes.\n*/\n"
+        "#define MR_LEXER_DFA_CLASS_COUNT %" PRIu16 "\n\n", mr_dfagen_class_size);
+    fprintf(file, "/**\n * Number of DFA states.\n*/\n"
+        "#define MR_LEXER_DFA_STATE_COUNT %" PRIu16 "\n\n", mr_dfagen_states_size);
+
+    fputs("/**\n * Action of a non-accepting state.\n*/\n"
+        "#define MR_LEXER_DFA_NONE ((mr_byte_t)0)\n\n", file);
+    fputs("/**\n * Action of a state that accepts a token (type of the token is in the \\a mr_lexer_dfa_token table).\n*/\n"
+        "#define MR_LEXER_DFA_TOKEN ((mr_byte_t)1)\n\n", file);
+
+    for (i = 0; i != mr_dfagen_actions_size; i++)
+    {
+        for (j = 0; mr_dfagen_actions[i][j]; j++)
+            name[j] = mr_dfagen_actions[i][j] >= 'a' && mr_dfagen_actions[i][j] <= 'z' ?
+                mr_dfagen_actions[i][j] - 'a' + 'A' : mr_dfagen_actions[i][j];
+        name[j] = '\0';
+
+        fprintf(file, "/**\n * Action of a state that hands the token over to the \\a %s subroutine.\n*/\n"
+            "#define MR_LEXER_DFA_%s ((mr_byte_t)%" PRIu16 ")\n\n", mr_dfagen_actions[i], name, (mr_short_t)(i + 2));
+    }
+
+    fputs("/**\n * Character class of each character.\n*/\n"
+        "static const mr_byte_t mr_lexer_dfa_class[256] =\n{", file);
+    for (i = 0; i != 256; i++)
+        fprintf(file, "%s%" PRIu8 "%s", i % 16 ? " " : "\n    ", mr_dfagen_class[i], i != 255 ? "," : "\n};\n\n");
+
+    fputs("/**\n * Transitions of the DFA states (indexed by state and character class).\n*/\n"
+        "static const mr_byte_t mr_lexer_dfa_next[MR_LEXER_DFA_STATE_COUNT][MR_LEXER_DFA_CLASS_COUNT] =\n{\n", file);
+    for (i = 0; i != mr_dfagen_states_size; i++)
+    {
+        fputs("    {", file);
+        for (j = 0; j != mr_dfagen_class_size; j++)
+            fprintf(file, "%" PRIu8 "%s", mr_dfagen_states[i].next[j], j + 1 != mr_dfagen_class_size ? ", " : "");
+        fputs(i + 1 != mr_dfagen_states_size ? "},\n" : "}\n};\n\n", file);
+    }
+
+    fputs("/**\n * Action of the DFA states.\n*/\n"
+        "static const mr_byte_t mr_lexer_dfa_action[MR_LEXER_DFA_STATE_COUNT] =\n{\n", file);
+    for (i = 0; i != mr_dfagen_states_size; i++)
+    {
+        rule = mr_dfagen_states[i].rule ? mr_dfagen_rules + mr_dfagen_states[i].rule - 1 : NULL;
+        fprintf(file, "    %" PRIu8 "%s", rule ? (mr_byte_t)(rule->action + 1) : 0, i + 1 != mr_dfagen_states_size ? ",\n" : "\n};\n\n");
+    }
+
+    fputs("/**\n * Token type of the DFA states (used by the states with \\a MR_LEXER_DFA_TOKEN action).\n*/\n"
+        "static const mr_byte_t mr_lexer_dfa_token[MR_LEXER_DFA_STATE_COUNT] =\n{\n", file);
+    for (i = 0; i != mr_dfagen_states_size; i++)
+    {
+        rule = mr_dfagen_states[i].rule ? mr_dfagen_rules + mr_dfagen_states[i].rule - 1 : NULL;
+        fprintf(file, "    %s%s", rule && !rule->action ? rule->result : "MR_TOKEN_EOF",
+            i + 1 != mr_dfagen_states_size ? ",\n" : "\n};\n\n");
+    }
+
+    fputs("#endif\n", file);
+}